@@ -13,6 +13,7 @@ from . import version
 from .version import module as __version__
 from .version import api as __api_version__
 from .train import *
+from .distributed import e_step_worker, train_distributed, train_local_distributed
 
 
 def ztnorm_same_value(vect_a, vect_b):
@@ -0,0 +1,392 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto CenteredGMMStats_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".CenteredGMMStats",
+  "The first order statistics of a probe, centered (and optionally variance-normalized) with respect to a UBM",
+  "The centered statistics :math:`F_c - N_c m_c` and the variance-normalized ones "
+  ":math:`\\Sigma_c^{-1} (F_c - N_c m_c)` are computed once per probe. "
+  "They can be passed instead of :py:class:`bob.learn.em.GMMStats` to "
+  ":py:func:`bob.learn.em.linear_scoring` and :py:meth:`bob.learn.em.IVectorMachine.project`, "
+  "which then skip this computation when the same probe is scored several times. "
+  "They must be used with machines that share the UBM they were computed with."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Centers the statistics of a probe with respect to a UBM.",
+    "",
+    true
+  )
+  .add_prototype("stats,ubm,[whitened]","")
+  .add_prototype("other","")
+  .add_prototype("","")
+
+  .add_parameter("stats", ":py:class:`bob.learn.em.GMMStats`", "The statistics of the probe")
+  .add_parameter("ubm", ":py:class:`bob.learn.em.GMMMachine`", "The UBM to center the statistics with")
+  .add_parameter("whitened", "bool", "[Default: ``True``] Compute the variance-normalized statistics as well")
+  .add_parameter("other", ":py:class:`bob.learn.em.CenteredGMMStats`", "A CenteredGMMStats object to be copied.")
+);
+
+
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}  /* converts PyObject to bool and returns false if object is NULL */
+
+static int PyBobLearnEMCenteredGMMStats_init_stats(PyBobLearnEMCenteredGMMStatsObject* self, PyObject* args, PyObject* kwargs) {
+
+  char** kwlist = CenteredGMMStats_doc.kwlist(0);
+  PyBobLearnEMGMMStatsObject* stats = 0;
+  PyBobLearnEMGMMMachineObject* ubm = 0;
+  PyObject* whitened = Py_True;
+  //Parsing the input argments
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!|O!", kwlist, &PyBobLearnEMGMMStats_Type, &stats,
+                                                                   &PyBobLearnEMGMMMachine_Type, &ubm,
+                                                                   &PyBool_Type, &whitened)){
+    CenteredGMMStats_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::learn::em::CenteredGMMStats(*stats->cxx, *ubm->cxx, f(whitened)));
+  return 0;
+}
+
+
+static int PyBobLearnEMCenteredGMMStats_init_copy(PyBobLearnEMCenteredGMMStatsObject* self, PyObject* args, PyObject* kwargs) {
+
+  char** kwlist = CenteredGMMStats_doc.kwlist(1);
+  PyBobLearnEMCenteredGMMStatsObject* tt;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobLearnEMCenteredGMMStats_Type, &tt)){
+    CenteredGMMStats_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::learn::em::CenteredGMMStats(*tt->cxx));
+  return 0;
+}
+
+
+static int PyBobLearnEMCenteredGMMStats_init(PyBobLearnEMCenteredGMMStatsObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  // get the number of command line arguments
+  int nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  switch (nargs) {
+
+    case 0: //default initializer ()
+      self->cxx.reset(new bob::learn::em::CenteredGMMStats());
+      return 0;
+
+    case 1:
+      return PyBobLearnEMCenteredGMMStats_init_copy(self, args, kwargs);
+
+    case 2:
+    case 3:
+      return PyBobLearnEMCenteredGMMStats_init_stats(self, args, kwargs);
+
+    default:
+      PyErr_Format(PyExc_RuntimeError, "number of arguments mismatch - %s requires 0, 1, 2 or 3 arguments, but you provided %d (see help)", Py_TYPE(self)->tp_name, nargs);
+      CenteredGMMStats_doc.print_usage();
+      return -1;
+  }
+  BOB_CATCH_MEMBER("cannot create CenteredGMMStats", -1)
+  return 0;
+}
+
+
+
+static void PyBobLearnEMCenteredGMMStats_delete(PyBobLearnEMCenteredGMMStatsObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* PyBobLearnEMCenteredGMMStats_RichCompare(PyBobLearnEMCenteredGMMStatsObject* self, PyObject* other, int op) {
+  BOB_TRY
+
+  if (!PyBobLearnEMCenteredGMMStats_Check(other)) {
+    PyErr_Format(PyExc_TypeError, "cannot compare `%s' with `%s'", Py_TYPE(self)->tp_name, Py_TYPE(other)->tp_name);
+    return 0;
+  }
+  auto other_ = reinterpret_cast<PyBobLearnEMCenteredGMMStatsObject*>(other);
+  switch (op) {
+    case Py_EQ:
+      if (*self->cxx==*other_->cxx) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+    case Py_NE:
+      if (*self->cxx==*other_->cxx) Py_RETURN_FALSE; else Py_RETURN_TRUE;
+    default:
+      Py_INCREF(Py_NotImplemented);
+      return Py_NotImplemented;
+  }
+  BOB_CATCH_MEMBER("cannot compare CenteredGMMStats objects", 0)
+}
+
+int PyBobLearnEMCenteredGMMStats_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMCenteredGMMStats_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+/***** n *****/
+static auto n = bob::extension::VariableDoc(
+  "n",
+  "array_like <float, 1D>",
+  "For each Gaussian, the accumulated sum of responsibilities"
+);
+PyObject* PyBobLearnEMCenteredGMMStats_getN(PyBobLearnEMCenteredGMMStatsObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getN());
+  BOB_CATCH_MEMBER("n could not be read", 0)
+}
+
+
+/***** t *****/
+static auto t = bob::extension::VariableDoc(
+  "t",
+  "int",
+  "The number of frames of the probe"
+);
+PyObject* PyBobLearnEMCenteredGMMStats_getT(PyBobLearnEMCenteredGMMStatsObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("i", self->cxx->getT());
+  BOB_CATCH_MEMBER("t could not be read", 0)
+}
+
+
+/***** centered_sum_px *****/
+static auto centered_sum_px = bob::extension::VariableDoc(
+  "centered_sum_px",
+  "array_like <float, 1D>",
+  "The centered first order statistics supervector :math:`F_c - N_c m_c`"
+);
+PyObject* PyBobLearnEMCenteredGMMStats_getCenteredSumPx(PyBobLearnEMCenteredGMMStatsObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getCenteredSumPx());
+  BOB_CATCH_MEMBER("centered_sum_px could not be read", 0)
+}
+
+
+/***** whitened_sum_px *****/
+static auto whitened_sum_px = bob::extension::VariableDoc(
+  "whitened_sum_px",
+  "array_like <float, 1D>",
+  "The variance-normalized centered first order statistics supervector :math:`\\Sigma_c^{-1} (F_c - N_c m_c)`",
+  "Raises a RuntimeError if they were not computed (see :py:attr:`has_whitened`)."
+);
+PyObject* PyBobLearnEMCenteredGMMStats_getWhitenedSumPx(PyBobLearnEMCenteredGMMStatsObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getWhitenedSumPx());
+  BOB_CATCH_MEMBER("whitened_sum_px could not be read", 0)
+}
+
+
+/***** has_whitened *****/
+static auto has_whitened = bob::extension::VariableDoc(
+  "has_whitened",
+  "bool",
+  "Tells if the variance-normalized statistics :py:attr:`whitened_sum_px` are available"
+);
+PyObject* PyBobLearnEMCenteredGMMStats_getHasWhitened(PyBobLearnEMCenteredGMMStatsObject* self, void*) {
+  BOB_TRY
+  if (self->cxx->hasWhitened()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("has_whitened could not be read", 0)
+}
+
+
+/***** shape *****/
+static auto shape = bob::extension::VariableDoc(
+  "shape",
+  "(int,int)",
+  "A tuple that represents the number of gaussians and dimensionality of each Gaussian ``(n_gaussians, dim)``.",
+  ""
+);
+PyObject* PyBobLearnEMCenteredGMMStats_getShape(PyBobLearnEMCenteredGMMStatsObject* self, void*) {
+  BOB_TRY
+  return Py_BuildValue("(i,i)", self->cxx->getNGaussians(), self->cxx->getNInputs());
+  BOB_CATCH_MEMBER("shape could not be read", 0)
+}
+
+
+static PyGetSetDef PyBobLearnEMCenteredGMMStats_getseters[] = {
+  {
+    n.name(),
+    (getter)PyBobLearnEMCenteredGMMStats_getN,
+    0,
+    n.doc(),
+    0
+  },
+  {
+    t.name(),
+    (getter)PyBobLearnEMCenteredGMMStats_getT,
+    0,
+    t.doc(),
+    0
+  },
+  {
+    centered_sum_px.name(),
+    (getter)PyBobLearnEMCenteredGMMStats_getCenteredSumPx,
+    0,
+    centered_sum_px.doc(),
+    0
+  },
+  {
+    whitened_sum_px.name(),
+    (getter)PyBobLearnEMCenteredGMMStats_getWhitenedSumPx,
+    0,
+    whitened_sum_px.doc(),
+    0
+  },
+  {
+    has_whitened.name(),
+    (getter)PyBobLearnEMCenteredGMMStats_getHasWhitened,
+    0,
+    has_whitened.doc(),
+    0
+  },
+  {
+    shape.name(),
+    (getter)PyBobLearnEMCenteredGMMStats_getShape,
+    0,
+    shape.doc(),
+    0
+  },
+
+  {0}  // Sentinel
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+/*** is_similar_to ***/
+static auto is_similar_to = bob::extension::FunctionDoc(
+  "is_similar_to",
+
+  "Compares this CenteredGMMStats with the ``other`` one to be approximately the same.",
+  "The optional values ``r_epsilon`` and ``a_epsilon`` refer to the "
+  "relative and absolute precision of the statistics."
+)
+.add_prototype("other, [r_epsilon], [a_epsilon]","output")
+.add_parameter("other", ":py:class:`bob.learn.em.CenteredGMMStats`", "A CenteredGMMStats object to be compared.")
+.add_parameter("r_epsilon", "float", "Relative precision.")
+.add_parameter("a_epsilon", "float", "Absolute precision.")
+.add_return("output","bool","True if it is similar, otherwise false.");
+static PyObject* PyBobLearnEMCenteredGMMStats_IsSimilarTo(PyBobLearnEMCenteredGMMStatsObject* self, PyObject* args, PyObject* kwds) {
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = is_similar_to.kwlist(0);
+
+  PyBobLearnEMCenteredGMMStatsObject* other = 0;
+  double r_epsilon = 1.e-5;
+  double a_epsilon = 1.e-8;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!|dd", kwlist,
+        &PyBobLearnEMCenteredGMMStats_Type, &other,
+        &r_epsilon, &a_epsilon)){
+
+        is_similar_to.print_usage();
+        return 0;
+  }
+
+  if (self->cxx->is_similar_to(*other->cxx, r_epsilon, a_epsilon))
+    Py_RETURN_TRUE;
+  else
+    Py_RETURN_FALSE;
+}
+
+
+/*** compute ***/
+static auto compute = bob::extension::FunctionDoc(
+  "compute",
+  "Centers the given statistics with respect to the UBM",
+  0,
+  true
+)
+.add_prototype("stats,ubm,[whitened]")
+.add_parameter("stats", ":py:class:`bob.learn.em.GMMStats`", "The statistics of the probe")
+.add_parameter("ubm", ":py:class:`bob.learn.em.GMMMachine`", "The UBM to center the statistics with")
+.add_parameter("whitened", "bool", "[Default: ``True``] Compute the variance-normalized statistics as well");
+static PyObject* PyBobLearnEMCenteredGMMStats_compute(PyBobLearnEMCenteredGMMStatsObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = compute.kwlist(0);
+  PyBobLearnEMGMMStatsObject* stats = 0;
+  PyBobLearnEMGMMMachineObject* ubm = 0;
+  PyObject* whitened = Py_True;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!|O!", kwlist, &PyBobLearnEMGMMStats_Type, &stats,
+                                                                   &PyBobLearnEMGMMMachine_Type, &ubm,
+                                                                   &PyBool_Type, &whitened)) return 0;
+
+  self->cxx->compute(*stats->cxx, *ubm->cxx, f(whitened));
+
+  BOB_CATCH_MEMBER("cannot compute the centered statistics", 0)
+  Py_RETURN_NONE;
+}
+
+
+static PyMethodDef PyBobLearnEMCenteredGMMStats_methods[] = {
+  {
+    is_similar_to.name(),
+    (PyCFunction)PyBobLearnEMCenteredGMMStats_IsSimilarTo,
+    METH_VARARGS|METH_KEYWORDS,
+    is_similar_to.doc()
+  },
+  {
+    compute.name(),
+    (PyCFunction)PyBobLearnEMCenteredGMMStats_compute,
+    METH_VARARGS|METH_KEYWORDS,
+    compute.doc()
+  },
+
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the CenteredGMMStats type struct; will be initialized later
+PyTypeObject PyBobLearnEMCenteredGMMStats_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobLearnEMCenteredGMMStats(PyObject* module)
+{
+  // initialize the type struct
+  PyBobLearnEMCenteredGMMStats_Type.tp_name = CenteredGMMStats_doc.name();
+  PyBobLearnEMCenteredGMMStats_Type.tp_basicsize = sizeof(PyBobLearnEMCenteredGMMStatsObject);
+  PyBobLearnEMCenteredGMMStats_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobLearnEMCenteredGMMStats_Type.tp_doc = CenteredGMMStats_doc.doc();
+
+  // set the functions
+  PyBobLearnEMCenteredGMMStats_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMCenteredGMMStats_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMCenteredGMMStats_init);
+  PyBobLearnEMCenteredGMMStats_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMCenteredGMMStats_delete);
+  PyBobLearnEMCenteredGMMStats_Type.tp_richcompare = reinterpret_cast<richcmpfunc>(PyBobLearnEMCenteredGMMStats_RichCompare);
+  PyBobLearnEMCenteredGMMStats_Type.tp_methods = PyBobLearnEMCenteredGMMStats_methods;
+  PyBobLearnEMCenteredGMMStats_Type.tp_getset = PyBobLearnEMCenteredGMMStats_getseters;
+  PyBobLearnEMCenteredGMMStats_Type.tp_call = 0;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobLearnEMCenteredGMMStats_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobLearnEMCenteredGMMStats_Type);
+  return PyModule_AddObject(module, "CenteredGMMStats", (PyObject*)&PyBobLearnEMCenteredGMMStats_Type) >= 0;
+}
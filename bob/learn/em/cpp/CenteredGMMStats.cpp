@@ -0,0 +1,111 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/CenteredGMMStats.h>
+#include <bob.core/assert.h>
+#include <bob.core/check.h>
+#include <bob.core/array_copy.h>
+
+bob::learn::em::CenteredGMMStats::CenteredGMMStats():
+  m_T(0), m_has_whitened(false)
+{
+}
+
+bob::learn::em::CenteredGMMStats::CenteredGMMStats(
+  const bob::learn::em::GMMStats& stats,
+  const bob::learn::em::GMMMachine& ubm, const bool whitened)
+{
+  compute(stats, ubm, whitened);
+}
+
+bob::learn::em::CenteredGMMStats::CenteredGMMStats(
+  const bob::learn::em::CenteredGMMStats& other):
+  m_T(other.m_T),
+  m_has_whitened(other.m_has_whitened),
+  m_n(bob::core::array::ccopy(other.m_n)),
+  m_centered(bob::core::array::ccopy(other.m_centered)),
+  m_whitened(bob::core::array::ccopy(other.m_whitened))
+{
+}
+
+bob::learn::em::CenteredGMMStats::~CenteredGMMStats()
+{
+}
+
+bob::learn::em::CenteredGMMStats&
+bob::learn::em::CenteredGMMStats::operator=(const bob::learn::em::CenteredGMMStats& other)
+{
+  if (this != &other)
+  {
+    m_T = other.m_T;
+    m_has_whitened = other.m_has_whitened;
+    m_n.reference(bob::core::array::ccopy(other.m_n));
+    m_centered.reference(bob::core::array::ccopy(other.m_centered));
+    m_whitened.reference(bob::core::array::ccopy(other.m_whitened));
+  }
+  return *this;
+}
+
+bool bob::learn::em::CenteredGMMStats::operator==(const bob::learn::em::CenteredGMMStats& b) const
+{
+  return (m_T == b.m_T && m_has_whitened == b.m_has_whitened &&
+          bob::core::array::isEqual(m_n, b.m_n) &&
+          bob::core::array::isEqual(m_centered, b.m_centered) &&
+          bob::core::array::isEqual(m_whitened, b.m_whitened));
+}
+
+bool bob::learn::em::CenteredGMMStats::operator!=(const bob::learn::em::CenteredGMMStats& b) const
+{
+  return !(this->operator==(b));
+}
+
+bool bob::learn::em::CenteredGMMStats::is_similar_to(const bob::learn::em::CenteredGMMStats& b,
+  const double r_epsilon, const double a_epsilon) const
+{
+  return (m_T == b.m_T && m_has_whitened == b.m_has_whitened &&
+          bob::core::array::isClose(m_n, b.m_n, r_epsilon, a_epsilon) &&
+          bob::core::array::isClose(m_centered, b.m_centered, r_epsilon, a_epsilon) &&
+          bob::core::array::isClose(m_whitened, b.m_whitened, r_epsilon, a_epsilon));
+}
+
+void bob::learn::em::CenteredGMMStats::compute(const bob::learn::em::GMMStats& stats,
+  const bob::learn::em::GMMMachine& ubm, const bool whitened)
+{
+  const int C = ubm.getNGaussians();
+  const int D = ubm.getNInputs();
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), C);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), D);
+
+  m_T = stats.T;
+  m_has_whitened = whitened;
+  m_n.resize(C);
+  m_n = stats.n;
+
+  // Computes F_c - N_c m_c
+  const blitz::Array<double,1>& mean = ubm.getMeanSupervector();
+  m_centered.resize(C*D);
+  for (int c=0; c<C; ++c) {
+    blitz::Range rc(c*D, (c+1)*D-1);
+    m_centered(rc) = stats.sumPx(c, blitz::Range::all()) - stats.n(c) * mean(rc);
+  }
+
+  // Computes Sigma_c^-1 (F_c - N_c m_c)
+  if (whitened) {
+    m_whitened.resize(C*D);
+    m_whitened = m_centered / ubm.getVarianceSupervector();
+  }
+  else
+    m_whitened.resize(0);
+}
+
+const blitz::Array<double,1>&
+bob::learn::em::CenteredGMMStats::getWhitenedSumPx() const
+{
+  if (!m_has_whitened)
+    throw std::runtime_error("CenteredGMMStats: the variance-normalized statistics were not computed");
+  return m_whitened;
+}
@@ -0,0 +1,42 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/Checkpoint.h>
+#include <boost/format.hpp>
+#include <sstream>
+#include <stdexcept>
+
+
+void bob::learn::em::saveRng(bob::io::base::HDF5File& config,
+  const std::string& path, const boost::mt19937& rng)
+{
+  // The stream operator of the generator gives its full state, as
+  // state_size words
+  std::stringstream ss;
+  ss << rng;
+  blitz::Array<uint32_t,1> state(boost::mt19937::state_size);
+  for (int i=0; i<state.extent(0); ++i)
+    ss >> state(i);
+  if (ss.fail())
+    throw std::runtime_error("cannot save the state of the random number generator");
+  config.setArray(path, state);
+}
+
+void bob::learn::em::loadRng(bob::io::base::HDF5File& config,
+  const std::string& path, boost::mt19937& rng)
+{
+  const blitz::Array<uint32_t,1> state = config.readArray<uint32_t,1>(path);
+  if (state.extent(0) != (int)boost::mt19937::state_size) {
+    boost::format m("the state of the random number generator `%s' has %d words instead of %d");
+    m % path % state.extent(0) % boost::mt19937::state_size;
+    throw std::runtime_error(m.str());
+  }
+  std::stringstream ss;
+  for (int i=0; i<state.extent(0); ++i)
+    ss << state(i) << ' ';
+  ss >> rng;
+}
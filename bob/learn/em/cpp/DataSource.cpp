@@ -0,0 +1,190 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/DataSource.h>
+#include <bob.io.base/HDF5File.h>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+
+bob::learn::em::ArrayDataSource::ArrayDataSource(
+  const blitz::Array<double,2>& data, const size_t chunk_size):
+  m_data(data),
+  m_chunk_size(chunk_size),
+  m_position(0)
+{
+}
+
+bob::learn::em::ArrayDataSource::~ArrayDataSource()
+{
+}
+
+void bob::learn::em::ArrayDataSource::reset()
+{
+  m_position = 0;
+}
+
+bool bob::learn::em::ArrayDataSource::next(blitz::Array<double,2>& chunk)
+{
+  const size_t n_samples = m_data.extent(0);
+  if (m_position >= n_samples) return false;
+
+  const size_t end = m_chunk_size ? std::min(m_position + m_chunk_size, n_samples) : n_samples;
+  chunk.reference(m_data(blitz::Range(m_position, end-1), blitz::Range::all()));
+  m_position = end;
+  return true;
+}
+
+
+bob::learn::em::FileListDataSource::FileListDataSource(
+  const std::vector<std::string>& filenames, const std::string& key,
+  const size_t n_buffers):
+  m_filenames(filenames),
+  m_key(key),
+  m_slots(n_buffers),
+  m_read(0),
+  m_write(0),
+  m_count(0),
+  m_holding(false),
+  m_started(false),
+  m_stop(false)
+{
+  if (n_buffers == 0)
+    throw std::runtime_error("FileListDataSource: the number of buffers must be greater than zero");
+}
+
+bob::learn::em::FileListDataSource::~FileListDataSource()
+{
+  stop();
+}
+
+void bob::learn::em::FileListDataSource::start()
+{
+  // The buffers are only released by the consumer thread, which may still
+  // reference them (the reference counts of blitz++ are not atomic)
+  for (size_t i=0; i<m_slots.size(); ++i)
+    m_slots[i].data.free();
+  m_read = 0;
+  m_write = 0;
+  m_count = 0;
+  m_holding = false;
+  m_started = false;
+  m_stop = false;
+  m_thread.reset(new boost::thread(boost::bind(&FileListDataSource::prefetch, this)));
+}
+
+void bob::learn::em::FileListDataSource::stop()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  if (m_thread) {
+    m_thread->join();
+    m_thread.reset();
+  }
+}
+
+void bob::learn::em::FileListDataSource::reset()
+{
+  // Keeps what was prefetched for a pass which did not start yet
+  if (m_thread && !m_started) return;
+  stop();
+  start();
+}
+
+bool bob::learn::em::FileListDataSource::waitForFreeSlot()
+{
+  boost::unique_lock<boost::mutex> lock(m_mutex);
+  while (m_count == m_slots.size() && !m_stop)
+    m_condition.wait(lock);
+  return !m_stop;
+}
+
+void bob::learn::em::FileListDataSource::push()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_write = (m_write + 1) % m_slots.size();
+    ++m_count;
+  }
+  m_condition.notify_all();
+}
+
+void bob::learn::em::FileListDataSource::prefetch()
+{
+  // The slot at m_write is only accessed by this thread until it is pushed,
+  // and its buffer was released by the consumer
+  for (size_t i=0; i<m_filenames.size(); ++i) {
+    if (!waitForFreeSlot()) return;
+    Slot& slot = m_slots[m_write];
+    slot.end = false;
+    slot.error.clear();
+    try {
+      bob::io::base::HDF5File file(m_filenames[i], bob::io::base::HDF5File::in);
+      slot.data.reference(file.readArray<double,2>(m_key));
+    }
+    catch (std::exception& e) {
+      slot.error = (boost::format("cannot read `%s' from `%s': %s") % m_key % m_filenames[i] % e.what()).str();
+    }
+    catch (...) {
+      slot.error = (boost::format("cannot read `%s' from `%s'") % m_key % m_filenames[i]).str();
+    }
+    const bool failed = !slot.error.empty();
+    push();
+    if (failed) return;
+  }
+
+  if (!waitForFreeSlot()) return;
+  Slot& slot = m_slots[m_write];
+  slot.end = true;
+  slot.error.clear();
+  push();
+}
+
+bool bob::learn::em::FileListDataSource::next(blitz::Array<double,2>& chunk)
+{
+  // The files are only read during a pass, so that the HDF5 library can be
+  // used by the caller between two passes (e.g., to save a checkpoint)
+  if (!m_thread) start();
+
+  boost::unique_lock<boost::mutex> lock(m_mutex);
+
+  // Releases the chunk given by the previous call
+  if (m_holding) {
+    m_slots[m_read].data.free();
+    m_read = (m_read + 1) % m_slots.size();
+    --m_count;
+    m_holding = false;
+    m_condition.notify_all();
+  }
+
+  while (m_count == 0)
+    m_condition.wait(lock);
+
+  const Slot& slot = m_slots[m_read];
+  if (!slot.error.empty()) {
+    // A reset() starts a new pass
+    m_started = true;
+    throw std::runtime_error("FileListDataSource: " + slot.error);
+  }
+
+  if (slot.end) {
+    lock.unlock();
+    // The next pass starts with reset() (or the next call)
+    stop();
+    return false;
+  }
+
+  chunk.reference(slot.data);
+  m_holding = true;
+  m_started = true;
+  return true;
+}
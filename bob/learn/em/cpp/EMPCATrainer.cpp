@@ -11,6 +11,7 @@
 #include <cmath>
 
 #include <bob.learn.em/EMPCATrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <bob.core/array_copy.h>
 #include <bob.core/check.h>
 #include <bob.math/linear.h>
@@ -418,3 +419,23 @@ double bob::learn::em::EMPCATrainer::computeLikelihood(bob::learn::linear::Machi
 
   return llh;
 }
+
+void bob::learn::em::EMPCATrainer::save(bob::io::base::HDF5File& config) const
+{
+  if (m_rng) saveRng(config, "rng", *m_rng);
+  config.set("sigma2", m_sigma2);
+  config.setArray("z_first_order", m_z_first_order);
+  config.setArray("z_second_order", m_z_second_order);
+  config.setArray("inW", m_inW);
+  config.setArray("invM", m_invM);
+}
+
+void bob::learn::em::EMPCATrainer::load(bob::io::base::HDF5File& config)
+{
+  if (m_rng) loadRng(config, "rng", *m_rng);
+  m_sigma2 = config.read<double>("sigma2");
+  m_z_first_order.reference(config.readArray<double,2>("z_first_order"));
+  m_z_second_order.reference(config.readArray<double,3>("z_second_order"));
+  m_inW.reference(config.readArray<double,2>("inW"));
+  m_invM.reference(config.readArray<double,2>("invM"));
+}
@@ -9,6 +9,7 @@
 
 #include <bob.learn.em/FABase.h>
 #include <bob.core/array_copy.h>
+#include <bob.core/assert.h>
 #include <bob.math/linear.h>
 #include <bob.math/inv.h>
 #include <limits>
@@ -240,6 +241,12 @@ void bob::learn::em::FABase::updateCacheUbmUVD()
 
 void bob::learn::em::FABase::computeIdPlusUSProdInv(const bob::learn::em::GMMStats& gmm_stats,
   blitz::Array<double,2>& output) const
+{
+  computeIdPlusUSProdInv(gmm_stats.n, output);
+}
+
+void bob::learn::em::FABase::computeIdPlusUSProdInv(const blitz::Array<double,1>& n,
+  blitz::Array<double,2>& output) const
 {
   // Computes (Id + U^T.Sigma^-1.U.N_{i,h}.U)^-1 =
   // (Id + sum_{c=1..C} N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c})^-1
@@ -265,7 +272,7 @@ void bob::learn::em::FABase::computeIdPlusUSProdInv(const bob::learn::em::GMMSta
     // Use m_cache_IdPlusUSProdInv as an intermediate array
     bob::math::prod(m_tmp_ruD, U_c, output); // U_{c}^T.Sigma_{c}^-1.U_{c}
     // Finally, add N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c} to m_tmp_ruru
-    m_tmp_ruru += output * gmm_stats.n(c);
+    m_tmp_ruru += output * n(c);
   }
   // Computes the inverse
   bob::math::inv(m_tmp_ruru, output);
@@ -305,3 +312,11 @@ void bob::learn::em::FABase::estimateX(const bob::learn::em::GMMStats& gmm_stats
   estimateX(m_tmp_IdPlusUSProdInv, m_tmp_Fn_x, x); // Estimates the value of x
 }
 
+void bob::learn::em::FABase::estimateX(const bob::learn::em::CenteredGMMStats& gmm_stats, blitz::Array<double,1>& x) const
+{
+  if (!m_ubm) throw std::runtime_error("No UBM was set in the JFA machine.");
+  bob::core::array::assertSameDimensionLength(gmm_stats.getCenteredSumPx().extent(0), (int)getSupervectorLength());
+  computeIdPlusUSProdInv(gmm_stats.getN(), m_tmp_IdPlusUSProdInv); // Computes first term
+  // The last term Fn_x = N*(o - m) is cached in the centered statistics
+  estimateX(m_tmp_IdPlusUSProdInv, gmm_stats.getCenteredSumPx(), x); // Estimates the value of x
+}
@@ -9,6 +9,7 @@
  */
 
 #include <bob.learn.em/FABaseTrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <bob.core/check.h>
 #include <bob.core/array_copy.h>
 #include <bob.core/array_random.h>
@@ -545,3 +546,30 @@ void bob::learn::em::FABaseTrainer::updateD(blitz::Array<double,1>& d)
 }
 
 
+
+
+void bob::learn::em::FABaseTrainer::save(bob::io::base::HDF5File& config) const
+{
+  saveArrays(config, "x", m_x);
+  saveArrays(config, "y", m_y);
+  saveArrays(config, "z", m_z);
+  saveOptionalArray(config, "acc_V_A1", m_acc_V_A1);
+  saveOptionalArray(config, "acc_V_A2", m_acc_V_A2);
+  saveOptionalArray(config, "acc_U_A1", m_acc_U_A1);
+  saveOptionalArray(config, "acc_U_A2", m_acc_U_A2);
+  saveOptionalArray(config, "acc_D_A1", m_acc_D_A1);
+  saveOptionalArray(config, "acc_D_A2", m_acc_D_A2);
+}
+
+void bob::learn::em::FABaseTrainer::load(bob::io::base::HDF5File& config)
+{
+  loadArrays(config, "x", m_x);
+  loadArrays(config, "y", m_y);
+  loadArrays(config, "z", m_z);
+  loadOptionalArray(config, "acc_V_A1", m_acc_V_A1);
+  loadOptionalArray(config, "acc_V_A2", m_acc_V_A2);
+  loadOptionalArray(config, "acc_U_A1", m_acc_U_A1);
+  loadOptionalArray(config, "acc_U_A2", m_acc_U_A2);
+  loadOptionalArray(config, "acc_D_A1", m_acc_D_A1);
+  loadOptionalArray(config, "acc_D_A2", m_acc_D_A2);
+}
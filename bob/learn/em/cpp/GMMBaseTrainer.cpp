@@ -21,6 +21,7 @@ bob::learn::em::GMMBaseTrainer::GMMBaseTrainer(const bool update_means,
 bob::learn::em::GMMBaseTrainer::GMMBaseTrainer(const bob::learn::em::GMMBaseTrainer& b):
   m_ss(new bob::learn::em::GMMStats()),
   m_update_means(b.m_update_means), m_update_variances(b.m_update_variances),
+  m_update_weights(b.m_update_weights),
   m_mean_var_update_responsibilities_threshold(b.m_mean_var_update_responsibilities_threshold)
 {}
 
@@ -41,6 +42,16 @@ void bob::learn::em::GMMBaseTrainer::eStep(bob::learn::em::GMMMachine& gmm,
   gmm.accStatistics(data, *m_ss);
 }
 
+void bob::learn::em::GMMBaseTrainer::eStep(bob::learn::em::GMMMachine& gmm,
+  bob::learn::em::DataSource& data)
+{
+  m_ss->init();
+  data.reset();
+  blitz::Array<double,2> chunk;
+  while (data.next(chunk))
+    gmm.accStatistics(chunk, *m_ss);
+}
+
 double bob::learn::em::GMMBaseTrainer::computeLikelihood(bob::learn::em::GMMMachine& gmm)
 {
   return m_ss->log_likelihood / m_ss->T;
@@ -94,3 +105,18 @@ void bob::learn::em::GMMBaseTrainer::setGMMStats(boost::shared_ptr<bob::learn::e
   bob::core::array::assertSameShape(m_ss->sumPx, stats->sumPx);
   m_ss = stats;
 }
+
+void bob::learn::em::GMMBaseTrainer::save(bob::io::base::HDF5File& config) const
+{
+  config.createGroup("stats");
+  config.cd("stats");
+  m_ss->save(config);
+  config.cd("..");
+}
+
+void bob::learn::em::GMMBaseTrainer::load(bob::io::base::HDF5File& config)
+{
+  config.cd("stats");
+  m_ss->load(config);
+  config.cd("..");
+}
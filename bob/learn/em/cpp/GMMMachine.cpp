@@ -9,6 +9,9 @@
 #include <bob.learn.em/GMMMachine.h>
 #include <bob.core/assert.h>
 #include <bob.math/log.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
 
 bob::learn::em::GMMMachine::GMMMachine(): m_gaussians(0) {
   resize(0,0);
@@ -224,6 +227,82 @@ void bob::learn::em::GMMMachine::resize(const size_t n_gaussians, const size_t n
   initCache();
 }
 
+namespace {
+  // Orders the components by decreasing weight
+  struct WeightGreater {
+    WeightGreater(const blitz::Array<double,1>& weights): m_weights(weights) {}
+    bool operator()(const size_t i, const size_t j) const
+    { return m_weights(i) > m_weights(j); }
+    const blitz::Array<double,1>& m_weights;
+  };
+}
+
+void bob::learn::em::GMMMachine::split(const size_t n_splits, const double epsilon) {
+  if (n_splits > m_n_gaussians) {
+    boost::format m("cannot split %lu components of a GMM with %lu components");
+    m % n_splits % m_n_gaussians;
+    throw std::runtime_error(m.str());
+  }
+  if (n_splits == 0) return;
+
+  std::vector<size_t> order(m_n_gaussians);
+  for (size_t i=0; i<m_n_gaussians; ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), WeightGreater(m_weights));
+
+  blitz::Array<double,1> weights(m_n_gaussians + n_splits);
+  weights(blitz::Range(0, m_n_gaussians-1)) = m_weights;
+  for (size_t k=0; k<n_splits; ++k) {
+    const size_t i = order[k];
+    boost::shared_ptr<bob::learn::em::Gaussian> g(new bob::learn::em::Gaussian(*m_gaussians[i]));
+
+    // Direction of largest variance
+    const blitz::Array<double,1>& variance = m_gaussians[i]->getVariance();
+    const int d = blitz::maxIndex(variance)(0);
+    const double shift = epsilon * std::sqrt(variance(d));
+    m_gaussians[i]->updateMean()(d) += shift;
+    g->updateMean()(d) -= shift;
+    m_gaussians.push_back(g);
+
+    weights(i) /= 2.;
+    weights(m_n_gaussians + k) = weights(i);
+  }
+
+  m_n_gaussians += n_splits;
+  m_weights.reference(weights);
+  initCache();
+}
+
+void bob::learn::em::GMMMachine::removeGaussians(const std::vector<size_t>& indices) {
+  std::vector<bool> removed(m_n_gaussians, false);
+  for (size_t k=0; k<indices.size(); ++k) {
+    if (indices[k] >= m_n_gaussians) {
+      boost::format m("cannot remove the component %lu of a GMM with %lu components");
+      m % indices[k] % m_n_gaussians;
+      throw std::runtime_error(m.str());
+    }
+    removed[indices[k]] = true;
+  }
+
+  std::vector<boost::shared_ptr<bob::learn::em::Gaussian> > gaussians;
+  std::vector<double> weights;
+  for (size_t i=0; i<m_n_gaussians; ++i) {
+    if (removed[i]) continue;
+    gaussians.push_back(m_gaussians[i]);
+    weights.push_back(m_weights(i));
+  }
+  if (gaussians.empty())
+    throw std::runtime_error("cannot remove all the components of a GMM");
+  if (gaussians.size() == m_n_gaussians) return;
+
+  m_n_gaussians = gaussians.size();
+  m_gaussians.swap(gaussians);
+  blitz::Array<double,1> new_weights(m_n_gaussians);
+  for (size_t i=0; i<m_n_gaussians; ++i) new_weights(i) = weights[i];
+  new_weights /= blitz::sum(new_weights);
+  m_weights.reference(new_weights);
+  initCache();
+}
+
 double bob::learn::em::GMMMachine::logLikelihood(const blitz::Array<double, 1> &x,
   blitz::Array<double,1> &log_weighted_gaussian_likelihoods) const
 {
@@ -352,8 +431,9 @@ void bob::learn::em::GMMMachine::accStatisticsInternal(const blitz::Array<double
 
   stats.sumPx += m_cache_Px;
 
-  // - second order stats
-  stats.sumPxx += (m_cache_Px(i,j) * x(j));
+  // - second order stats (skipped for first order only statistics)
+  if (stats.hasSecondOrder())
+    stats.sumPxx += (m_cache_Px(i,j) * x(j));
 }
 
 boost::shared_ptr<bob::learn::em::Gaussian> bob::learn::em::GMMMachine::getGaussian(const size_t i) {
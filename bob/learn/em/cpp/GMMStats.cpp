@@ -14,8 +14,10 @@ bob::learn::em::GMMStats::GMMStats() {
   resize(0,0);
 }
 
-bob::learn::em::GMMStats::GMMStats(const size_t n_gaussians, const size_t n_inputs) {
-  resize(n_gaussians,n_inputs);
+bob::learn::em::GMMStats::GMMStats(const size_t n_gaussians, const size_t n_inputs,
+  const bool second_order)
+{
+  resize(n_gaussians,n_inputs,second_order);
 }
 
 bob::learn::em::GMMStats::GMMStats(bob::io::base::HDF5File& config) {
@@ -42,6 +44,7 @@ bob::learn::em::GMMStats::operator=(const bob::learn::em::GMMStats& other) {
 bool bob::learn::em::GMMStats::operator==(const bob::learn::em::GMMStats& b) const
 {
   return (T == b.T && log_likelihood == b.log_likelihood &&
+          m_second_order == b.m_second_order &&
           bob::core::array::isEqual(n, b.n) &&
           bob::core::array::isEqual(sumPx, b.sumPx) &&
           bob::core::array::isEqual(sumPxx, b.sumPxx));
@@ -56,7 +59,7 @@ bob::learn::em::GMMStats::operator!=(const bob::learn::em::GMMStats& b) const
 bool bob::learn::em::GMMStats::is_similar_to(const bob::learn::em::GMMStats& b,
   const double r_epsilon, const double a_epsilon) const
 {
-  return (T == b.T &&
+  return (T == b.T && m_second_order == b.m_second_order &&
           bob::core::isClose(log_likelihood, b.log_likelihood, r_epsilon, a_epsilon) &&
           bob::core::array::isClose(n, b.n, r_epsilon, a_epsilon) &&
           bob::core::array::isClose(sumPx, b.sumPx, r_epsilon, a_epsilon) &&
@@ -67,22 +70,26 @@ bool bob::learn::em::GMMStats::is_similar_to(const bob::learn::em::GMMStats& b,
 void bob::learn::em::GMMStats::operator+=(const bob::learn::em::GMMStats& b) {
   // Check dimensions
   if(n.extent(0) != b.n.extent(0) ||
-      sumPx.extent(0) != b.sumPx.extent(0) || sumPx.extent(1) != b.sumPx.extent(1) ||
-      sumPxx.extent(0) != b.sumPxx.extent(0) || sumPxx.extent(1) != b.sumPxx.extent(1))
+      sumPx.extent(0) != b.sumPx.extent(0) || sumPx.extent(1) != b.sumPx.extent(1))
     // TODO: add a specialized exception
     throw std::runtime_error("if you see this exception, fill a bug report");
+  // Second order statistics can only be added to first order ones
+  // (they are then discarded), not the opposite
+  if(m_second_order && !b.m_second_order)
+    throw std::runtime_error("GMMStats: cannot add first order only statistics to statistics with second order");
 
   // Update GMMStats object with the content of the other one
   T += b.T;
   log_likelihood += b.log_likelihood;
   n += b.n;
   sumPx += b.sumPx;
-  sumPxx += b.sumPxx;
+  if(m_second_order)
+    sumPxx += b.sumPxx;
 }
 
 void bob::learn::em::GMMStats::copy(const GMMStats& other) {
   // Resize arrays
-  resize(other.sumPx.extent(0),other.sumPx.extent(1));
+  resize(other.sumPx.extent(0),other.sumPx.extent(1),other.m_second_order);
   // Copy content
   T = other.T;
   log_likelihood = other.log_likelihood;
@@ -91,10 +98,16 @@ void bob::learn::em::GMMStats::copy(const GMMStats& other) {
   sumPxx = other.sumPxx;
 }
 
-void bob::learn::em::GMMStats::resize(const size_t n_gaussians, const size_t n_inputs) {
+void bob::learn::em::GMMStats::resize(const size_t n_gaussians, const size_t n_inputs,
+  const bool second_order)
+{
+  m_second_order = second_order;
   n.resize(n_gaussians);
   sumPx.resize(n_gaussians, n_inputs);
-  sumPxx.resize(n_gaussians, n_inputs);
+  if(m_second_order)
+    sumPxx.resize(n_gaussians, n_inputs);
+  else
+    sumPxx.resize(0, 0);
   init();
 }
 
@@ -118,24 +131,25 @@ void bob::learn::em::GMMStats::save(bob::io::base::HDF5File& config) const {
   config.set("T", static_cast<int64_t>(T));
   config.setArray("n", n); //Array1d
   config.setArray("sumPx", sumPx); //Array2d
-  config.setArray("sumPxx", sumPxx); //Array2d
+  // first order only statistics are stored without the sumPxx dataset
+  if(m_second_order)
+    config.setArray("sumPxx", sumPxx); //Array2d
 }
 
 void bob::learn::em::GMMStats::load(bob::io::base::HDF5File& config) {
-  log_likelihood = config.read<double>("log_liklihood");
   int64_t n_gaussians = config.read<int64_t>("n_gaussians");
   int64_t n_inputs = config.read<int64_t>("n_inputs");
-  T = static_cast<size_t>(config.read<int64_t>("T"));
 
   //resize arrays to prepare for HDF5 readout
-  n.resize(n_gaussians);
-  sumPx.resize(n_gaussians, n_inputs);
-  sumPxx.resize(n_gaussians, n_inputs);
+  resize(n_gaussians, n_inputs, config.contains("sumPxx"));
+  T = static_cast<size_t>(config.read<int64_t>("T"));
+  log_likelihood = config.read<double>("log_liklihood");
 
   //load data
   config.readArray("n", n);
   config.readArray("sumPx", sumPx);
-  config.readArray("sumPxx", sumPxx);
+  if(m_second_order)
+    config.readArray("sumPxx", sumPxx);
 }
 
 namespace bob { namespace learn { namespace em {
@@ -0,0 +1,150 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/GMMStatsAccumulator.h>
+#include <bob.io.base/HDF5File.h>
+#include <boost/format.hpp>
+#include <cstdio>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+
+namespace {
+  // FNV-1a hash of the values of an array
+  uint64_t hashValues(uint64_t hash, const blitz::Array<double,1>& values)
+  {
+    for (int i=0; i<values.extent(0); ++i) {
+      const double v = values(i);
+      unsigned char bytes[sizeof(double)];
+      std::memcpy(bytes, &v, sizeof(double));
+      for (size_t b=0; b<sizeof(double); ++b) {
+        hash ^= bytes[b];
+        hash *= 1099511628211ULL;
+      }
+    }
+    return hash;
+  }
+}
+
+bob::learn::em::GMMStatsAccumulator::GMMStatsAccumulator(
+  boost::shared_ptr<const bob::learn::em::GMMMachine> machine,
+  const std::string& checkpoint, const size_t checkpoint_interval,
+  const bool second_order):
+  m_machine(machine),
+  m_checkpoint(checkpoint),
+  m_cursor(0),
+  m_stats(machine->getNGaussians(), machine->getNInputs(), second_order)
+{
+  setCheckpointInterval(checkpoint_interval);
+}
+
+bob::learn::em::GMMStatsAccumulator::~GMMStatsAccumulator()
+{
+}
+
+void bob::learn::em::GMMStatsAccumulator::setCheckpointInterval(const size_t checkpoint_interval)
+{
+  if (checkpoint_interval == 0)
+    throw std::runtime_error("GMMStatsAccumulator: the checkpoint interval must be greater than zero");
+  m_checkpoint_interval = checkpoint_interval;
+}
+
+size_t bob::learn::em::GMMStatsAccumulator::resume()
+{
+  if (!std::ifstream(m_checkpoint.c_str()).good())
+    return m_cursor;
+
+  bob::io::base::HDF5File file(m_checkpoint, bob::io::base::HDF5File::in);
+  if (!file.contains("machine_hash") ||
+      static_cast<uint64_t>(file.read<int64_t>("machine_hash")) != machineHash()) {
+    boost::format m("GMMStatsAccumulator: the checkpoint `%s' was not computed with the same GMM");
+    m % m_checkpoint;
+    throw std::runtime_error(m.str());
+  }
+  const size_t cursor = static_cast<size_t>(file.read<int64_t>("cursor"));
+  file.cd("stats");
+  bob::learn::em::GMMStats stats(file);
+  file.cd("..");
+
+  if (stats.sumPx.extent(0) != m_stats.sumPx.extent(0) ||
+      stats.sumPx.extent(1) != m_stats.sumPx.extent(1)) {
+    boost::format m("GMMStatsAccumulator: the checkpoint `%s' has statistics of shape (%d,%d), while the machine has shape (%d,%d)");
+    m % m_checkpoint % stats.sumPx.extent(0) % stats.sumPx.extent(1)
+      % m_stats.sumPx.extent(0) % m_stats.sumPx.extent(1);
+    throw std::runtime_error(m.str());
+  }
+  if (m_stats.hasSecondOrder() && !stats.hasSecondOrder()) {
+    boost::format m("GMMStatsAccumulator: the checkpoint `%s' does not contain second order statistics");
+    m % m_checkpoint;
+    throw std::runtime_error(m.str());
+  }
+
+  m_stats.T = stats.T;
+  m_stats.log_likelihood = stats.log_likelihood;
+  m_stats.n = stats.n;
+  m_stats.sumPx = stats.sumPx;
+  if (m_stats.hasSecondOrder())
+    m_stats.sumPxx = stats.sumPxx;
+  m_cursor = cursor;
+  return m_cursor;
+}
+
+void bob::learn::em::GMMStatsAccumulator::accumulate(const blitz::Array<double,2>& input)
+{
+  m_machine->accStatistics(input, m_stats);
+  next();
+}
+
+void bob::learn::em::GMMStatsAccumulator::skip()
+{
+  next();
+}
+
+void bob::learn::em::GMMStatsAccumulator::next()
+{
+  ++m_cursor;
+  if (m_cursor % m_checkpoint_interval == 0)
+    checkpoint();
+}
+
+void bob::learn::em::GMMStatsAccumulator::checkpoint() const
+{
+  const std::string tmp = m_checkpoint + ".tmp";
+  {
+    bob::io::base::HDF5File file(tmp, bob::io::base::HDF5File::trunc);
+    file.set("cursor", static_cast<int64_t>(m_cursor));
+    file.set("machine_hash", static_cast<int64_t>(machineHash()));
+    file.createGroup("stats");
+    file.cd("stats");
+    m_stats.save(file);
+    file.cd("..");
+  }
+  // rename() atomically replaces the previous checkpoint
+  if (std::rename(tmp.c_str(), m_checkpoint.c_str()) != 0) {
+    boost::format m("GMMStatsAccumulator: cannot write the checkpoint `%s': %s");
+    m % m_checkpoint % std::strerror(errno);
+    throw std::runtime_error(m.str());
+  }
+}
+
+uint64_t bob::learn::em::GMMStatsAccumulator::machineHash() const
+{
+  uint64_t hash = 14695981039346656037ULL;
+  blitz::Array<double,1> shape(2);
+  shape = m_machine->getNGaussians(), m_machine->getNInputs();
+  hash = hashValues(hash, shape);
+  hash = hashValues(hash, m_machine->getWeights());
+  hash = hashValues(hash, m_machine->getMeanSupervector());
+  hash = hashValues(hash, m_machine->getVarianceSupervector());
+  return hash;
+}
+
+void bob::learn::em::GMMStatsAccumulator::reset()
+{
+  m_stats.init();
+  m_cursor = 0;
+}
@@ -0,0 +1,475 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/GMMStatsArchive.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char archive_magic[8] = {'B','O','B','G','M','M','S','A'};
+const uint32_t archive_version = 1;
+
+/**
+ * The fixed-size header at the beginning of an archive
+ */
+struct ArchiveHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t second_order;
+  uint64_t n_gaussians;
+  uint64_t n_inputs;
+  char padding[bob::learn::em::GMMStatsArchiveLayout::header_size - 32];
+};
+
+// Offsets (in bytes) of the fields of a record
+const size_t offset_T = bob::learn::em::GMMStatsArchiveLayout::key_size;
+const size_t offset_log_likelihood = offset_T + sizeof(uint64_t);
+const size_t offset_n = offset_log_likelihood + sizeof(double);
+
+void writeHeader(std::ofstream& file, const bob::learn::em::GMMStatsArchiveLayout& layout)
+{
+  ArchiveHeader header;
+  std::memset(&header, 0, sizeof(ArchiveHeader));
+  std::memcpy(header.magic, archive_magic, sizeof(archive_magic));
+  header.version = archive_version;
+  header.second_order = layout.second_order ? 1 : 0;
+  header.n_gaussians = layout.n_gaussians;
+  header.n_inputs = layout.n_inputs;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(ArchiveHeader));
+}
+
+bob::learn::em::GMMStatsArchiveLayout readHeader(const char* data, const size_t length,
+    const std::string& filename)
+{
+  if (length < sizeof(ArchiveHeader)) {
+    boost::format m("GMMStatsArchive: `%s' is too short to be an archive");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+  ArchiveHeader header;
+  std::memcpy(&header, data, sizeof(ArchiveHeader));
+  if (std::memcmp(header.magic, archive_magic, sizeof(archive_magic)) != 0) {
+    boost::format m("GMMStatsArchive: `%s' is not a GMMStats archive");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+  if (header.version != archive_version) {
+    boost::format m("GMMStatsArchive: `%s' has an unsupported version (%u)");
+    m % filename % header.version;
+    throw std::runtime_error(m.str());
+  }
+  return bob::learn::em::GMMStatsArchiveLayout(header.n_gaussians,
+    header.n_inputs, header.second_order != 0);
+}
+
+/**
+ * Writes the first length bytes of the given stream (the header only if
+ * none) to a temporary file, which is then renamed to filename. Unlike a
+ * truncation of the file in place, this keeps the previous content for the
+ * readers which mapped it (an access beyond the new end of a mapped file
+ * fails with SIGBUS).
+ */
+void replaceFile(const std::string& filename,
+  const bob::learn::em::GMMStatsArchiveLayout& layout,
+  std::istream* source, size_t length)
+{
+  const std::string tmp = (boost::format("%s.tmp%d") % filename % ::getpid()).str();
+  {
+    std::ofstream file(tmp.c_str(), std::ios::binary | std::ios::out | std::ios::trunc);
+    if (source) {
+      std::vector<char> buffer(1 << 20);
+      while (length > 0 && file) {
+        const size_t n = std::min(length, buffer.size());
+        if (!source->read(&buffer[0], n)) break;
+        file.write(&buffer[0], n);
+        length -= n;
+      }
+    }
+    else
+      writeHeader(file, layout);
+    file.close();
+    if (!file || length > 0) {
+      std::remove(tmp.c_str());
+      boost::format m("GMMStatsArchiveWriter: cannot write `%s'");
+      m % tmp;
+      throw std::runtime_error(m.str());
+    }
+  }
+  if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+    const int error = errno;
+    std::remove(tmp.c_str());
+    boost::format m("GMMStatsArchiveWriter: cannot replace `%s': %s");
+    m % filename % std::strerror(error);
+    throw std::runtime_error(m.str());
+  }
+}
+
+} // anonymous namespace
+
+
+/************** GMMStatsArchiveLayout **************/
+
+bob::learn::em::GMMStatsArchiveLayout::GMMStatsArchiveLayout(
+  const size_t n_gaussians_, const size_t n_inputs_, const bool second_order_):
+  n_gaussians(n_gaussians_), n_inputs(n_inputs_), second_order(second_order_)
+{
+}
+
+size_t bob::learn::em::GMMStatsArchiveLayout::recordSize() const
+{
+  return offset_n + sizeof(double) *
+    (n_gaussians + (second_order ? 2 : 1) * n_gaussians * n_inputs);
+}
+
+
+/************** GMMStatsArchiveWriter **************/
+
+bob::learn::em::GMMStatsArchiveWriter::GMMStatsArchiveWriter(
+  const std::string& filename, const size_t n_gaussians,
+  const size_t n_inputs, const bool second_order):
+  m_filename(filename),
+  m_layout(n_gaussians, n_inputs, second_order),
+  m_buffer(m_layout.recordSize())
+{
+  // An existing archive is replaced rather than truncated, as it may be
+  // mapped by a reader
+  replaceFile(filename, m_layout, 0, 0);
+
+  m_file.open(filename.c_str(), std::ios::binary | std::ios::out | std::ios::app);
+  if (!m_file) {
+    boost::format m("GMMStatsArchiveWriter: cannot create `%s'");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+}
+
+bob::learn::em::GMMStatsArchiveWriter::GMMStatsArchiveWriter(
+  const std::string& filename):
+  m_filename(filename)
+{
+  size_t length;
+  {
+    // Reads the layout and the keys of the existing records
+    bob::learn::em::GMMStatsArchive archive(filename);
+    m_layout = archive.getLayout();
+    m_keys.insert(archive.getKeys().begin(), archive.getKeys().end());
+    length = GMMStatsArchiveLayout::header_size + archive.size() * m_layout.recordSize();
+  }
+  m_buffer.resize(m_layout.recordSize());
+
+  // Drops an incomplete record at the end of the file (e.g. after a crash),
+  // by replacing the file with its complete records
+  struct stat st;
+  if (::stat(filename.c_str(), &st) != 0) {
+    boost::format m("GMMStatsArchiveWriter: cannot stat `%s': %s");
+    m % filename % std::strerror(errno);
+    throw std::runtime_error(m.str());
+  }
+  if ((size_t)st.st_size != length) {
+    std::ifstream source(filename.c_str(), std::ios::binary | std::ios::in);
+    replaceFile(filename, m_layout, &source, length);
+  }
+
+  m_file.open(filename.c_str(), std::ios::binary | std::ios::out | std::ios::app);
+  if (!m_file) {
+    boost::format m("GMMStatsArchiveWriter: cannot open `%s' for appending");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+}
+
+bob::learn::em::GMMStatsArchiveWriter::~GMMStatsArchiveWriter()
+{
+  if (m_file.is_open()) m_file.close();
+}
+
+void bob::learn::em::GMMStatsArchiveWriter::append(const std::string& key,
+  const bob::learn::em::GMMStats& stats)
+{
+  if (!m_file.is_open())
+    throw std::runtime_error("GMMStatsArchiveWriter: the archive is closed");
+  if (key.empty() || key.size() > GMMStatsArchiveLayout::max_key_length) {
+    boost::format m("GMMStatsArchiveWriter: the length of the key `%s' must be in [1,%lu]");
+    m % key % GMMStatsArchiveLayout::max_key_length;
+    throw std::runtime_error(m.str());
+  }
+  if (m_keys.find(key) != m_keys.end()) {
+    boost::format m("GMMStatsArchiveWriter: the key `%s' is already in the archive");
+    m % key;
+    throw std::runtime_error(m.str());
+  }
+  if ((size_t)stats.sumPx.extent(0) != m_layout.n_gaussians ||
+      (size_t)stats.sumPx.extent(1) != m_layout.n_inputs) {
+    boost::format m("GMMStatsArchiveWriter: the statistics have shape (%d,%d), while the archive expects (%lu,%lu)");
+    m % stats.sumPx.extent(0) % stats.sumPx.extent(1) % m_layout.n_gaussians % m_layout.n_inputs;
+    throw std::runtime_error(m.str());
+  }
+  if (m_layout.second_order && !stats.hasSecondOrder())
+    throw std::runtime_error("GMMStatsArchiveWriter: cannot append first order only statistics to an archive with second order");
+
+  const int C = m_layout.n_gaussians;
+  const int D = m_layout.n_inputs;
+  char* record = &m_buffer[0];
+  std::memset(record, 0, offset_T);
+  record[0] = (char)key.size();
+  std::memcpy(record + 1, key.data(), key.size());
+  const uint64_t T = stats.T;
+  std::memcpy(record + offset_T, &T, sizeof(uint64_t));
+  std::memcpy(record + offset_log_likelihood, &stats.log_likelihood, sizeof(double));
+
+  double* data = reinterpret_cast<double*>(record + offset_n);
+  blitz::Array<double,1> n(data, blitz::shape(C), blitz::neverDeleteData);
+  n = stats.n;
+  blitz::Array<double,2> sumPx(data + C, blitz::shape(C,D), blitz::neverDeleteData);
+  sumPx = stats.sumPx;
+  if (m_layout.second_order) {
+    blitz::Array<double,2> sumPxx(data + C + C*D, blitz::shape(C,D), blitz::neverDeleteData);
+    sumPxx = stats.sumPxx;
+  }
+
+  m_file.write(record, m_buffer.size());
+  if (!m_file) {
+    boost::format m("GMMStatsArchiveWriter: cannot write to `%s'");
+    m % m_filename;
+    throw std::runtime_error(m.str());
+  }
+  m_keys.insert(key);
+}
+
+void bob::learn::em::GMMStatsArchiveWriter::flush()
+{
+  if (m_file.is_open()) m_file.flush();
+}
+
+void bob::learn::em::GMMStatsArchiveWriter::close()
+{
+  if (m_file.is_open()) m_file.close();
+}
+
+
+/************** GMMStatsArchive **************/
+
+bob::learn::em::GMMStatsArchive::GMMStatsArchive(const std::string& filename):
+  m_filename(filename), m_data(0), m_length(0)
+{
+  map();
+}
+
+bob::learn::em::GMMStatsArchive::~GMMStatsArchive()
+{
+  unmap();
+}
+
+void bob::learn::em::GMMStatsArchive::map()
+{
+  const int fd = ::open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    boost::format m("GMMStatsArchive: cannot open `%s': %s");
+    m % m_filename % std::strerror(errno);
+    throw std::runtime_error(m.str());
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    boost::format m("GMMStatsArchive: cannot stat `%s': %s");
+    m % m_filename % std::strerror(errno);
+    throw std::runtime_error(m.str());
+  }
+  m_length = st.st_size;
+  if (m_length > 0) {
+    void* data = ::mmap(0, m_length, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      m_length = 0;
+      boost::format m("GMMStatsArchive: cannot map `%s': %s");
+      m % m_filename % std::strerror(errno);
+      throw std::runtime_error(m.str());
+    }
+    m_data = static_cast<char*>(data);
+  }
+  // The mapping stays valid after the file descriptor is closed
+  ::close(fd);
+
+  try {
+    m_layout = readHeader(m_data, m_length, m_filename);
+  }
+  catch (...) {
+    unmap();
+    throw;
+  }
+
+  // An incomplete record at the end (being written) is ignored
+  const size_t record_size = m_layout.recordSize();
+  const size_t N = (m_length - GMMStatsArchiveLayout::header_size) / record_size;
+  m_keys.clear();
+  m_index.clear();
+  m_keys.reserve(N);
+  for (size_t i=0; i<N; ++i) {
+    const char* record = m_data + GMMStatsArchiveLayout::header_size + i * record_size;
+    m_keys.push_back(std::string(record + 1, (unsigned char)record[0]));
+    m_index[m_keys.back()] = i;
+  }
+}
+
+void bob::learn::em::GMMStatsArchive::unmap()
+{
+  if (m_data) ::munmap(m_data, m_length);
+  m_data = 0;
+  m_length = 0;
+}
+
+void bob::learn::em::GMMStatsArchive::refresh()
+{
+  unmap();
+  map();
+}
+
+const char* bob::learn::em::GMMStatsArchive::getRecord(const size_t i) const
+{
+  if (i >= m_keys.size()) {
+    boost::format m("GMMStatsArchive: cannot get the record with index %lu: out of bounds [0,%lu[");
+    m % i % m_keys.size();
+    throw std::runtime_error(m.str());
+  }
+  return m_data + GMMStatsArchiveLayout::header_size + i * m_layout.recordSize();
+}
+
+const std::string& bob::learn::em::GMMStatsArchive::getKey(const size_t i) const
+{
+  if (i >= m_keys.size()) {
+    boost::format m("GMMStatsArchive: cannot get the key with index %lu: out of bounds [0,%lu[");
+    m % i % m_keys.size();
+    throw std::runtime_error(m.str());
+  }
+  return m_keys[i];
+}
+
+size_t bob::learn::em::GMMStatsArchive::getIndex(const std::string& key) const
+{
+  std::map<std::string, size_t>::const_iterator it = m_index.find(key);
+  if (it == m_index.end()) {
+    boost::format m("GMMStatsArchive: there is no record with the key `%s'");
+    m % key;
+    throw std::runtime_error(m.str());
+  }
+  return it->second;
+}
+
+uint64_t bob::learn::em::GMMStatsArchive::getT(const size_t i) const
+{
+  uint64_t T;
+  std::memcpy(&T, getRecord(i) + offset_T, sizeof(uint64_t));
+  return T;
+}
+
+double bob::learn::em::GMMStatsArchive::getLogLikelihood(const size_t i) const
+{
+  double log_likelihood;
+  std::memcpy(&log_likelihood, getRecord(i) + offset_log_likelihood, sizeof(double));
+  return log_likelihood;
+}
+
+const blitz::Array<double,1> bob::learn::em::GMMStatsArchive::getN(const size_t i) const
+{
+  double* data = reinterpret_cast<double*>(const_cast<char*>(getRecord(i) + offset_n));
+  return blitz::Array<double,1>(data, blitz::shape(m_layout.n_gaussians), blitz::neverDeleteData);
+}
+
+const blitz::Array<double,2> bob::learn::em::GMMStatsArchive::getSumPx(const size_t i) const
+{
+  double* data = reinterpret_cast<double*>(const_cast<char*>(getRecord(i) + offset_n));
+  return blitz::Array<double,2>(data + m_layout.n_gaussians,
+    blitz::shape(m_layout.n_gaussians, m_layout.n_inputs), blitz::neverDeleteData);
+}
+
+const blitz::Array<double,2> bob::learn::em::GMMStatsArchive::getSumPxx(const size_t i) const
+{
+  if (!m_layout.second_order)
+    throw std::runtime_error("GMMStatsArchive: the archive does not contain second order statistics");
+  const size_t C = m_layout.n_gaussians;
+  const size_t D = m_layout.n_inputs;
+  double* data = reinterpret_cast<double*>(const_cast<char*>(getRecord(i) + offset_n));
+  return blitz::Array<double,2>(data + C + C*D, blitz::shape(C, D), blitz::neverDeleteData);
+}
+
+const blitz::Array<double,2> bob::learn::em::GMMStatsArchive::getN() const
+{
+  const int N = size();
+  const int C = m_layout.n_gaussians;
+  if (N == 0) return blitz::Array<double,2>(0, C);
+  double* data = reinterpret_cast<double*>(const_cast<char*>(getRecord(0) + offset_n));
+  const blitz::diffType stride = m_layout.recordSize() / sizeof(double);
+  return blitz::Array<double,2>(data, blitz::shape(N, C),
+    blitz::TinyVector<blitz::diffType,2>(stride, 1), blitz::neverDeleteData);
+}
+
+const blitz::Array<double,3> bob::learn::em::GMMStatsArchive::getSumPx() const
+{
+  const int N = size();
+  const int C = m_layout.n_gaussians;
+  const int D = m_layout.n_inputs;
+  if (N == 0) return blitz::Array<double,3>(0, C, D);
+  double* data = reinterpret_cast<double*>(const_cast<char*>(getRecord(0) + offset_n));
+  const blitz::diffType stride = m_layout.recordSize() / sizeof(double);
+  return blitz::Array<double,3>(data + C, blitz::shape(N, C, D),
+    blitz::TinyVector<blitz::diffType,3>(stride, D, 1), blitz::neverDeleteData);
+}
+
+const blitz::Array<double,3> bob::learn::em::GMMStatsArchive::getSumPxx() const
+{
+  if (!m_layout.second_order)
+    throw std::runtime_error("GMMStatsArchive: the archive does not contain second order statistics");
+  const int N = size();
+  const int C = m_layout.n_gaussians;
+  const int D = m_layout.n_inputs;
+  if (N == 0) return blitz::Array<double,3>(0, C, D);
+  double* data = reinterpret_cast<double*>(const_cast<char*>(getRecord(0) + offset_n));
+  const blitz::diffType stride = m_layout.recordSize() / sizeof(double);
+  return blitz::Array<double,3>(data + C + C*D, blitz::shape(N, C, D),
+    blitz::TinyVector<blitz::diffType,3>(stride, D, 1), blitz::neverDeleteData);
+}
+
+boost::shared_ptr<bob::learn::em::GMMStats> bob::learn::em::GMMStatsArchive::getStats(const size_t i) const
+{
+  if (i >= size()) {
+    boost::format m("GMMStatsArchive: cannot get the statistics with index %lu: out of bounds [0,%lu[");
+    m % i % size();
+    throw std::runtime_error(m.str());
+  }
+  boost::shared_ptr<bob::learn::em::GMMStats> stats(new bob::learn::em::GMMStats(
+    m_layout.n_gaussians, m_layout.n_inputs, m_layout.second_order));
+  stats->T = getT(i);
+  stats->log_likelihood = getLogLikelihood(i);
+  stats->n = getN(i);
+  stats->sumPx = getSumPx(i);
+  if (m_layout.second_order)
+    stats->sumPxx = getSumPxx(i);
+  return stats;
+}
+
+void bob::learn::em::GMMStatsArchive::getStatsSet(bob::learn::em::GMMStatsSet& output) const
+{
+  const size_t N = size();
+  output.resize(N, m_layout.n_gaussians, m_layout.n_inputs, m_layout.second_order);
+  if (N == 0) return;
+  for (size_t i=0; i<N; ++i) {
+    output.T(i) = getT(i);
+    output.log_likelihood(i) = getLogLikelihood(i);
+  }
+  output.n = getN();
+  output.sumPx = getSumPx();
+  if (m_layout.second_order)
+    output.sumPxx = getSumPxx();
+}
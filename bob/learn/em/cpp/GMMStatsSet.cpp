@@ -0,0 +1,234 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/GMMStatsSet.h>
+#include <bob.core/assert.h>
+#include <bob.core/check.h>
+#include <boost/format.hpp>
+
+bob::learn::em::GMMStatsSet::GMMStatsSet() {
+  resize(0,0,0);
+}
+
+bob::learn::em::GMMStatsSet::GMMStatsSet(const size_t n_samples,
+  const size_t n_gaussians, const size_t n_inputs, const bool second_order)
+{
+  resize(n_samples,n_gaussians,n_inputs,second_order);
+}
+
+bob::learn::em::GMMStatsSet::GMMStatsSet(const std::vector<bob::learn::em::GMMStats>& stats)
+{
+  std::vector<const bob::learn::em::GMMStats*> ptrs;
+  for (size_t i=0; i<stats.size(); ++i)
+    ptrs.push_back(&stats[i]);
+  pack(ptrs);
+}
+
+bob::learn::em::GMMStatsSet::GMMStatsSet(const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats)
+{
+  std::vector<const bob::learn::em::GMMStats*> ptrs;
+  for (size_t i=0; i<stats.size(); ++i)
+    ptrs.push_back(stats[i].get());
+  pack(ptrs);
+}
+
+bob::learn::em::GMMStatsSet::GMMStatsSet(bob::io::base::HDF5File& config) {
+  load(config);
+}
+
+bob::learn::em::GMMStatsSet::GMMStatsSet(const bob::learn::em::GMMStatsSet& other) {
+  copy(other);
+}
+
+bob::learn::em::GMMStatsSet::~GMMStatsSet() {
+}
+
+bob::learn::em::GMMStatsSet&
+bob::learn::em::GMMStatsSet::operator=(const bob::learn::em::GMMStatsSet& other) {
+  // protect against invalid self-assignment
+  if (this != &other)
+    copy(other);
+
+  // by convention, always return *this
+  return *this;
+}
+
+bool bob::learn::em::GMMStatsSet::operator==(const bob::learn::em::GMMStatsSet& b) const
+{
+  return (m_second_order == b.m_second_order &&
+          bob::core::array::isEqual(T, b.T) &&
+          bob::core::array::isEqual(log_likelihood, b.log_likelihood) &&
+          bob::core::array::isEqual(n, b.n) &&
+          bob::core::array::isEqual(sumPx, b.sumPx) &&
+          bob::core::array::isEqual(sumPxx, b.sumPxx));
+}
+
+bool
+bob::learn::em::GMMStatsSet::operator!=(const bob::learn::em::GMMStatsSet& b) const
+{
+  return !(this->operator==(b));
+}
+
+bool bob::learn::em::GMMStatsSet::is_similar_to(const bob::learn::em::GMMStatsSet& b,
+  const double r_epsilon, const double a_epsilon) const
+{
+  return (m_second_order == b.m_second_order &&
+          bob::core::array::isEqual(T, b.T) &&
+          bob::core::array::isClose(log_likelihood, b.log_likelihood, r_epsilon, a_epsilon) &&
+          bob::core::array::isClose(n, b.n, r_epsilon, a_epsilon) &&
+          bob::core::array::isClose(sumPx, b.sumPx, r_epsilon, a_epsilon) &&
+          bob::core::array::isClose(sumPxx, b.sumPxx, r_epsilon, a_epsilon));
+}
+
+void bob::learn::em::GMMStatsSet::copy(const GMMStatsSet& other) {
+  // Resize arrays
+  resize(other.sumPx.extent(0), other.sumPx.extent(1), other.sumPx.extent(2),
+    other.m_second_order);
+  // Copy content
+  T = other.T;
+  log_likelihood = other.log_likelihood;
+  n = other.n;
+  sumPx = other.sumPx;
+  if (m_second_order)
+    sumPxx = other.sumPxx;
+}
+
+void bob::learn::em::GMMStatsSet::pack(const std::vector<const bob::learn::em::GMMStats*>& stats)
+{
+  if (stats.size() == 0) {
+    resize(0,0,0);
+    return;
+  }
+
+  const size_t n_gaussians = stats[0]->sumPx.extent(0);
+  const size_t n_inputs = stats[0]->sumPx.extent(1);
+  bool second_order = true;
+  for (size_t i=0; i<stats.size(); ++i)
+    second_order = second_order && stats[i]->hasSecondOrder();
+
+  resize(stats.size(), n_gaussians, n_inputs, second_order);
+  for (size_t i=0; i<stats.size(); ++i)
+    setStats(i, *stats[i]);
+}
+
+void bob::learn::em::GMMStatsSet::resize(const size_t n_samples,
+  const size_t n_gaussians, const size_t n_inputs, const bool second_order)
+{
+  m_second_order = second_order;
+  log_likelihood.resize(n_samples);
+  T.resize(n_samples);
+  n.resize(n_samples, n_gaussians);
+  sumPx.resize(n_samples, n_gaussians, n_inputs);
+  if (m_second_order)
+    sumPxx.resize(n_samples, n_gaussians, n_inputs);
+  else
+    sumPxx.resize(0, 0, 0);
+  init();
+}
+
+void bob::learn::em::GMMStatsSet::init() {
+  log_likelihood = 0.;
+  T = 0;
+  n = 0.;
+  sumPx = 0.;
+  sumPxx = 0.;
+}
+
+boost::shared_ptr<bob::learn::em::GMMStats>
+bob::learn::em::GMMStatsSet::getStats(const size_t i) const
+{
+  if (i >= getNSamples()) {
+    boost::format m("cannot get the statistics with index %lu: out of bounds [0,%lu[");
+    m % i % getNSamples();
+    throw std::runtime_error(m.str());
+  }
+
+  blitz::Range rall = blitz::Range::all();
+  boost::shared_ptr<bob::learn::em::GMMStats> stats(new bob::learn::em::GMMStats(0, 0, m_second_order));
+  stats->T = static_cast<size_t>(T(i));
+  stats->log_likelihood = log_likelihood(i);
+  // The blitz arrays share (and reference count) the memory of this set
+  stats->n.reference(n(i, rall));
+  stats->sumPx.reference(sumPx(i, rall, rall));
+  if (m_second_order)
+    stats->sumPxx.reference(sumPxx(i, rall, rall));
+  return stats;
+}
+
+void bob::learn::em::GMMStatsSet::setStats(const size_t i,
+  const bob::learn::em::GMMStats& stats)
+{
+  if (i >= getNSamples()) {
+    boost::format m("cannot set the statistics with index %lu: out of bounds [0,%lu[");
+    m % i % getNSamples();
+    throw std::runtime_error(m.str());
+  }
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), sumPx.extent(1));
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), sumPx.extent(2));
+  if (m_second_order && !stats.hasSecondOrder())
+    throw std::runtime_error("GMMStatsSet: cannot set first order only statistics into a set with second order");
+
+  blitz::Range rall = blitz::Range::all();
+  T(i) = stats.T;
+  log_likelihood(i) = stats.log_likelihood;
+  n(i, rall) = stats.n;
+  sumPx(i, rall, rall) = stats.sumPx;
+  if (m_second_order)
+    sumPxx(i, rall, rall) = stats.sumPxx;
+}
+
+void bob::learn::em::GMMStatsSet::computeCenteredSumPx(
+  const blitz::Array<double,1>& mean_supervector, blitz::Array<double,2>& output,
+  const size_t start) const
+{
+  const int N = sumPx.extent(0);
+  const int C = sumPx.extent(1);
+  const int D = sumPx.extent(2);
+  bob::core::array::assertSameDimensionLength(mean_supervector.extent(0), C*D);
+  bob::core::array::assertSameDimensionLength(output.extent(1), C*D);
+  if (start + output.extent(0) > (size_t)N) {
+    boost::format m("cannot compute the centered statistics of samples [%lu,%lu[: out of bounds [0,%d[");
+    m % start % (start + output.extent(0)) % N;
+    throw std::runtime_error(m.str());
+  }
+
+  for (int j=0; j<output.extent(0); ++j)
+    for (int c=0; c<C; ++c) {
+      blitz::Range rc(c*D, (c+1)*D-1);
+      output(j, rc) = sumPx(start+j, c, blitz::Range::all()) - n(start+j, c) * mean_supervector(rc);
+    }
+}
+
+void bob::learn::em::GMMStatsSet::save(bob::io::base::HDF5File& config) const {
+  config.set("n_samples", static_cast<int64_t>(sumPx.extent(0)));
+  config.set("n_gaussians", static_cast<int64_t>(sumPx.extent(1)));
+  config.set("n_inputs", static_cast<int64_t>(sumPx.extent(2)));
+  config.setArray("log_likelihood", log_likelihood);
+  config.setArray("T", T);
+  config.setArray("n", n);
+  config.setArray("sumPx", sumPx);
+  // first order only statistics are stored without the sumPxx dataset
+  if (m_second_order)
+    config.setArray("sumPxx", sumPxx);
+}
+
+void bob::learn::em::GMMStatsSet::load(bob::io::base::HDF5File& config) {
+  int64_t n_samples = config.read<int64_t>("n_samples");
+  int64_t n_gaussians = config.read<int64_t>("n_gaussians");
+  int64_t n_inputs = config.read<int64_t>("n_inputs");
+
+  //resize arrays to prepare for HDF5 readout
+  resize(n_samples, n_gaussians, n_inputs, config.contains("sumPxx"));
+
+  //load data
+  config.readArray("log_likelihood", log_likelihood);
+  config.readArray("T", T);
+  config.readArray("n", n);
+  config.readArray("sumPx", sumPx);
+  if (m_second_order)
+    config.readArray("sumPxx", sumPxx);
+}
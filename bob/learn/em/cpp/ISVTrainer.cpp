@@ -8,6 +8,7 @@
  */
 
 #include <bob.learn.em/ISVTrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <bob.core/check.h>
 #include <bob.core/array_copy.h>
 #include <bob.core/array_random.h>
@@ -125,3 +126,15 @@ void bob::learn::em::ISVTrainer::enroll(bob::learn::em::ISVMachine& machine,
   const blitz::Array<double,1> z(m_base_trainer.getZ()[0]);
   machine.setZ(z);
 }
+
+void bob::learn::em::ISVTrainer::save(bob::io::base::HDF5File& config) const
+{
+  if (m_rng) saveRng(config, "rng", *m_rng);
+  m_base_trainer.save(config);
+}
+
+void bob::learn::em::ISVTrainer::load(bob::io::base::HDF5File& config)
+{
+  if (m_rng) loadRng(config, "rng", *m_rng);
+  m_base_trainer.load(config);
+}
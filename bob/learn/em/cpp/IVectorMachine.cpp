@@ -212,12 +212,18 @@ void bob::learn::em::IVectorMachine::forward(const bob::learn::em::GMMStats& gs,
 
 void bob::learn::em::IVectorMachine::computeIdTtSigmaInvT(
   const bob::learn::em::GMMStats& gs, blitz::Array<double,2>& output) const
+{
+  computeIdTtSigmaInvT(gs.n, output);
+}
+
+void bob::learn::em::IVectorMachine::computeIdTtSigmaInvT(
+  const blitz::Array<double,1>& n, blitz::Array<double,2>& output) const
 {
   // Computes \f$(Id + \sum_{c=1}^{C} N_{i,j,c} T^{T} \Sigma_{c}^{-1} T)\f$
   blitz::Range rall = blitz::Range::all();
   bob::math::eye(output);
   for (int c=0; c<(int)getNGaussians(); ++c)
-    output += gs.n(c) * m_cache_Tct_sigmacInv_Tc(c, rall, rall);
+    output += n(c) * m_cache_Tct_sigmacInv_Tc(c, rall, rall);
 }
 
 void bob::learn::em::IVectorMachine::computeTtSigmaInvFnorm(
@@ -236,6 +242,40 @@ void bob::learn::em::IVectorMachine::computeTtSigmaInvFnorm(
   }
 }
 
+void bob::learn::em::IVectorMachine::computeTtSigmaInvFnorm(
+  const bob::learn::em::CenteredGMMStats& gs, blitz::Array<double,1>& output) const
+{
+  // Computes \f$T^{T} \Sigma^{-1} \sum_{c=1}^{C} (F_c - N_c ubmmean_{c})\f$
+  blitz::Range rall = blitz::Range::all();
+  const blitz::Array<double,1>& Fnorm = gs.getCenteredSumPx();
+  const int D = getNInputs();
+  output = 0;
+  for (int c=0; c<(int)getNGaussians(); ++c)
+  {
+    blitz::Array<double,1> Fnorm_c = Fnorm(blitz::Range(c*D, (c+1)*D-1));
+    blitz::Array<double,2> Tct_sigmacInv = m_cache_Tct_sigmacInv(c, rall, rall);
+    bob::math::prod(Tct_sigmacInv, Fnorm_c, m_tmp_t2);
+
+    output += m_tmp_t2;
+  }
+}
+
+void bob::learn::em::IVectorMachine::forward(const bob::learn::em::CenteredGMMStats& gs,
+  blitz::Array<double,1>& ivector) const
+{
+  bob::core::array::assertSameDimensionLength(ivector.extent(0), (int)m_rt);
+  bob::core::array::assertSameDimensionLength(gs.getCenteredSumPx().extent(0), (int)getSupervectorLength());
+
+  // Computes \f$(Id + \sum_{c=1}^{C} N_{i,j,c} T^{T} \Sigma_{c}^{-1} T)\f$
+  computeIdTtSigmaInvT(gs.getN(), m_tmp_tt);
+
+  // Computes \f$T^{T} \Sigma^{-1} \sum_{c=1}^{C} (F_c - N_c ubmmean_{c})\f$
+  computeTtSigmaInvFnorm(gs, m_tmp_t1);
+
+  // Solves m_tmp_tt.ivector = m_tmp_t1
+  bob::math::linsolve(m_tmp_tt, ivector, m_tmp_t1);
+}
+
 void bob::learn::em::IVectorMachine::forward_(const bob::learn::em::GMMStats& gs,
   blitz::Array<double,1>& ivector) const
 {
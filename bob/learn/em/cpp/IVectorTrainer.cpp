@@ -7,6 +7,7 @@
 
 
 #include <bob.learn.em/IVectorTrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <bob.core/check.h>
 #include <bob.core/array_copy.h>
 #include <bob.core/array_random.h>
@@ -125,7 +126,11 @@ void bob::learn::em::IVectorTrainer::eStep(
     m_tmp_wij2 += m_tmp_tt2; // E{wij.wij^{T}}
 
     if (m_update_sigma)
+    {
+      if (!(*it).hasSecondOrder())
+        throw std::runtime_error("IVectorTrainer: updating sigma requires second order statistics");
       m_acc_Nij += (*it).n;
+    }
 
     for (int c=0; c<C; ++c)
     {
@@ -149,6 +154,109 @@ void bob::learn::em::IVectorTrainer::eStep(
   }
 }
 
+void bob::learn::em::IVectorTrainer::eStep(
+  bob::learn::em::IVectorMachine& machine,
+  const bob::learn::em::GMMStatsSet& data)
+{
+  blitz::Range rall = blitz::Range::all();
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  const int N = data.getNSamples();
+  const int C = machine.getNGaussians();
+  const int D = machine.getNInputs();
+  const int Rt = machine.getDimRt();
+  bob::core::array::assertSameDimensionLength(data.getNGaussians(), C);
+  bob::core::array::assertSameDimensionLength(data.getNInputs(), D);
+  if (m_update_sigma && !data.hasSecondOrder())
+    throw std::runtime_error("IVectorTrainer: updating sigma requires second order statistics");
+
+  // Reinitializes accumulators to 0
+  resetAccumulators(machine);
+
+  const blitz::Array<double,1>& ubm_mean = machine.getUbm()->getMeanSupervector();
+  blitz::Array<double,2> TSigmaInv(C*D, Rt);
+  TSigmaInv = machine.getT()(i,j) / machine.getSigma()(i);
+
+  // The samples are processed by tiles, such that the temporary arrays
+  // (tile_size x CD and tile_size x Rt^2) do not grow with N
+  const int tile_size = 32;
+  const int max_tile = std::min(tile_size, N);
+  blitz::Array<double,2> Fnorm_buffer(max_tile, C*D);
+  blitz::Array<double,2> TtSigmaInvFnorm_buffer(max_tile, Rt);
+  blitz::Array<double,2> W_buffer(max_tile, Rt);
+  blitz::Array<double,2> WW_buffer(max_tile, Rt*Rt);
+  blitz::Array<double,2> acc_Nij_wij2(C, Rt*Rt);
+  blitz::Array<double,2> acc_Fnormij_wij_c(D, Rt);
+  for (int start=0; start<N; start+=tile_size)
+  {
+    const int end = std::min(start + tile_size, N);
+    blitz::Range rt(0, end-start-1);
+    blitz::Array<double,2> Fnorm = Fnorm_buffer(rt, rall);
+    blitz::Array<double,2> TtSigmaInvFnorm = TtSigmaInvFnorm_buffer(rt, rall);
+    blitz::Array<double,2> W = W_buffer(rt, rall);
+    blitz::Array<double,2> WW = WW_buffer(rt, rall);
+
+    // a. Computes \f$F_{norm} = F - N ubmmean\f$ for the samples of the
+    //    tile (tile x CD)
+    data.computeCenteredSumPx(ubm_mean, Fnorm, start);
+
+    // b. Computes \f$T^{T} \Sigma^{-1} F_{norm}\f$ (tile x Rt)
+    bob::math::prod(Fnorm, TSigmaInv, TtSigmaInvFnorm);
+
+    // c. Computes E{wij} (tile x Rt) and E{wij.wij^{T}} (tile x Rt^2) for
+    //    each sample
+    for (int s=start; s<end; ++s)
+    {
+      // \f$(Id + T^{T} \Sigma^{-1} T)^{-1}\f$
+      machine.computeIdTtSigmaInvT(data.n(s,rall), m_tmp_tt1);
+      bob::math::inv(m_tmp_tt1, m_tmp_tt2);
+      // \f$E{wij} = (Id + T^{T} \Sigma^{-1} T)^{-1} T^{T} \Sigma^{-1} F_{norm}\f$
+      m_tmp_t1 = TtSigmaInvFnorm(s-start,rall);
+      bob::math::prod(m_tmp_tt2, m_tmp_t1, m_tmp_wij);
+      W(s-start,rall) = m_tmp_wij;
+      // \f$E{wij.wij^{T}} = (Id + T^{T} \Sigma^{-1} T)^{-1} + E{wij}.E{wij^{T}}\f$
+      bob::math::prod(m_tmp_wij, m_tmp_wij, m_tmp_wij2);
+      m_tmp_wij2 += m_tmp_tt2;
+      for (int r1=0; r1<Rt; ++r1)
+        for (int r2=0; r2<Rt; ++r2)
+          WW(s-start, r1*Rt+r2) = m_tmp_wij2(r1,r2);
+    }
+
+    // d. acc_Nij_wij2 += sum_{j} Nijc . E{wij.wij^{T}}, i.e. N^{T}.WW
+    //    (C x Rt^2)
+    const blitz::Array<double,2> Nt = data.n(blitz::Range(start, end-1), rall).transpose(1,0);
+    bob::math::prod(Nt, WW, acc_Nij_wij2);
+    for (int c=0; c<C; ++c)
+      for (int r1=0; r1<Rt; ++r1)
+        for (int r2=0; r2<Rt; ++r2)
+          m_acc_Nij_wij2(c,r1,r2) += acc_Nij_wij2(c, r1*Rt+r2);
+
+    // e. acc_Fnormij_wij += sum_{j} (Fijc - Nijc * ubmmean_{c}).E{wij}^{T},
+    //    i.e. Fnorm_{c}^{T}.W (D x Rt) for each Gaussian
+    for (int c=0; c<C; ++c)
+    {
+      blitz::Array<double,2> Fnorm_c = Fnorm(rall, blitz::Range(c*D,(c+1)*D-1));
+      blitz::Array<double,2> Fnorm_ct = Fnorm_c.transpose(1,0);
+      bob::math::prod(Fnorm_ct, W, acc_Fnormij_wij_c);
+      m_acc_Fnormij_wij(c,rall,rall) += acc_Fnormij_wij_c;
+    }
+
+    if (m_update_sigma)
+    {
+      for (int s=start; s<end; ++s)
+      {
+        m_acc_Nij += data.n(s,rall);
+        for (int c=0; c<C; ++c)
+        {
+          blitz::Range rc(c*D,(c+1)*D-1);
+          blitz::Array<double,1> acc_Snormij_c = m_acc_Snormij(c,rall);
+          acc_Snormij_c += data.sumPxx(s,c,rall) - ubm_mean(rc)*(data.sumPx(s,c,rall) + Fnorm(s-start,rc));
+        }
+      }
+    }
+  }
+}
+
 void bob::learn::em::IVectorTrainer::mStep(
   bob::learn::em::IVectorMachine& machine)
 {
@@ -233,3 +341,22 @@ bool bob::learn::em::IVectorTrainer::is_similar_to
          bob::core::array::isClose(m_acc_Nij, other.m_acc_Nij, r_epsilon, a_epsilon) &&
          bob::core::array::isClose(m_acc_Snormij, other.m_acc_Snormij, r_epsilon, a_epsilon);
 }
+
+void bob::learn::em::IVectorTrainer::save(bob::io::base::HDF5File& config) const
+{
+  if (m_rng) saveRng(config, "rng", *m_rng);
+  config.setArray("acc_Nij_wij2", m_acc_Nij_wij2);
+  config.setArray("acc_Fnormij_wij", m_acc_Fnormij_wij);
+  // Only allocated if sigma is updated
+  saveOptionalArray(config, "acc_Nij", m_acc_Nij);
+  saveOptionalArray(config, "acc_Snormij", m_acc_Snormij);
+}
+
+void bob::learn::em::IVectorTrainer::load(bob::io::base::HDF5File& config)
+{
+  if (m_rng) loadRng(config, "rng", *m_rng);
+  m_acc_Nij_wij2.reference(config.readArray<double,3>("acc_Nij_wij2"));
+  m_acc_Fnormij_wij.reference(config.readArray<double,3>("acc_Fnormij_wij"));
+  loadOptionalArray(config, "acc_Nij", m_acc_Nij);
+  loadOptionalArray(config, "acc_Snormij", m_acc_Snormij);
+}
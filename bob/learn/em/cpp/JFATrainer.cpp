@@ -8,6 +8,7 @@
  */
 
 #include <bob.learn.em/JFATrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <bob.core/check.h>
 #include <bob.core/array_copy.h>
 #include <bob.core/array_random.h>
@@ -197,3 +198,15 @@ void bob::learn::em::JFATrainer::enroll(bob::learn::em::JFAMachine& machine,
   machine.setY(y);
   machine.setZ(z);
 }
+
+void bob::learn::em::JFATrainer::save(bob::io::base::HDF5File& config) const
+{
+  if (m_rng) saveRng(config, "rng", *m_rng);
+  m_base_trainer.save(config);
+}
+
+void bob::learn::em::JFATrainer::load(bob::io::base::HDF5File& config)
+{
+  if (m_rng) loadRng(config, "rng", *m_rng);
+  m_base_trainer.load(config);
+}
@@ -0,0 +1,172 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/KDTree.h>
+#include <bob.core/assert.h>
+
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+  // Orders the indices of the points by one of their coordinates
+  struct CoordinateLess {
+    const blitz::Array<double,2>& points;
+    const int dim;
+    CoordinateLess(const blitz::Array<double,2>& p, const int d): points(p), dim(d) {}
+    bool operator()(const int i, const int j) const
+    { return points(i,dim) < points(j,dim); }
+  };
+
+  bool isFinite(const blitz::Array<double,2>& points, const int i)
+  {
+    for (int d=0; d<points.extent(1); ++d)
+      if (!(std::fabs(points(i,d)) <= std::numeric_limits<double>::max()))
+        return false;
+    return true;
+  }
+}
+
+bob::learn::em::KDTree::KDTree(const blitz::Array<double,2>& points,
+  const size_t leaf_size):
+  m_n_inputs(points.extent(1))
+{
+  if (leaf_size == 0)
+    throw std::runtime_error("KDTree: the leaf size must be greater than zero");
+
+  // The points which are not finite are left out, such that the bounding
+  // boxes and the medians are well defined
+  std::vector<int> order;
+  order.reserve(points.extent(0));
+  for (int i=0; i<points.extent(0); ++i)
+    if (isFinite(points, i))
+      order.push_back(i);
+  const int n_points = order.size();
+  if (n_points > 0)
+    build(order, points, 0, n_points, leaf_size);
+
+  // Copies the points in the order of the leaves, such that a leaf is
+  // searched in a contiguous block
+  m_ids = order;
+  m_points.resize(n_points * m_n_inputs);
+  for (int k=0; k<n_points; ++k)
+    for (size_t d=0; d<m_n_inputs; ++d)
+      m_points[k*m_n_inputs+d] = points(order[k],d);
+}
+
+int bob::learn::em::KDTree::build(std::vector<int>& order,
+  const blitz::Array<double,2>& points, const int start, const int end,
+  const size_t leaf_size)
+{
+  const int node = m_nodes.size();
+  Node n = {start, end, -1, -1};
+  m_nodes.push_back(n);
+
+  // Bounding box of the points of the node
+  m_lower.resize(m_nodes.size() * m_n_inputs);
+  m_upper.resize(m_nodes.size() * m_n_inputs);
+  double* lower = &m_lower[node*m_n_inputs];
+  double* upper = &m_upper[node*m_n_inputs];
+  for (size_t d=0; d<m_n_inputs; ++d)
+    lower[d] = upper[d] = points(order[start],d);
+  for (int k=start+1; k<end; ++k)
+    for (size_t d=0; d<m_n_inputs; ++d) {
+      lower[d] = std::min(lower[d], points(order[k],d));
+      upper[d] = std::max(upper[d], points(order[k],d));
+    }
+
+  // Splits along the dimension with the largest spread, unless the node is
+  // small enough (or all its points are the same)
+  int split = 0;
+  for (size_t d=1; d<m_n_inputs; ++d)
+    if (upper[d] - lower[d] > upper[split] - lower[split])
+      split = d;
+  if (end - start <= (int)leaf_size || !(upper[split] > lower[split]))
+    return node;
+
+  const int middle = start + (end - start) / 2;
+  std::nth_element(order.begin() + start, order.begin() + middle,
+    order.begin() + end, CoordinateLess(points, split));
+  // lower and upper may be invalidated by the children
+  const int left = build(order, points, start, middle, leaf_size);
+  const int right = build(order, points, middle, end, leaf_size);
+  m_nodes[node].left = left;
+  m_nodes[node].right = right;
+  return node;
+}
+
+double bob::learn::em::KDTree::boxDistance(const int node, const double* x) const
+{
+  const double* lower = &m_lower[node*m_n_inputs];
+  const double* upper = &m_upper[node*m_n_inputs];
+  double distance = 0.;
+  for (size_t d=0; d<m_n_inputs; ++d) {
+    const double diff = x[d] < lower[d] ? lower[d] - x[d] :
+                        x[d] > upper[d] ? x[d] - upper[d] : 0.;
+    distance += diff * diff;
+  }
+  return distance;
+}
+
+void bob::learn::em::KDTree::search(const int node, const double* x,
+  int& best, double& best_distance, size_t& n_distances) const
+{
+  const Node& n = m_nodes[node];
+  if (n.left < 0) {
+    n_distances += n.end - n.start;
+    for (int k=n.start; k<n.end; ++k) {
+      // Same sum, in the same order, as KMeansMachine::getDistanceFromMean()
+      const double* p = &m_points[k*m_n_inputs];
+      double distance = 0.;
+      for (size_t d=0; d<m_n_inputs; ++d)
+        distance += (p[d] - x[d]) * (p[d] - x[d]);
+      // Ties go to the smallest index, as with an exhaustive search
+      if (distance < best_distance ||
+          (distance == best_distance && best >= 0 && m_ids[k] < best)) {
+        best = m_ids[k];
+        best_distance = distance;
+      }
+    }
+    return;
+  }
+
+  // Visits the closest child first; a child at the same distance as the
+  // best point may still contain a point with a smaller index
+  double d_left = boxDistance(n.left, x);
+  double d_right = boxDistance(n.right, x);
+  int first = n.left, second = n.right;
+  if (d_right < d_left) {
+    std::swap(first, second);
+    std::swap(d_left, d_right);
+  }
+  if (d_left <= best_distance)
+    search(first, x, best, best_distance, n_distances);
+  if (d_right <= best_distance)
+    search(second, x, best, best_distance, n_distances);
+}
+
+size_t bob::learn::em::KDTree::getNearest(const double* x, size_t& index,
+  double& distance) const
+{
+  int best = -1;
+  size_t n_distances = 0;
+  distance = std::numeric_limits<double>::max();
+  if (!m_nodes.empty())
+    search(0, x, best, distance, n_distances);
+  index = best < 0 ? 0 : best;
+  return n_distances;
+}
+
+size_t bob::learn::em::KDTree::getNearest(const blitz::Array<double,1>& x,
+  size_t& index, double& distance) const
+{
+  bob::core::array::assertSameDimensionLength(x.extent(0), m_n_inputs);
+  std::vector<double> query(x.begin(), x.end());
+  return getNearest(&query[0], index, distance);
+}
@@ -11,7 +11,10 @@
 #include <bob.core/assert.h>
 #include <bob.core/check.h>
 #include <bob.core/array_copy.h>
+#include <cblas.h>
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 bob::learn::em::KMeansMachine::KMeansMachine():
   m_n_means(0), m_n_inputs(0), m_means(0,0),
@@ -32,12 +35,14 @@ bob::learn::em::KMeansMachine::KMeansMachine(const blitz::Array<double,2>& means
   m_means(bob::core::array::ccopy(means)),
   m_cache_means(means.shape())
 {
+  updateIndex();
 }
 
 bob::learn::em::KMeansMachine::KMeansMachine(const bob::learn::em::KMeansMachine& other):
   m_n_means(other.m_n_means), m_n_inputs(other.m_n_inputs),
   m_means(bob::core::array::ccopy(other.m_means)),
-  m_cache_means(other.m_cache_means.shape())
+  m_cache_means(other.m_cache_means.shape()),
+  m_index(other.m_index)
 {
 }
 
@@ -57,6 +62,7 @@ bob::learn::em::KMeansMachine& bob::learn::em::KMeansMachine::operator=
     m_n_inputs = other.m_n_inputs;
     m_means.reference(bob::core::array::ccopy(other.m_means));
     m_cache_means.resize(other.m_means.shape());
+    m_index = other.m_index;
   }
   return *this;
 }
@@ -86,6 +92,7 @@ void bob::learn::em::KMeansMachine::load(bob::io::base::HDF5File& config)
   m_n_means = m_means.extent(0);
   m_n_inputs = m_means.extent(1);
   m_cache_means.resize(m_n_means, m_n_inputs);
+  updateIndex();
 }
 
 void bob::learn::em::KMeansMachine::save(bob::io::base::HDF5File& config) const
@@ -97,6 +104,7 @@ void bob::learn::em::KMeansMachine::setMeans(const blitz::Array<double,2> &means
 {
   bob::core::array::assertSameShape(means, m_means);
   m_means = means;
+  updateIndex();
 }
 
 void bob::learn::em::KMeansMachine::setMean(const size_t i, const blitz::Array<double,1> &mean)
@@ -108,6 +116,7 @@ void bob::learn::em::KMeansMachine::setMean(const size_t i, const blitz::Array<d
   }
   bob::core::array::assertSameDimensionLength(mean.extent(0), m_means.extent(1));
   m_means(i,blitz::Range::all()) = mean;
+  m_index.reset();
 }
 
 const blitz::Array<double,1> bob::learn::em::KMeansMachine::getMean(const size_t i) const
@@ -122,6 +131,23 @@ const blitz::Array<double,1> bob::learn::em::KMeansMachine::getMean(const size_t
 
 }
 
+void bob::learn::em::KMeansMachine::updateIndex()
+{
+  // The tree search only pays off for many means of a low dimensionality,
+  // as it prunes fewer means as the dimensionality grows
+  const size_t max_inputs = 16;
+  const size_t min_means = std::max<size_t>(64, size_t(1) << (m_n_inputs / 2));
+  if (m_n_inputs <= max_inputs && m_n_means >= min_means)
+    buildIndex();
+  else
+    m_index.reset();
+}
+
+void bob::learn::em::KMeansMachine::buildIndex()
+{
+  m_index.reset(new bob::learn::em::KDTree(m_means));
+}
+
 double bob::learn::em::KMeansMachine::getDistanceFromMean(const blitz::Array<double,1> &x,
   const size_t i) const
 {
@@ -131,6 +157,11 @@ double bob::learn::em::KMeansMachine::getDistanceFromMean(const blitz::Array<dou
 void bob::learn::em::KMeansMachine::getClosestMean(const blitz::Array<double,1> &x,
   size_t &closest_mean, double &min_distance) const
 {
+  if (m_index) {
+    m_index->getNearest(x, closest_mean, min_distance);
+    return;
+  }
+
   min_distance = std::numeric_limits<double>::max();
 
   for(size_t i=0; i<m_n_means; ++i) {
@@ -150,6 +181,109 @@ double bob::learn::em::KMeansMachine::getMinDistance(const blitz::Array<double,1
   return min_distance;
 }
 
+size_t bob::learn::em::KMeansMachine::getClosestMeans(const blitz::Array<double,2>& data,
+  blitz::Array<int,1>& closest_means, blitz::Array<double,1>& min_distances) const
+{
+  // check arguments
+  bob::core::array::assertSameDimensionLength(data.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(closest_means.extent(0), data.extent(0));
+  bob::core::array::assertSameDimensionLength(min_distances.extent(0), data.extent(0));
+
+  const int n_samples = data.extent(0);
+  const int n_means = m_n_means;
+  blitz::Range a = blitz::Range::all();
+
+  if (m_index) {
+    size_t n_distances = 0;
+    std::vector<double> x(m_n_inputs);
+    for (int i=0; i<n_samples; ++i) {
+      for (size_t d=0; d<m_n_inputs; ++d)
+        x[d] = data(i,d);
+      size_t closest_mean;
+      n_distances += m_index->getNearest(&x[0], closest_mean, min_distances(i));
+      closest_means(i) = closest_mean;
+    }
+    return n_distances;
+  }
+
+  // The products of a tile with the means fit in the cache
+  const int tile_size = 256;
+  // Relative rounding error of the scores, with respect to the squared
+  // norms of the sample and of the means (far above the one of a product of
+  // a few thousand dimensions)
+  static const double tolerance = 1e-10;
+
+  blitz::Array<double,1> mean_norms(n_means);
+  double max_mean_norm = 0.;
+  for (int j=0; j<n_means; ++j) {
+    mean_norms(j) = blitz::sum(blitz::pow2(m_means(j,a)));
+    if (mean_norms(j) > max_mean_norm) max_mean_norm = mean_norms(j);
+  }
+  // The means are stored by row, as BLAS expects them
+  const blitz::Array<double,2> means = bob::core::array::ccopy(m_means);
+  // The samples are read in place if their rows are contiguous, and copied
+  // by tiles otherwise
+  const bool in_place = data.stride(1) == 1 && data.stride(0) >= (int)m_n_inputs;
+  blitz::Array<double,2> tile_copy;
+  if (!in_place) tile_copy.resize(std::min(tile_size, n_samples), m_n_inputs);
+
+  blitz::Array<double,2> products(std::min(tile_size, n_samples), n_means);
+  for (int start=0; start<n_samples; start+=tile_size) {
+    const int end = std::min(start + tile_size, n_samples);
+    const double* tile;
+    int tile_stride;
+    if (in_place) {
+      tile = data.data() + start * data.stride(0);
+      tile_stride = data.stride(0);
+    }
+    else {
+      tile_copy(blitz::Range(0, end-start-1), a) = data(blitz::Range(start, end-1), a);
+      tile = tile_copy.data();
+      tile_stride = m_n_inputs;
+    }
+    // products = tile * means^T
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans, end-start, n_means,
+      m_n_inputs, 1., tile, tile_stride, means.data(), m_n_inputs, 0.,
+      products.data(), n_means);
+    const blitz::Array<double,2> tile_products = products(blitz::Range(0, end-start-1), a);
+
+    for (int i=start; i<end; ++i) {
+      const blitz::Array<double,1> x = data(i,a);
+      double min_score = std::numeric_limits<double>::max();
+      for (int j=0; j<n_means; ++j) {
+        const double score = mean_norms(j) - 2. * tile_products(i-start, j);
+        if (score < min_score) min_score = score;
+      }
+
+      // The scores are rounded differently than the distances: the means
+      // whose score is close to the best one are ranked by their distance,
+      // as in getClosestMean() (the first of the closest means)
+      const double margin = tolerance * (blitz::sum(blitz::pow2(x)) + max_mean_norm);
+      int closest_mean = 0;
+      double min_distance = std::numeric_limits<double>::max();
+      for (int j=0; j<n_means; ++j) {
+        if (!(mean_norms(j) - 2. * tile_products(i-start, j) <= min_score + margin))
+          continue;
+        const double distance = getDistanceFromMean(x, j);
+        if (distance < min_distance) {
+          min_distance = distance;
+          closest_mean = j;
+        }
+      }
+      closest_means(i) = closest_mean;
+      min_distances(i) = min_distance;
+    }
+  }
+  return static_cast<size_t>(n_samples) * n_means;
+}
+
+void bob::learn::em::KMeansMachine::getMinDistance(const blitz::Array<double,2>& data,
+  blitz::Array<double,1>& min_distances) const
+{
+  blitz::Array<int,1> closest_means(data.extent(0));
+  getClosestMeans(data, closest_means, min_distances);
+}
+
 void bob::learn::em::KMeansMachine::getVariancesAndWeightsForEachClusterInit(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
 {
   // check arguments
@@ -172,40 +306,53 @@ void bob::learn::em::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(cons
   bob::core::array::assertSameShape(variances, m_means);
   bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
 
+  accumulateVariancesAndWeights(data, m_cache_means, variances, weights);
+}
+
+void bob::learn::em::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+{
+  // check arguments
+  bob::core::array::assertSameShape(variances, m_means);
+  bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
+
+  finalizeVariancesAndWeights(m_cache_means, variances, weights);
+}
+
+void bob::learn::em::KMeansMachine::accumulateVariancesAndWeights(const blitz::Array<double,2>& data,
+  blitz::Array<double,2>& sums, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+{
+  // find the closest means
+  blitz::Array<int,1> closest_means(data.extent(0));
+  blitz::Array<double,1> min_distances(data.extent(0));
+  getClosestMeans(data, closest_means, min_distances);
+
   // iterate over data
   blitz::Range a = blitz::Range::all();
   for(int i=0; i<data.extent(0); ++i) {
     // - get example
     blitz::Array<double,1> x(data(i,a));
-
-    // - find closest mean
-    size_t closest_mean = 0;
-    double min_distance = 0;
-    getClosestMean(x,closest_mean,min_distance);
+    const int closest_mean = closest_means(i);
 
     // - accumulate stats
-    m_cache_means(closest_mean, blitz::Range::all()) += x;
+    sums(closest_mean, blitz::Range::all()) += x;
     variances(closest_mean, blitz::Range::all()) += blitz::pow2(x);
     ++weights(closest_mean);
   }
 }
 
-void bob::learn::em::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
+void bob::learn::em::KMeansMachine::finalizeVariancesAndWeights(blitz::Array<double,2>& sums,
+  blitz::Array<double,2>& variances, blitz::Array<double,1>& weights)
 {
-  // check arguments
-  bob::core::array::assertSameShape(variances, m_means);
-  bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
-
   // calculate final variances and weights
   blitz::firstIndex idx1;
   blitz::secondIndex idx2;
 
   // find means
-  m_cache_means = m_cache_means(idx1,idx2) / weights(idx1);
+  sums = sums(idx1,idx2) / weights(idx1);
 
   // find variances
   variances = variances(idx1,idx2) / weights(idx1);
-  variances -= blitz::pow2(m_cache_means);
+  variances -= blitz::pow2(sums);
 
   // find weights
   weights = weights / blitz::sum(weights);
@@ -219,12 +366,19 @@ void bob::learn::em::KMeansMachine::setCacheMeans(const blitz::Array<double,2> &
 
 void bob::learn::em::KMeansMachine::getVariancesAndWeightsForEachCluster(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const
 {
-  // initialise
-  getVariancesAndWeightsForEachClusterInit(variances, weights);
+  // check arguments
+  bob::core::array::assertSameShape(variances, m_means);
+  bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
+
+  // initialise, with local sums such that the cache is left untouched
+  blitz::Array<double,2> sums(m_means.shape());
+  sums = 0;
+  variances = 0;
+  weights = 0;
   // accumulate
-  getVariancesAndWeightsForEachClusterAcc(data, variances, weights);
-  // merge/finalize
-  getVariancesAndWeightsForEachClusterFin(variances, weights);
+  accumulateVariancesAndWeights(data, sums, variances, weights);
+  // finalize
+  finalizeVariancesAndWeights(sums, variances, weights);
 }
 
 void bob::learn::em::KMeansMachine::forward(const blitz::Array<double,1>& input, double& output) const
@@ -248,6 +402,7 @@ void bob::learn::em::KMeansMachine::resize(const size_t n_means, const size_t n_
   m_n_inputs = n_inputs;
   m_means.resizeAndPreserve(n_means, n_inputs);
   m_cache_means.resizeAndPreserve(n_means, n_inputs);
+  updateIndex();
 }
 
 namespace bob { namespace learn { namespace em {
@@ -7,17 +7,32 @@
  */
 
 #include <bob.learn.em/KMeansTrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <bob.core/array_copy.h>
+#include <bob.core/check.h>
 
 #include <boost/random.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
 #include <bob.core/random.h>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <limits>
 
 
 bob::learn::em::KMeansTrainer::KMeansTrainer(InitializationMethod i_m):
 m_rng(new boost::mt19937()),
 m_average_min_distance(0),
 m_zeroethOrderStats(0),
-m_firstOrderStats(0)
+m_firstOrderStats(0),
+m_compute_variances(false),
+m_oversampling_factor(0.),
+m_n_parallel_rounds(5),
+m_n_threads(1),
+m_accelerated(false),
+m_n_distances(0)
 {
   m_initialization_method = i_m;
 }
@@ -30,6 +45,13 @@ bob::learn::em::KMeansTrainer::KMeansTrainer(const bob::learn::em::KMeansTrainer
   m_average_min_distance  = other.m_average_min_distance;
   m_zeroethOrderStats     = bob::core::array::ccopy(other.m_zeroethOrderStats);
   m_firstOrderStats       = bob::core::array::ccopy(other.m_firstOrderStats);
+  m_oversampling_factor   = other.m_oversampling_factor;
+  m_n_parallel_rounds     = other.m_n_parallel_rounds;
+  m_n_threads             = other.m_n_threads;
+  m_compute_variances     = other.m_compute_variances;
+  m_secondOrderStats.reference(bob::core::array::ccopy(other.m_secondOrderStats));
+  m_accelerated           = other.m_accelerated;
+  m_n_distances           = 0;
 }
 
 
@@ -44,6 +66,13 @@ bob::learn::em::KMeansTrainer& bob::learn::em::KMeansTrainer::operator=
 
     m_zeroethOrderStats = bob::core::array::ccopy(other.m_zeroethOrderStats);
     m_firstOrderStats   = bob::core::array::ccopy(other.m_firstOrderStats);
+    m_oversampling_factor = other.m_oversampling_factor;
+    m_n_parallel_rounds = other.m_n_parallel_rounds;
+    m_n_threads         = other.m_n_threads;
+    m_compute_variances = other.m_compute_variances;
+    m_secondOrderStats.reference(bob::core::array::ccopy(other.m_secondOrderStats));
+    m_accelerated       = other.m_accelerated;
+    clearBounds();
   }
   return *this;
 }
@@ -52,11 +81,16 @@ bob::learn::em::KMeansTrainer& bob::learn::em::KMeansTrainer::operator=
 bool bob::learn::em::KMeansTrainer::operator==(const bob::learn::em::KMeansTrainer& b) const {
   return
          m_initialization_method == b.m_initialization_method &&
+         m_oversampling_factor == b.m_oversampling_factor &&
+         m_n_parallel_rounds == b.m_n_parallel_rounds &&
          *m_rng == *(b.m_rng) && m_average_min_distance == b.m_average_min_distance &&
          bob::core::array::hasSameShape(m_zeroethOrderStats, b.m_zeroethOrderStats) &&
          bob::core::array::hasSameShape(m_firstOrderStats, b.m_firstOrderStats) &&
          blitz::all(m_zeroethOrderStats == b.m_zeroethOrderStats) &&
-         blitz::all(m_firstOrderStats == b.m_firstOrderStats);
+         blitz::all(m_firstOrderStats == b.m_firstOrderStats) &&
+         m_compute_variances == b.m_compute_variances &&
+         bob::core::array::hasSameShape(m_secondOrderStats, b.m_secondOrderStats) &&
+         blitz::all(m_secondOrderStats == b.m_secondOrderStats);
 }
 
 bool bob::learn::em::KMeansTrainer::operator!=(const bob::learn::em::KMeansTrainer& b) const {
@@ -66,6 +100,8 @@ bool bob::learn::em::KMeansTrainer::operator!=(const bob::learn::em::KMeansTrain
 void bob::learn::em::KMeansTrainer::initialize(bob::learn::em::KMeansMachine& kmeans,
   const blitz::Array<double,2>& ar)
 {
+  clearBounds();
+
   // split data into as many chunks as there are means
   size_t n_data = ar.extent(0);
 
@@ -124,6 +160,10 @@ void bob::learn::em::KMeansTrainer::initialize(bob::learn::em::KMeansMachine& km
       kmeans.setMean(i, mean);
     }
   }
+#if BOOST_VERSION >= 104700
+  else if(m_initialization_method == KMEANS_PARALLEL) // K-Means||
+    initializeParallel(kmeans, ar);
+#endif
   else // K-Means++
   {
     // 1.a. Selects one sample randomly
@@ -132,24 +172,19 @@ void bob::learn::em::KMeansTrainer::initialize(bob::learn::em::KMeansMachine& km
     blitz::Array<double,1> mean = ar(die(*m_rng),a);
     kmeans.setMean(0, mean);
 
+    // For each sample, the distance to the closest mean, which is only
+    // updated with the distance to the newest mean
+    blitz::Array<double,1> min_distances(n_data);
+    for(size_t s=0; s<n_data; ++s)
+      min_distances(s) = kmeans.getDistanceFromMean(ar(s,a), 0);
+
     // 1.b. Loops, computes probability distribution and select samples accordingly
     blitz::Array<double,1> weights(n_data);
     for(size_t m=1; m<kmeans.getNMeans(); ++m)
     {
-      // For each sample, puts the distance to the closest mean in the weight vector
-      for(size_t s=0; s<n_data; ++s)
-      {
-        blitz::Array<double,1> s_cur = ar(s,a);
-        double& w_cur = weights(s);
-        // Initializes with the distance to first mean
-        w_cur = kmeans.getDistanceFromMean(s_cur, 0);
-        // Loops over the remaining mean and update the mean distance if required
-        for(size_t i=1; i<m; ++i)
-          w_cur = std::min(w_cur, kmeans.getDistanceFromMean(s_cur, i));
-      }
       // Square and normalize the weights vectors such that
       // \f$weights[x] = D(x)^{2} \sum_{y} D(y)^{2}\f$
-      weights = blitz::pow2(weights);
+      weights = blitz::pow2(min_distances);
       weights /= blitz::sum(weights);
 
       // Takes a sample according to the weights distribution
@@ -158,33 +193,444 @@ void bob::learn::em::KMeansTrainer::initialize(bob::learn::em::KMeansMachine& km
       bob::core::random::discrete_distribution<> die2(weights.begin(), weights.end());
       blitz::Array<double,1> new_mean = ar(die2(*m_rng),a);
       kmeans.setMean(m, new_mean);
+
+      // Updates the distances with the new mean
+      if(m+1 < kmeans.getNMeans())
+        for(size_t s=0; s<n_data; ++s)
+          min_distances(s) = std::min(min_distances(s), kmeans.getDistanceFromMean(ar(s,a), m));
+    }
+  }
+
+  // setMean() cleared the index of the means
+  kmeans.updateIndex();
+}
+
+#if BOOST_VERSION >= 104700
+/**
+ * Weighted K-Means++ on the candidates of K-Means||: the means are drawn
+ * with a probability proportional to the weight of the candidates times
+ * their (square Euclidean) distance to the closest mean already drawn.
+ */
+static void weightedKMeansPlusPlus(bob::learn::em::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& candidates, const blitz::Array<double,1>& weights,
+  boost::mt19937& rng)
+{
+  const int n_candidates = candidates.extent(0);
+  blitz::Range a = blitz::Range::all();
+  blitz::Array<double,1> probabilities(n_candidates);
+  blitz::Array<double,1> min_distances(n_candidates);
+  min_distances = std::numeric_limits<double>::max();
+  probabilities = weights;
+
+  for(size_t m=0; m<kmeans.getNMeans(); ++m)
+  {
+    const double sum = blitz::sum(probabilities);
+    if(!(sum > 0.)) {
+      boost::format f("initialization failure: the K-Means|| candidates only give %u distinct means out of %u");
+      f % m % kmeans.getNMeans();
+      throw std::runtime_error(f.str());
+    }
+    probabilities /= sum;
+    bob::core::random::discrete_distribution<> die(probabilities.begin(), probabilities.end());
+    kmeans.setMean(m, candidates(die(rng),a));
+
+    for(int c=0; c<n_candidates; ++c) {
+      min_distances(c) = std::min(min_distances(c), kmeans.getDistanceFromMean(candidates(c,a), m));
+      probabilities(c) = weights(c) * min_distances(c);
     }
   }
 }
 
+void bob::learn::em::KMeansTrainer::initializeParallel(bob::learn::em::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& ar)
+{
+  const size_t n_data = ar.extent(0);
+  const size_t n_means = kmeans.getNMeans();
+  const double oversampling = m_oversampling_factor > 0. ? m_oversampling_factor : 2. * n_means;
+  blitz::Range a = blitz::Range::all();
+
+  // 1. Selects one sample randomly as the first candidate
+  boost::uniform_int<> die(0, n_data-1);
+  std::vector<int> candidates(1, die(*m_rng));
+  blitz::Array<double,1> min_distances(n_data);
+  {
+    bob::learn::em::KMeansMachine first(ar(blitz::Range(candidates[0], candidates[0]), a));
+    first.getMinDistance(ar, min_distances);
+  }
+
+  // 2. At each round, each sample becomes a candidate with a probability
+  // proportional to its (square Euclidean) distance to the closest
+  // candidate, such that oversampling candidates are expected
+  boost::uniform_real<> die01(0., 1.);
+  blitz::Array<double,1> new_distances(n_data);
+  for(size_t r=0; r<m_n_parallel_rounds; ++r)
+  {
+    const double cost = blitz::sum(min_distances);
+    if(!(cost > 0.)) break;
+
+    const size_t n_candidates = candidates.size();
+    for(size_t s=0; s<n_data; ++s)
+      if(die01(*m_rng) < oversampling * min_distances(s) / cost)
+        candidates.push_back(s);
+    if(candidates.size() == n_candidates) continue;
+
+    // Updates the distances with the candidates of this round only
+    blitz::Array<double,2> new_means(candidates.size() - n_candidates, ar.extent(1));
+    for(int i=0; i<new_means.extent(0); ++i)
+      new_means(i,a) = ar(candidates[n_candidates+i],a);
+    bob::learn::em::KMeansMachine round(new_means);
+    round.getMinDistance(ar, new_distances);
+    min_distances = blitz::min(min_distances, new_distances);
+  }
+
+  // 3. Weights each candidate by the number of samples closest to it
+  blitz::Array<double,2> candidate_means(candidates.size(), ar.extent(1));
+  for(int i=0; i<candidate_means.extent(0); ++i)
+    candidate_means(i,a) = ar(candidates[i],a);
+  bob::learn::em::KMeansMachine all(candidate_means);
+  blitz::Array<int,1> closest_means(n_data);
+  all.getClosestMeans(ar, closest_means, new_distances);
+  blitz::Array<double,1> weights(candidate_means.extent(0));
+  weights = 0.;
+  for(size_t s=0; s<n_data; ++s)
+    weights(closest_means(s)) += 1.;
+
+  // 4. Reduces the candidates to the means
+  weightedKMeansPlusPlus(kmeans, candidate_means, weights, *m_rng);
+}
+#endif
+
 void bob::learn::em::KMeansTrainer::eStep(bob::learn::em::KMeansMachine& kmeans,
   const blitz::Array<double,2>& ar)
 {
   // initialise the accumulators
   resetAccumulators(kmeans);
+  m_n_distances = 0;
+  if (m_accelerated)
+    accumulateBounded(kmeans, ar);
+  else
+    accumulate(kmeans, ar);
+  m_average_min_distance /= static_cast<double>(ar.extent(0));
+}
+
+void bob::learn::em::KMeansTrainer::eStep(bob::learn::em::KMeansMachine& kmeans,
+  bob::learn::em::DataSource& data)
+{
+  resetAccumulators(kmeans);
+  m_n_distances = 0;
+  clearBounds();
+  size_t n_samples = 0;
+  data.reset();
+  blitz::Array<double,2> chunk;
+  while (data.next(chunk)) {
+    if (chunk.extent(1) != static_cast<int>(kmeans.getNInputs()))
+      throw std::runtime_error("KMeansTrainer: the data does not have the dimensionality of the machine");
+    accumulate(kmeans, chunk);
+    n_samples += chunk.extent(0);
+  }
+  m_average_min_distance /= static_cast<double>(n_samples);
+}
+
+struct bob::learn::em::KMeansTrainer::Chunk
+{
+  Chunk(): kmeans(0), distance(0.), n_distances(0), valid(false),
+    max_drift_mean(0), max_drift(0.), second_max_drift(0.) {}
+
+  // The machine and the samples, and for the accelerated E-step, the
+  // bounds of the samples
+  const bob::learn::em::KMeansMachine* kmeans;
+  blitz::Array<double,2> data;
+  blitz::Array<int,1> assignment;
+  blitz::Array<double,1> lower_bound;
+
+  // The statistics accumulated on these samples
+  blitz::Array<double,1> zeroeth;
+  blitz::Array<double,2> first;
+  // Empty if the second order statistics are not computed
+  blitz::Array<double,2> second;
+  double distance;
+  size_t n_distances;
+
+  // Whether the bounds are valid, and the drifts of the means
+  bool valid;
+  int max_drift_mean;
+  double max_drift;
+  double second_max_drift;
+};
+
+namespace {
+
+/**
+ * Gives the rows [start, end[ of an array, in an array which does not share
+ * the reference count of the original one: the reference counts of blitz++
+ * are not atomic, and the views of the different threads would race on it
+ */
+template <typename T, int N>
+blitz::Array<T,N> rows(const blitz::Array<T,N>& array, const int start, const int end)
+{
+  blitz::TinyVector<int,N> shape = array.shape();
+  shape(0) = end - start;
+  return blitz::Array<T,N>(const_cast<T*>(array.data()) + start * array.stride(0),
+    shape, array.stride(), blitz::neverDeleteData);
+}
+
+template <typename Chunk>
+void runChunk(const boost::function<void (Chunk&)>& job, Chunk& chunk,
+  std::string& error)
+{
+  try {
+    job(chunk);
+  }
+  catch (std::exception& e) {
+    error = e.what();
+  }
+  catch (...) {
+    error = "unknown exception";
+  }
+}
+
+} // anonymous namespace
+
+void bob::learn::em::KMeansTrainer::accumulateChunks(bob::learn::em::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& ar, const Chunk& bounds, const bool bounded)
+{
+  const boost::function<void (Chunk&)> job = bounded ?
+    boost::function<void (Chunk&)>(boost::bind(&KMeansTrainer::accumulateBoundedChunk, this, _1)) :
+    boost::function<void (Chunk&)>(boost::bind(&KMeansTrainer::accumulateChunk, this, _1));
+
+  const int n_samples = ar.extent(0);
+  const int n_threads = std::min<int>(m_n_threads, n_samples);
+  if (n_threads <= 1) {
+    // Accumulates in place, as a single loop over the samples
+    Chunk chunk(bounds);
+    chunk.kmeans = &kmeans;
+    chunk.data.reference(ar);
+    if (bounded) {
+      chunk.assignment.reference(m_assignment);
+      chunk.lower_bound.reference(m_lower_bound);
+    }
+    chunk.zeroeth.reference(m_zeroethOrderStats);
+    chunk.first.reference(m_firstOrderStats);
+    chunk.second.reference(m_secondOrderStats);
+    chunk.distance = m_average_min_distance;
+    chunk.n_distances = m_n_distances;
+    job(chunk);
+    m_average_min_distance = chunk.distance;
+    m_n_distances = chunk.n_distances;
+    return;
+  }
+
+  // Each thread has its own contiguous samples, statistics, and copy of the
+  // machine
+  std::vector<Chunk> chunks(n_threads, bounds);
+  std::vector<boost::shared_ptr<bob::learn::em::KMeansMachine> > machines(n_threads);
+  std::vector<std::string> errors(n_threads);
+  for (int t=0; t<n_threads; ++t) {
+    const int start = t * n_samples / n_threads, end = (t+1) * n_samples / n_threads;
+    machines[t].reset(new bob::learn::em::KMeansMachine(kmeans));
+    chunks[t].kmeans = machines[t].get();
+    chunks[t].data.reference(rows(ar, start, end));
+    if (bounded) {
+      chunks[t].assignment.reference(rows(m_assignment, start, end));
+      chunks[t].lower_bound.reference(rows(m_lower_bound, start, end));
+    }
+    chunks[t].zeroeth.resize(m_zeroethOrderStats.shape());
+    chunks[t].zeroeth = 0.;
+    chunks[t].first.resize(m_firstOrderStats.shape());
+    chunks[t].first = 0.;
+    chunks[t].second.resize(m_secondOrderStats.shape());
+    chunks[t].second = 0.;
+  }
+
+  boost::thread_group threads;
+  for (int t=0; t<n_threads; ++t)
+    threads.create_thread(boost::bind(&runChunk<Chunk>, boost::cref(job),
+      boost::ref(chunks[t]), boost::ref(errors[t])));
+  threads.join_all();
+
+  for (int t=0; t<n_threads; ++t)
+    if (!errors[t].empty())
+      throw std::runtime_error("KMeansTrainer: " + errors[t]);
+
+  // The statistics are merged in the order of the samples, such that a
+  // given number of threads always gives the same result
+  for (int t=0; t<n_threads; ++t) {
+    m_zeroethOrderStats += chunks[t].zeroeth;
+    m_firstOrderStats += chunks[t].first;
+    if (m_compute_variances)
+      m_secondOrderStats += chunks[t].second;
+    m_average_min_distance += chunks[t].distance;
+    m_n_distances += chunks[t].n_distances;
+  }
+}
+
+void bob::learn::em::KMeansTrainer::accumulate(bob::learn::em::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& ar)
+{
+  accumulateChunks(kmeans, ar, Chunk(), false);
+}
+
+void bob::learn::em::KMeansTrainer::accumulateChunk(Chunk& chunk) const
+{
+  // find the closest means, and distances from these means
+  const blitz::Array<double,2>& ar = chunk.data;
+  blitz::Array<int,1> closest_means(ar.extent(0));
+  blitz::Array<double,1> min_distances(ar.extent(0));
+  chunk.n_distances += chunk.kmeans->getClosestMeans(ar, closest_means, min_distances);
 
   // iterate over data samples
   blitz::Range a = blitz::Range::all();
   for(int i=0; i<ar.extent(0); ++i) {
     // get example
     blitz::Array<double, 1> x(ar(i,a));
+    const int closest_mean = closest_means(i);
+    const double min_distance = min_distances(i);
+
+    // accumulate the stats
+    chunk.distance += min_distance;
+    ++chunk.zeroeth(closest_mean);
+    chunk.first(closest_mean,blitz::Range::all()) += x;
+    if (chunk.second.extent(0))
+      chunk.second(closest_mean,blitz::Range::all()) += blitz::pow2(x);
+  }
+}
+
+void bob::learn::em::KMeansTrainer::accumulateBounded(bob::learn::em::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& ar)
+{
+  blitz::Range a = blitz::Range::all();
+  const int n_samples = ar.extent(0);
+  const int n_means = kmeans.getNMeans();
+  const blitz::Array<double,2>& means = kmeans.getMeans();
+
+  // The bounds are those of the same data, unless clearBounds() was called
+  Chunk bounds;
+  bounds.valid = m_assignment.extent(0) == n_samples &&
+    bob::core::array::hasSameShape(m_bound_means, means);
+
+  // Drift of each mean since the previous E-step, and the two largest ones
+  if (bounds.valid) {
+    m_cache_drift.resize(n_means);
+    for (int j=0; j<n_means; ++j) {
+      m_cache_drift(j) = std::sqrt(blitz::sum(blitz::pow2(means(j,a) - m_bound_means(j,a))));
+      if (!(m_cache_drift(j) < std::numeric_limits<double>::infinity())) {
+        // A mean which is not finite (e.g., of an empty cluster) is never
+        // the closest one, but a mean which was not finite has no bound
+        if (blitz::sum(blitz::pow2(means(j,a))) < std::numeric_limits<double>::infinity())
+          bounds.valid = false;
+        continue;
+      }
+      if (m_cache_drift(j) > bounds.max_drift) {
+        bounds.second_max_drift = bounds.max_drift;
+        bounds.max_drift = m_cache_drift(j);
+        bounds.max_drift_mean = j;
+      }
+      else if (m_cache_drift(j) > bounds.second_max_drift)
+        bounds.second_max_drift = m_cache_drift(j);
+    }
+  }
+
+  if (bounds.valid) {
+    // Half the distance of each mean to the closest other one
+    m_cache_half_separation.resize(n_means);
+    m_cache_half_separation = std::numeric_limits<double>::max();
+    for (int j=0; j<n_means; ++j)
+      for (int k=j+1; k<n_means; ++k) {
+        const double d = std::sqrt(blitz::sum(blitz::pow2(means(j,a) - means(k,a)))) / 2.;
+        if (d < m_cache_half_separation(j)) m_cache_half_separation(j) = d;
+        if (d < m_cache_half_separation(k)) m_cache_half_separation(k) = d;
+      }
+    m_n_distances += n_means * (n_means - 1) / 2;
+  }
+  else {
+    m_assignment.resize(n_samples);
+    m_lower_bound.resize(n_samples);
+  }
+
+  accumulateChunks(kmeans, ar, bounds, true);
+
+  m_bound_means.resize(means.shape());
+  m_bound_means = means;
+}
+
+void bob::learn::em::KMeansTrainer::accumulateBoundedChunk(Chunk& chunk) const
+{
+  // Relative margin on the bounds, which absorbs the rounding errors of the
+  // square roots and of the updates: ties are always resolved by the
+  // exhaustive search
+  static const double tolerance = 1e-10;
 
-    // find closest mean, and distance from that mean
+  blitz::Range a = blitz::Range::all();
+  const int n_means = chunk.kmeans->getNMeans();
+  const blitz::Array<double,2>& data = chunk.data;
+  blitz::Array<int,1>& assignment = chunk.assignment;
+  blitz::Array<double,1>& lower_bound = chunk.lower_bound;
+
+  for (int i=0; i<data.extent(0); ++i) {
+    blitz::Array<double,1> x(data(i,a));
+
+    // The distance to the assigned mean is always required, for the
+    // average distance
     size_t closest_mean = 0;
-    double min_distance = 0;
-    kmeans.getClosestMean(x,closest_mean,min_distance);
+    double min_distance = 0.;
+    bool found = false;
+    if (chunk.valid) {
+      closest_mean = assignment(i);
+      // The other means got closer by at most the largest of their drifts
+      lower_bound(i) -= (int)closest_mean == chunk.max_drift_mean ? chunk.second_max_drift : chunk.max_drift;
+      min_distance = chunk.kmeans->getDistanceFromMean(x, closest_mean);
+      ++chunk.n_distances;
+      const double bound = std::max(lower_bound(i), m_cache_half_separation(closest_mean));
+      found = std::sqrt(min_distance) < (1. - tolerance) * bound;
+    }
+
+    if (!found) {
+      // Exhaustive search, as in KMeansMachine::getClosestMean(), which also
+      // gives the distance to the second closest mean
+      min_distance = std::numeric_limits<double>::max();
+      double second_distance = std::numeric_limits<double>::max();
+      for (int j=0; j<n_means; ++j) {
+        const double distance = chunk.kmeans->getDistanceFromMean(x, j);
+        if (distance < min_distance) {
+          second_distance = min_distance;
+          min_distance = distance;
+          closest_mean = j;
+        }
+        else if (distance < second_distance)
+          second_distance = distance;
+      }
+      chunk.n_distances += n_means;
+      assignment(i) = closest_mean;
+      lower_bound(i) = std::sqrt(second_distance);
+    }
 
     // accumulate the stats
-    m_average_min_distance += min_distance;
-    ++m_zeroethOrderStats(closest_mean);
-    m_firstOrderStats(closest_mean,blitz::Range::all()) += x;
+    chunk.distance += min_distance;
+    ++chunk.zeroeth(closest_mean);
+    chunk.first(closest_mean,a) += x;
+    if (chunk.second.extent(0))
+      chunk.second(closest_mean,a) += blitz::pow2(x);
   }
-  m_average_min_distance /= static_cast<double>(ar.extent(0));
+}
+
+void bob::learn::em::KMeansTrainer::clearBounds()
+{
+  m_bound_means.resize(0,0);
+  m_assignment.resize(0);
+  m_lower_bound.resize(0);
+}
+
+void bob::learn::em::KMeansTrainer::setNThreads(const size_t n_threads)
+{
+  if (n_threads == 0)
+    throw std::runtime_error("KMeansTrainer: the number of threads must be greater than zero");
+  m_n_threads = n_threads;
+}
+
+void bob::learn::em::KMeansTrainer::setAccelerated(const bool accelerated)
+{
+  m_accelerated = accelerated;
+  clearBounds();
 }
 
 void bob::learn::em::KMeansTrainer::mStep(bob::learn::em::KMeansMachine& kmeans)
@@ -195,6 +641,7 @@ void bob::learn::em::KMeansTrainer::mStep(bob::learn::em::KMeansMachine& kmeans)
     means(i,blitz::Range::all()) =
       m_firstOrderStats(i,blitz::Range::all()) / m_zeroethOrderStats(i);
   }
+  kmeans.updateIndex();
 }
 
 double bob::learn::em::KMeansTrainer::computeLikelihood(bob::learn::em::KMeansMachine& kmeans)
@@ -213,6 +660,29 @@ void bob::learn::em::KMeansTrainer::resetAccumulators(bob::learn::em::KMeansMach
   m_average_min_distance = 0;
   m_zeroethOrderStats = 0;
   m_firstOrderStats = 0;
+
+  if (m_compute_variances) {
+    m_secondOrderStats.resize(kmeans.getNMeans(), kmeans.getNInputs());
+    m_secondOrderStats = 0;
+  }
+  else
+    m_secondOrderStats.resize(0,0);
+}
+
+void bob::learn::em::KMeansTrainer::getVariancesAndWeightsForEachCluster(
+  const bob::learn::em::KMeansMachine& kmeans, blitz::Array<double,2>& variances,
+  blitz::Array<double,1>& weights) const
+{
+  if (!m_secondOrderStats.extent(0))
+    throw std::runtime_error("KMeansTrainer: the second order statistics were not accumulated by the last E-step (see setComputeVariances())");
+  bob::core::array::assertSameShape(m_secondOrderStats, kmeans.getMeans());
+  bob::core::array::assertSameShape(variances, kmeans.getMeans());
+  bob::core::array::assertSameDimensionLength(weights.extent(0), kmeans.getNMeans());
+
+  blitz::Array<double,2> sums = bob::core::array::ccopy(m_firstOrderStats);
+  variances = m_secondOrderStats;
+  weights = m_zeroethOrderStats;
+  bob::learn::em::KMeansMachine::finalizeVariancesAndWeights(sums, variances, weights);
 }
 
 void bob::learn::em::KMeansTrainer::setZeroethOrderStats(const blitz::Array<double,1>& zeroethOrderStats)
@@ -226,3 +696,22 @@ void bob::learn::em::KMeansTrainer::setFirstOrderStats(const blitz::Array<double
   bob::core::array::assertSameShape(m_firstOrderStats, firstOrderStats);
   m_firstOrderStats = firstOrderStats;
 }
+
+void bob::learn::em::KMeansTrainer::save(bob::io::base::HDF5File& config) const
+{
+  if (m_rng) saveRng(config, "rng", *m_rng);
+  config.set("average_min_distance", m_average_min_distance);
+  config.setArray("zeroeth_order_stats", m_zeroethOrderStats);
+  config.setArray("first_order_stats", m_firstOrderStats);
+  saveOptionalArray(config, "second_order_stats", m_secondOrderStats);
+}
+
+void bob::learn::em::KMeansTrainer::load(bob::io::base::HDF5File& config)
+{
+  clearBounds();
+  if (m_rng) loadRng(config, "rng", *m_rng);
+  m_average_min_distance = config.read<double>("average_min_distance");
+  m_zeroethOrderStats.reference(config.readArray<double,1>("zeroeth_order_stats"));
+  m_firstOrderStats.reference(config.readArray<double,2>("first_order_stats"));
+  loadOptionalArray(config, "second_order_stats", m_secondOrderStats);
+}
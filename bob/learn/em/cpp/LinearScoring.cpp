@@ -131,6 +131,155 @@ void bob::learn::em::linearScoring(const std::vector<boost::shared_ptr<const bob
   _linearScoring(models_b, ubm_mean, ubm_variance, test_stats, &test_channelOffset, frame_length_normalisation, scores);
 }
 
+void bob::learn::em::linearScoring(const std::vector<blitz::Array<double,1> >& models,
+                   const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                   const bob::learn::em::GMMStatsSet& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores)
+{
+  int CD = test_stats.getNGaussians() * test_stats.getNInputs();
+  int Tt = test_stats.getNSamples();
+  int Tm = models.size();
+
+  // Check output size
+  bob::core::array::assertSameDimensionLength(scores.extent(0), Tm);
+  bob::core::array::assertSameDimensionLength(scores.extent(1), Tt);
+
+  blitz::Array<double,2> A(Tm, CD);
+  blitz::Array<double,2> Bt(Tt, CD);
+
+  // 1) Compute A
+  for(int t=0; t<Tm; ++t) {
+    blitz::Array<double, 1> tmp = A(t, blitz::Range::all());
+    tmp = (models[t] - ubm_mean) / ubm_variance;
+  }
+
+  // 2) Compute B (transposed), directly from the contiguous statistics
+  test_stats.computeCenteredSumPx(ubm_mean, Bt);
+
+  // Apply the normalisation if needed
+  if(frame_length_normalisation) {
+    for(int t=0; t<Tt; ++t) {
+      double sum_N = test_stats.T(t);
+      blitz::Array<double, 1> v_t = Bt(t, blitz::Range::all());
+
+      if (sum_N <= std::numeric_limits<double>::epsilon() && sum_N >= -std::numeric_limits<double>::epsilon())
+        v_t = 0;
+      else
+        v_t /= sum_N;
+    }
+  }
+
+  // 3) Compute LLR
+  blitz::Array<double,2> B = Bt.transpose(1,0);
+  bob::math::prod(A, B, scores);
+}
+
+void bob::learn::em::linearScoring(const std::vector<boost::shared_ptr<const bob::learn::em::GMMMachine> >& models,
+                   const bob::learn::em::GMMMachine& ubm,
+                   const bob::learn::em::GMMStatsSet& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores)
+{
+  int CD = test_stats.getNGaussians() * test_stats.getNInputs();
+  std::vector<blitz::Array<double,1> > models_b;
+  // Allocate and get the mean supervector
+  for(size_t i=0; i<models.size(); ++i) {
+    blitz::Array<double,1> mod(CD);
+    mod = models[i]->getMeanSupervector();
+    models_b.push_back(mod);
+  }
+  const blitz::Array<double,1>& ubm_mean = ubm.getMeanSupervector();
+  const blitz::Array<double,1>& ubm_variance = ubm.getVarianceSupervector();
+  bob::learn::em::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, frame_length_normalisation, scores);
+}
+
+void bob::learn::em::linearScoring(const std::vector<blitz::Array<double,1> >& models,
+                   const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                   const std::vector<boost::shared_ptr<const bob::learn::em::CenteredGMMStats> >& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores)
+{
+  int CD = ubm_mean.extent(0);
+  int Tt = test_stats.size();
+  int Tm = models.size();
+
+  // Check output size
+  bob::core::array::assertSameDimensionLength(scores.extent(0), Tm);
+  bob::core::array::assertSameDimensionLength(scores.extent(1), Tt);
+
+  blitz::Array<double,2> A(Tm, CD);
+  blitz::Array<double,2> B(CD, Tt);
+
+  // 1) Compute A (the variance normalisation is moved to B)
+  for(int t=0; t<Tm; ++t) {
+    blitz::Array<double, 1> tmp = A(t, blitz::Range::all());
+    tmp = models[t] - ubm_mean;
+  }
+
+  // 2) Compute B, reusing the cached statistics
+  for(int t=0; t<Tt; ++t) {
+    bob::core::array::assertSameDimensionLength(test_stats[t]->getCenteredSumPx().extent(0), CD);
+    blitz::Array<double, 1> v_t = B(blitz::Range::all(),t);
+    if (test_stats[t]->hasWhitened())
+      v_t = test_stats[t]->getWhitenedSumPx();
+    else
+      v_t = test_stats[t]->getCenteredSumPx() / ubm_variance;
+
+    // Apply the normalisation if needed
+    if(frame_length_normalisation) {
+      double sum_N = test_stats[t]->getT();
+      if (sum_N <= std::numeric_limits<double>::epsilon() && sum_N >= -std::numeric_limits<double>::epsilon())
+        v_t = 0;
+      else
+        v_t /= sum_N;
+    }
+  }
+
+  // 3) Compute LLR
+  bob::math::prod(A, B, scores);
+}
+
+void bob::learn::em::linearScoring(const std::vector<boost::shared_ptr<const bob::learn::em::GMMMachine> >& models,
+                   const bob::learn::em::GMMMachine& ubm,
+                   const std::vector<boost::shared_ptr<const bob::learn::em::CenteredGMMStats> >& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores)
+{
+  int CD = ubm.getNGaussians() * ubm.getNInputs();
+  std::vector<blitz::Array<double,1> > models_b;
+  // Allocate and get the mean supervector
+  for(size_t i=0; i<models.size(); ++i) {
+    blitz::Array<double,1> mod(CD);
+    mod = models[i]->getMeanSupervector();
+    models_b.push_back(mod);
+  }
+  const blitz::Array<double,1>& ubm_mean = ubm.getMeanSupervector();
+  const blitz::Array<double,1>& ubm_variance = ubm.getVarianceSupervector();
+  bob::learn::em::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, frame_length_normalisation, scores);
+}
+
+double bob::learn::em::linearScoring(const blitz::Array<double,1>& model,
+                     const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                     const bob::learn::em::CenteredGMMStats& test_stats,
+                     const bool frame_length_normalisation)
+{
+  double score;
+  if (test_stats.hasWhitened())
+    score = blitz::sum((model - ubm_mean) * test_stats.getWhitenedSumPx());
+  else
+    score = blitz::sum((model - ubm_mean) / ubm_variance * test_stats.getCenteredSumPx());
+
+  // Apply the normalisation if needed
+  if (frame_length_normalisation) {
+    double sum_N = test_stats.getT();
+    if (sum_N == 0)
+      score = 0;
+    else
+      score /= sum_N;
+  }
+  return score;
+}
 
 
 double bob::learn::em::linearScoring(const blitz::Array<double,1>& models,
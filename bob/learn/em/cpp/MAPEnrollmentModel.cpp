@@ -0,0 +1,98 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/MAPEnrollmentModel.h>
+#include <bob.core/assert.h>
+#include <vector>
+
+bob::learn::em::MAPEnrollmentModel::MAPEnrollmentModel(
+  boost::shared_ptr<const bob::learn::em::MAP_GMMTrainer> trainer):
+  m_trainer(trainer),
+  m_n_sessions(0)
+{
+  reset();
+}
+
+bob::learn::em::MAPEnrollmentModel::MAPEnrollmentModel(
+  boost::shared_ptr<const bob::learn::em::MAP_GMMTrainer> trainer,
+  bob::io::base::HDF5File& config):
+  m_trainer(trainer),
+  m_n_sessions(0)
+{
+  reset();
+  load(config);
+}
+
+bob::learn::em::MAPEnrollmentModel::~MAPEnrollmentModel()
+{}
+
+void bob::learn::em::MAPEnrollmentModel::reset()
+{
+  if (!m_trainer || !m_trainer->getPriorGMM())
+    throw std::runtime_error("MAPEnrollmentModel: the prior GMM of the trainer has not been set");
+  const bob::learn::em::GMMMachine& prior = *m_trainer->getPriorGMM();
+  m_machine.reset(new bob::learn::em::GMMMachine(prior));
+  m_stats.resize(prior.getNGaussians(), prior.getNInputs());
+  m_n_sessions = 0;
+}
+
+void bob::learn::em::MAPEnrollmentModel::addSession(const bob::learn::em::GMMStats& stats)
+{
+  // The first session decides if the second order statistics are kept
+  if (m_n_sessions == 0) {
+    bob::core::array::assertSameShape(stats.sumPx, m_stats.sumPx);
+    m_stats = stats;
+  }
+  else
+    m_stats += stats;
+  ++m_n_sessions;
+  update();
+}
+
+void bob::learn::em::MAPEnrollmentModel::addSession(const blitz::Array<double,2>& features)
+{
+  bob::learn::em::GMMStats stats(m_stats.sumPx.extent(0), m_stats.sumPx.extent(1),
+    m_stats.hasSecondOrder());
+  m_trainer->getPriorGMM()->accStatistics(features, stats);
+  addSession(stats);
+}
+
+void bob::learn::em::MAPEnrollmentModel::update()
+{
+  if (m_n_sessions == 0) return;
+
+  // A single MAP update on the retained statistics
+  std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats(1,
+    boost::shared_ptr<const bob::learn::em::GMMStats>(new bob::learn::em::GMMStats(m_stats)));
+  blitz::Array<double,3> means, variances;
+  blitz::Array<double,2> weights;
+  m_trainer->enroll(stats, means, weights, variances);
+
+  const blitz::Range a = blitz::Range::all();
+  m_machine->setMeans(means(0,a,a));
+  if (weights.extent(0)) m_machine->setWeights(weights(0,a));
+  if (variances.extent(0)) m_machine->setVariances(variances(0,a,a));
+}
+
+void bob::learn::em::MAPEnrollmentModel::save(bob::io::base::HDF5File& config) const
+{
+  config.set("n_sessions", static_cast<int64_t>(m_n_sessions));
+  config.createGroup("stats");
+  config.cd("stats");
+  m_stats.save(config);
+  config.cd("..");
+}
+
+void bob::learn::em::MAPEnrollmentModel::load(bob::io::base::HDF5File& config)
+{
+  reset();
+  m_n_sessions = config.read<int64_t>("n_sessions");
+  config.cd("stats");
+  m_stats.load(config);
+  config.cd("..");
+  update();
+}
@@ -0,0 +1,104 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/MAPSupervectors.h>
+#include <bob.core/assert.h>
+
+namespace {
+
+/**
+ * Writes the supervector of one model, given its statistics n (C) and
+ * sumPx (C x D)
+ */
+template <typename T_n, typename T_sumPx>
+void adaptModel(const T_n& n, const T_sumPx& sumPx,
+  const blitz::Array<double,2>& ubm_means, const blitz::Array<double,2>& scale,
+  const double relevance_factor, const bob::learn::em::MAPSupervectorType type,
+  const double threshold, blitz::Array<double,1> output)
+{
+  const int C = ubm_means.extent(0);
+  const int D = ubm_means.extent(1);
+  const blitz::Range a = blitz::Range::all();
+  for (int c=0; c<C; ++c) {
+    blitz::Array<double,1> out(output(blitz::Range(c*D, (c+1)*D-1)));
+    // As in MAP_GMMTrainer::mStep(), the mean of a Gaussian with too small
+    // responsibilities is the prior one
+    if (n(c) < threshold) {
+      if (type == bob::learn::em::MAP_MEANS) out = ubm_means(c,a);
+      else out = 0.;
+      continue;
+    }
+    const double factor = 1. / (n(c) + relevance_factor);
+    switch (type) {
+      case bob::learn::em::MAP_MEANS:
+        out = (sumPx(c,a) + relevance_factor * ubm_means(c,a)) * factor;
+        break;
+      case bob::learn::em::MAP_OFFSETS:
+        out = (sumPx(c,a) - n(c) * ubm_means(c,a)) * factor;
+        break;
+      case bob::learn::em::MAP_NORMALIZED_OFFSETS:
+        out = (sumPx(c,a) - n(c) * ubm_means(c,a)) * (factor * scale(c,a));
+        break;
+    }
+  }
+}
+
+/**
+ * Prepares the output and the normalization of the UBM
+ */
+void prepare(const bob::learn::em::GMMMachine& ubm, const size_t n_models,
+  const double relevance_factor, blitz::Array<double,2>& output,
+  blitz::Array<double,2>& scale)
+{
+  if (relevance_factor <= 0.)
+    throw std::runtime_error("mapMeanSupervectors: the relevance factor must be positive");
+  const int C = ubm.getNGaussians();
+  const int D = ubm.getNInputs();
+  output.resize(n_models, C*D);
+
+  // sqrt(w_c) / sigma_c
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  scale.resize(C, D);
+  scale = blitz::sqrt(ubm.getWeights()(i) / ubm.getVariances()(i,j));
+}
+
+} // anonymous namespace
+
+
+void bob::learn::em::mapMeanSupervectors(const bob::learn::em::GMMMachine& ubm,
+  const blitz::Array<double,2>& n, const blitz::Array<double,3>& sumPx,
+  const double relevance_factor, blitz::Array<double,2>& output,
+  const bob::learn::em::MAPSupervectorType type, const double threshold)
+{
+  bob::core::array::assertSameDimensionLength(n.extent(0), sumPx.extent(0));
+  bob::core::array::assertSameDimensionLength(n.extent(1), ubm.getNGaussians());
+  bob::core::array::assertSameDimensionLength(sumPx.extent(1), ubm.getNGaussians());
+  bob::core::array::assertSameDimensionLength(sumPx.extent(2), ubm.getNInputs());
+
+  blitz::Array<double,2> scale;
+  prepare(ubm, n.extent(0), relevance_factor, output, scale);
+  const blitz::Array<double,2> ubm_means(ubm.getMeans());
+  const blitz::Range a = blitz::Range::all();
+  for (int k=0; k<n.extent(0); ++k)
+    adaptModel(n(k,a), sumPx(k,a,a), ubm_means, scale, relevance_factor, type, threshold, output(k,a));
+}
+
+void bob::learn::em::mapMeanSupervectors(const bob::learn::em::GMMMachine& ubm,
+  const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+  const double relevance_factor, blitz::Array<double,2>& output,
+  const bob::learn::em::MAPSupervectorType type, const double threshold)
+{
+  blitz::Array<double,2> scale;
+  prepare(ubm, stats.size(), relevance_factor, output, scale);
+  const blitz::Array<double,2> ubm_means(ubm.getMeans());
+  const blitz::Range a = blitz::Range::all();
+  for (size_t k=0; k<stats.size(); ++k) {
+    bob::core::array::assertSameShape(stats[k]->sumPx, ubm_means);
+    adaptModel(stats[k]->n, stats[k]->sumPx, ubm_means, scale, relevance_factor, type, threshold, output(k,a));
+  }
+}
@@ -7,6 +7,10 @@
 
 #include <bob.learn.em/MAP_GMMTrainer.h>
 #include <bob.core/check.h>
+#include <bob.core/assert.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 
 bob::learn::em::MAP_GMMTrainer::MAP_GMMTrainer(
    const bool update_means,
@@ -84,35 +88,50 @@ void bob::learn::em::MAP_GMMTrainer::mStep(bob::learn::em::GMMMachine& gmm)
   if (!m_prior_gmm)
     throw std::runtime_error("MAP_GMMTrainer: Prior GMM distribution has not been set");
 
+  blitz::Array<double,1> weights(gmm.getWeights().copy());
+  blitz::Array<double,2> means(gmm.getMeans());
+  blitz::Array<double,2> variances(gmm.getVariances());
+  adapt(*m_gmm_base_trainer.getGMMStats(), weights, means, variances, gmm.getVarianceThresholds());
+
+  if (m_gmm_base_trainer.getUpdateWeights())
+    gmm.setWeights(weights);
+  if (m_gmm_base_trainer.getUpdateMeans())
+    gmm.setMeans(means);
+  if (m_gmm_base_trainer.getUpdateVariances())
+    gmm.setVariances(variances);
+}
+
+
+void bob::learn::em::MAP_GMMTrainer::adapt(const bob::learn::em::GMMStats& stats,
+  blitz::Array<double,1>& weights, blitz::Array<double,2>& means,
+  blitz::Array<double,2>& variances,
+  const blitz::Array<double,2>& variance_thresholds) const
+{
+  const size_t n_gaussians = means.extent(0);
+  const double threshold = m_gmm_base_trainer.getMeanVarUpdateResponsibilitiesThreshold();
+  const blitz::Range a = blitz::Range::all();
+
   blitz::firstIndex i;
-  blitz::secondIndex j;
 
   // Calculate the "data-dependent adaptation coefficient", alpha_i
-  // TODO: check if required // m_cache_alpha.resize(n_gaussians);
+  blitz::Array<double,1> alpha(n_gaussians);
   if (!m_reynolds_adaptation)
-    m_cache_alpha = m_alpha;
+    alpha = m_alpha;
   else
-    m_cache_alpha = m_gmm_base_trainer.getGMMStats()->n(i) / (m_gmm_base_trainer.getGMMStats()->n(i) + m_relevance_factor);
+    alpha = stats.n(i) / (stats.n(i) + m_relevance_factor);
 
   // - Update weights if requested
   //   Equation 11 of Reynolds et al., "Speaker Verification Using Adapted Gaussian Mixture Models", Digital Signal Processing, 2000
   if (m_gmm_base_trainer.getUpdateWeights()) {
     // Calculate the maximum likelihood weights
-    m_cache_ml_weights = m_gmm_base_trainer.getGMMStats()->n / static_cast<double>(m_gmm_base_trainer.getGMMStats()->T); //cast req. for linux/32-bits & osx
-
-    // Get the prior weights
-    const blitz::Array<double,1>& prior_weights = m_prior_gmm->getWeights();
-    blitz::Array<double,1>& new_weights = gmm.updateWeights();
+    blitz::Array<double,1> ml_weights(stats.n / static_cast<double>(stats.T)); //cast req. for linux/32-bits & osx
 
     // Calculate the new weights
-    new_weights = m_cache_alpha * m_cache_ml_weights + (1-m_cache_alpha) * prior_weights;
+    weights = alpha * ml_weights + (1-alpha) * m_prior_gmm->getWeights();
 
     // Apply the scale factor, gamma, to ensure the new weights sum to unity
-    double gamma = blitz::sum(new_weights);
-    new_weights /= gamma;
-
-    // Recompute the log weights in the cache of the GMMMachine
-    gmm.recomputeLogWeights();
+    double gamma = blitz::sum(weights);
+    weights /= gamma;
   }
 
   // Update GMM parameters
@@ -120,15 +139,14 @@ void bob::learn::em::MAP_GMMTrainer::mStep(bob::learn::em::GMMMachine& gmm)
   //   Equation 12 of Reynolds et al., "Speaker Verification Using Adapted Gaussian Mixture Models", Digital Signal Processing, 2000
   if (m_gmm_base_trainer.getUpdateMeans()) {
     // Calculate new means
-    for (size_t i=0; i<n_gaussians; ++i) {
-      const blitz::Array<double,1>& prior_means = m_prior_gmm->getGaussian(i)->getMean();
-      blitz::Array<double,1>& means = gmm.getGaussian(i)->updateMean();
-      if (m_gmm_base_trainer.getGMMStats()->n(i) < m_gmm_base_trainer.getMeanVarUpdateResponsibilitiesThreshold()) {
-        means = prior_means;
+    for (size_t c=0; c<n_gaussians; ++c) {
+      const blitz::Array<double,1>& prior_means = m_prior_gmm->getGaussian(c)->getMean();
+      if (stats.n(c) < threshold) {
+        means(c,a) = prior_means;
       }
       else {
         // Use the maximum likelihood means
-        means = m_cache_alpha(i) * (m_gmm_base_trainer.getGMMStats()->sumPx(i,blitz::Range::all()) / m_gmm_base_trainer.getGMMStats()->n(i)) + (1-m_cache_alpha(i)) * prior_means;
+        means(c,a) = alpha(c) * (stats.sumPx(c,a) / stats.n(c)) + (1-alpha(c)) * prior_means;
       }
     }
   }
@@ -136,24 +154,208 @@ void bob::learn::em::MAP_GMMTrainer::mStep(bob::learn::em::GMMMachine& gmm)
   // - Update variance if requested
   //   Equation 13 of Reynolds et al., "Speaker Verification Using Adapted Gaussian Mixture Models", Digital Signal Processing, 2000
   if (m_gmm_base_trainer.getUpdateVariances()) {
+    if (!stats.hasSecondOrder())
+      throw std::runtime_error("MAP_GMMTrainer: updating the variances requires second order statistics");
     // Calculate new variances (equation 13)
-    for (size_t i=0; i<n_gaussians; ++i) {
-      const blitz::Array<double,1>& prior_means = m_prior_gmm->getGaussian(i)->getMean();
-      blitz::Array<double,1>& means = gmm.getGaussian(i)->updateMean();
-      const blitz::Array<double,1>& prior_variances = m_prior_gmm->getGaussian(i)->getVariance();
-      blitz::Array<double,1>& variances = gmm.getGaussian(i)->updateVariance();
-      if (m_gmm_base_trainer.getGMMStats()->n(i) < m_gmm_base_trainer.getMeanVarUpdateResponsibilitiesThreshold()) {
-        variances = (prior_variances + prior_means) - blitz::pow2(means);
+    for (size_t c=0; c<n_gaussians; ++c) {
+      const blitz::Array<double,1>& prior_means = m_prior_gmm->getGaussian(c)->getMean();
+      const blitz::Array<double,1>& prior_variances = m_prior_gmm->getGaussian(c)->getVariance();
+      if (stats.n(c) < threshold) {
+        variances(c,a) = (prior_variances + prior_means) - blitz::pow2(means(c,a));
       }
       else {
-        variances = m_cache_alpha(i) * m_gmm_base_trainer.getGMMStats()->sumPxx(i,blitz::Range::all()) / m_gmm_base_trainer.getGMMStats()->n(i) + (1-m_cache_alpha(i)) * (prior_variances + prior_means) - blitz::pow2(means);
+        variances(c,a) = alpha(c) * stats.sumPxx(c,a) / stats.n(c) + (1-alpha(c)) * (prior_variances + prior_means) - blitz::pow2(means(c,a));
       }
-      gmm.getGaussian(i)->applyVarianceThresholds();
+      // Variance flooring
+      variances(c,a) = blitz::where(variances(c,a) < variance_thresholds(c,a), variance_thresholds(c,a), variances(c,a));
     }
   }
 }
 
 
+void bob::learn::em::MAP_GMMTrainer::resizeBanks(const size_t n_models,
+  blitz::Array<double,3>& means, blitz::Array<double,2>& weights,
+  blitz::Array<double,3>& variances) const
+{
+  // Check that the prior GMM has been specified
+  if (!m_prior_gmm)
+    throw std::runtime_error("MAP_GMMTrainer: Prior GMM distribution has not been set");
+
+  const int C = m_prior_gmm->getNGaussians();
+  const int D = m_prior_gmm->getNInputs();
+  means.resize(n_models, C, D);
+  weights.resize(m_gmm_base_trainer.getUpdateWeights() ? n_models : 0, C);
+  variances.resize(m_gmm_base_trainer.getUpdateVariances() ? n_models : 0, C, D);
+}
+
+
+namespace {
+
+void runChunk(const boost::function<void (size_t, size_t)>& chunk,
+  const size_t start, const size_t end, std::string& error)
+{
+  try {
+    chunk(start, end);
+  }
+  catch (std::exception& e) {
+    error = e.what();
+  }
+  catch (...) {
+    error = "unknown exception";
+  }
+}
+
+/**
+ * Runs chunk(start, end) on n_threads contiguous chunks of [0, N[
+ */
+void runChunks(const size_t N, size_t n_threads,
+  const boost::function<void (size_t, size_t)>& chunk)
+{
+  if (n_threads == 0)
+    throw std::runtime_error("MAP_GMMTrainer: the number of threads must be greater than zero");
+  if (n_threads > N)
+    n_threads = N;
+  if (n_threads <= 1) {
+    if (N) chunk(0, N);
+    return;
+  }
+
+  std::vector<std::string> errors(n_threads);
+  boost::thread_group threads;
+  for (size_t t=0; t<n_threads; ++t)
+    threads.create_thread(boost::bind(&runChunk, boost::cref(chunk),
+      t*N/n_threads, (t+1)*N/n_threads, boost::ref(errors[t])));
+  threads.join_all();
+
+  for (size_t t=0; t<n_threads; ++t)
+    if (!errors[t].empty())
+      throw std::runtime_error("MAP_GMMTrainer: " + errors[t]);
+}
+
+/**
+ * Gives the n'th model of a bank (or the buffer if the bank is empty), in
+ * an array which does not share the reference count of the bank: the
+ * reference counts of blitz++ are not atomic, and the views of the
+ * different threads would race on it
+ */
+template <typename T, int N>
+blitz::Array<T,N-1> bankModel(blitz::Array<T,N>& bank, const int n,
+  blitz::Array<T,N-1>& buffer)
+{
+  if (bank.extent(0) == 0)
+    return blitz::Array<T,N-1>(buffer.data(), buffer.shape(), buffer.stride(),
+      blitz::neverDeleteData);
+  blitz::TinyVector<int,N-1> shape;
+  blitz::TinyVector<blitz::diffType,N-1> stride;
+  for (int i=0; i<N-1; ++i) {
+    shape(i) = bank.extent(i+1);
+    stride(i) = bank.stride(i+1);
+  }
+  return blitz::Array<T,N-1>(bank.data() + n * bank.stride(0), shape, stride,
+    blitz::neverDeleteData);
+}
+
+} // anonymous namespace
+
+
+void bob::learn::em::MAP_GMMTrainer::enrollStatsChunk(
+  const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+  const size_t start, const size_t end, blitz::Array<double,3>& means,
+  blitz::Array<double,2>& weights, blitz::Array<double,3>& variances) const
+{
+  // The arrays of the prior GMM may not be referenced by several threads:
+  // each thread has its own copy
+  const bob::learn::em::GMMMachine prior(*m_prior_gmm);
+  const blitz::Array<double,1> prior_weights(prior.getWeights());
+  const blitz::Array<double,2> prior_means(prior.getMeans());
+  const blitz::Array<double,2> prior_variances(prior.getVariances());
+  const blitz::Array<double,2> variance_thresholds(prior.getVarianceThresholds());
+  // Buffers for the parameters which are not updated
+  blitz::Array<double,1> w(prior_weights.shape());
+  blitz::Array<double,2> v(prior_variances.shape());
+
+  for (size_t n=start; n<end; ++n) {
+    bob::core::array::assertSameShape(stats[n]->sumPx, prior_means);
+    blitz::Array<double,1> weights_n(bankModel(weights, n, w));
+    blitz::Array<double,2> means_n(bankModel(means, n, v));
+    blitz::Array<double,2> variances_n(bankModel(variances, n, v));
+    weights_n = prior_weights;
+    means_n = prior_means;
+    variances_n = prior_variances;
+    adapt(*stats[n], weights_n, means_n, variances_n, variance_thresholds);
+  }
+}
+
+
+void bob::learn::em::MAP_GMMTrainer::enrollFeaturesChunk(
+  const std::vector<blitz::Array<double,2> >& features,
+  const size_t n_iterations, const size_t start, const size_t end,
+  blitz::Array<double,3>& means, blitz::Array<double,2>& weights,
+  blitz::Array<double,3>& variances) const
+{
+  // The machines are not thread-safe (they use caches): each thread has
+  // its own copies
+  const bob::learn::em::GMMMachine prior(*m_prior_gmm);
+  bob::learn::em::GMMMachine model(*m_prior_gmm);
+  bob::learn::em::GMMStats stats(prior.getNGaussians(), prior.getNInputs(),
+    m_gmm_base_trainer.getUpdateVariances());
+
+  const blitz::Array<double,1> prior_weights(prior.getWeights());
+  const blitz::Array<double,2> prior_means(prior.getMeans());
+  const blitz::Array<double,2> prior_variances(prior.getVariances());
+  const blitz::Array<double,2> variance_thresholds(prior.getVarianceThresholds());
+  blitz::Array<double,1> w(prior_weights.shape());
+  blitz::Array<double,2> v(prior_variances.shape());
+
+  for (size_t n=start; n<end; ++n) {
+    blitz::Array<double,1> weights_n(bankModel(weights, n, w));
+    blitz::Array<double,2> means_n(bankModel(means, n, v));
+    blitz::Array<double,2> variances_n(bankModel(variances, n, v));
+    weights_n = prior_weights;
+    means_n = prior_means;
+    variances_n = prior_variances;
+
+    for (size_t it=0; it<n_iterations; ++it) {
+      stats.init();
+      if (it == 0)
+        prior.accStatistics(features[n], stats);
+      else {
+        model.setWeights(weights_n);
+        model.setMeans(means_n);
+        model.setVariances(variances_n);
+        model.accStatistics(features[n], stats);
+      }
+      adapt(stats, weights_n, means_n, variances_n, variance_thresholds);
+    }
+  }
+}
+
+
+void bob::learn::em::MAP_GMMTrainer::enroll(
+  const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+  blitz::Array<double,3>& means, blitz::Array<double,2>& weights,
+  blitz::Array<double,3>& variances, const size_t n_threads) const
+{
+  resizeBanks(stats.size(), means, weights, variances);
+  runChunks(stats.size(), n_threads, boost::bind(&MAP_GMMTrainer::enrollStatsChunk,
+    this, boost::cref(stats), _1, _2, boost::ref(means), boost::ref(weights),
+    boost::ref(variances)));
+}
+
+
+void bob::learn::em::MAP_GMMTrainer::enroll(
+  const std::vector<blitz::Array<double,2> >& features,
+  blitz::Array<double,3>& means, blitz::Array<double,2>& weights,
+  blitz::Array<double,3>& variances, const size_t n_iterations,
+  const size_t n_threads) const
+{
+  resizeBanks(features.size(), means, weights, variances);
+  runChunks(features.size(), n_threads, boost::bind(&MAP_GMMTrainer::enrollFeaturesChunk,
+    this, boost::cref(features), n_iterations, _1, _2, boost::ref(means),
+    boost::ref(weights), boost::ref(variances)));
+}
+
+
 
 bob::learn::em::MAP_GMMTrainer& bob::learn::em::MAP_GMMTrainer::operator=
   (const bob::learn::em::MAP_GMMTrainer &other)
@@ -200,3 +402,13 @@ bool bob::learn::em::MAP_GMMTrainer::is_similar_to
          bob::core::isClose(m_alpha, other.m_alpha, r_epsilon, a_epsilon) &&
          m_reynolds_adaptation == other.m_reynolds_adaptation;
 }
+
+void bob::learn::em::MAP_GMMTrainer::save(bob::io::base::HDF5File& config) const
+{
+  m_gmm_base_trainer.save(config);
+}
+
+void bob::learn::em::MAP_GMMTrainer::load(bob::io::base::HDF5File& config)
+{
+  m_gmm_base_trainer.load(config);
+}
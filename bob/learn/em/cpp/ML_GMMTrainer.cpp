@@ -6,7 +6,10 @@
  */
 
 #include <bob.learn.em/ML_GMMTrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <algorithm>
+#include <cmath>
+#include <boost/format.hpp>
 
 bob::learn::em::ML_GMMTrainer::ML_GMMTrainer(
    const bool update_means,
@@ -14,13 +17,31 @@ bob::learn::em::ML_GMMTrainer::ML_GMMTrainer(
    const bool update_weights,
    const double mean_var_update_responsibilities_threshold
 ):
-  m_gmm_base_trainer(update_means, update_variances, update_weights, mean_var_update_responsibilities_threshold)
+  m_gmm_base_trainer(update_means, update_variances, update_weights, mean_var_update_responsibilities_threshold),
+  m_stepwise_decay(0.6),
+  m_stepwise_offset(2.),
+  m_stepwise_iteration(0),
+  m_prune_threshold(0.),
+  m_prune_iterations(3),
+  m_prune_resplit(false),
+  m_next_component_id(0)
 {}
 
 
 
 bob::learn::em::ML_GMMTrainer::ML_GMMTrainer(const bob::learn::em::ML_GMMTrainer& b):
-  m_gmm_base_trainer(b.m_gmm_base_trainer)
+  m_gmm_base_trainer(b.m_gmm_base_trainer),
+  m_stepwise_decay(b.m_stepwise_decay),
+  m_stepwise_offset(b.m_stepwise_offset),
+  m_stepwise_iteration(b.m_stepwise_iteration),
+  m_stepwise_ss(b.m_stepwise_ss),
+  m_prune_threshold(b.m_prune_threshold),
+  m_prune_iterations(b.m_prune_iterations),
+  m_prune_resplit(b.m_prune_resplit),
+  m_prune_counts(b.m_prune_counts),
+  m_component_ids(b.m_component_ids),
+  m_next_component_id(b.m_next_component_id),
+  m_pruned_components(b.m_pruned_components)
 {}
 
 bob::learn::em::ML_GMMTrainer::~ML_GMMTrainer()
@@ -33,30 +54,112 @@ void bob::learn::em::ML_GMMTrainer::initialize(bob::learn::em::GMMMachine& gmm)
   // Allocate cache
   size_t n_gaussians = gmm.getNGaussians();
   m_cache_ss_n_thresholded.resize(n_gaussians);
+
+  resetStepwise();
+  resetPruning(n_gaussians);
 }
 
 
 void bob::learn::em::ML_GMMTrainer::mStep(bob::learn::em::GMMMachine& gmm)
 {
-  // Read options and variables
-  const size_t n_gaussians = gmm.getNGaussians();
-
  //Checking if it is necessary to resize the cache
- if((size_t)m_cache_ss_n_thresholded.extent(0) != n_gaussians)
+ if((size_t)m_cache_ss_n_thresholded.extent(0) != gmm.getNGaussians())
    initialize(gmm); //If it is different for some reason, there is no way, you have to initialize
 
+  updateParameters(gmm, *m_gmm_base_trainer.getGMMStats());
+
+  if (m_prune_threshold > 0.)
+    prune(gmm, *m_gmm_base_trainer.getGMMStats());
+}
+
+
+void bob::learn::em::ML_GMMTrainer::resetPruning(const size_t n_gaussians)
+{
+  m_prune_counts.assign(n_gaussians, 0);
+  m_component_ids.resize(n_gaussians);
+  for (size_t i=0; i<n_gaussians; ++i) m_component_ids[i] = i;
+  m_next_component_id = n_gaussians;
+  m_pruned_components.clear();
+}
+
+
+void bob::learn::em::ML_GMMTrainer::prune(bob::learn::em::GMMMachine& gmm,
+  const bob::learn::em::GMMStats& stats)
+{
+  const size_t n_gaussians = gmm.getNGaussians();
+  if (m_prune_counts.size() != n_gaussians)
+    resetPruning(n_gaussians);
+
+  std::vector<size_t> dead;
+  for (size_t i=0; i<n_gaussians; ++i) {
+    if (stats.n(i) < m_prune_threshold) ++m_prune_counts[i];
+    else m_prune_counts[i] = 0;
+    if (m_prune_counts[i] >= m_prune_iterations) dead.push_back(i);
+  }
+  // At least one component must remain
+  if (dead.empty() || dead.size() == n_gaussians) return;
+
+  gmm.removeGaussians(dead);
+  for (size_t k=dead.size(); k>0; --k) {
+    const size_t i = dead[k-1];
+    m_pruned_components.push_back(m_component_ids[i]);
+    m_component_ids.erase(m_component_ids.begin() + i);
+    m_prune_counts.erase(m_prune_counts.begin() + i);
+  }
+  // Reported in order of increasing index
+  std::reverse(m_pruned_components.end() - dead.size(), m_pruned_components.end());
+
+  if (m_prune_resplit) {
+    const size_t n_splits = std::min(dead.size(), gmm.getNGaussians());
+    gmm.split(n_splits);
+    for (size_t k=0; k<n_splits; ++k) {
+      m_component_ids.push_back(m_next_component_id++);
+      m_prune_counts.push_back(0);
+    }
+  }
+
+  // The next E-step accumulates statistics for the remaining components
+  m_cache_ss_n_thresholded.resize(gmm.getNGaussians());
+  m_gmm_base_trainer.initialize(gmm);
+}
+
+void bob::learn::em::ML_GMMTrainer::setPruneThreshold(const double threshold)
+{
+  if (threshold < 0.) {
+    boost::format m("ML_GMMTrainer: the pruning threshold must be positive, not %f");
+    m % threshold;
+    throw std::runtime_error(m.str());
+  }
+  m_prune_threshold = threshold;
+}
+
+void bob::learn::em::ML_GMMTrainer::setPruneIterations(const size_t iterations)
+{
+  if (iterations == 0)
+    throw std::runtime_error("ML_GMMTrainer: the number of pruning iterations must be greater than zero");
+  m_prune_iterations = iterations;
+}
+
+
+void bob::learn::em::ML_GMMTrainer::updateParameters(bob::learn::em::GMMMachine& gmm,
+  const bob::learn::em::GMMStats& stats, const double frame_weight)
+{
+  // Read options and variables
+  const size_t n_gaussians = gmm.getNGaussians();
+
   // - Update weights if requested
   //   Equation 9.26 of Bishop, "Pattern recognition and machine learning", 2006
   if (m_gmm_base_trainer.getUpdateWeights()) {
     blitz::Array<double,1>& weights = gmm.updateWeights();
-    weights = m_gmm_base_trainer.getGMMStats()->n / static_cast<double>(m_gmm_base_trainer.getGMMStats()->T); //cast req. for linux/32-bits & osx
+    weights = stats.n / static_cast<double>(stats.T); //cast req. for linux/32-bits & osx
     // Recompute the log weights in the cache of the GMMMachine
     gmm.recomputeLogWeights();
   }
 
   // Generate a thresholded version of m_ss.n
+  const double threshold = frame_weight * m_gmm_base_trainer.getMeanVarUpdateResponsibilitiesThreshold();
   for(size_t i=0; i<n_gaussians; ++i)
-    m_cache_ss_n_thresholded(i) = std::max(m_gmm_base_trainer.getGMMStats()->n(i), m_gmm_base_trainer.getMeanVarUpdateResponsibilitiesThreshold());
+    m_cache_ss_n_thresholded(i) = std::max(stats.n(i), threshold);
 
   // Update GMM parameters using the sufficient statistics (m_ss)
   // - Update means if requested
@@ -64,7 +167,7 @@ void bob::learn::em::ML_GMMTrainer::mStep(bob::learn::em::GMMMachine& gmm)
   if (m_gmm_base_trainer.getUpdateMeans()) {
     for(size_t i=0; i<n_gaussians; ++i) {
       blitz::Array<double,1>& means = gmm.getGaussian(i)->updateMean();
-      means = m_gmm_base_trainer.getGMMStats()->sumPx(i, blitz::Range::all()) / m_cache_ss_n_thresholded(i);
+      means = stats.sumPx(i, blitz::Range::all()) / m_cache_ss_n_thresholded(i);
     }
   }
 
@@ -74,15 +177,83 @@ void bob::learn::em::ML_GMMTrainer::mStep(bob::learn::em::GMMMachine& gmm)
   //   var = 1/n * sum (P(x-mean)(x-mean))
   //       = 1/n * sum (Pxx) - mean^2
   if (m_gmm_base_trainer.getUpdateVariances()) {
+    if (!stats.hasSecondOrder())
+      throw std::runtime_error("ML_GMMTrainer: updating the variances requires second order statistics");
     for(size_t i=0; i<n_gaussians; ++i) {
       const blitz::Array<double,1>& means = gmm.getGaussian(i)->getMean();
       blitz::Array<double,1>& variances = gmm.getGaussian(i)->updateVariance();
-      variances = m_gmm_base_trainer.getGMMStats()->sumPxx(i, blitz::Range::all()) / m_cache_ss_n_thresholded(i) - blitz::pow2(means);
+      variances = stats.sumPxx(i, blitz::Range::all()) / m_cache_ss_n_thresholded(i) - blitz::pow2(means);
       gmm.getGaussian(i)->applyVarianceThresholds();
     }
   }
 }
 
+void bob::learn::em::ML_GMMTrainer::resetStepwise()
+{
+  m_stepwise_iteration = 0;
+  m_stepwise_ss.resize(0, 0);
+}
+
+double bob::learn::em::ML_GMMTrainer::getStepSize() const
+{
+  // The first mini-batch initializes the running statistics
+  if (m_stepwise_iteration == 0) return 1.;
+  return std::pow(m_stepwise_iteration + m_stepwise_offset, -m_stepwise_decay);
+}
+
+void bob::learn::em::ML_GMMTrainer::setStepwiseDecay(const double decay)
+{
+  if (decay <= 0.5 || decay > 1.) {
+    boost::format m("ML_GMMTrainer: the decay of the step size must be in ]0.5,1], not %f");
+    m % decay;
+    throw std::runtime_error(m.str());
+  }
+  m_stepwise_decay = decay;
+}
+
+void bob::learn::em::ML_GMMTrainer::setStepwiseOffset(const double offset)
+{
+  if (offset < 0.) {
+    boost::format m("ML_GMMTrainer: the offset of the step size must be positive, not %f");
+    m % offset;
+    throw std::runtime_error(m.str());
+  }
+  m_stepwise_offset = offset;
+}
+
+void bob::learn::em::ML_GMMTrainer::stepwiseStep(bob::learn::em::GMMMachine& gmm,
+  const blitz::Array<double,2>& data)
+{
+  if (data.extent(0) == 0)
+    throw std::runtime_error("ML_GMMTrainer: the mini-batch is empty");
+
+  //Checking if it is necessary to resize the cache
+  if((size_t)m_cache_ss_n_thresholded.extent(0) != gmm.getNGaussians())
+    initialize(gmm);
+
+  // Statistics of the mini-batch
+  m_gmm_base_trainer.eStep(gmm, data);
+  const bob::learn::em::GMMStats& batch = *m_gmm_base_trainer.getGMMStats();
+
+  // Interpolates the per-frame statistics into the running ones
+  const double eta = getStepSize();
+  const double w = eta / batch.T;
+  if (m_stepwise_iteration == 0)
+    m_stepwise_ss.resize(gmm.getNGaussians(), gmm.getNInputs(), batch.hasSecondOrder());
+  m_stepwise_ss.T = 1;
+  m_stepwise_ss.log_likelihood = (1. - eta) * m_stepwise_ss.log_likelihood + w * batch.log_likelihood;
+  m_stepwise_ss.n = (1. - eta) * m_stepwise_ss.n + w * batch.n;
+  m_stepwise_ss.sumPx = (1. - eta) * m_stepwise_ss.sumPx + w * batch.sumPx;
+  if (m_stepwise_ss.hasSecondOrder())
+    m_stepwise_ss.sumPxx = (1. - eta) * m_stepwise_ss.sumPxx + w * batch.sumPxx;
+  ++m_stepwise_iteration;
+
+  // The running statistics are per frame, where the frames of the last
+  // mini-batch weigh w each: the responsibilities threshold, a number of
+  // frames, is scaled accordingly
+  updateParameters(gmm, m_stepwise_ss, w);
+}
+
 bob::learn::em::ML_GMMTrainer& bob::learn::em::ML_GMMTrainer::operator=
   (const bob::learn::em::ML_GMMTrainer &other)
 {
@@ -90,6 +261,17 @@ bob::learn::em::ML_GMMTrainer& bob::learn::em::ML_GMMTrainer::operator=
   {
     m_gmm_base_trainer = other.m_gmm_base_trainer;
     m_cache_ss_n_thresholded.resize(other.m_cache_ss_n_thresholded.extent(0));
+    m_stepwise_decay = other.m_stepwise_decay;
+    m_stepwise_offset = other.m_stepwise_offset;
+    m_stepwise_iteration = other.m_stepwise_iteration;
+    m_stepwise_ss = other.m_stepwise_ss;
+    m_prune_threshold = other.m_prune_threshold;
+    m_prune_iterations = other.m_prune_iterations;
+    m_prune_resplit = other.m_prune_resplit;
+    m_prune_counts = other.m_prune_counts;
+    m_component_ids = other.m_component_ids;
+    m_next_component_id = other.m_next_component_id;
+    m_pruned_components = other.m_pruned_components;
   }
   return *this;
 }
@@ -97,7 +279,12 @@ bob::learn::em::ML_GMMTrainer& bob::learn::em::ML_GMMTrainer::operator=
 bool bob::learn::em::ML_GMMTrainer::operator==
   (const bob::learn::em::ML_GMMTrainer &other) const
 {
-  return m_gmm_base_trainer == other.m_gmm_base_trainer;
+  return m_gmm_base_trainer == other.m_gmm_base_trainer &&
+         m_stepwise_decay == other.m_stepwise_decay &&
+         m_stepwise_offset == other.m_stepwise_offset &&
+         m_prune_threshold == other.m_prune_threshold &&
+         m_prune_iterations == other.m_prune_iterations &&
+         m_prune_resplit == other.m_prune_resplit;
 }
 
 bool bob::learn::em::ML_GMMTrainer::operator!=
@@ -105,3 +292,62 @@ bool bob::learn::em::ML_GMMTrainer::operator!=
 {
   return !(this->operator==(other));
 }
+
+
+static void _saveIndices(bob::io::base::HDF5File& config, const std::string& path,
+  const std::vector<size_t>& indices)
+{
+  // Empty datasets are not stored
+  if (indices.empty()) return;
+  blitz::Array<uint64_t,1> a(indices.size());
+  for (size_t i=0; i<indices.size(); ++i) a(i) = indices[i];
+  config.setArray(path, a);
+}
+
+static void _loadIndices(bob::io::base::HDF5File& config, const std::string& path,
+  std::vector<size_t>& indices)
+{
+  indices.clear();
+  if (!config.contains(path)) return;
+  const blitz::Array<uint64_t,1> a = config.readArray<uint64_t,1>(path);
+  for (int i=0; i<a.extent(0); ++i) indices.push_back(a(i));
+}
+
+void bob::learn::em::ML_GMMTrainer::save(bob::io::base::HDF5File& config) const
+{
+  m_gmm_base_trainer.save(config);
+
+  config.set("stepwise_iteration", static_cast<int64_t>(m_stepwise_iteration));
+  if (m_stepwise_iteration > 0) {
+    config.createGroup("stepwise_stats");
+    config.cd("stepwise_stats");
+    m_stepwise_ss.save(config);
+    config.cd("..");
+  }
+
+  _saveIndices(config, "prune_counts", m_prune_counts);
+  _saveIndices(config, "component_ids", m_component_ids);
+  config.set("next_component_id", static_cast<int64_t>(m_next_component_id));
+  _saveIndices(config, "pruned_components", m_pruned_components);
+}
+
+void bob::learn::em::ML_GMMTrainer::load(bob::io::base::HDF5File& config)
+{
+  m_gmm_base_trainer.load(config);
+  // The number of components may have changed by pruning
+  m_cache_ss_n_thresholded.resize(m_gmm_base_trainer.getGMMStats()->n.extent(0));
+
+  m_stepwise_iteration = config.read<int64_t>("stepwise_iteration");
+  if (m_stepwise_iteration > 0) {
+    config.cd("stepwise_stats");
+    m_stepwise_ss.load(config);
+    config.cd("..");
+  }
+  else
+    m_stepwise_ss.resize(0, 0);
+
+  _loadIndices(config, "prune_counts", m_prune_counts);
+  _loadIndices(config, "component_ids", m_component_ids);
+  m_next_component_id = config.read<int64_t>("next_component_id");
+  _loadIndices(config, "pruned_components", m_pruned_components);
+}
@@ -0,0 +1,183 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/MiniBatchKMeansTrainer.h>
+#include <bob.learn.em/Checkpoint.h>
+#include <bob.core/array_copy.h>
+#include <bob.core/check.h>
+
+#include <boost/random.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+
+bob::learn::em::MiniBatchKMeansTrainer::MiniBatchKMeansTrainer(
+  const size_t batch_size, KMeansTrainer::InitializationMethod i_m):
+  m_batch_size(batch_size),
+  m_initialization_method(i_m),
+  m_rng(new boost::mt19937()),
+  m_batch_average_min_distance(0),
+  m_average_min_distance(0),
+  m_n_batches(0)
+{
+  if (batch_size == 0)
+    throw std::runtime_error("MiniBatchKMeansTrainer: the batch size must be greater than zero");
+}
+
+bob::learn::em::MiniBatchKMeansTrainer::MiniBatchKMeansTrainer(
+  const bob::learn::em::MiniBatchKMeansTrainer& other):
+  m_batch_size(other.m_batch_size),
+  m_initialization_method(other.m_initialization_method),
+  m_rng(other.m_rng),
+  m_counts(bob::core::array::ccopy(other.m_counts)),
+  m_batch(bob::core::array::ccopy(other.m_batch)),
+  m_assignment(bob::core::array::ccopy(other.m_assignment)),
+  m_batch_average_min_distance(other.m_batch_average_min_distance),
+  m_average_min_distance(other.m_average_min_distance),
+  m_n_batches(other.m_n_batches)
+{
+}
+
+bob::learn::em::MiniBatchKMeansTrainer& bob::learn::em::MiniBatchKMeansTrainer::operator=
+(const bob::learn::em::MiniBatchKMeansTrainer& other)
+{
+  if (this != &other)
+  {
+    m_batch_size = other.m_batch_size;
+    m_initialization_method = other.m_initialization_method;
+    m_rng = other.m_rng;
+    m_counts.reference(bob::core::array::ccopy(other.m_counts));
+    m_batch.reference(bob::core::array::ccopy(other.m_batch));
+    m_assignment.reference(bob::core::array::ccopy(other.m_assignment));
+    m_batch_average_min_distance = other.m_batch_average_min_distance;
+    m_average_min_distance = other.m_average_min_distance;
+    m_n_batches = other.m_n_batches;
+  }
+  return *this;
+}
+
+bool bob::learn::em::MiniBatchKMeansTrainer::operator==
+(const bob::learn::em::MiniBatchKMeansTrainer& b) const
+{
+  return m_batch_size == b.m_batch_size &&
+         m_initialization_method == b.m_initialization_method &&
+         *m_rng == *(b.m_rng) &&
+         bob::core::array::hasSameShape(m_counts, b.m_counts) &&
+         blitz::all(m_counts == b.m_counts) &&
+         m_average_min_distance == b.m_average_min_distance &&
+         m_n_batches == b.m_n_batches;
+}
+
+bool bob::learn::em::MiniBatchKMeansTrainer::operator!=
+(const bob::learn::em::MiniBatchKMeansTrainer& b) const
+{
+  return !(this->operator==(b));
+}
+
+void bob::learn::em::MiniBatchKMeansTrainer::setBatchSize(const size_t batch_size)
+{
+  if (batch_size == 0)
+    throw std::runtime_error("MiniBatchKMeansTrainer: the batch size must be greater than zero");
+  m_batch_size = batch_size;
+}
+
+void bob::learn::em::MiniBatchKMeansTrainer::initialize(
+  bob::learn::em::KMeansMachine& kmeans, const blitz::Array<double,2>& data)
+{
+  bob::learn::em::KMeansTrainer trainer(m_initialization_method);
+  trainer.setRng(m_rng);
+  trainer.initialize(kmeans, data);
+
+  m_counts.resize(kmeans.getNMeans());
+  m_counts = 0.;
+  m_batch.resize(0, 0);
+  m_assignment.resize(0);
+  m_batch_average_min_distance = 0.;
+  m_average_min_distance = 0.;
+  m_n_batches = 0;
+}
+
+void bob::learn::em::MiniBatchKMeansTrainer::eStep(
+  bob::learn::em::KMeansMachine& kmeans, const blitz::Array<double,2>& data)
+{
+  bob::core::array::assertSameDimensionLength(data.extent(1), kmeans.getNInputs());
+  const int n_data = data.extent(0);
+  if (n_data == 0)
+    throw std::runtime_error("MiniBatchKMeansTrainer: the data is empty");
+
+  // Draws the batch; the samples are gathered in the order of the data,
+  // for a better memory access pattern
+  boost::uniform_int<> die(0, n_data-1);
+  std::vector<int> indices(m_batch_size);
+  for (size_t i=0; i<m_batch_size; ++i)
+    indices[i] = die(*m_rng);
+  std::sort(indices.begin(), indices.end());
+
+  blitz::Range a = blitz::Range::all();
+  m_batch.resize(m_batch_size, data.extent(1));
+  for (size_t i=0; i<m_batch_size; ++i)
+    m_batch(i,a) = data(indices[i],a);
+
+  m_assignment.resize(m_batch_size);
+  m_cache_min_distances.resize(m_batch_size);
+  kmeans.getClosestMeans(m_batch, m_assignment, m_cache_min_distances);
+  m_batch_average_min_distance = blitz::mean(m_cache_min_distances);
+
+  // The average is over a fixed number of batches, whatever the size of the
+  // data, such that its relative change (the convergence criterion of
+  // train()) does not vanish on large data; the first batches are averaged
+  // uniformly
+  static const double window = 10.;
+  ++m_n_batches;
+  const double alpha = std::max(2. / (window + 1.), 1. / m_n_batches);
+  m_average_min_distance = (1. - alpha) * m_average_min_distance + alpha * m_batch_average_min_distance;
+}
+
+void bob::learn::em::MiniBatchKMeansTrainer::mStep(bob::learn::em::KMeansMachine& kmeans)
+{
+  bob::core::array::assertSameDimensionLength(m_counts.extent(0), kmeans.getNMeans());
+
+  // Each sample moves its mean with a decreasing learning rate, such that a
+  // mean is the average of all the samples it was ever assigned
+  blitz::Range a = blitz::Range::all();
+  blitz::Array<double,2>& means = kmeans.updateMeans();
+  for (int i=0; i<m_batch.extent(0); ++i) {
+    const int m = m_assignment(i);
+    m_counts(m) += 1.;
+    const double eta = 1. / m_counts(m);
+    means(m,a) = (1. - eta) * means(m,a) + eta * m_batch(i,a);
+  }
+  kmeans.updateIndex();
+}
+
+double bob::learn::em::MiniBatchKMeansTrainer::computeLikelihood(bob::learn::em::KMeansMachine& kmeans)
+{
+  return m_average_min_distance;
+}
+
+void bob::learn::em::MiniBatchKMeansTrainer::save(bob::io::base::HDF5File& config) const
+{
+  if (m_rng) saveRng(config, "rng", *m_rng);
+  config.setArray("counts", m_counts);
+  saveOptionalArray(config, "batch", m_batch);
+  saveOptionalArray(config, "assignment", m_assignment);
+  config.set("batch_average_min_distance", m_batch_average_min_distance);
+  config.set("average_min_distance", m_average_min_distance);
+  config.set("n_batches", static_cast<int64_t>(m_n_batches));
+}
+
+void bob::learn::em::MiniBatchKMeansTrainer::load(bob::io::base::HDF5File& config)
+{
+  if (m_rng) loadRng(config, "rng", *m_rng);
+  m_counts.reference(config.readArray<double,1>("counts"));
+  loadOptionalArray(config, "batch", m_batch);
+  loadOptionalArray(config, "assignment", m_assignment);
+  m_batch_average_min_distance = config.read<double>("batch_average_min_distance");
+  m_average_min_distance = config.read<double>("average_min_distance");
+  m_n_batches = config.read<int64_t>("n_batches");
+}
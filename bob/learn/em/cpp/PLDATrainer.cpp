@@ -9,6 +9,7 @@
 
 
 #include <bob.learn.em/PLDATrainer.h>
+#include <bob.learn.em/Checkpoint.h>
 #include <bob.core/check.h>
 #include <bob.core/array_copy.h>
 #include <bob.core/array_random.h>
@@ -798,3 +799,21 @@ void bob::learn::em::PLDATrainer::enroll(bob::learn::em::PLDAMachine& plda_machi
   plda_machine.setLogLikelihood(plda_machine.computeLogLikelihood(
                                   blitz::Array<double,2>(0,dim_d),true));
 }
+
+void bob::learn::em::PLDATrainer::save(bob::io::base::HDF5File& config) const
+{
+  if (m_rng) saveRng(config, "rng", *m_rng);
+  saveArrays(config, "z_first_order", m_cache_z_first_order);
+  config.setArray("sum_z_second_order", m_cache_sum_z_second_order);
+  if (!m_use_sum_second_order)
+    saveArrays(config, "z_second_order", m_cache_z_second_order);
+}
+
+void bob::learn::em::PLDATrainer::load(bob::io::base::HDF5File& config)
+{
+  if (m_rng) loadRng(config, "rng", *m_rng);
+  loadArrays(config, "z_first_order", m_cache_z_first_order);
+  m_cache_sum_z_second_order.reference(config.readArray<double,2>("sum_z_second_order"));
+  if (!m_use_sum_second_order)
+    loadArrays(config, "z_second_order", m_cache_z_second_order);
+}
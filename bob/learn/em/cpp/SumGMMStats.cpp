@@ -0,0 +1,248 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.learn.em/SumGMMStats.h>
+#include <bob.core/assert.h>
+#include <bob.io.base/HDF5File.h>
+#include <boost/thread.hpp>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <cmath>
+
+namespace {
+
+/**
+ * Adds v to sum, accumulating the rounding error in comp (Neumaier's
+ * variant of the Kahan summation)
+ */
+inline void compensatedAdd(double& sum, double& comp, const double v)
+{
+  const double t = sum + v;
+  if (std::fabs(sum) >= std::fabs(v))
+    comp += (sum - t) + v;
+  else
+    comp += (v - t) + sum;
+  sum = t;
+}
+
+/**
+ * A running sum of GMMStats, with an optional compensation term
+ */
+class StatsAccumulator {
+  public:
+    StatsAccumulator(const size_t n_gaussians, const size_t n_inputs,
+        const bool second_order, const bool compensated):
+      m_sum(n_gaussians, n_inputs, second_order),
+      m_comp(compensated ? n_gaussians : 0, compensated ? n_inputs : 0, second_order),
+      m_compensated(compensated)
+    {
+    }
+
+    void add(const bob::learn::em::GMMStats& s)
+    {
+      bob::core::array::assertSameShape(s.sumPx, m_sum.sumPx);
+      if (m_sum.hasSecondOrder() && !s.hasSecondOrder())
+        throw std::runtime_error("sumGMMStats: cannot add first order only statistics to second order ones");
+
+      m_sum.T += s.T;
+      if (!m_compensated) {
+        m_sum.log_likelihood += s.log_likelihood;
+        m_sum.n += s.n;
+        m_sum.sumPx += s.sumPx;
+        if (m_sum.hasSecondOrder())
+          m_sum.sumPxx += s.sumPxx;
+        return;
+      }
+
+      compensatedAdd(m_sum.log_likelihood, m_comp.log_likelihood, s.log_likelihood);
+      const int C = m_sum.sumPx.extent(0);
+      const int D = m_sum.sumPx.extent(1);
+      for (int c=0; c<C; ++c) {
+        compensatedAdd(m_sum.n(c), m_comp.n(c), s.n(c));
+        for (int d=0; d<D; ++d) {
+          compensatedAdd(m_sum.sumPx(c,d), m_comp.sumPx(c,d), s.sumPx(c,d));
+          if (m_sum.hasSecondOrder())
+            compensatedAdd(m_sum.sumPxx(c,d), m_comp.sumPxx(c,d), s.sumPxx(c,d));
+        }
+      }
+    }
+
+    void merge(const StatsAccumulator& other)
+    {
+      add(other.m_sum);
+      if (m_compensated) {
+        m_comp.log_likelihood += other.m_comp.log_likelihood;
+        m_comp.n += other.m_comp.n;
+        m_comp.sumPx += other.m_comp.sumPx;
+        if (m_sum.hasSecondOrder())
+          m_comp.sumPxx += other.m_comp.sumPxx;
+      }
+    }
+
+    void result(bob::learn::em::GMMStats& output) const
+    {
+      output = m_sum;
+      if (m_compensated) {
+        output.log_likelihood += m_comp.log_likelihood;
+        output.n += m_comp.n;
+        output.sumPx += m_comp.sumPx;
+        if (m_sum.hasSecondOrder())
+          output.sumPxx += m_comp.sumPxx;
+      }
+    }
+
+  private:
+    bob::learn::em::GMMStats m_sum;
+    bob::learn::em::GMMStats m_comp;
+    bool m_compensated;
+};
+
+
+/**
+ * Returns the i'th statistics of an in-memory collection
+ */
+class MemorySource {
+  public:
+    MemorySource(const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats):
+      m_stats(stats) {}
+
+    size_t size() const { return m_stats.size(); }
+
+    const bob::learn::em::GMMStats& get(const size_t i, bob::learn::em::GMMStats&) const
+    { return *m_stats[i]; }
+
+  private:
+    const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& m_stats;
+};
+
+/**
+ * Loads the i'th statistics of a collection of HDF5 files
+ */
+class FileSource {
+  public:
+    FileSource(const std::vector<std::string>& filenames):
+      m_filenames(filenames) {}
+
+    size_t size() const { return m_filenames.size(); }
+
+    const bob::learn::em::GMMStats& get(const size_t i, bob::learn::em::GMMStats& buffer) const
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      bob::io::base::HDF5File file(m_filenames[i], bob::io::base::HDF5File::in);
+      buffer.load(file);
+      return buffer;
+    }
+
+  private:
+    const std::vector<std::string>& m_filenames;
+    mutable boost::mutex m_mutex;
+};
+
+
+/**
+ * Accumulates the elements [start, end[ of the source
+ */
+template <typename Source>
+void accumulateChunk(const Source& source, const size_t start, const size_t end,
+    StatsAccumulator& acc, std::string& error)
+{
+  try {
+    bob::learn::em::GMMStats buffer;
+    for (size_t i=start; i<end; ++i)
+      acc.add(source.get(i, buffer));
+  }
+  catch (std::exception& e) {
+    error = e.what();
+  }
+  catch (...) {
+    error = "unknown exception";
+  }
+}
+
+void mergeAccumulators(StatsAccumulator& acc, const StatsAccumulator& other,
+    std::string& error)
+{
+  try {
+    acc.merge(other);
+  }
+  catch (std::exception& e) {
+    error = e.what();
+  }
+}
+
+void checkErrors(const std::vector<std::string>& errors)
+{
+  for (size_t i=0; i<errors.size(); ++i)
+    if (!errors[i].empty())
+      throw std::runtime_error("sumGMMStats: " + errors[i]);
+}
+
+template <typename Source>
+void sumGMMStatsImpl(const Source& source, const bob::learn::em::GMMStats& first,
+    bob::learn::em::GMMStats& output, size_t n_threads, const bool compensated)
+{
+  const size_t N = source.size();
+  if (n_threads == 0)
+    throw std::runtime_error("sumGMMStats: the number of threads must be greater than zero");
+  if (n_threads > N)
+    n_threads = N;
+
+  std::vector<boost::shared_ptr<StatsAccumulator> > accs;
+  for (size_t t=0; t<n_threads; ++t)
+    accs.push_back(boost::shared_ptr<StatsAccumulator>(new StatsAccumulator(
+      first.sumPx.extent(0), first.sumPx.extent(1), first.hasSecondOrder(), compensated)));
+  std::vector<std::string> errors(n_threads);
+
+  // 1. Accumulates contiguous chunks in parallel
+  if (n_threads == 1)
+    accumulateChunk(source, 0, N, *accs[0], errors[0]);
+  else {
+    boost::thread_group threads;
+    for (size_t t=0; t<n_threads; ++t)
+      threads.create_thread(boost::bind(&accumulateChunk<Source>, boost::cref(source),
+        t*N/n_threads, (t+1)*N/n_threads, boost::ref(*accs[t]), boost::ref(errors[t])));
+    threads.join_all();
+  }
+  checkErrors(errors);
+
+  // 2. Pairwise tree reduction of the partial sums
+  for (size_t step=1; step<n_threads; step*=2) {
+    boost::thread_group threads;
+    for (size_t t=0; t+step<n_threads; t+=2*step)
+      threads.create_thread(boost::bind(&mergeAccumulators, boost::ref(*accs[t]),
+        boost::cref(*accs[t+step]), boost::ref(errors[t])));
+    threads.join_all();
+    checkErrors(errors);
+  }
+
+  accs[0]->result(output);
+}
+
+} // anonymous namespace
+
+
+void bob::learn::em::sumGMMStats(
+  const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+  bob::learn::em::GMMStats& output,
+  const size_t n_threads, const bool compensated)
+{
+  if (stats.size() == 0)
+    throw std::runtime_error("sumGMMStats: the list of statistics is empty");
+  sumGMMStatsImpl(MemorySource(stats), *stats[0], output, n_threads, compensated);
+}
+
+void bob::learn::em::sumGMMStats(const std::vector<std::string>& filenames,
+  bob::learn::em::GMMStats& output,
+  const size_t n_threads, const bool compensated)
+{
+  if (filenames.size() == 0)
+    throw std::runtime_error("sumGMMStats: the list of files is empty");
+  // The first file gives the shape of the statistics
+  bob::io::base::HDF5File file(filenames[0], bob::io::base::HDF5File::in);
+  bob::learn::em::GMMStats first(file);
+  sumGMMStatsImpl(FileSource(filenames), first, output, n_threads, compensated);
+}
@@ -0,0 +1,232 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto FileListDataSource_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".FileListDataSource",
+  "Training data read from a list of HDF5 files, on a background thread",
+  "This can be given instead of an array to the ``e_step`` of the :py:class:`bob.learn.em.ML_GMMTrainer`, "
+  ":py:class:`bob.learn.em.MAP_GMMTrainer` and :py:class:`bob.learn.em.KMeansTrainer`, "
+  "and thus to :py:func:`bob.learn.em.train` (for the :py:class:`bob.learn.em.KMeansTrainer`, the initialization requires an array). "
+  "Each E-step makes a pass over the files, without concatenating them in memory: "
+  "a prefetch thread reads the next files into a ring of ``n_buffers`` buffers while the current file is processed. "
+  "At most ``n_buffers`` files are held in memory.\n\n"
+  "Other HDF5 files should not be accessed from another thread during a pass; "
+  "they can be accessed between two E-steps, e.g., to save a checkpoint.\n\n"
+  ".. code-block:: python\n\n"
+  "   data = bob.learn.em.FileListDataSource(filenames)\n"
+  "   bob.learn.em.train(ml_trainer, gmm, data, max_iterations=10)\n"
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a source of data on a list of HDF5 files, which are read from the first pass on",
+    "",
+    true
+  )
+  .add_prototype("filenames,[key],[n_buffers]","")
+  .add_parameter("filenames", "[str]", "The names of the HDF5 files, each of them holding a 2D array of float64 with one feature vector per row")
+  .add_parameter("key", "str", "[Default: ``'array'``] The path of the array in each file; the default is the one used by :py:func:`bob.io.base.save`")
+  .add_parameter("n_buffers", "int", "[Default: ``2``] The number of buffers of the ring; at least 2 are required for the reading to overlap with the computation")
+);
+
+
+static int PyBobLearnEMFileListDataSource_init(PyBobLearnEMFileListDataSourceObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = FileListDataSource_doc.kwlist(0);
+
+  PyObject* filenames = 0;
+  const char* key = "array";
+  int n_buffers = 2;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|si", kwlist, &PyList_Type, &filenames, &key, &n_buffers)){
+    FileListDataSource_doc.print_usage();
+    return -1;
+  }
+
+  if (n_buffers <= 0){
+    PyErr_Format(PyExc_TypeError, "n_buffers must be greater than zero");
+    FileListDataSource_doc.print_usage();
+    return -1;
+  }
+
+  std::vector<std::string> filenames_;
+  for (int i=0; i<PyList_GET_SIZE(filenames); i++){
+    PyObject* item = PyList_GetItem(filenames, i);
+    if (!PyString_Check(item)){
+      PyErr_Format(PyExc_TypeError, "Expected file names");
+      return -1;
+    }
+    filenames_.push_back(PyString_AS_STRING(item));
+  }
+
+  self->cxx.reset(new bob::learn::em::FileListDataSource(filenames_, key, n_buffers));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create FileListDataSource", -1)
+}
+
+
+static void PyBobLearnEMFileListDataSource_delete(PyBobLearnEMFileListDataSourceObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobLearnEMFileListDataSource_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMFileListDataSource_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+/***** filenames *****/
+static auto filenames = bob::extension::VariableDoc(
+  "filenames",
+  "[str]",
+  "The names of the HDF5 files",
+  ""
+);
+PyObject* PyBobLearnEMFileListDataSource_getFilenames(PyBobLearnEMFileListDataSourceObject* self, void*){
+  BOB_TRY
+  const std::vector<std::string>& filenames = self->cxx->getFilenames();
+  PyObject* list = PyList_New(filenames.size());
+  if (!list) return 0;
+  auto list_ = make_safe(list);
+  for (size_t i=0; i<filenames.size(); ++i){
+    PyObject* filename = Py_BuildValue("s", filenames[i].c_str());
+    if (!filename) return 0;
+    PyList_SET_ITEM(list, i, filename);
+  }
+  return Py_BuildValue("O", list);
+  BOB_CATCH_MEMBER("filenames could not be read", 0)
+}
+
+
+/***** key *****/
+static auto key = bob::extension::VariableDoc(
+  "key",
+  "str",
+  "The path of the array in each file",
+  ""
+);
+PyObject* PyBobLearnEMFileListDataSource_getKey(PyBobLearnEMFileListDataSourceObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("s", self->cxx->getKey().c_str());
+  BOB_CATCH_MEMBER("key could not be read", 0)
+}
+
+
+/***** n_buffers *****/
+static auto n_buffers = bob::extension::VariableDoc(
+  "n_buffers",
+  "int",
+  "The number of buffers of the ring",
+  ""
+);
+PyObject* PyBobLearnEMFileListDataSource_getNBuffers(PyBobLearnEMFileListDataSourceObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getNBuffers());
+  BOB_CATCH_MEMBER("n_buffers could not be read", 0)
+}
+
+
+static PyGetSetDef PyBobLearnEMFileListDataSource_getseters[] = {
+  {
+    filenames.name(),
+    (getter)PyBobLearnEMFileListDataSource_getFilenames,
+    0,
+    filenames.doc(),
+    0
+  },
+  {
+    key.name(),
+    (getter)PyBobLearnEMFileListDataSource_getKey,
+    0,
+    key.doc(),
+    0
+  },
+  {
+    n_buffers.name(),
+    (getter)PyBobLearnEMFileListDataSource_getNBuffers,
+    0,
+    n_buffers.doc(),
+    0
+  },
+  {0}  // Sentinel
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+/*** reset ***/
+static auto reset = bob::extension::FunctionDoc(
+  "reset",
+  "Restarts the reading from the first file",
+  "This is only required to abort a pass; each E-step starts a new pass anyway."
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMFileListDataSource_reset(PyBobLearnEMFileListDataSourceObject* self) {
+  BOB_TRY
+  self->cxx->reset();
+  BOB_CATCH_MEMBER("cannot reset the data source", 0)
+  Py_RETURN_NONE;
+}
+
+
+static PyMethodDef PyBobLearnEMFileListDataSource_methods[] = {
+  {
+    reset.name(),
+    (PyCFunction)PyBobLearnEMFileListDataSource_reset,
+    METH_NOARGS,
+    reset.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the FileListDataSource type struct; will be initialized later
+PyTypeObject PyBobLearnEMFileListDataSource_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobLearnEMFileListDataSource(PyObject* module)
+{
+  // initialize the type struct
+  PyBobLearnEMFileListDataSource_Type.tp_name = FileListDataSource_doc.name();
+  PyBobLearnEMFileListDataSource_Type.tp_basicsize = sizeof(PyBobLearnEMFileListDataSourceObject);
+  PyBobLearnEMFileListDataSource_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobLearnEMFileListDataSource_Type.tp_doc = FileListDataSource_doc.doc();
+
+  // set the functions
+  PyBobLearnEMFileListDataSource_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMFileListDataSource_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMFileListDataSource_init);
+  PyBobLearnEMFileListDataSource_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMFileListDataSource_delete);
+  PyBobLearnEMFileListDataSource_Type.tp_methods = PyBobLearnEMFileListDataSource_methods;
+  PyBobLearnEMFileListDataSource_Type.tp_getset = PyBobLearnEMFileListDataSource_getseters;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobLearnEMFileListDataSource_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobLearnEMFileListDataSource_Type);
+  return PyModule_AddObject(module, "FileListDataSource", (PyObject*)&PyBobLearnEMFileListDataSource_Type) >= 0;
+}
@@ -0,0 +1,229 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+# Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+# Mon Oct 19 09:12:41 2026 +0200
+#
+# Copyright (C) 2011-2015 Idiap Research Institute, Martigny, Switzerland
+import os
+import glob
+import time
+import shutil
+import tempfile
+import multiprocessing
+import bob.io.base
+import bob.learn.em
+import logging
+logger = logging.getLogger('bob.learn.em')
+
+# The files exchanged in the working directory:
+#  - machine_<iteration>.hdf5        the GMM broadcast by the coordinator
+#  - stats_<iteration>_<shard>.hdf5  the partial statistics of a worker
+#  - done                            written by the coordinator at the end
+# The coordinator removes them all when it starts, except for ``done`` which
+# it leaves at the end such that the workers terminate.
+
+
+def _machine_file(work_dir, iteration):
+  return os.path.join(work_dir, "machine_%d.hdf5" % iteration)
+
+def _stats_file(work_dir, iteration, shard):
+  return os.path.join(work_dir, "stats_%d_%d.hdf5" % (iteration, shard))
+
+def _done_file(work_dir):
+  return os.path.join(work_dir, "done")
+
+
+def _clean(work_dir):
+  # Removes the files of a previous training in this working directory
+  patterns = ["machine_*.hdf5*", "stats_*_*.hdf5*", "done"]
+  for pattern in patterns:
+    for filename in glob.glob(os.path.join(work_dir, pattern)):
+      os.unlink(filename)
+
+
+def _remove(filenames):
+  for filename in filenames:
+    if os.path.exists(filename):
+      os.unlink(filename)
+
+
+def _save_atomic(obj, filename):
+  # The file is only visible under its final name once it is complete
+  tmp = filename + ".tmp%d" % os.getpid()
+  obj.save(bob.io.base.HDF5File(tmp, 'w'))
+  os.rename(tmp, filename)
+
+
+def _wait_for(filenames, poll_interval, timeout):
+  start = time.time()
+  while True:
+    for filename in filenames:
+      if os.path.exists(filename):
+        return filename
+    if timeout is not None and time.time() - start > timeout:
+      raise RuntimeError("timed out while waiting for `%s'" % filenames[0])
+    time.sleep(poll_interval)
+
+
+def e_step_worker(work_dir, shard, data, poll_interval=0.1, timeout=None):
+  """
+  Runs the E-step of a distributed GMM training on one shard of the data
+
+  The worker waits for the :py:class:`bob.learn.em.GMMMachine` broadcast by the
+  coordinator (see :py:func:`train_distributed`) in ``work_dir``, accumulates the
+  :py:class:`bob.learn.em.GMMStats` of its shard and writes them back to ``work_dir``.
+  This is repeated for each iteration, until the coordinator terminates the training.
+  Workers may run on other machines, as long as ``work_dir`` is on a shared filesystem.
+
+  **Parameters**:
+    work_dir : str
+      The directory shared with the coordinator
+    shard : int
+      The index of the shard, in ``[0, n_shards[``
+    data : array_like <float, 2D> or str
+      The data of the shard, or the name of a file it is loaded from
+    poll_interval : float
+      The time (in seconds) between two checks of the working directory
+    timeout : float
+      The maximum time (in seconds) to wait for the coordinator. If None, waits forever
+  """
+  if isinstance(data, str):
+    data = bob.io.base.load(data)
+
+  iteration = 0
+  while True:
+    machine_file = _machine_file(work_dir, iteration)
+    if _wait_for([machine_file, _done_file(work_dir)], poll_interval, timeout) != machine_file:
+      return
+    machine = bob.learn.em.GMMMachine(bob.io.base.HDF5File(machine_file))
+    stats = bob.learn.em.GMMStats(machine.shape[0], machine.shape[1])
+    machine.acc_statistics(data, stats)
+    _save_atomic(stats, _stats_file(work_dir, iteration, shard))
+    iteration += 1
+
+
+def _distributed_e_step(trainer, machine, work_dir, n_shards, iteration, poll_interval, timeout):
+  # Broadcasts the machine and merges the partial statistics of the workers
+  _save_atomic(machine, _machine_file(work_dir, iteration))
+  filenames = [_stats_file(work_dir, iteration, s) for s in range(n_shards)]
+  for filename in filenames:
+    _wait_for([filename], poll_interval, timeout)
+  trainer.gmm_statistics = bob.learn.em.sum_gmm_stats(filenames, compensated=True)
+
+  # Files of the previous iteration are not needed anymore
+  if iteration > 0:
+    _remove([_machine_file(work_dir, iteration-1)] + [_stats_file(work_dir, iteration-1, s) for s in range(n_shards)])
+
+
+def train_distributed(trainer, machine, n_shards, work_dir, max_iterations=50, convergence_threshold=None, initialize=True, poll_interval=0.1, timeout=None):
+  """
+  Trains a :py:class:`bob.learn.em.GMMMachine` with its E-step distributed over several worker processes
+
+  This is the coordinator of the training: each of the ``n_shards`` workers runs
+  :py:func:`e_step_worker` on its part of the data. At each iteration, the
+  machine is broadcast to the workers through ``work_dir``, their partial
+  statistics are merged with :py:func:`bob.learn.em.sum_gmm_stats` and the
+  M-step is run on the merged statistics. The iterations are the same as in
+  :py:func:`bob.learn.em.train`.
+
+  The files of a previous training in ``work_dir`` are removed when this
+  function starts, so workers that reuse ``work_dir`` must be started after it.
+
+  **Parameters**:
+    trainer : :py:class:`ML_GMMTrainer` or :py:class:`MAP_GMMTrainer`
+      A trainer mechanism
+    machine : :py:class:`GMMMachine`
+      The machine to train
+    n_shards : int
+      The number of workers (shards of the data)
+    work_dir : str
+      A directory shared with the workers
+    max_iterations : int
+      The maximum number of iterations to train a machine
+    convergence_threshold : float
+      The convergence threshold to train a machine. If None, the training procedure will stop with the iterations criteria
+    initialize : bool
+      If True, runs the initialization procedure
+    poll_interval : float
+      The time (in seconds) between two checks of the working directory
+    timeout : float
+      The maximum time (in seconds) to wait for the workers. If None, waits forever
+  """
+  _clean(work_dir)
+  if initialize:
+    trainer.initialize(machine)
+
+  iteration = 0
+  try:
+    _distributed_e_step(trainer, machine, work_dir, n_shards, iteration, poll_interval, timeout)
+    average_output = trainer.compute_likelihood(machine)
+
+    for i in range(max_iterations):
+      logger.info("Iteration = %d/%d", i, max_iterations)
+      average_output_previous = average_output
+      trainer.m_step(machine)
+      iteration += 1
+      _distributed_e_step(trainer, machine, work_dir, n_shards, iteration, poll_interval, timeout)
+
+      average_output = trainer.compute_likelihood(machine)
+      logger.info("log likelihood = %f", average_output)
+
+      convergence_value = abs((average_output_previous - average_output)/average_output_previous)
+      logger.info("convergence value = %f",convergence_value)
+
+      #Terminates if converged
+      if convergence_threshold!=None and convergence_value <= convergence_threshold:
+        break
+
+  finally:
+    # Terminates the workers, and removes the files of the last iteration
+    open(_done_file(work_dir), 'w').close()
+    _remove([_machine_file(work_dir, iteration)] + [_stats_file(work_dir, iteration, s) for s in range(n_shards)])
+
+
+def train_local_distributed(trainer, machine, shards, work_dir=None, max_iterations=50, convergence_threshold=None, initialize=True, poll_interval=0.01, timeout=None):
+  """
+  Trains a :py:class:`bob.learn.em.GMMMachine` with one local worker process per shard of the data
+
+  This starts one process running :py:func:`e_step_worker` for each shard, and
+  runs :py:func:`train_distributed` as the coordinator.
+
+  **Parameters**:
+    trainer : :py:class:`ML_GMMTrainer` or :py:class:`MAP_GMMTrainer`
+      A trainer mechanism
+    machine : :py:class:`GMMMachine`
+      The machine to train
+    shards : [array_like <float, 2D> or str]
+      The data of each shard, or the names of the files they are loaded from
+    work_dir : str
+      The directory used to exchange the machines and the statistics. If None, a temporary directory is used
+    max_iterations : int
+      The maximum number of iterations to train a machine
+    convergence_threshold : float
+      The convergence threshold to train a machine. If None, the training procedure will stop with the iterations criteria
+    initialize : bool
+      If True, runs the initialization procedure
+    poll_interval : float
+      The time (in seconds) between two checks of the working directory
+    timeout : float
+      The maximum time (in seconds) to wait for a process. If None, waits forever
+  """
+  temporary = work_dir is None
+  if temporary:
+    work_dir = tempfile.mkdtemp(prefix="bob.learn.em.")
+  else:
+    # The workers would otherwise see the files of a previous training
+    _clean(work_dir)
+
+  workers = [multiprocessing.Process(target=e_step_worker, args=(work_dir, s, shards[s], poll_interval, timeout)) for s in range(len(shards))]
+  for worker in workers:
+    worker.start()
+  try:
+    train_distributed(trainer, machine, len(shards), work_dir, max_iterations, convergence_threshold, initialize, poll_interval, timeout)
+  finally:
+    for worker in workers:
+      worker.join(timeout)
+      if worker.is_alive():
+        worker.terminate()
+    if temporary:
+      shutil.rmtree(work_dir)
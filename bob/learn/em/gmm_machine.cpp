@@ -639,6 +639,43 @@ static PyObject* PyBobLearnEMGMMMachine_resize(PyBobLearnEMGMMMachineObject* sel
 }
 
 
+/*** split ***/
+static auto split = bob::extension::FunctionDoc(
+  "split",
+  "Splits Gaussian components in two, as in the binary splitting training of UBMs",
+  "The two halves of a split component share its variances and half of its weight, "
+  "and their means are moved by +/- ``epsilon`` standard deviations along the dimension of largest variance. "
+  "The components with the largest weights are split first; the new components are appended after the existing ones.",
+  true
+)
+.add_prototype("n_splits,[epsilon]")
+.add_parameter("n_splits", "int", "The number of components to split, at most the number of components")
+.add_parameter("epsilon", "float", "[Default: ``0.2``] The displacement of the means, in standard deviations");
+static PyObject* PyBobLearnEMGMMMachine_split(PyBobLearnEMGMMMachineObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = split.kwlist(0);
+
+  int n_splits = 0;
+  double epsilon = 0.2;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|d", kwlist, &n_splits, &epsilon)) return 0;
+
+  if (n_splits < 0){
+    PyErr_Format(PyExc_TypeError, "n_splits must be greater than or equal to zero");
+    split.print_usage();
+    return 0;
+  }
+
+  self->cxx->split(n_splits, epsilon);
+
+  BOB_CATCH_MEMBER("cannot perform the split method", 0)
+
+  Py_RETURN_NONE;
+}
+
+
 /*** log_likelihood ***/
 static auto log_likelihood = bob::extension::FunctionDoc(
   "log_likelihood",
@@ -907,6 +944,12 @@ static PyMethodDef PyBobLearnEMGMMMachine_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     resize.doc()
   },
+  {
+    split.name(),
+    (PyCFunction)PyBobLearnEMGMMMachine_split,
+    METH_VARARGS|METH_KEYWORDS,
+    split.doc()
+  },
   {
     log_likelihood.name(),
     (PyCFunction)PyBobLearnEMGMMMachine_loglikelihood,
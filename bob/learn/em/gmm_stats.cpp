@@ -27,26 +27,30 @@ static auto GMMStats_doc = bob::extension::ClassDoc(
     "",
     true
   )
-  .add_prototype("n_gaussians,n_inputs","")
+  .add_prototype("n_gaussians,n_inputs,[second_order]","")
   .add_prototype("other","")
   .add_prototype("hdf5","")
   .add_prototype("","")
 
   .add_parameter("n_gaussians", "int", "Number of gaussians")
   .add_parameter("n_inputs", "int", "Dimension of the feature vector")
+  .add_parameter("second_order", "bool", "[Default: ``True``] Allocate and accumulate the second order statistics :py:attr:`sum_pxx`. First order only statistics are sufficient for i-vector extraction, ISV/JFA enrollment and linear scoring.")
   .add_parameter("other", ":py:class:`bob.learn.em.GMMStats`", "A GMMStats object to be copied.")
   .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading")
 
 );
 
 
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}  /* converts PyObject to bool and returns false if object is NULL */
+
 static int PyBobLearnEMGMMStats_init_number(PyBobLearnEMGMMStatsObject* self, PyObject* args, PyObject* kwargs) {
 
   char** kwlist = GMMStats_doc.kwlist(0);
   int n_inputs    = 1;
   int n_gaussians = 1;
+  PyObject* second_order = Py_True;
   //Parsing the input argments
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ii", kwlist, &n_gaussians, &n_inputs))
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ii|O!", kwlist, &n_gaussians, &n_inputs, &PyBool_Type, &second_order))
     return -1;
 
   if(n_gaussians < 0){
@@ -61,7 +65,7 @@ static int PyBobLearnEMGMMStats_init_number(PyBobLearnEMGMMStatsObject* self, Py
     return -1;
    }
 
-  self->cxx.reset(new bob::learn::em::GMMStats(n_gaussians, n_inputs));
+  self->cxx.reset(new bob::learn::em::GMMStats(n_gaussians, n_inputs, f(second_order)));
   return 0;
 }
 
@@ -128,9 +132,10 @@ static int PyBobLearnEMGMMStats_init(PyBobLearnEMGMMStatsObject* self, PyObject*
        return PyBobLearnEMGMMStats_init_hdf5(self, args, kwargs);
     }
     case 2:
+    case 3:
       return PyBobLearnEMGMMStats_init_number(self, args, kwargs);
     default:
-      PyErr_Format(PyExc_RuntimeError, "number of arguments mismatch - %s requires 0, 1 or 2 arguments, but you provided %d (see help)", Py_TYPE(self)->tp_name, nargs);
+      PyErr_Format(PyExc_RuntimeError, "number of arguments mismatch - %s requires 0, 1, 2 or 3 arguments, but you provided %d (see help)", Py_TYPE(self)->tp_name, nargs);
       GMMStats_doc.print_usage();
       return -1;
   }
@@ -266,7 +271,8 @@ int PyBobLearnEMGMMStats_setSum_px(PyBobLearnEMGMMStatsObject* self, PyObject* v
 static auto sum_pxx = bob::extension::VariableDoc(
   "sum_pxx",
   "array_like <float, 2D>",
-  "For each Gaussian, the accumulated sum of responsibility times the sample squared"
+  "For each Gaussian, the accumulated sum of responsibility times the sample squared",
+  "This array is empty if the statistics are first order only (see :py:attr:`has_second_order`)."
 );
 PyObject* PyBobLearnEMGMMStats_getSum_pxx(PyBobLearnEMGMMStatsObject* self, void*){
   BOB_TRY
@@ -293,6 +299,11 @@ int PyBobLearnEMGMMStats_setSum_pxx(PyBobLearnEMGMMStatsObject* self, PyObject*
     return -1;
   }
 
+  if (!self->cxx->hasSecondOrder()){
+    PyErr_Format(PyExc_RuntimeError, "`%s' holds first order statistics only, `%s` cannot be set", Py_TYPE(self)->tp_name, sum_pxx.name());
+    return -1;
+  }
+
   if (input->shape[1] != (Py_ssize_t)self->cxx->sumPxx.extent(1) && input->shape[0] != (Py_ssize_t)self->cxx->sumPxx.extent(0)) {
     PyErr_Format(PyExc_TypeError, "`%s' 2D `input` array should have the shape [%" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d] not [%" PY_FORMAT_SIZE_T "d, %" PY_FORMAT_SIZE_T "d] for `%s`", Py_TYPE(self)->tp_name, (Py_ssize_t)self->cxx->sumPxx.extent(1), (Py_ssize_t)self->cxx->sumPxx.extent(0), (Py_ssize_t)input->shape[1], (Py_ssize_t)input->shape[0], sum_pxx.name());
     return -1;
@@ -361,6 +372,20 @@ int PyBobLearnEMGMMStats_setLog_likelihood(PyBobLearnEMGMMStatsObject* self, PyO
 }
 
 
+/***** has_second_order *****/
+static auto has_second_order = bob::extension::VariableDoc(
+  "has_second_order",
+  "bool",
+  "Tells if the second order statistics :py:attr:`sum_pxx` are allocated and accumulated",
+  ""
+);
+PyObject* PyBobLearnEMGMMStats_getHasSecondOrder(PyBobLearnEMGMMStatsObject* self, void*) {
+  BOB_TRY
+  if (self->cxx->hasSecondOrder()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("has_second_order could not be read", 0)
+}
+
+
 /***** shape *****/
 static auto shape = bob::extension::VariableDoc(
   "shape",
@@ -419,6 +444,13 @@ static PyGetSetDef PyBobLearnEMGMMStats_getseters[] = {
    shape.doc(),
    0
   },
+  {
+   has_second_order.name(),
+   (getter)PyBobLearnEMGMMStats_getHasSecondOrder,
+   0,
+   has_second_order.doc(),
+   0
+  },
 
 
   {0}  // Sentinel
@@ -521,9 +553,10 @@ static auto resize = bob::extension::FunctionDoc(
   0,
   true
 )
-.add_prototype("n_gaussians,n_inputs")
+.add_prototype("n_gaussians,n_inputs,[second_order]")
 .add_parameter("n_gaussians", "int", "Number of gaussians")
-.add_parameter("n_inputs", "int", "Dimensionality of the feature vector");
+.add_parameter("n_inputs", "int", "Dimensionality of the feature vector")
+.add_parameter("second_order", "bool", "[Default: ``True``] Allocate the second order statistics");
 static PyObject* PyBobLearnEMGMMStats_resize(PyBobLearnEMGMMStatsObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
@@ -532,8 +565,9 @@ static PyObject* PyBobLearnEMGMMStats_resize(PyBobLearnEMGMMStatsObject* self, P
 
   int n_gaussians = 0;
   int n_inputs = 0;
+  PyObject* second_order = Py_True;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ii", kwlist, &n_gaussians, &n_inputs)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ii|O!", kwlist, &n_gaussians, &n_inputs, &PyBool_Type, &second_order)) return 0;
 
   if (n_gaussians <= 0){
     PyErr_Format(PyExc_TypeError, "n_gaussians must be greater than zero");
@@ -547,7 +581,7 @@ static PyObject* PyBobLearnEMGMMStats_resize(PyBobLearnEMGMMStatsObject* self, P
   }
 
 
-  self->cxx->resize(n_gaussians, n_inputs);
+  self->cxx->resize(n_gaussians, n_inputs, f(second_order));
 
   BOB_CATCH_MEMBER("cannot perform the resize method", 0)
 
@@ -0,0 +1,341 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/* converts PyObject to bool and returns false if object is NULL */
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}
+
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto GMMStatsAccumulator_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".GMMStatsAccumulator",
+  "Accumulates the GMM statistics of an ordered list of samples, with periodic checkpoints",
+  "Every ``checkpoint_interval`` samples, the partial statistics are saved to an HDF5 file together with "
+  "the number of samples processed so far (:py:attr:`cursor`). A job that was killed can be restarted "
+  "with the same list of samples: after :py:meth:`resume`, the first :py:attr:`cursor` samples must be "
+  "skipped, and the accumulation continues exactly from the last checkpoint.\n\n"
+  ".. code-block:: python\n\n"
+  "   acc = bob.learn.em.GMMStatsAccumulator(ubm, 'stats.ckpt.hdf5', 100)\n"
+  "   for filename in filenames[acc.resume():]:\n"
+  "     acc.accumulate(bob.io.base.load(filename))\n"
+  "   acc.checkpoint()\n"
+  "   stats = acc.stats\n"
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an accumulator of GMM statistics",
+    "",
+    true
+  )
+  .add_prototype("machine,checkpoint,[checkpoint_interval],[second_order]","")
+  .add_parameter("machine", ":py:class:`bob.learn.em.GMMMachine`", "The GMM used to compute the statistics")
+  .add_parameter("checkpoint", "str", "The name of the HDF5 checkpoint file")
+  .add_parameter("checkpoint_interval", "int", "[Default: ``1``] The number of samples between two checkpoints")
+  .add_parameter("second_order", "bool", "[Default: ``True``] Accumulate the second order statistics")
+);
+
+
+static int PyBobLearnEMGMMStatsAccumulator_init(PyBobLearnEMGMMStatsAccumulatorObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = GMMStatsAccumulator_doc.kwlist(0);
+
+  PyBobLearnEMGMMMachineObject* machine = 0;
+  const char* checkpoint = 0;
+  int checkpoint_interval = 1;
+  PyObject* second_order = Py_True;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!s|iO!", kwlist, &PyBobLearnEMGMMMachine_Type, &machine,
+                                                                   &checkpoint, &checkpoint_interval,
+                                                                   &PyBool_Type, &second_order)){
+    GMMStatsAccumulator_doc.print_usage();
+    return -1;
+  }
+
+  if (checkpoint_interval <= 0){
+    PyErr_Format(PyExc_TypeError, "checkpoint_interval must be greater than zero");
+    GMMStatsAccumulator_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::learn::em::GMMStatsAccumulator(machine->cxx, checkpoint, checkpoint_interval, f(second_order)));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create GMMStatsAccumulator", -1)
+}
+
+
+static void PyBobLearnEMGMMStatsAccumulator_delete(PyBobLearnEMGMMStatsAccumulatorObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobLearnEMGMMStatsAccumulator_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMGMMStatsAccumulator_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+/***** cursor *****/
+static auto cursor = bob::extension::VariableDoc(
+  "cursor",
+  "int",
+  "The number of samples processed so far",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsAccumulator_getCursor(PyBobLearnEMGMMStatsAccumulatorObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getCursor());
+  BOB_CATCH_MEMBER("cursor could not be read", 0)
+}
+
+
+/***** stats *****/
+static auto stats = bob::extension::VariableDoc(
+  "stats",
+  ":py:class:`bob.learn.em.GMMStats`",
+  "A copy of the statistics accumulated so far",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsAccumulator_getStats(PyBobLearnEMGMMStatsAccumulatorObject* self, void*){
+  BOB_TRY
+
+  //Allocating the correspondent python object
+  PyBobLearnEMGMMStatsObject* retval =
+    (PyBobLearnEMGMMStatsObject*)PyBobLearnEMGMMStats_Type.tp_alloc(&PyBobLearnEMGMMStats_Type, 0);
+  retval->cxx.reset(new bob::learn::em::GMMStats(self->cxx->getStats()));
+
+  return Py_BuildValue("N",retval);
+  BOB_CATCH_MEMBER("stats could not be read", 0)
+}
+
+
+/***** checkpoint_interval *****/
+static auto checkpoint_interval = bob::extension::VariableDoc(
+  "checkpoint_interval",
+  "int",
+  "The number of samples between two checkpoints",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsAccumulator_getCheckpointInterval(PyBobLearnEMGMMStatsAccumulatorObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getCheckpointInterval());
+  BOB_CATCH_MEMBER("checkpoint_interval could not be read", 0)
+}
+int PyBobLearnEMGMMStatsAccumulator_setCheckpointInterval(PyBobLearnEMGMMStatsAccumulatorObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyInt_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an int", Py_TYPE(self)->tp_name, checkpoint_interval.name());
+    return -1;
+  }
+
+  if (PyInt_AS_LONG(value) <= 0){
+    PyErr_Format(PyExc_TypeError, "checkpoint_interval must be greater than zero");
+    return -1;
+  }
+
+  self->cxx->setCheckpointInterval(PyInt_AS_LONG(value));
+  return 0;
+  BOB_CATCH_MEMBER("checkpoint_interval could not be set", -1)
+}
+
+
+static PyGetSetDef PyBobLearnEMGMMStatsAccumulator_getseters[] = {
+  {
+    cursor.name(),
+    (getter)PyBobLearnEMGMMStatsAccumulator_getCursor,
+    0,
+    cursor.doc(),
+    0
+  },
+  {
+    stats.name(),
+    (getter)PyBobLearnEMGMMStatsAccumulator_getStats,
+    0,
+    stats.doc(),
+    0
+  },
+  {
+    checkpoint_interval.name(),
+    (getter)PyBobLearnEMGMMStatsAccumulator_getCheckpointInterval,
+    (setter)PyBobLearnEMGMMStatsAccumulator_setCheckpointInterval,
+    checkpoint_interval.doc(),
+    0
+  },
+  {0}  // Sentinel
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+/*** resume ***/
+static auto resume = bob::extension::FunctionDoc(
+  "resume",
+  "Loads the last checkpoint, if any",
+  "",
+  true
+)
+.add_prototype("","cursor")
+.add_return("cursor","int","The number of samples that were already processed, i.e., the position of the next sample to accumulate");
+static PyObject* PyBobLearnEMGMMStatsAccumulator_resume(PyBobLearnEMGMMStatsAccumulatorObject* self) {
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->resume());
+  BOB_CATCH_MEMBER("cannot resume from the checkpoint", 0)
+}
+
+
+/*** accumulate ***/
+static auto accumulate = bob::extension::FunctionDoc(
+  "accumulate",
+  "Adds the statistics of the next sample, and saves a checkpoint if required",
+  "",
+  true
+)
+.add_prototype("input")
+.add_parameter("input", "array_like <float, 2D>", "The feature vectors of the sample, one per row");
+static PyObject* PyBobLearnEMGMMStatsAccumulator_accumulate(PyBobLearnEMGMMStatsAccumulatorObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = accumulate.kwlist(0);
+
+  PyBlitzArrayObject* input = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBlitzArray_Converter, &input)) return 0;
+  auto input_ = make_safe(input);
+
+  if (input->type_num != NPY_FLOAT64 || input->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays of float64", Py_TYPE(self)->tp_name);
+    accumulate.print_usage();
+    return 0;
+  }
+
+  self->cxx->accumulate(*PyBlitzArrayCxx_AsBlitz<double,2>(input));
+
+  BOB_CATCH_MEMBER("cannot accumulate the statistics", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** skip ***/
+static auto skip = bob::extension::FunctionDoc(
+  "skip",
+  "Skips the next sample (e.g. a missing feature file), and saves a checkpoint if required"
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMGMMStatsAccumulator_skip(PyBobLearnEMGMMStatsAccumulatorObject* self) {
+  BOB_TRY
+  self->cxx->skip();
+  BOB_CATCH_MEMBER("cannot skip the sample", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** checkpoint ***/
+static auto checkpoint = bob::extension::FunctionDoc(
+  "checkpoint",
+  "Saves a checkpoint now"
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMGMMStatsAccumulator_checkpoint(PyBobLearnEMGMMStatsAccumulatorObject* self) {
+  BOB_TRY
+  self->cxx->checkpoint();
+  BOB_CATCH_MEMBER("cannot save the checkpoint", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** reset ***/
+static auto reset = bob::extension::FunctionDoc(
+  "reset",
+  "Resets the statistics and the cursor"
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMGMMStatsAccumulator_reset(PyBobLearnEMGMMStatsAccumulatorObject* self) {
+  BOB_TRY
+  self->cxx->reset();
+  BOB_CATCH_MEMBER("cannot reset the accumulator", 0)
+  Py_RETURN_NONE;
+}
+
+
+static PyMethodDef PyBobLearnEMGMMStatsAccumulator_methods[] = {
+  {
+    resume.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsAccumulator_resume,
+    METH_NOARGS,
+    resume.doc()
+  },
+  {
+    accumulate.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsAccumulator_accumulate,
+    METH_VARARGS|METH_KEYWORDS,
+    accumulate.doc()
+  },
+  {
+    skip.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsAccumulator_skip,
+    METH_NOARGS,
+    skip.doc()
+  },
+  {
+    checkpoint.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsAccumulator_checkpoint,
+    METH_NOARGS,
+    checkpoint.doc()
+  },
+  {
+    reset.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsAccumulator_reset,
+    METH_NOARGS,
+    reset.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the GMMStatsAccumulator type struct; will be initialized later
+PyTypeObject PyBobLearnEMGMMStatsAccumulator_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobLearnEMGMMStatsAccumulator(PyObject* module)
+{
+  // initialize the type struct
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_name = GMMStatsAccumulator_doc.name();
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_basicsize = sizeof(PyBobLearnEMGMMStatsAccumulatorObject);
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_doc = GMMStatsAccumulator_doc.doc();
+
+  // set the functions
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMGMMStatsAccumulator_init);
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMGMMStatsAccumulator_delete);
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_methods = PyBobLearnEMGMMStatsAccumulator_methods;
+  PyBobLearnEMGMMStatsAccumulator_Type.tp_getset = PyBobLearnEMGMMStatsAccumulator_getseters;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobLearnEMGMMStatsAccumulator_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobLearnEMGMMStatsAccumulator_Type);
+  return PyModule_AddObject(module, "GMMStatsAccumulator", (PyObject*)&PyBobLearnEMGMMStatsAccumulator_Type) >= 0;
+}
@@ -0,0 +1,699 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/* converts PyObject to bool and returns false if object is NULL */
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}
+
+
+/******************************************************************/
+/************ GMMStatsArchiveWriter *******************************/
+/******************************************************************/
+
+static auto GMMStatsArchiveWriter_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".GMMStatsArchiveWriter",
+  "Writes many :py:class:`bob.learn.em.GMMStats` into a single indexed archive file",
+  "The records are appended one by one to the end of the file, each with a unique key "
+  "(e.g. the name of the utterance). An archive being written can be read at the same "
+  "time with :py:class:`bob.learn.em.GMMStatsArchive` (see :py:meth:`bob.learn.em.GMMStatsArchive.refresh`)."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a new archive, or opens an existing one to append records to it",
+    "When only the file name is given, the existing archive is opened and the records are appended to it. "
+    "Otherwise, a new archive is created, overwriting any existing file.",
+    true
+  )
+  .add_prototype("filename,n_gaussians,n_inputs,[second_order]","")
+  .add_prototype("filename","")
+
+  .add_parameter("filename", "str", "The name of the archive file")
+  .add_parameter("n_gaussians", "int", "Number of gaussians")
+  .add_parameter("n_inputs", "int", "Dimension of the feature vector")
+  .add_parameter("second_order", "bool", "[Default: ``True``] Store the second order statistics")
+);
+
+
+static int PyBobLearnEMGMMStatsArchiveWriter_init(PyBobLearnEMGMMStatsArchiveWriterObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  // get the number of command line arguments
+  int nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  if (nargs == 1){
+    char** kwlist = GMMStatsArchiveWriter_doc.kwlist(1);
+    const char* filename = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &filename)){
+      GMMStatsArchiveWriter_doc.print_usage();
+      return -1;
+    }
+    self->cxx.reset(new bob::learn::em::GMMStatsArchiveWriter(filename));
+    return 0;
+  }
+
+  char** kwlist = GMMStatsArchiveWriter_doc.kwlist(0);
+  const char* filename = 0;
+  int n_gaussians = 0;
+  int n_inputs = 0;
+  PyObject* second_order = Py_True;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sii|O!", kwlist, &filename, &n_gaussians, &n_inputs, &PyBool_Type, &second_order)){
+    GMMStatsArchiveWriter_doc.print_usage();
+    return -1;
+  }
+
+  if (n_gaussians < 0 || n_inputs < 0){
+    PyErr_Format(PyExc_TypeError, "n_gaussians and n_inputs must be greater than or equal to zero");
+    GMMStatsArchiveWriter_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::learn::em::GMMStatsArchiveWriter(filename, n_gaussians, n_inputs, f(second_order)));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create GMMStatsArchiveWriter", -1)
+}
+
+
+static void PyBobLearnEMGMMStatsArchiveWriter_delete(PyBobLearnEMGMMStatsArchiveWriterObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobLearnEMGMMStatsArchiveWriter_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMGMMStatsArchiveWriter_Type));
+}
+
+static Py_ssize_t PyBobLearnEMGMMStatsArchiveWriter_len(PyBobLearnEMGMMStatsArchiveWriterObject* self) {
+  return self->cxx->size();
+}
+
+
+/***** shape *****/
+static auto writer_shape = bob::extension::VariableDoc(
+  "shape",
+  "(int,int,int)",
+  "A tuple that represents the number of records, the number of gaussians and dimensionality of each Gaussian ``(n_records, n_gaussians, dim)``.",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsArchiveWriter_getShape(PyBobLearnEMGMMStatsArchiveWriterObject* self, void*) {
+  BOB_TRY
+  return Py_BuildValue("(i,i,i)", self->cxx->size(), self->cxx->getNGaussians(), self->cxx->getNInputs());
+  BOB_CATCH_MEMBER("shape could not be read", 0)
+}
+
+static PyGetSetDef PyBobLearnEMGMMStatsArchiveWriter_getseters[] = {
+  {
+    writer_shape.name(),
+    (getter)PyBobLearnEMGMMStatsArchiveWriter_getShape,
+    0,
+    writer_shape.doc(),
+    0
+  },
+  {0}  // Sentinel
+};
+
+
+/*** append ***/
+static auto writer_append = bob::extension::FunctionDoc(
+  "append",
+  "Appends the given statistics at the end of the archive",
+  0,
+  true
+)
+.add_prototype("key,stats")
+.add_parameter("key", "str", "A unique key of at most 255 characters")
+.add_parameter("stats", ":py:class:`bob.learn.em.GMMStats`", "The statistics, with the shape of the archive");
+static PyObject* PyBobLearnEMGMMStatsArchiveWriter_append(PyBobLearnEMGMMStatsArchiveWriterObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = writer_append.kwlist(0);
+
+  const char* key = 0;
+  PyBobLearnEMGMMStatsObject* stats = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO!", kwlist, &key, &PyBobLearnEMGMMStats_Type, &stats)) return 0;
+
+  self->cxx->append(key, *stats->cxx);
+
+  BOB_CATCH_MEMBER("cannot append the statistics", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** flush ***/
+static auto writer_flush = bob::extension::FunctionDoc(
+  "flush",
+  "Flushes the records appended so far to the file"
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMGMMStatsArchiveWriter_flush(PyBobLearnEMGMMStatsArchiveWriterObject* self) {
+  BOB_TRY
+  self->cxx->flush();
+  BOB_CATCH_MEMBER("cannot flush the archive", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** close ***/
+static auto writer_close = bob::extension::FunctionDoc(
+  "close",
+  "Flushes and closes the archive; no record can be appended afterwards"
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMGMMStatsArchiveWriter_close(PyBobLearnEMGMMStatsArchiveWriterObject* self) {
+  BOB_TRY
+  self->cxx->close();
+  BOB_CATCH_MEMBER("cannot close the archive", 0)
+  Py_RETURN_NONE;
+}
+
+
+static PyMethodDef PyBobLearnEMGMMStatsArchiveWriter_methods[] = {
+  {
+    writer_append.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchiveWriter_append,
+    METH_VARARGS|METH_KEYWORDS,
+    writer_append.doc()
+  },
+  {
+    writer_flush.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchiveWriter_flush,
+    METH_NOARGS,
+    writer_flush.doc()
+  },
+  {
+    writer_close.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchiveWriter_close,
+    METH_NOARGS,
+    writer_close.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ GMMStatsArchive *************************************/
+/******************************************************************/
+
+static auto GMMStatsArchive_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".GMMStatsArchive",
+  "Memory-mapped, read-only access to an archive written by :py:class:`bob.learn.em.GMMStatsArchiveWriter`",
+  "The records can be accessed by position or by key. "
+  "The arrays :py:attr:`n`, :py:attr:`sum_px` and :py:attr:`sum_pxx` are read-only views on the mapped file: "
+  "no data is copied, and only the pages that are accessed are read from the disk."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Maps the given archive",
+    "",
+    true
+  )
+  .add_prototype("filename","")
+  .add_parameter("filename", "str", "The name of the archive file")
+);
+
+
+static int PyBobLearnEMGMMStatsArchive_init(PyBobLearnEMGMMStatsArchiveObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = GMMStatsArchive_doc.kwlist(0);
+  const char* filename = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &filename)){
+    GMMStatsArchive_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::learn::em::GMMStatsArchive(filename));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create GMMStatsArchive", -1)
+}
+
+
+static void PyBobLearnEMGMMStatsArchive_delete(PyBobLearnEMGMMStatsArchiveObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobLearnEMGMMStatsArchive_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMGMMStatsArchive_Type));
+}
+
+static Py_ssize_t PyBobLearnEMGMMStatsArchive_len(PyBobLearnEMGMMStatsArchiveObject* self) {
+  return self->cxx->size();
+}
+
+
+/* keeps the mapping alive as long as a numpy view on it exists */
+static void PyBobLearnEMGMMStatsArchive_release(PyObject* capsule) {
+  delete reinterpret_cast<boost::shared_ptr<bob::learn::em::GMMStatsArchive>*>(PyCapsule_GetPointer(capsule, 0));
+}
+
+/* wraps a view on the mapped file into a read-only numpy array */
+template <int N>
+static PyObject* PyBobLearnEMGMMStatsArchive_view(PyBobLearnEMGMMStatsArchiveObject* self, const blitz::Array<double,N>& view) {
+  npy_intp dims[N], strides[N];
+  for (int k=0; k<N; ++k){
+    dims[k] = view.extent(k);
+    strides[k] = view.stride(k) * sizeof(double);
+  }
+  if (view.numElements() == 0)
+    return PyArray_SimpleNew(N, dims, NPY_FLOAT64);
+
+  PyObject* retval = PyArray_New(&PyArray_Type, N, dims, NPY_FLOAT64, strides,
+    const_cast<double*>(view.data()), 0, NPY_ARRAY_ALIGNED, 0);
+  if (!retval) return 0;
+
+  PyObject* owner = PyCapsule_New(new boost::shared_ptr<bob::learn::em::GMMStatsArchive>(self->cxx), 0, PyBobLearnEMGMMStatsArchive_release);
+  if (!owner || PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(retval), owner) < 0){
+    Py_XDECREF(owner);
+    Py_DECREF(retval);
+    return 0;
+  }
+  return retval;
+}
+
+
+/***** shape *****/
+static auto shape = bob::extension::VariableDoc(
+  "shape",
+  "(int,int,int)",
+  "A tuple that represents the number of records, the number of gaussians and dimensionality of each Gaussian ``(n_records, n_gaussians, dim)``.",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getShape(PyBobLearnEMGMMStatsArchiveObject* self, void*) {
+  BOB_TRY
+  return Py_BuildValue("(i,i,i)", self->cxx->size(), self->cxx->getNGaussians(), self->cxx->getNInputs());
+  BOB_CATCH_MEMBER("shape could not be read", 0)
+}
+
+
+/***** has_second_order *****/
+static auto has_second_order = bob::extension::VariableDoc(
+  "has_second_order",
+  "bool",
+  "Tells if the archive contains the second order statistics :py:attr:`sum_pxx`",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getHasSecondOrder(PyBobLearnEMGMMStatsArchiveObject* self, void*) {
+  BOB_TRY
+  if (self->cxx->hasSecondOrder()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("has_second_order could not be read", 0)
+}
+
+
+/***** keys *****/
+static auto keys = bob::extension::VariableDoc(
+  "keys",
+  "[str]",
+  "The keys of the records, in order",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getKeys(PyBobLearnEMGMMStatsArchiveObject* self, void*) {
+  BOB_TRY
+  const std::vector<std::string>& keys = self->cxx->getKeys();
+  PyObject* retval = PyList_New(keys.size());
+  if (!retval) return 0;
+  for (size_t i=0; i<keys.size(); ++i)
+    PyList_SET_ITEM(retval, i, Py_BuildValue("s", keys[i].c_str()));
+  return retval;
+  BOB_CATCH_MEMBER("keys could not be read", 0)
+}
+
+
+/***** t *****/
+static auto t = bob::extension::VariableDoc(
+  "t",
+  "array_like <uint64, 1D>",
+  "For each record, the number of frames"
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getT(PyBobLearnEMGMMStatsArchiveObject* self, void*){
+  BOB_TRY
+  blitz::Array<uint64_t,1> T(self->cxx->size());
+  for (int i=0; i<T.extent(0); ++i)
+    T(i) = self->cxx->getT(i);
+  return PyBlitzArrayCxx_AsNumpy(T);
+  BOB_CATCH_MEMBER("t could not be read", 0)
+}
+
+
+/***** log_likelihood *****/
+static auto log_likelihood = bob::extension::VariableDoc(
+  "log_likelihood",
+  "array_like <float, 1D>",
+  "For each record, the accumulated log likelihood of all frames"
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getLog_likelihood(PyBobLearnEMGMMStatsArchiveObject* self, void*){
+  BOB_TRY
+  blitz::Array<double,1> log_likelihood(self->cxx->size());
+  for (int i=0; i<log_likelihood.extent(0); ++i)
+    log_likelihood(i) = self->cxx->getLogLikelihood(i);
+  return PyBlitzArrayCxx_AsNumpy(log_likelihood);
+  BOB_CATCH_MEMBER("log_likelihood could not be read", 0)
+}
+
+
+/***** n *****/
+static auto n = bob::extension::VariableDoc(
+  "n",
+  "array_like <float, 2D>",
+  "For each record and each Gaussian, the accumulated sum of responsibilities ``(n_records, n_gaussians)``",
+  "This is a read-only view on the mapped file."
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getN(PyBobLearnEMGMMStatsArchiveObject* self, void*){
+  BOB_TRY
+  return PyBobLearnEMGMMStatsArchive_view(self, self->cxx->getN());
+  BOB_CATCH_MEMBER("n could not be read", 0)
+}
+
+
+/***** sum_px *****/
+static auto sum_px = bob::extension::VariableDoc(
+  "sum_px",
+  "array_like <float, 3D>",
+  "For each record and each Gaussian, the accumulated sum of responsibility times the frame ``(n_records, n_gaussians, n_inputs)``",
+  "This is a read-only view on the mapped file."
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getSum_px(PyBobLearnEMGMMStatsArchiveObject* self, void*){
+  BOB_TRY
+  return PyBobLearnEMGMMStatsArchive_view(self, self->cxx->getSumPx());
+  BOB_CATCH_MEMBER("sum_px could not be read", 0)
+}
+
+
+/***** sum_pxx *****/
+static auto sum_pxx = bob::extension::VariableDoc(
+  "sum_pxx",
+  "array_like <float, 3D>",
+  "For each record and each Gaussian, the accumulated sum of responsibility times the frame squared ``(n_records, n_gaussians, n_inputs)``",
+  "This is a read-only view on the mapped file. It is only available if :py:attr:`has_second_order` is ``True``."
+);
+PyObject* PyBobLearnEMGMMStatsArchive_getSum_pxx(PyBobLearnEMGMMStatsArchiveObject* self, void*){
+  BOB_TRY
+  return PyBobLearnEMGMMStatsArchive_view(self, self->cxx->getSumPxx());
+  BOB_CATCH_MEMBER("sum_pxx could not be read", 0)
+}
+
+
+static PyGetSetDef PyBobLearnEMGMMStatsArchive_getseters[] = {
+  {
+    shape.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getShape,
+    0,
+    shape.doc(),
+    0
+  },
+  {
+    has_second_order.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getHasSecondOrder,
+    0,
+    has_second_order.doc(),
+    0
+  },
+  {
+    keys.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getKeys,
+    0,
+    keys.doc(),
+    0
+  },
+  {
+    t.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getT,
+    0,
+    t.doc(),
+    0
+  },
+  {
+    log_likelihood.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getLog_likelihood,
+    0,
+    log_likelihood.doc(),
+    0
+  },
+  {
+    n.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getN,
+    0,
+    n.doc(),
+    0
+  },
+  {
+    sum_px.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getSum_px,
+    0,
+    sum_px.doc(),
+    0
+  },
+  {
+    sum_pxx.name(),
+    (getter)PyBobLearnEMGMMStatsArchive_getSum_pxx,
+    0,
+    sum_pxx.doc(),
+    0
+  },
+  {0}  // Sentinel
+};
+
+
+/*** get_stats ***/
+static auto get_stats = bob::extension::FunctionDoc(
+  "get_stats",
+  "Returns a copy of a record",
+  0,
+  true
+)
+.add_prototype("key","stats")
+.add_parameter("key", "str or int", "The key or the position of the record")
+.add_return("stats",":py:class:`bob.learn.em.GMMStats`","The statistics of the record");
+static PyObject* PyBobLearnEMGMMStatsArchive_get_stats(PyBobLearnEMGMMStatsArchiveObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = get_stats.kwlist(0);
+
+  PyObject* key = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &key)) return 0;
+
+  boost::shared_ptr<bob::learn::em::GMMStats> stats;
+  if (PyString_Check(key))
+    stats = self->cxx->getStats(std::string(PyString_AS_STRING(key)));
+  else if (PyIndex_Check(key)){
+    Py_ssize_t i = PyNumber_AsSsize_t(key, PyExc_IndexError);
+    if (i == -1 && PyErr_Occurred()) return 0;
+    if (i < 0){
+      PyErr_Format(PyExc_TypeError, "the position must be greater than or equal to zero");
+      get_stats.print_usage();
+      return 0;
+    }
+    stats = self->cxx->getStats((size_t)i);
+  }
+  else{
+    PyErr_Format(PyExc_TypeError, "the key must be a string or an integer");
+    get_stats.print_usage();
+    return 0;
+  }
+
+  //Allocating the correspondent python object
+  PyBobLearnEMGMMStatsObject* retval =
+    (PyBobLearnEMGMMStatsObject*)PyBobLearnEMGMMStats_Type.tp_alloc(&PyBobLearnEMGMMStats_Type, 0);
+  retval->cxx = stats;
+
+  return Py_BuildValue("N",retval);
+
+  BOB_CATCH_MEMBER("cannot get the statistics", 0)
+}
+
+
+/*** index ***/
+static auto get_index = bob::extension::FunctionDoc(
+  "index",
+  "Returns the position of the record with the given key",
+  0,
+  true
+)
+.add_prototype("key","i")
+.add_parameter("key", "str", "The key of the record")
+.add_return("i","int","The position of the record");
+static PyObject* PyBobLearnEMGMMStatsArchive_index(PyBobLearnEMGMMStatsArchiveObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = get_index.kwlist(0);
+
+  const char* key = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &key)) return 0;
+
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getIndex(key));
+
+  BOB_CATCH_MEMBER("cannot get the index of the record", 0)
+}
+
+
+/*** contains ***/
+static auto archive_contains = bob::extension::FunctionDoc(
+  "contains",
+  "Tells if a record with the given key exists",
+  0,
+  true
+)
+.add_prototype("key","exists")
+.add_parameter("key", "str", "The key of the record")
+.add_return("exists","bool","``True`` if the record exists");
+static PyObject* PyBobLearnEMGMMStatsArchive_contains(PyBobLearnEMGMMStatsArchiveObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = archive_contains.kwlist(0);
+
+  const char* key = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &key)) return 0;
+
+  if (self->cxx->contains(key)) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+
+  BOB_CATCH_MEMBER("cannot check the key", 0)
+}
+
+
+/*** stats_set ***/
+static auto stats_set = bob::extension::FunctionDoc(
+  "stats_set",
+  "Copies all the records into a :py:class:`bob.learn.em.GMMStatsSet`",
+  "The returned set can be given to :py:meth:`bob.learn.em.IVectorTrainer.e_step` or :py:func:`bob.learn.em.linear_scoring`.",
+  true
+)
+.add_prototype("","stats")
+.add_return("stats",":py:class:`bob.learn.em.GMMStatsSet`","The statistics of all the records");
+static PyObject* PyBobLearnEMGMMStatsArchive_stats_set(PyBobLearnEMGMMStatsArchiveObject* self) {
+  BOB_TRY
+
+  boost::shared_ptr<bob::learn::em::GMMStatsSet> output(new bob::learn::em::GMMStatsSet());
+  self->cxx->getStatsSet(*output);
+
+  //Allocating the correspondent python object
+  PyBobLearnEMGMMStatsSetObject* retval =
+    (PyBobLearnEMGMMStatsSetObject*)PyBobLearnEMGMMStatsSet_Type.tp_alloc(&PyBobLearnEMGMMStatsSet_Type, 0);
+  retval->cxx = output;
+
+  return Py_BuildValue("N",retval);
+
+  BOB_CATCH_MEMBER("cannot get the statistics set", 0)
+}
+
+
+/*** refresh ***/
+static auto refresh = bob::extension::FunctionDoc(
+  "refresh",
+  "Remaps the archive, to access the records appended since it was opened",
+  "The arrays obtained before calling this method keep referring to the previous mapping."
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMGMMStatsArchive_refresh(PyBobLearnEMGMMStatsArchiveObject* self) {
+  BOB_TRY
+
+  // A new mapping is created, since the views returned so far may still use the current one
+  self->cxx.reset(new bob::learn::em::GMMStatsArchive(self->cxx->getFilename()));
+
+  BOB_CATCH_MEMBER("cannot refresh the archive", 0)
+  Py_RETURN_NONE;
+}
+
+
+static PyMethodDef PyBobLearnEMGMMStatsArchive_methods[] = {
+  {
+    get_stats.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchive_get_stats,
+    METH_VARARGS|METH_KEYWORDS,
+    get_stats.doc()
+  },
+  {
+    get_index.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchive_index,
+    METH_VARARGS|METH_KEYWORDS,
+    get_index.doc()
+  },
+  {
+    archive_contains.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchive_contains,
+    METH_VARARGS|METH_KEYWORDS,
+    archive_contains.doc()
+  },
+  {
+    stats_set.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchive_stats_set,
+    METH_NOARGS,
+    stats_set.doc()
+  },
+  {
+    refresh.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsArchive_refresh,
+    METH_NOARGS,
+    refresh.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the GMMStatsArchive types struct; will be initialized later
+PyTypeObject PyBobLearnEMGMMStatsArchiveWriter_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+PyTypeObject PyBobLearnEMGMMStatsArchive_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobLearnEMGMMStatsArchiveWriter_sequence = {0};
+static PySequenceMethods PyBobLearnEMGMMStatsArchive_sequence = {0};
+
+bool init_BobLearnEMGMMStatsArchive(PyObject* module)
+{
+  // initialize the writer type struct
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_name = GMMStatsArchiveWriter_doc.name();
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_basicsize = sizeof(PyBobLearnEMGMMStatsArchiveWriterObject);
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_doc = GMMStatsArchiveWriter_doc.doc();
+
+  // set the functions
+  PyBobLearnEMGMMStatsArchiveWriter_sequence.sq_length = reinterpret_cast<lenfunc>(PyBobLearnEMGMMStatsArchiveWriter_len);
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMGMMStatsArchiveWriter_init);
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMGMMStatsArchiveWriter_delete);
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_methods = PyBobLearnEMGMMStatsArchiveWriter_methods;
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_getset = PyBobLearnEMGMMStatsArchiveWriter_getseters;
+  PyBobLearnEMGMMStatsArchiveWriter_Type.tp_as_sequence = &PyBobLearnEMGMMStatsArchiveWriter_sequence;
+
+  // initialize the archive type struct
+  PyBobLearnEMGMMStatsArchive_Type.tp_name = GMMStatsArchive_doc.name();
+  PyBobLearnEMGMMStatsArchive_Type.tp_basicsize = sizeof(PyBobLearnEMGMMStatsArchiveObject);
+  PyBobLearnEMGMMStatsArchive_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobLearnEMGMMStatsArchive_Type.tp_doc = GMMStatsArchive_doc.doc();
+
+  // set the functions
+  PyBobLearnEMGMMStatsArchive_sequence.sq_length = reinterpret_cast<lenfunc>(PyBobLearnEMGMMStatsArchive_len);
+  PyBobLearnEMGMMStatsArchive_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMGMMStatsArchive_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMGMMStatsArchive_init);
+  PyBobLearnEMGMMStatsArchive_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMGMMStatsArchive_delete);
+  PyBobLearnEMGMMStatsArchive_Type.tp_methods = PyBobLearnEMGMMStatsArchive_methods;
+  PyBobLearnEMGMMStatsArchive_Type.tp_getset = PyBobLearnEMGMMStatsArchive_getseters;
+  PyBobLearnEMGMMStatsArchive_Type.tp_as_sequence = &PyBobLearnEMGMMStatsArchive_sequence;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobLearnEMGMMStatsArchiveWriter_Type) < 0) return false;
+  if (PyType_Ready(&PyBobLearnEMGMMStatsArchive_Type) < 0) return false;
+
+  // add the types to the module
+  Py_INCREF(&PyBobLearnEMGMMStatsArchiveWriter_Type);
+  if (PyModule_AddObject(module, "GMMStatsArchiveWriter", (PyObject*)&PyBobLearnEMGMMStatsArchiveWriter_Type) < 0) return false;
+  Py_INCREF(&PyBobLearnEMGMMStatsArchive_Type);
+  return PyModule_AddObject(module, "GMMStatsArchive", (PyObject*)&PyBobLearnEMGMMStatsArchive_Type) >= 0;
+}
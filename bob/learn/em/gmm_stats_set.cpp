@@ -0,0 +1,679 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto GMMStatsSet_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".GMMStatsSet",
+  "A contiguous container for the GMM statistics of many samples",
+  "The statistics of ``N`` samples (e.g. utterances) are stored in contiguous arrays "
+  "of shape ``(N, n_gaussians)`` for :py:attr:`n` and ``(N, n_gaussians, n_inputs)`` for "
+  ":py:attr:`sum_px` and :py:attr:`sum_pxx`. "
+  "It can be passed instead of a list of :py:class:`bob.learn.em.GMMStats` to "
+  ":py:meth:`bob.learn.em.IVectorTrainer.e_step` and :py:func:`bob.learn.em.linear_scoring`, "
+  "which then process all the samples at once using matrix products."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "A contiguous container for the GMM statistics of many samples.",
+    "",
+    true
+  )
+  .add_prototype("n_samples,n_gaussians,n_inputs,[second_order]","")
+  .add_prototype("stats","")
+  .add_prototype("other","")
+  .add_prototype("hdf5","")
+  .add_prototype("","")
+
+  .add_parameter("n_samples", "int", "Number of samples")
+  .add_parameter("n_gaussians", "int", "Number of gaussians")
+  .add_parameter("n_inputs", "int", "Dimension of the feature vector")
+  .add_parameter("second_order", "bool", "[Default: ``True``] Allocate the second order statistics :py:attr:`sum_pxx`")
+  .add_parameter("stats", "[:py:class:`bob.learn.em.GMMStats`]", "A list of GMMStats of the same shape to be packed. The second order statistics are kept only if all the GMMStats have them.")
+  .add_parameter("other", ":py:class:`bob.learn.em.GMMStatsSet`", "A GMMStatsSet object to be copied.")
+  .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading")
+
+);
+
+
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}  /* converts PyObject to bool and returns false if object is NULL */
+
+static int PyBobLearnEMGMMStatsSet_init_number(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+
+  char** kwlist = GMMStatsSet_doc.kwlist(0);
+  int n_samples   = 0;
+  int n_inputs    = 1;
+  int n_gaussians = 1;
+  PyObject* second_order = Py_True;
+  //Parsing the input argments
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iii|O!", kwlist, &n_samples, &n_gaussians, &n_inputs, &PyBool_Type, &second_order))
+    return -1;
+
+  if(n_samples < 0){
+    PyErr_Format(PyExc_TypeError, "n_samples argument must be greater than or equal to zero");
+    GMMStatsSet_doc.print_usage();
+    return -1;
+  }
+
+  if(n_gaussians < 0){
+    PyErr_Format(PyExc_TypeError, "gaussians argument must be greater than or equal to zero");
+    GMMStatsSet_doc.print_usage();
+    return -1;
+  }
+
+  if(n_inputs < 0){
+    PyErr_Format(PyExc_TypeError, "input argument must be greater than or equal to zero");
+    GMMStatsSet_doc.print_usage();
+    return -1;
+   }
+
+  self->cxx.reset(new bob::learn::em::GMMStatsSet(n_samples, n_gaussians, n_inputs, f(second_order)));
+  return 0;
+}
+
+
+static int PyBobLearnEMGMMStatsSet_init_list(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+
+  char** kwlist = GMMStatsSet_doc.kwlist(1);
+  PyObject* stats_list_o = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyList_Type, &stats_list_o)){
+    GMMStatsSet_doc.print_usage();
+    return -1;
+  }
+
+  std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats;
+  for (int i=0; i<PyList_GET_SIZE(stats_list_o); i++){
+    PyBobLearnEMGMMStatsObject* s;
+    if (!PyArg_Parse(PyList_GetItem(stats_list_o, i), "O!", &PyBobLearnEMGMMStats_Type, &s)){
+      PyErr_Format(PyExc_RuntimeError, "Expected GMMStats objects");
+      return -1;
+    }
+    stats.push_back(s->cxx);
+  }
+
+  self->cxx.reset(new bob::learn::em::GMMStatsSet(stats));
+  return 0;
+}
+
+
+static int PyBobLearnEMGMMStatsSet_init_copy(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+
+  char** kwlist = GMMStatsSet_doc.kwlist(2);
+  PyBobLearnEMGMMStatsSetObject* tt;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobLearnEMGMMStatsSet_Type, &tt)){
+    GMMStatsSet_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::learn::em::GMMStatsSet(*tt->cxx));
+  return 0;
+}
+
+
+static int PyBobLearnEMGMMStatsSet_init_hdf5(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+
+  char** kwlist = GMMStatsSet_doc.kwlist(3);
+
+  PyBobIoHDF5FileObject* config = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBobIoHDF5File_Converter, &config)){
+    GMMStatsSet_doc.print_usage();
+    return -1;
+  }
+  auto config_ = make_safe(config);
+  self->cxx.reset(new bob::learn::em::GMMStatsSet(*(config->f)));
+
+  return 0;
+}
+
+
+
+static int PyBobLearnEMGMMStatsSet_init(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  // get the number of command line arguments
+  int nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  switch (nargs) {
+
+    case 0: //default initializer ()
+      self->cxx.reset(new bob::learn::em::GMMStatsSet());
+      return 0;
+
+    case 1:{
+      //Reading the input argument
+      PyObject* arg = 0;
+      if (PyTuple_Size(args))
+        arg = PyTuple_GET_ITEM(args, 0);
+      else {
+        PyObject* tmp = PyDict_Values(kwargs);
+        auto tmp_ = make_safe(tmp);
+        arg = PyList_GET_ITEM(tmp, 0);
+      }
+
+      /**If the constructor input is a list of GMMStats**/
+      if (PyList_Check(arg))
+        return PyBobLearnEMGMMStatsSet_init_list(self, args, kwargs);
+      /**If the constructor input is a GMMStatsSet object**/
+      else if (PyBobLearnEMGMMStatsSet_Check(arg))
+        return PyBobLearnEMGMMStatsSet_init_copy(self, args, kwargs);
+      /**If the constructor input is a HDF5**/
+      else if (PyBobIoHDF5File_Check(arg))
+        return PyBobLearnEMGMMStatsSet_init_hdf5(self, args, kwargs);
+
+      PyErr_Format(PyExc_TypeError, "invalid input argument");
+      GMMStatsSet_doc.print_usage();
+      return -1;
+    }
+    case 3:
+    case 4:
+      return PyBobLearnEMGMMStatsSet_init_number(self, args, kwargs);
+    default:
+      PyErr_Format(PyExc_RuntimeError, "number of arguments mismatch - %s requires 0, 1, 3 or 4 arguments, but you provided %d (see help)", Py_TYPE(self)->tp_name, nargs);
+      GMMStatsSet_doc.print_usage();
+      return -1;
+  }
+  BOB_CATCH_MEMBER("cannot create GMMStatsSet", -1)
+  return 0;
+}
+
+
+
+static void PyBobLearnEMGMMStatsSet_delete(PyBobLearnEMGMMStatsSetObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* PyBobLearnEMGMMStatsSet_RichCompare(PyBobLearnEMGMMStatsSetObject* self, PyObject* other, int op) {
+  BOB_TRY
+
+  if (!PyBobLearnEMGMMStatsSet_Check(other)) {
+    PyErr_Format(PyExc_TypeError, "cannot compare `%s' with `%s'", Py_TYPE(self)->tp_name, Py_TYPE(other)->tp_name);
+    return 0;
+  }
+  auto other_ = reinterpret_cast<PyBobLearnEMGMMStatsSetObject*>(other);
+  switch (op) {
+    case Py_EQ:
+      if (*self->cxx==*other_->cxx) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+    case Py_NE:
+      if (*self->cxx==*other_->cxx) Py_RETURN_FALSE; else Py_RETURN_TRUE;
+    default:
+      Py_INCREF(Py_NotImplemented);
+      return Py_NotImplemented;
+  }
+  BOB_CATCH_MEMBER("cannot compare GMMStatsSet objects", 0)
+}
+
+int PyBobLearnEMGMMStatsSet_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMGMMStatsSet_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+/***** n *****/
+static auto n = bob::extension::VariableDoc(
+  "n",
+  "array_like <float, 2D>",
+  "For each sample and each Gaussian, the accumulated sum of responsibilities ``(n_samples, n_gaussians)``"
+);
+PyObject* PyBobLearnEMGMMStatsSet_getN(PyBobLearnEMGMMStatsSetObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->n);
+  BOB_CATCH_MEMBER("n could not be read", 0)
+}
+
+
+/***** sum_px *****/
+static auto sum_px = bob::extension::VariableDoc(
+  "sum_px",
+  "array_like <float, 3D>",
+  "For each sample and each Gaussian, the accumulated sum of responsibility times the frame ``(n_samples, n_gaussians, n_inputs)``"
+);
+PyObject* PyBobLearnEMGMMStatsSet_getSum_px(PyBobLearnEMGMMStatsSetObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->sumPx);
+  BOB_CATCH_MEMBER("sum_px could not be read", 0)
+}
+
+
+/***** sum_pxx *****/
+static auto sum_pxx = bob::extension::VariableDoc(
+  "sum_pxx",
+  "array_like <float, 3D>",
+  "For each sample and each Gaussian, the accumulated sum of responsibility times the frame squared ``(n_samples, n_gaussians, n_inputs)``",
+  "This array is empty if the statistics are first order only (see :py:attr:`has_second_order`)."
+);
+PyObject* PyBobLearnEMGMMStatsSet_getSum_pxx(PyBobLearnEMGMMStatsSetObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->sumPxx);
+  BOB_CATCH_MEMBER("sum_pxx could not be read", 0)
+}
+
+
+/***** t *****/
+static auto t = bob::extension::VariableDoc(
+  "t",
+  "array_like <uint64, 1D>",
+  "For each sample, the number of frames"
+);
+PyObject* PyBobLearnEMGMMStatsSet_getT(PyBobLearnEMGMMStatsSetObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->T);
+  BOB_CATCH_MEMBER("t could not be read", 0)
+}
+
+
+/***** log_likelihood *****/
+static auto log_likelihood = bob::extension::VariableDoc(
+  "log_likelihood",
+  "array_like <float, 1D>",
+  "For each sample, the accumulated log likelihood of all frames"
+);
+PyObject* PyBobLearnEMGMMStatsSet_getLog_likelihood(PyBobLearnEMGMMStatsSetObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->log_likelihood);
+  BOB_CATCH_MEMBER("log_likelihood could not be read", 0)
+}
+
+
+/***** has_second_order *****/
+static auto has_second_order = bob::extension::VariableDoc(
+  "has_second_order",
+  "bool",
+  "Tells if the second order statistics :py:attr:`sum_pxx` are allocated",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsSet_getHasSecondOrder(PyBobLearnEMGMMStatsSetObject* self, void*) {
+  BOB_TRY
+  if (self->cxx->hasSecondOrder()) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("has_second_order could not be read", 0)
+}
+
+
+/***** shape *****/
+static auto shape = bob::extension::VariableDoc(
+  "shape",
+  "(int,int,int)",
+  "A tuple that represents the number of samples, the number of gaussians and dimensionality of each Gaussian ``(n_samples, n_gaussians, dim)``.",
+  ""
+);
+PyObject* PyBobLearnEMGMMStatsSet_getShape(PyBobLearnEMGMMStatsSetObject* self, void*) {
+  BOB_TRY
+  return Py_BuildValue("(i,i,i)", self->cxx->getNSamples(), self->cxx->getNGaussians(), self->cxx->getNInputs());
+  BOB_CATCH_MEMBER("shape could not be read", 0)
+}
+
+
+
+static PyGetSetDef PyBobLearnEMGMMStatsSet_getseters[] = {
+  {
+    n.name(),
+    (getter)PyBobLearnEMGMMStatsSet_getN,
+    0,
+    n.doc(),
+    0
+  },
+  {
+    sum_px.name(),
+    (getter)PyBobLearnEMGMMStatsSet_getSum_px,
+    0,
+    sum_px.doc(),
+    0
+  },
+  {
+    sum_pxx.name(),
+    (getter)PyBobLearnEMGMMStatsSet_getSum_pxx,
+    0,
+    sum_pxx.doc(),
+    0
+  },
+  {
+    t.name(),
+    (getter)PyBobLearnEMGMMStatsSet_getT,
+    0,
+    t.doc(),
+    0
+  },
+  {
+    log_likelihood.name(),
+    (getter)PyBobLearnEMGMMStatsSet_getLog_likelihood,
+    0,
+    log_likelihood.doc(),
+    0
+  },
+  {
+   shape.name(),
+   (getter)PyBobLearnEMGMMStatsSet_getShape,
+   0,
+   shape.doc(),
+   0
+  },
+  {
+   has_second_order.name(),
+   (getter)PyBobLearnEMGMMStatsSet_getHasSecondOrder,
+   0,
+   has_second_order.doc(),
+   0
+  },
+
+
+  {0}  // Sentinel
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Save the configuration of the GMMStatsSet to a given HDF5 file"
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMGMMStatsSet_Save(PyBobLearnEMGMMStatsSetObject* self,  PyObject* args, PyObject* kwargs) {
+
+  BOB_TRY
+
+  // get list of arguments
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the data", 0)
+  Py_RETURN_NONE;
+}
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Load the configuration of the GMMStatsSet to a given HDF5 file"
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMGMMStatsSet_Load(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the data", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** is_similar_to ***/
+static auto is_similar_to = bob::extension::FunctionDoc(
+  "is_similar_to",
+
+  "Compares this GMMStatsSet with the ``other`` one to be approximately the same.",
+  "The optional values ``r_epsilon`` and ``a_epsilon`` refer to the "
+  "relative and absolute precision of the statistics."
+)
+.add_prototype("other, [r_epsilon], [a_epsilon]","output")
+.add_parameter("other", ":py:class:`bob.learn.em.GMMStatsSet`", "A GMMStatsSet object to be compared.")
+.add_parameter("r_epsilon", "float", "Relative precision.")
+.add_parameter("a_epsilon", "float", "Absolute precision.")
+.add_return("output","bool","True if it is similar, otherwise false.");
+static PyObject* PyBobLearnEMGMMStatsSet_IsSimilarTo(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwds) {
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = is_similar_to.kwlist(0);
+
+  PyBobLearnEMGMMStatsSetObject* other = 0;
+  double r_epsilon = 1.e-5;
+  double a_epsilon = 1.e-8;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!|dd", kwlist,
+        &PyBobLearnEMGMMStatsSet_Type, &other,
+        &r_epsilon, &a_epsilon)){
+
+        is_similar_to.print_usage();
+        return 0;
+  }
+
+  if (self->cxx->is_similar_to(*other->cxx, r_epsilon, a_epsilon))
+    Py_RETURN_TRUE;
+  else
+    Py_RETURN_FALSE;
+}
+
+
+/*** resize ***/
+static auto resize = bob::extension::FunctionDoc(
+  "resize",
+  "Allocates space for the statistics and resets to zero.",
+  0,
+  true
+)
+.add_prototype("n_samples,n_gaussians,n_inputs,[second_order]")
+.add_parameter("n_samples", "int", "Number of samples")
+.add_parameter("n_gaussians", "int", "Number of gaussians")
+.add_parameter("n_inputs", "int", "Dimensionality of the feature vector")
+.add_parameter("second_order", "bool", "[Default: ``True``] Allocate the second order statistics");
+static PyObject* PyBobLearnEMGMMStatsSet_resize(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = resize.kwlist(0);
+
+  int n_samples = 0;
+  int n_gaussians = 0;
+  int n_inputs = 0;
+  PyObject* second_order = Py_True;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iii|O!", kwlist, &n_samples, &n_gaussians, &n_inputs, &PyBool_Type, &second_order)) return 0;
+
+  if (n_samples < 0){
+    PyErr_Format(PyExc_TypeError, "n_samples must be greater than or equal to zero");
+    resize.print_usage();
+    return 0;
+  }
+  if (n_gaussians <= 0){
+    PyErr_Format(PyExc_TypeError, "n_gaussians must be greater than zero");
+    resize.print_usage();
+    return 0;
+  }
+  if (n_inputs <= 0){
+    PyErr_Format(PyExc_TypeError, "n_inputs must be greater than zero");
+    resize.print_usage();
+    return 0;
+  }
+
+  self->cxx->resize(n_samples, n_gaussians, n_inputs, f(second_order));
+
+  BOB_CATCH_MEMBER("cannot perform the resize method", 0)
+
+  Py_RETURN_NONE;
+}
+
+
+/*** get_stats ***/
+static auto get_stats = bob::extension::FunctionDoc(
+  "get_stats",
+  "Returns the statistics of the i'th sample",
+  "The arrays of the returned :py:class:`bob.learn.em.GMMStats` share the memory of this set (no data is copied).",
+  true
+)
+.add_prototype("i","stats")
+.add_parameter("i", "int", "Index of the sample")
+.add_return("stats",":py:class:`bob.learn.em.GMMStats`","The statistics of the i'th sample");
+static PyObject* PyBobLearnEMGMMStatsSet_get_stats(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = get_stats.kwlist(0);
+
+  int i = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &i)) return 0;
+
+  if (i < 0){
+    PyErr_Format(PyExc_TypeError, "i must be greater than or equal to zero");
+    get_stats.print_usage();
+    return 0;
+  }
+
+  //Allocating the correspondent python object
+  PyBobLearnEMGMMStatsObject* retval =
+    (PyBobLearnEMGMMStatsObject*)PyBobLearnEMGMMStats_Type.tp_alloc(&PyBobLearnEMGMMStats_Type, 0);
+
+  retval->cxx = self->cxx->getStats(i);
+
+  return Py_BuildValue("N",retval);
+
+  BOB_CATCH_MEMBER("cannot get the statistics", 0)
+}
+
+
+/*** set_stats ***/
+static auto set_stats = bob::extension::FunctionDoc(
+  "set_stats",
+  "Copies the given statistics into the i'th sample of this set",
+  0,
+  true
+)
+.add_prototype("i,stats")
+.add_parameter("i", "int", "Index of the sample")
+.add_parameter("stats", ":py:class:`bob.learn.em.GMMStats`", "The statistics to be copied");
+static PyObject* PyBobLearnEMGMMStatsSet_set_stats(PyBobLearnEMGMMStatsSetObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = set_stats.kwlist(0);
+
+  int i = 0;
+  PyBobLearnEMGMMStatsObject* stats = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iO!", kwlist, &i, &PyBobLearnEMGMMStats_Type, &stats)) return 0;
+
+  if (i < 0){
+    PyErr_Format(PyExc_TypeError, "i must be greater than or equal to zero");
+    set_stats.print_usage();
+    return 0;
+  }
+
+  self->cxx->setStats(i, *stats->cxx);
+
+  BOB_CATCH_MEMBER("cannot set the statistics", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** init ***/
+static auto init = bob::extension::FunctionDoc(
+  "init",
+  " Resets statistics to zero."
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMGMMStatsSet_init_method(PyBobLearnEMGMMStatsSetObject* self) {
+  BOB_TRY
+
+  self->cxx->init();
+
+  BOB_CATCH_MEMBER("cannot perform the init method", 0)
+
+  Py_RETURN_NONE;
+}
+
+
+
+static PyMethodDef PyBobLearnEMGMMStatsSet_methods[] = {
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsSet_Save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsSet_Load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
+  {
+    is_similar_to.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsSet_IsSimilarTo,
+    METH_VARARGS|METH_KEYWORDS,
+    is_similar_to.doc()
+  },
+  {
+    resize.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsSet_resize,
+    METH_VARARGS|METH_KEYWORDS,
+    resize.doc()
+  },
+  {
+    get_stats.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsSet_get_stats,
+    METH_VARARGS|METH_KEYWORDS,
+    get_stats.doc()
+  },
+  {
+    set_stats.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsSet_set_stats,
+    METH_VARARGS|METH_KEYWORDS,
+    set_stats.doc()
+  },
+  {
+    init.name(),
+    (PyCFunction)PyBobLearnEMGMMStatsSet_init_method,
+    METH_NOARGS,
+    init.doc()
+  },
+
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the GMMStatsSet type struct; will be initialized later
+PyTypeObject PyBobLearnEMGMMStatsSet_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobLearnEMGMMStatsSet(PyObject* module)
+{
+  // initialize the type struct
+  PyBobLearnEMGMMStatsSet_Type.tp_name = GMMStatsSet_doc.name();
+  PyBobLearnEMGMMStatsSet_Type.tp_basicsize = sizeof(PyBobLearnEMGMMStatsSetObject);
+  PyBobLearnEMGMMStatsSet_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobLearnEMGMMStatsSet_Type.tp_doc = GMMStatsSet_doc.doc();
+
+  // set the functions
+  PyBobLearnEMGMMStatsSet_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMGMMStatsSet_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMGMMStatsSet_init);
+  PyBobLearnEMGMMStatsSet_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMGMMStatsSet_delete);
+  PyBobLearnEMGMMStatsSet_Type.tp_richcompare = reinterpret_cast<richcmpfunc>(PyBobLearnEMGMMStatsSet_RichCompare);
+  PyBobLearnEMGMMStatsSet_Type.tp_methods = PyBobLearnEMGMMStatsSet_methods;
+  PyBobLearnEMGMMStatsSet_Type.tp_getset = PyBobLearnEMGMMStatsSet_getseters;
+  PyBobLearnEMGMMStatsSet_Type.tp_call = 0;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobLearnEMGMMStatsSet_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobLearnEMGMMStatsSet_Type);
+  return PyModule_AddObject(module, "GMMStatsSet", (PyObject*)&PyBobLearnEMGMMStatsSet_Type) >= 0;
+}
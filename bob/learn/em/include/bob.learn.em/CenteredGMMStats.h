@@ -0,0 +1,140 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief UBM-centered first order statistics of a probe
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_CENTEREDGMMSTATS_H
+#define BOB_LEARN_EM_CENTEREDGMMSTATS_H
+
+#include <blitz/array.h>
+#include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/GMMMachine.h>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief The first order statistics of a probe, centered (and optionally
+ * variance-normalized) with respect to a UBM.
+ * @details The linear scoring, the i-vector extraction and the estimation of
+ * the session offset x of the factor analysis all start by computing
+ * \f$F - N.m\f$ (and for the linear scoring \f$\Sigma^{-1}(F - N.m)\f$).
+ * Computing them once per probe avoids doing it each time the same probe is
+ * scored or projected. The statistics must be used with machines that share
+ * the UBM they were computed with.
+ */
+class CenteredGMMStats {
+  public:
+
+    /**
+     * Default constructor (empty statistics)
+     */
+    CenteredGMMStats();
+
+    /**
+     * Constructor, which centers the given statistics
+     * @param stats    The GMM statistics of the probe
+     * @param ubm      The UBM to center the statistics with
+     * @param whitened Whether the variance-normalized statistics are computed
+     */
+    CenteredGMMStats(const bob::learn::em::GMMStats& stats,
+      const bob::learn::em::GMMMachine& ubm, const bool whitened=true);
+
+    /**
+     * Copy constructor
+     */
+    CenteredGMMStats(const CenteredGMMStats& other);
+
+    /**
+     * Destructor
+     */
+    ~CenteredGMMStats();
+
+    /**
+     * Assigment
+     */
+    CenteredGMMStats& operator=(const CenteredGMMStats& other);
+
+    /**
+     * Equal to
+     */
+    bool operator==(const CenteredGMMStats& b) const;
+
+    /**
+     * Not Equal to
+     */
+    bool operator!=(const CenteredGMMStats& b) const;
+
+    /**
+     * @brief Similar to
+     */
+    bool is_similar_to(const CenteredGMMStats& b, const double r_epsilon=1e-5,
+      const double a_epsilon=1e-8) const;
+
+    /**
+     * Centers the given statistics with respect to the UBM
+     * @param stats    The GMM statistics of the probe
+     * @param ubm      The UBM to center the statistics with
+     * @param whitened Whether the variance-normalized statistics are computed
+     */
+    void compute(const bob::learn::em::GMMStats& stats,
+      const bob::learn::em::GMMMachine& ubm, const bool whitened=true);
+
+    /**
+     * Returns the number of Gaussians C
+     */
+    size_t getNGaussians() const
+    { return m_n.extent(0); }
+
+    /**
+     * Returns the feature dimensionality D
+     */
+    size_t getNInputs() const
+    { return m_n.extent(0) ? m_centered.extent(0) / m_n.extent(0) : 0; }
+
+    /**
+     * Returns the number of frames of the probe
+     */
+    size_t getT() const
+    { return m_T; }
+
+    /**
+     * Returns the zeroth order statistics N (C)
+     */
+    const blitz::Array<double,1>& getN() const
+    { return m_n; }
+
+    /**
+     * Returns the centered first order statistics supervector
+     * \f$F_c - N_c m_c\f$ (CD)
+     */
+    const blitz::Array<double,1>& getCenteredSumPx() const
+    { return m_centered; }
+
+    /**
+     * Tells if the variance-normalized statistics are available
+     */
+    bool hasWhitened() const
+    { return m_has_whitened; }
+
+    /**
+     * Returns the variance-normalized centered first order statistics
+     * supervector \f$\Sigma_c^{-1} (F_c - N_c m_c)\f$ (CD)
+     * @warning throws if they were not computed
+     */
+    const blitz::Array<double,1>& getWhitenedSumPx() const;
+
+  private:
+    size_t m_T;
+    bool m_has_whitened;
+    blitz::Array<double,1> m_n;
+    blitz::Array<double,1> m_centered;
+    blitz::Array<double,1> m_whitened;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_CENTEREDGMMSTATS_H
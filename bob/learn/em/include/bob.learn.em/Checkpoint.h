@@ -0,0 +1,90 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief Helpers to save and restore the state of the trainers, used to
+ * checkpoint a training
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_CHECKPOINT_H
+#define BOB_LEARN_EM_CHECKPOINT_H
+
+#include <blitz/array.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <bob.io.base/HDF5File.h>
+#include <string>
+#include <vector>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief Saves the full state of a random number generator, such that
+ * loadRng() restores a generator giving the exact same sequence
+ */
+void saveRng(bob::io::base::HDF5File& config, const std::string& path,
+  const boost::mt19937& rng);
+
+/**
+ * @brief Restores the state of a random number generator saved by saveRng()
+ */
+void loadRng(bob::io::base::HDF5File& config, const std::string& path,
+  boost::mt19937& rng);
+
+/**
+ * @brief Saves an array which may be empty (e.g., a cache which was not
+ * allocated). Empty arrays are not stored.
+ */
+template <typename T, int N>
+void saveOptionalArray(bob::io::base::HDF5File& config, const std::string& path,
+  const blitz::Array<T,N>& array)
+{
+  if (array.numElements() > 0)
+    config.setArray(path, array);
+}
+
+/**
+ * @brief Loads an array saved by saveOptionalArray(), which is left empty
+ * if it was not stored
+ */
+template <typename T, int N>
+void loadOptionalArray(bob::io::base::HDF5File& config, const std::string& path,
+  blitz::Array<T,N>& array)
+{
+  if (config.contains(path))
+    array.reference(config.readArray<T,N>(path));
+  else
+    array.resize(blitz::TinyVector<int,N>(0));
+}
+
+/**
+ * @brief Saves a list of arrays (e.g., one per identity), as path_0,
+ * path_1, ... and their number as path_size
+ */
+template <typename T, int N>
+void saveArrays(bob::io::base::HDF5File& config, const std::string& path,
+  const std::vector<blitz::Array<T,N> >& arrays)
+{
+  config.set(path + "_size", static_cast<int64_t>(arrays.size()));
+  for (size_t i=0; i<arrays.size(); ++i)
+    saveOptionalArray(config, path + "_" + boost::lexical_cast<std::string>(i), arrays[i]);
+}
+
+/**
+ * @brief Loads a list of arrays saved by saveArrays()
+ */
+template <typename T, int N>
+void loadArrays(bob::io::base::HDF5File& config, const std::string& path,
+  std::vector<blitz::Array<T,N> >& arrays)
+{
+  const size_t size = config.read<int64_t>(path + "_size");
+  arrays.resize(size);
+  for (size_t i=0; i<size; ++i)
+    loadOptionalArray(config, path + "_" + boost::lexical_cast<std::string>(i), arrays[i]);
+}
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_CHECKPOINT_H
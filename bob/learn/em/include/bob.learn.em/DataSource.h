@@ -0,0 +1,165 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief Sources of training data, consumed chunk by chunk by the E-steps
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_DATASOURCE_H
+#define BOB_LEARN_EM_DATASOURCE_H
+
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <string>
+#include <vector>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief A source of training data, which gives the feature vectors (one
+ * per row) by chunks.
+ * @details A pass over the data starts with reset(), and next() is called
+ * until it returns false.
+ */
+class DataSource {
+  public:
+    virtual ~DataSource() {}
+
+    /**
+     * Starts a new pass over the data
+     */
+    virtual void reset() = 0;
+
+    /**
+     * Gives the next chunk of the current pass
+     * @param chunk Set to the chunk. It is only valid until the next call
+     *   of next() or reset(), and must not be modified.
+     * @return false if the pass is over (chunk is then left unchanged)
+     */
+    virtual bool next(blitz::Array<double,2>& chunk) = 0;
+};
+
+
+/**
+ * @brief A DataSource on an array in memory, given by chunks of consecutive
+ * rows
+ */
+class ArrayDataSource: public DataSource {
+  public:
+    /**
+     * Constructor
+     * @param data       The data, referenced (not copied)
+     * @param chunk_size The number of rows of the chunks (0 for a single
+     *   chunk with all the data)
+     */
+    ArrayDataSource(const blitz::Array<double,2>& data, const size_t chunk_size=0);
+
+    virtual ~ArrayDataSource();
+
+    virtual void reset();
+
+    virtual bool next(blitz::Array<double,2>& chunk);
+
+  private:
+    blitz::Array<double,2> m_data;
+    size_t m_chunk_size;
+    size_t m_position;
+};
+
+
+/**
+ * @brief A DataSource on a list of HDF5 files, each of them holding a 2D
+ * array of features, read on a background thread.
+ * @details Each file is a chunk. A prefetch thread reads the files in order
+ * into a ring of n_buffers buffers, while the chunks already read are
+ * processed: the I/O overlaps with the E-step. A buffer is only recycled
+ * once the chunk it holds has been released (on the next call of next()),
+ * so at most n_buffers files are held in memory. The prefetch thread only
+ * runs during a pass, i.e., from reset() (or the first call of next()) until
+ * next() returns false.
+ *
+ * The HDF5 library is used by the prefetch thread: other HDF5 files should
+ * not be accessed from another thread during a pass. They can be accessed
+ * between two passes, e.g., to save a checkpoint after the M-step.
+ */
+class FileListDataSource: public DataSource {
+  public:
+    /**
+     * Constructor. The files are read from the first pass on.
+     * @param filenames The names of the HDF5 files
+     * @param key       The path of the 2D array in each file
+     * @param n_buffers The number of buffers of the ring (at least 2 for the
+     *   I/O to overlap with the computation)
+     */
+    FileListDataSource(const std::vector<std::string>& filenames,
+      const std::string& key="array", const size_t n_buffers=2);
+
+    /**
+     * Destructor, which stops the prefetch thread
+     */
+    virtual ~FileListDataSource();
+
+    /**
+     * Starts a new pass, and the prefetch thread. If no chunk of the current
+     * pass was given yet, the chunks prefetched so far are kept.
+     */
+    virtual void reset();
+
+    virtual bool next(blitz::Array<double,2>& chunk);
+
+    const std::vector<std::string>& getFilenames() const
+    { return m_filenames; }
+
+    const std::string& getKey() const
+    { return m_key; }
+
+    size_t getNBuffers() const
+    { return m_slots.size(); }
+
+  private:
+    // Disable copy
+    FileListDataSource(const FileListDataSource&);
+    FileListDataSource& operator=(const FileListDataSource&);
+
+    struct Slot {
+      Slot(): end(false) {}
+      blitz::Array<double,2> data;
+      // Set if the file could not be read
+      std::string error;
+      // Set after the last file of the pass
+      bool end;
+    };
+
+    void start();
+    void stop();
+    void prefetch();
+    bool waitForFreeSlot();
+    void push();
+
+    std::vector<std::string> m_filenames;
+    std::string m_key;
+
+    std::vector<Slot> m_slots;
+    // Position of the next slot to read and to write, and number of filled
+    // slots (including the one held by the consumer)
+    size_t m_read;
+    size_t m_write;
+    size_t m_count;
+    // Whether the consumer holds the slot at m_read
+    bool m_holding;
+    // Whether a chunk of the current pass was given (the prefetch thread is
+    // stopped between two passes)
+    bool m_started;
+    bool m_stop;
+
+    boost::mutex m_mutex;
+    boost::condition_variable m_condition;
+    boost::shared_ptr<boost::thread> m_thread;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_DATASOURCE_H
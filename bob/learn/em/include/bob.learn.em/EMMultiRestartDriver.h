@@ -0,0 +1,382 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief Concurrent EM trainings from several random initializations
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_EMMULTIRESTARTDRIVER_H
+#define BOB_LEARN_EM_EMMULTIRESTARTDRIVER_H
+
+#include <bob.learn.em/EMTrainingDriver.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/random.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief The outcome of one restart of an EMMultiRestartDriver
+ */
+struct EMRestartReport {
+  EMRestartReport():
+    seed(0), n_iterations(0), likelihood(0.), converged(false),
+    stopped_early(false), time(0.) {}
+
+  // The seed of the random generator of the restart
+  uint64_t seed;
+  // The number of iterations (M-step and E-step) run
+  size_t n_iterations;
+  // The last value returned by computeLikelihood()
+  double likelihood;
+  // Whether the convergence criterion was reached
+  bool converged;
+  // Whether the restart was stopped because it trailed the leader
+  bool stopped_early;
+  // The wall time of the restart, in seconds
+  double time;
+};
+
+
+/**
+ * @brief The per-restart calls of an EMMultiRestartDriver.
+ * @details seed() randomizes a restart before its initialization, and
+ * score() turns a likelihood into a value that is larger for better
+ * machines. By default, the random generator is given to the trainer.
+ */
+template <typename T_trainer, typename T_machine>
+struct EMRestartCalls {
+  static void seed(T_trainer& trainer, T_machine&,
+      const blitz::Array<double,2>&, const boost::shared_ptr<boost::mt19937>& rng)
+  { trainer.setRng(rng); }
+
+  static double score(const double likelihood)
+  { return likelihood; }
+};
+
+// The k-means "likelihood" is the average distance to the closest mean
+template <>
+inline double EMRestartCalls<KMeansTrainer, KMeansMachine>::score(const double likelihood)
+{ return -likelihood; }
+
+// The means of a GMM are drawn among the data, without replacement; the
+// variances are the ones of the data and the weights are uniform
+template <>
+inline void EMRestartCalls<ML_GMMTrainer, GMMMachine>::seed(ML_GMMTrainer&,
+    GMMMachine& machine, const blitz::Array<double,2>& data,
+    const boost::shared_ptr<boost::mt19937>& rng)
+{
+  const size_t n_gaussians = machine.getNGaussians();
+  const size_t n_samples = data.extent(0);
+  if (n_samples < n_gaussians)
+    throw std::runtime_error(boost::str(boost::format("EMMultiRestartDriver: "
+      "%lu samples are not enough to initialize %lu Gaussians") % n_samples % n_gaussians));
+
+  const blitz::Range a = blitz::Range::all();
+  boost::uniform_int<size_t> die(0, n_samples-1);
+  std::set<size_t> drawn;
+  blitz::Array<double,2> means(n_gaussians, data.extent(1));
+  for (size_t c=0; c<n_gaussians; ) {
+    const size_t index = die(*rng);
+    if (drawn.insert(index).second)
+      means(c++, a) = data(index, a);
+  }
+
+  blitz::Array<double,2> variances(means.shape());
+  for (int d=0; d<data.extent(1); ++d) {
+    const double mean = blitz::mean(data(a, d));
+    variances(a, d) = blitz::mean(blitz::pow2(data(a, d) - mean));
+  }
+
+  blitz::Array<double,1> weights(n_gaussians);
+  weights = 1. / n_gaussians;
+
+  machine.setMeans(means);
+  machine.setVariances(variances);
+  machine.setWeights(weights);
+}
+
+
+/**
+ * @brief Trains several copies of a machine from independent random
+ * initializations, concurrently, and keeps the best one.
+ * @details Each restart has its own copy of the trainer and of the machine,
+ * and a random generator seeded with seed+r; the data is shared (read-only)
+ * by all of them, each of them through its own array, which does not share
+ * the (non-atomic) reference count of the given one. The restarts are run in lockstep rounds on a pool of
+ * threads: after warmup_iterations, and then every check_interval
+ * iterations, the restarts whose score trails the one of the leader by more
+ * than margin (relative to the leader) are stopped. At the end, the machine
+ * of the best restart is copied into the given machine.
+ */
+template <typename T_trainer, typename T_machine,
+          typename T_calls=EMTrainerCalls<T_trainer, T_machine>,
+          typename T_restart=EMRestartCalls<T_trainer, T_machine> >
+class EMMultiRestartDriver {
+  public:
+    /**
+     * @brief Constructor
+     * @param n_restarts            The number of restarts
+     * @param max_iterations        The maximum number of iterations of a
+     *   restart
+     * @param convergence_threshold The convergence threshold of a restart.
+     *   A negative value disables the criterion.
+     * @param warmup_iterations     The number of iterations before the
+     *   restarts are first compared
+     * @param check_interval        The number of iterations between two
+     *   comparisons of the restarts
+     * @param margin                The relative margin below the leader
+     *   under which a restart is stopped. A negative value disables the
+     *   early stopping.
+     * @param n_threads             The number of threads
+     */
+    EMMultiRestartDriver(const size_t n_restarts=4,
+        const size_t max_iterations=50, const double convergence_threshold=-1.,
+        const size_t warmup_iterations=5, const size_t check_interval=5,
+        const double margin=0.01, const size_t n_threads=1):
+      m_n_restarts(n_restarts),
+      m_max_iterations(max_iterations),
+      m_convergence_threshold(convergence_threshold),
+      m_warmup_iterations(warmup_iterations),
+      m_check_interval(check_interval),
+      m_margin(margin),
+      m_n_threads(n_threads),
+      m_best(0)
+    {}
+
+    /**
+     * @brief Trains the restarts, and copies the best machine
+     * @param trainer The trainer, copied for each restart
+     * @param machine The machine, copied for each restart; overwritten by
+     *   the best machine
+     * @param data    The training data
+     * @param seed    The seed of the first restart
+     * @return The index of the best restart
+     */
+    size_t train(const T_trainer& trainer, T_machine& machine,
+        const blitz::Array<double,2>& data, const uint64_t seed=0)
+    {
+      if (m_n_restarts == 0)
+        throw std::runtime_error("EMMultiRestartDriver: the number of restarts must be greater than zero");
+      if (m_n_threads == 0)
+        throw std::runtime_error("EMMultiRestartDriver: the number of threads must be greater than zero");
+      if (m_check_interval == 0)
+        throw std::runtime_error("EMMultiRestartDriver: the check interval must be greater than zero");
+
+      std::vector<boost::shared_ptr<Restart> > restarts;
+      std::vector<Restart*> active;
+      for (size_t r=0; r<m_n_restarts; ++r) {
+        restarts.push_back(boost::shared_ptr<Restart>(new Restart(trainer,
+          machine, data, m_max_iterations, m_convergence_threshold, seed + r)));
+        active.push_back(restarts.back().get());
+      }
+
+      size_t n_iterations = m_warmup_iterations;
+      while (!active.empty()) {
+        runRound(active, n_iterations);
+        n_iterations = m_check_interval;
+
+        // The leader among the restarts which were not stopped
+        double best = 0.;
+        bool first = true;
+        for (size_t r=0; r<restarts.size(); ++r) {
+          if (restarts[r]->report.stopped_early) continue;
+          const double score = T_restart::score(restarts[r]->report.likelihood);
+          if (first || score > best) best = score;
+          first = false;
+        }
+
+        std::vector<Restart*> next;
+        for (size_t r=0; r<active.size(); ++r) {
+          Restart& restart = *active[r];
+          const double score = T_restart::score(restart.report.likelihood);
+          if (m_margin >= 0. && best - score > m_margin * std::fabs(best))
+            restart.report.stopped_early = true;
+          if (restart.report.stopped_early || restart.driver.isFinished())
+            restart.driver.end(restart.trainer, restart.machine, restart.data);
+          else
+            next.push_back(&restart);
+        }
+        active.swap(next);
+      }
+
+      m_reports.clear();
+      m_best = 0;
+      for (size_t r=0; r<restarts.size(); ++r) {
+        m_reports.push_back(restarts[r]->report);
+        if (m_reports[m_best].stopped_early ||
+            (!m_reports[r].stopped_early &&
+             T_restart::score(m_reports[r].likelihood) > T_restart::score(m_reports[m_best].likelihood)))
+          m_best = r;
+      }
+
+      machine = restarts[m_best]->machine;
+      return m_best;
+    }
+
+    /**
+     * @brief Returns the report of each restart of the last training
+     */
+    const std::vector<EMRestartReport>& getReports() const
+    { return m_reports; }
+
+    /**
+     * @brief Returns the index of the best restart of the last training
+     */
+    size_t getBestRestart() const
+    { return m_best; }
+
+    size_t getNRestarts() const
+    { return m_n_restarts; }
+
+    void setNRestarts(const size_t n_restarts)
+    { m_n_restarts = n_restarts; }
+
+    size_t getMaxIterations() const
+    { return m_max_iterations; }
+
+    void setMaxIterations(const size_t max_iterations)
+    { m_max_iterations = max_iterations; }
+
+    double getConvergenceThreshold() const
+    { return m_convergence_threshold; }
+
+    void setConvergenceThreshold(const double convergence_threshold)
+    { m_convergence_threshold = convergence_threshold; }
+
+    size_t getWarmupIterations() const
+    { return m_warmup_iterations; }
+
+    void setWarmupIterations(const size_t warmup_iterations)
+    { m_warmup_iterations = warmup_iterations; }
+
+    size_t getCheckInterval() const
+    { return m_check_interval; }
+
+    void setCheckInterval(const size_t check_interval)
+    { m_check_interval = check_interval; }
+
+    double getMargin() const
+    { return m_margin; }
+
+    void setMargin(const double margin)
+    { m_margin = margin; }
+
+    size_t getNThreads() const
+    { return m_n_threads; }
+
+    void setNThreads(const size_t n_threads)
+    { m_n_threads = n_threads; }
+
+  private:
+    struct Restart {
+      Restart(const T_trainer& trainer, const T_machine& machine,
+          const blitz::Array<double,2>& data,
+          const size_t max_iterations, const double convergence_threshold,
+          const uint64_t seed):
+        trainer(trainer), machine(machine),
+        // Built by the main thread: the views of the data made by the
+        // restart only change the reference count of this array
+        data(const_cast<double*>(data.data()), data.shape(), data.stride(),
+          blitz::neverDeleteData),
+        driver(max_iterations, convergence_threshold),
+        rng(new boost::mt19937(seed)), started(false)
+      { report.seed = seed; }
+
+      T_trainer trainer;
+      T_machine machine;
+      blitz::Array<double,2> data;
+      EMTrainingDriver<T_trainer, T_machine, T_calls> driver;
+      boost::shared_ptr<boost::mt19937> rng;
+      bool started;
+      EMRestartReport report;
+    };
+
+    /**
+     * Runs up to n_iterations iterations of a restart (started if needed)
+     */
+    static void runRestart(Restart& restart, const size_t n_iterations)
+    {
+      if (!restart.started) {
+        T_restart::seed(restart.trainer, restart.machine, restart.data, restart.rng);
+        restart.driver.begin(restart.trainer, restart.machine, restart.data);
+        restart.started = true;
+      }
+      for (size_t i=0; i<n_iterations && !restart.driver.isFinished(); ++i)
+        restart.driver.step(restart.trainer, restart.machine, restart.data);
+
+      const std::vector<EMIteration>& iterations = restart.driver.getIterations();
+      restart.report.n_iterations = iterations.size() - 1;
+      restart.report.likelihood = iterations.back().likelihood;
+      restart.report.converged = restart.driver.hasConverged();
+      restart.report.time = 0.;
+      for (size_t i=0; i<iterations.size(); ++i)
+        restart.report.time += iterations[i].time;
+    }
+
+    /**
+     * Runs the restarts t, t+n_threads, t+2*n_threads, ...
+     */
+    static void runRestarts(const std::vector<Restart*>& restarts,
+        const size_t t, const size_t n_threads, const size_t n_iterations,
+        std::string& error)
+    {
+      try {
+        for (size_t r=t; r<restarts.size(); r+=n_threads)
+          runRestart(*restarts[r], n_iterations);
+      }
+      catch (std::exception& e) {
+        error = e.what();
+      }
+      catch (...) {
+        error = "unknown exception";
+      }
+    }
+
+    void runRound(const std::vector<Restart*>& restarts,
+        const size_t n_iterations) const
+    {
+      const size_t n_threads = std::min(m_n_threads, restarts.size());
+      if (n_threads <= 1) {
+        for (size_t r=0; r<restarts.size(); ++r)
+          runRestart(*restarts[r], n_iterations);
+        return;
+      }
+
+      std::vector<std::string> errors(n_threads);
+      boost::thread_group threads;
+      for (size_t t=0; t<n_threads; ++t)
+        threads.create_thread(boost::bind(&EMMultiRestartDriver::runRestarts,
+          boost::cref(restarts), t, n_threads, n_iterations,
+          boost::ref(errors[t])));
+      threads.join_all();
+
+      for (size_t t=0; t<n_threads; ++t)
+        if (!errors[t].empty())
+          throw std::runtime_error("EMMultiRestartDriver: " + errors[t]);
+    }
+
+    size_t m_n_restarts;
+    size_t m_max_iterations;
+    double m_convergence_threshold;
+    size_t m_warmup_iterations;
+    size_t m_check_interval;
+    double m_margin;
+    size_t m_n_threads;
+    size_t m_best;
+    std::vector<EMRestartReport> m_reports;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_EMMULTIRESTARTDRIVER_H
@@ -12,6 +12,7 @@
 #define BOB_LEARN_EM_EMPCA_TRAINER_H
 
 #include <bob.learn.linear/machine.h>
+#include <bob.io.base/HDF5File.h>
 #include <blitz/array.h>
 
 namespace bob { namespace learn { namespace em {
@@ -128,6 +129,18 @@ class EMPCATrainer
     const boost::shared_ptr<boost::mt19937> getRng() const
     { return m_rng; }
 
+    /**
+     * @brief Saves the state of the trainer (random number generator,
+     * \f$\sigma^2\f$ and statistics of the latent variables) to
+     * checkpoint a training. The configuration is not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
 
   private: //representation
 
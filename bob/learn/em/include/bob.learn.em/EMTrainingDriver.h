@@ -0,0 +1,228 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief A generic driver of the expectation-maximisation loop
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_EMTRAININGDRIVER_H
+#define BOB_LEARN_EM_EMTRAININGDRIVER_H
+
+#include <bob.learn.em/KMeansTrainer.h>
+#include <bob.learn.em/ML_GMMTrainer.h>
+#include <bob.learn.em/MAP_GMMTrainer.h>
+#include <bob.learn.em/EMPCATrainer.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cmath>
+#include <vector>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief The state of the training after one iteration of the EM loop.
+ * @details The iteration 0 is the E-step that follows the initialization.
+ */
+struct EMIteration {
+  EMIteration(const size_t iteration=0, const double likelihood=0.,
+      const double convergence=0., const double time=0.):
+    iteration(iteration), likelihood(likelihood), convergence(convergence),
+    time(time) {}
+
+  size_t iteration;
+  // The value returned by computeLikelihood() after the E-step
+  double likelihood;
+  // The relative change of the likelihood w.r.t. the previous iteration
+  double convergence;
+  // The wall time of the iteration (M-step and E-step), in seconds
+  double time;
+};
+
+
+/**
+ * @brief The calls of the EM loop on a trainer.
+ * @details The trainers do not share a common base class, and their
+ * signatures slightly differ: this struct adapts them to the driver. It can
+ * be specialized for other trainers.
+ */
+template <typename T_trainer, typename T_machine>
+struct EMTrainerCalls {
+  static void initialize(T_trainer& trainer, T_machine& machine,
+      const blitz::Array<double,2>& data)
+  { trainer.initialize(machine, data); }
+
+  static void eStep(T_trainer& trainer, T_machine& machine,
+      const blitz::Array<double,2>& data)
+  { trainer.eStep(machine, data); }
+
+  static void mStep(T_trainer& trainer, T_machine& machine,
+      const blitz::Array<double,2>&)
+  { trainer.mStep(machine); }
+
+  static double computeLikelihood(T_trainer& trainer, T_machine& machine)
+  { return trainer.computeLikelihood(machine); }
+
+  static void finalize(T_trainer&, T_machine&, const blitz::Array<double,2>&)
+  {}
+};
+
+template <>
+inline void EMTrainerCalls<ML_GMMTrainer, GMMMachine>::initialize(
+    ML_GMMTrainer& trainer, GMMMachine& machine, const blitz::Array<double,2>&)
+{ trainer.initialize(machine); }
+
+template <>
+inline void EMTrainerCalls<MAP_GMMTrainer, GMMMachine>::initialize(
+    MAP_GMMTrainer& trainer, GMMMachine& machine, const blitz::Array<double,2>&)
+{ trainer.initialize(machine); }
+
+template <>
+inline void EMTrainerCalls<EMPCATrainer, bob::learn::linear::Machine>::mStep(
+    EMPCATrainer& trainer, bob::learn::linear::Machine& machine,
+    const blitz::Array<double,2>& data)
+{ trainer.mStep(machine, data); }
+
+
+/**
+ * @brief Runs the EM loop of a trainer on a machine: initialization, then
+ * alternated M-steps and E-steps until convergence, then finalization.
+ * @details This is the C++ counterpart of bob.learn.em.train(): the
+ * iterations and the convergence criterion are the same. The likelihood and
+ * the wall time of each iteration are recorded.
+ */
+template <typename T_trainer, typename T_machine,
+          typename T_calls=EMTrainerCalls<T_trainer, T_machine> >
+class EMTrainingDriver {
+  public:
+    /**
+     * @brief Constructor
+     * @param max_iterations        The maximum number of iterations
+     * @param convergence_threshold The threshold on the relative change of
+     *   the likelihood below which the training stops. A negative value
+     *   disables the criterion.
+     */
+    EMTrainingDriver(const size_t max_iterations=50,
+        const double convergence_threshold=-1.):
+      m_max_iterations(max_iterations),
+      m_convergence_threshold(convergence_threshold),
+      m_converged(false),
+      m_likelihood(0.)
+    {}
+
+    /**
+     * @brief Trains the machine
+     * @param trainer    The trainer
+     * @param machine    The machine to train
+     * @param data       The training data
+     * @param initialize Whether the initialization procedure is run
+     */
+    void train(T_trainer& trainer, T_machine& machine,
+        const blitz::Array<double,2>& data, const bool initialize=true)
+    {
+      begin(trainer, machine, data, initialize);
+      while (!isFinished())
+        step(trainer, machine, data);
+      end(trainer, machine, data);
+    }
+
+    /**
+     * @brief Starts a training: initialization and first E-step.
+     * @details train() is equivalent to begin(), step() until isFinished()
+     * and end(). These are exposed to interleave the training of several
+     * machines.
+     */
+    void begin(T_trainer& trainer, T_machine& machine,
+        const blitz::Array<double,2>& data, const bool initialize=true)
+    {
+      m_iterations.clear();
+      m_converged = false;
+
+      if (initialize) T_calls::initialize(trainer, machine, data);
+
+      const boost::posix_time::ptime start = now();
+      T_calls::eStep(trainer, machine, data);
+      m_likelihood = T_calls::computeLikelihood(trainer, machine);
+      m_iterations.push_back(EMIteration(0, m_likelihood, 0., elapsed(start)));
+    }
+
+    /**
+     * @brief Runs one iteration (M-step and E-step) of a training started
+     * with begin(), unless it is finished
+     */
+    void step(T_trainer& trainer, T_machine& machine,
+        const blitz::Array<double,2>& data)
+    {
+      if (isFinished()) return;
+
+      const boost::posix_time::ptime start = now();
+      const double previous = m_likelihood;
+      T_calls::mStep(trainer, machine, data);
+      T_calls::eStep(trainer, machine, data);
+      m_likelihood = T_calls::computeLikelihood(trainer, machine);
+      const double convergence = std::fabs((previous - m_likelihood) / previous);
+      m_iterations.push_back(EMIteration(m_iterations.size(), m_likelihood, convergence, elapsed(start)));
+
+      if (m_convergence_threshold >= 0. && convergence <= m_convergence_threshold)
+        m_converged = true;
+    }
+
+    /**
+     * @brief Ends a training started with begin()
+     */
+    void end(T_trainer& trainer, T_machine& machine,
+        const blitz::Array<double,2>& data)
+    {
+      T_calls::finalize(trainer, machine, data);
+    }
+
+    /**
+     * @brief Tells if the training started with begin() converged or
+     * reached the maximum number of iterations
+     */
+    bool isFinished() const
+    { return m_converged || m_iterations.size() > m_max_iterations; }
+
+    /**
+     * @brief Returns the state after each iteration of the last training
+     */
+    const std::vector<EMIteration>& getIterations() const
+    { return m_iterations; }
+
+    /**
+     * @brief Tells if the last training stopped because of the convergence
+     * criterion
+     */
+    bool hasConverged() const
+    { return m_converged; }
+
+    size_t getMaxIterations() const
+    { return m_max_iterations; }
+
+    void setMaxIterations(const size_t max_iterations)
+    { m_max_iterations = max_iterations; }
+
+    double getConvergenceThreshold() const
+    { return m_convergence_threshold; }
+
+    void setConvergenceThreshold(const double convergence_threshold)
+    { m_convergence_threshold = convergence_threshold; }
+
+  private:
+    static boost::posix_time::ptime now()
+    { return boost::posix_time::microsec_clock::universal_time(); }
+
+    static double elapsed(const boost::posix_time::ptime& start)
+    { return (now() - start).total_microseconds() * 1e-6; }
+
+    size_t m_max_iterations;
+    double m_convergence_threshold;
+    bool m_converged;
+    double m_likelihood;
+    std::vector<EMIteration> m_iterations;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_EMTRAININGDRIVER_H
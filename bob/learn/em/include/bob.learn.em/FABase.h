@@ -14,6 +14,7 @@
 #include <stdexcept>
 
 #include <bob.learn.em/GMMMachine.h>
+#include <bob.learn.em/CenteredGMMStats.h>
 #include <boost/shared_ptr.hpp>
 
 namespace bob { namespace learn { namespace em {
@@ -221,6 +222,12 @@ class FABase
      */
     void estimateX(const bob::learn::em::GMMStats& gmm_stats, blitz::Array<double,1>& x) const;
 
+    /**
+     * @brief Estimates x from GMM statistics already centered with respect
+     * to the UBM, considering the LPT assumption
+     */
+    void estimateX(const bob::learn::em::CenteredGMMStats& gmm_stats, blitz::Array<double,1>& x) const;
+
     /**
      * @brief Compute and put U^{T}.Sigma^{-1} matrix in cache
      * @warning Should only be used by the trainer for efficiency reason,
@@ -248,6 +255,12 @@ class FABase
      */
     void computeIdPlusUSProdInv(const bob::learn::em::GMMStats& gmm_stats,
       blitz::Array<double,2>& out) const;
+    /**
+     * @brief Computes (Id + U^T.Sigma^-1.U.N_{i,h}.U)^-1 from the zeroth
+     * order statistics N_{i,h} only
+     */
+    void computeIdPlusUSProdInv(const blitz::Array<double,1>& n,
+      blitz::Array<double,2>& out) const;
     /**
      * @brief Computes Fn_x = sum_{sessions h}(N*(o - m))
      * (Normalised first order statistics)
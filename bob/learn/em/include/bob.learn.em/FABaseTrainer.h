@@ -294,6 +294,18 @@ class FABaseTrainer
     { bob::core::array::assertSameShape(acc, m_acc_D_A2);
       m_acc_D_A2 = acc; }
 
+    /**
+     * @brief Saves the state of the trainer (latent variables and
+     * accumulators) to checkpoint a training. The configuration is not
+     * saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
 
   private:
     size_t m_Nid; // Number of identities
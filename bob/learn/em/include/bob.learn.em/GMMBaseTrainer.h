@@ -13,6 +13,7 @@
 
 #include <bob.learn.em/GMMMachine.h>
 #include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/DataSource.h>
 #include <limits>
 
 namespace bob { namespace learn { namespace em {
@@ -61,6 +62,12 @@ class GMMBaseTrainer
      void eStep(bob::learn::em::GMMMachine& gmm,
       const blitz::Array<double,2>& data);
 
+    /**
+     * @brief Same as above, on a full pass over a source of data
+     */
+     void eStep(bob::learn::em::GMMMachine& gmm,
+      bob::learn::em::DataSource& data);
+
     /**
      * @brief Computes the likelihood using current estimates of the latent
      * variables
@@ -89,6 +96,17 @@ class GMMBaseTrainer
     bool is_similar_to(const GMMBaseTrainer& b, const double r_epsilon=1e-5,
       const double a_epsilon=1e-8) const;
 
+    /**
+     * @brief Saves the state of the trainer (statistics of the last
+     * E-step) to checkpoint a training. The configuration is not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
     /**
      * @brief Returns the internal GMM statistics. Useful to parallelize the
      * E-step
@@ -105,21 +123,21 @@ class GMMBaseTrainer
     /**
      * update means on each iteration
      */
-    bool getUpdateMeans()
+    bool getUpdateMeans() const
     {return m_update_means;}
 
     /**
      * update variances on each iteration
      */
-    bool getUpdateVariances()
+    bool getUpdateVariances() const
     {return m_update_variances;}
 
 
-    bool getUpdateWeights()
+    bool getUpdateWeights() const
     {return m_update_weights;}
 
 
-    double getMeanVarUpdateResponsibilitiesThreshold()
+    double getMeanVarUpdateResponsibilitiesThreshold() const
     {return m_mean_var_update_responsibilities_threshold;}
 
 
@@ -86,6 +86,28 @@ class GMMMachine
      */
     void resize(const size_t n_gaussians, const size_t n_inputs);
 
+    /**
+     * Splits Gaussian components in two, as in the binary splitting
+     * training of UBMs.
+     * The two halves of a split component share its variances and half of
+     * its weight, and their means are moved by +/- epsilon standard
+     * deviations along the dimension of largest variance. The components
+     * with the largest weights are split first; the new components are
+     * appended after the existing ones.
+     * @param n_splits The number of components to split (at most
+     *                 getNGaussians())
+     * @param epsilon  The displacement of the means, in standard deviations
+     */
+    void split(const size_t n_splits, const double epsilon=0.2);
+
+    /**
+     * Removes Gaussian components. The remaining components keep their
+     * order, and their weights are rescaled to sum up to one.
+     * @param indices The indices of the components to remove (at least one
+     *                component must remain)
+     */
+    void removeGaussians(const std::vector<size_t>& indices);
+
 
     /////////////////////////
     // Getters
@@ -34,10 +34,15 @@ class GMMStats {
 
     /**
      * Constructor.
-     * @param n_gaussians Number of Gaussians in the mixture model.
-     * @param n_inputs    Feature dimensionality.
+     * @param n_gaussians  Number of Gaussians in the mixture model.
+     * @param n_inputs     Feature dimensionality.
+     * @param second_order Whether the second order statistics (sumPxx) are
+     *                     allocated and accumulated. If false, only n and
+     *                     sumPx are kept, which is sufficient for i-vector
+     *                     extraction, ISV/JFA enrollment and linear scoring.
      */
-    GMMStats(const size_t n_gaussians, const size_t n_inputs);
+    GMMStats(const size_t n_gaussians, const size_t n_inputs,
+      const bool second_order=true);
 
     /**
      * Copy constructor
@@ -82,10 +87,19 @@ class GMMStats {
 
     /**
      * Allocates space for the statistics and resets to zero.
-     * @param n_gaussians Number of Gaussians in the mixture model.
-     * @param n_inputs    Feature dimensionality.
+     * @param n_gaussians  Number of Gaussians in the mixture model.
+     * @param n_inputs     Feature dimensionality.
+     * @param second_order Whether the second order statistics are allocated
      */
-    void resize(const size_t n_gaussians, const size_t n_inputs);
+    void resize(const size_t n_gaussians, const size_t n_inputs,
+      const bool second_order=true);
+
+    /**
+     * Tells if the second order statistics (sumPxx) are allocated and
+     * accumulated. If not, sumPxx is an empty array.
+     */
+    bool hasSecondOrder() const
+    { return m_second_order; }
 
     /**
      * Resets statistics to zero.
@@ -114,6 +128,7 @@ class GMMStats {
 
     /**
      * For each Gaussian, the accumulated sum of responsibility times the sample squared
+     * (empty if the statistics are first order only)
      */
     blitz::Array<double,2> sumPxx;
 
@@ -134,6 +149,11 @@ class GMMStats {
      * Copy another GMMStats
      */
     void copy(const GMMStats&);
+
+    /**
+     * Whether sumPxx is allocated and accumulated
+     */
+    bool m_second_order;
 };
 
 } } } // namespaces
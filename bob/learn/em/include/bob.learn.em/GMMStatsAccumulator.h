@@ -0,0 +1,133 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief Resumable accumulation of GMM statistics over a long list of samples
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_GMMSTATSACCUMULATOR_H
+#define BOB_LEARN_EM_GMMSTATSACCUMULATOR_H
+
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/GMMMachine.h>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief Accumulates the GMM statistics of an ordered list of samples (e.g.
+ * the feature files of a corpus), and periodically saves the partial
+ * statistics together with the number of samples processed so far.
+ * @details A job that is killed can be restarted with the same list: after
+ * resume(), the samples before getCursor() must be skipped, and the
+ * accumulation continues exactly from the last checkpoint. As the samples
+ * are added in the same order, the final statistics are identical to the
+ * ones of an uninterrupted run.
+ *
+ * The checkpoint is first written to a temporary file, which then replaces
+ * the previous checkpoint, so that a job killed while saving leaves a valid
+ * checkpoint behind.
+ */
+class GMMStatsAccumulator {
+  public:
+    /**
+     * Constructor
+     * @param machine             The GMM used to compute the statistics
+     * @param checkpoint          The name of the HDF5 checkpoint file
+     * @param checkpoint_interval The number of samples between two checkpoints
+     * @param second_order        Whether the second order statistics are accumulated
+     */
+    GMMStatsAccumulator(boost::shared_ptr<const bob::learn::em::GMMMachine> machine,
+      const std::string& checkpoint, const size_t checkpoint_interval=1,
+      const bool second_order=true);
+
+    /**
+     * Destructor
+     */
+    ~GMMStatsAccumulator();
+
+    /**
+     * Loads the last checkpoint, if any. A checkpoint saved with a GMM of
+     * different shape or parameters is refused.
+     * @return the number of samples that were already processed
+     */
+    size_t resume();
+
+    /**
+     * Adds the statistics of the next sample (one feature vector per row)
+     * and saves a checkpoint if required
+     */
+    void accumulate(const blitz::Array<double,2>& input);
+
+    /**
+     * Skips the next sample (e.g. an empty or missing feature file) and
+     * saves a checkpoint if required
+     */
+    void skip();
+
+    /**
+     * Saves a checkpoint now
+     */
+    void checkpoint() const;
+
+    /**
+     * Resets the statistics and the cursor (the checkpoint file is kept
+     * until the next one is saved)
+     */
+    void reset();
+
+    /**
+     * Returns the number of samples processed so far
+     */
+    size_t getCursor() const
+    { return m_cursor; }
+
+    /**
+     * Returns the statistics accumulated so far
+     */
+    const bob::learn::em::GMMStats& getStats() const
+    { return m_stats; }
+
+    /**
+     * Returns the name of the checkpoint file
+     */
+    const std::string& getCheckpointFile() const
+    { return m_checkpoint; }
+
+    /**
+     * Returns the number of samples between two checkpoints
+     */
+    size_t getCheckpointInterval() const
+    { return m_checkpoint_interval; }
+
+    /**
+     * Sets the number of samples between two checkpoints
+     */
+    void setCheckpointInterval(const size_t checkpoint_interval);
+
+  private:
+    /**
+     * Advances the cursor and saves a checkpoint if required
+     */
+    void next();
+
+    /**
+     * A hash of the shape and parameters of the GMM, saved with the
+     * checkpoints to check that they were computed with the same GMM
+     */
+    uint64_t machineHash() const;
+
+    boost::shared_ptr<const bob::learn::em::GMMMachine> m_machine;
+    std::string m_checkpoint;
+    size_t m_checkpoint_interval;
+    size_t m_cursor;
+    bob::learn::em::GMMStats m_stats;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_GMMSTATSACCUMULATOR_H
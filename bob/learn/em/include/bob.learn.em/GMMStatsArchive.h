@@ -0,0 +1,286 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief An indexed archive of many GMMStats records in a single file
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_GMMSTATSARCHIVE_H
+#define BOB_LEARN_EM_GMMSTATSARCHIVE_H
+
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/GMMStatsSet.h>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief Layout of a GMMStats archive file.
+ * @details An archive starts with a header of 64 bytes (magic string,
+ * version, number of Gaussians C, feature dimensionality D and whether the
+ * second order statistics are stored), followed by fixed-size records.
+ * Each record holds a key of at most 255 characters (stored in 256 bytes),
+ * the number of frames T, the log likelihood, n (C), sumPx (C x D) and
+ * optionally sumPxx (C x D), all in the native byte order. Since all the
+ * records have the same size and are 8-byte aligned, the i'th record can
+ * be accessed directly and the arrays can be mapped in memory.
+ */
+struct GMMStatsArchiveLayout {
+  GMMStatsArchiveLayout(const size_t n_gaussians=0, const size_t n_inputs=0,
+    const bool second_order=true);
+
+  /**
+   * Size of a record in bytes
+   */
+  size_t recordSize() const;
+
+  static const size_t header_size = 64;
+  static const size_t key_size = 256;
+  static const size_t max_key_length = 255;
+
+  size_t n_gaussians;
+  size_t n_inputs;
+  bool second_order;
+};
+
+
+/**
+ * @brief Creates or extends a GMMStats archive, one record at a time.
+ * @details Records are appended at the end of the file as soon as they are
+ * given, so that a GMMStatsArchive opened on the same file sees the records
+ * written (and flushed) so far after a refresh(). The file is never
+ * truncated in place: a new archive, or an existing one with an incomplete
+ * last record, is written to a temporary file renamed into place, such that
+ * the readers which mapped the previous file keep its content.
+ */
+class GMMStatsArchiveWriter {
+  public:
+    /**
+     * Creates a new (empty) archive, replacing any existing file
+     * @param filename     The name of the archive file
+     * @param n_gaussians  Number of Gaussians in the mixture model.
+     * @param n_inputs     Feature dimensionality.
+     * @param second_order Whether the second order statistics are stored
+     */
+    GMMStatsArchiveWriter(const std::string& filename, const size_t n_gaussians,
+      const size_t n_inputs, const bool second_order=true);
+
+    /**
+     * Opens an existing archive to append records to it
+     * @param filename     The name of the archive file
+     */
+    GMMStatsArchiveWriter(const std::string& filename);
+
+    /**
+     * Destructor (flushes and closes the file)
+     */
+    ~GMMStatsArchiveWriter();
+
+    /**
+     * Appends a record
+     * @param key   A unique key of at most 255 characters
+     * @param stats The statistics, which must have the shape of the archive
+     */
+    void append(const std::string& key, const bob::learn::em::GMMStats& stats);
+
+    /**
+     * Flushes the records written so far to the file
+     */
+    void flush();
+
+    /**
+     * Flushes and closes the file. No record can be appended afterwards.
+     */
+    void close();
+
+    /**
+     * Returns the number of records in the archive
+     */
+    size_t size() const
+    { return m_keys.size(); }
+
+    size_t getNGaussians() const
+    { return m_layout.n_gaussians; }
+
+    size_t getNInputs() const
+    { return m_layout.n_inputs; }
+
+    bool hasSecondOrder() const
+    { return m_layout.second_order; }
+
+  private:
+    // Disable copy
+    GMMStatsArchiveWriter(const GMMStatsArchiveWriter&);
+    GMMStatsArchiveWriter& operator=(const GMMStatsArchiveWriter&);
+
+    std::string m_filename;
+    GMMStatsArchiveLayout m_layout;
+    std::ofstream m_file;
+    std::set<std::string> m_keys;
+    std::vector<char> m_buffer;
+};
+
+
+/**
+ * @brief Read-only, memory-mapped access to a GMMStats archive.
+ * @details The records can be accessed by position or by key. The arrays
+ * returned by getN(), getSumPx() and getSumPxx() are views on the mapped
+ * file (no data is copied, and the pages are only read from the disk when
+ * they are accessed). They must not be modified, and are only valid as long
+ * as this object exists and refresh() is not called.
+ */
+class GMMStatsArchive {
+  public:
+    /**
+     * Maps the given archive
+     */
+    GMMStatsArchive(const std::string& filename);
+
+    /**
+     * Destructor (unmaps the file)
+     */
+    ~GMMStatsArchive();
+
+    /**
+     * Remaps the archive, to access the records appended since it was
+     * opened
+     */
+    void refresh();
+
+    /**
+     * Returns the name of the archive file
+     */
+    const std::string& getFilename() const
+    { return m_filename; }
+
+    /**
+     * Returns the number of records
+     */
+    size_t size() const
+    { return m_keys.size(); }
+
+    size_t getNGaussians() const
+    { return m_layout.n_gaussians; }
+
+    size_t getNInputs() const
+    { return m_layout.n_inputs; }
+
+    bool hasSecondOrder() const
+    { return m_layout.second_order; }
+
+    /**
+     * Returns the key of the i'th record
+     */
+    const std::string& getKey(const size_t i) const;
+
+    /**
+     * Returns the keys of all the records, in order
+     */
+    const std::vector<std::string>& getKeys() const
+    { return m_keys; }
+
+    /**
+     * Tells if a record with the given key exists
+     */
+    bool contains(const std::string& key) const
+    { return m_index.find(key) != m_index.end(); }
+
+    /**
+     * Returns the position of the record with the given key
+     */
+    size_t getIndex(const std::string& key) const;
+
+    /**
+     * Returns the number of frames of the i'th record
+     */
+    uint64_t getT(const size_t i) const;
+
+    /**
+     * Returns the log likelihood of the i'th record
+     */
+    double getLogLikelihood(const size_t i) const;
+
+    /**
+     * Returns a view on n of the i'th record (C)
+     */
+    const blitz::Array<double,1> getN(const size_t i) const;
+
+    /**
+     * Returns a view on sumPx of the i'th record (C x D)
+     */
+    const blitz::Array<double,2> getSumPx(const size_t i) const;
+
+    /**
+     * Returns a view on sumPxx of the i'th record (C x D)
+     */
+    const blitz::Array<double,2> getSumPxx(const size_t i) const;
+
+    /**
+     * Returns a (strided) view on n of all the records (N x C)
+     */
+    const blitz::Array<double,2> getN() const;
+
+    /**
+     * Returns a (strided) view on sumPx of all the records (N x C x D)
+     */
+    const blitz::Array<double,3> getSumPx() const;
+
+    /**
+     * Returns a (strided) view on sumPxx of all the records (N x C x D)
+     */
+    const blitz::Array<double,3> getSumPxx() const;
+
+    /**
+     * Returns a copy of the i'th record as a GMMStats
+     */
+    boost::shared_ptr<bob::learn::em::GMMStats> getStats(const size_t i) const;
+
+    /**
+     * Returns a copy of the record with the given key as a GMMStats
+     */
+    boost::shared_ptr<bob::learn::em::GMMStats> getStats(const std::string& key) const
+    { return getStats(getIndex(key)); }
+
+    /**
+     * Copies all the records into a GMMStatsSet (resized if required)
+     */
+    void getStatsSet(bob::learn::em::GMMStatsSet& output) const;
+
+    /**
+     * Returns the address of the first byte of the i'th record in memory
+     */
+    const char* getRecord(const size_t i) const;
+
+    /**
+     * Returns the layout of the archive
+     */
+    const GMMStatsArchiveLayout& getLayout() const
+    { return m_layout; }
+
+  private:
+    // Disable copy
+    GMMStatsArchive(const GMMStatsArchive&);
+    GMMStatsArchive& operator=(const GMMStatsArchive&);
+
+    void map();
+    void unmap();
+
+    std::string m_filename;
+    GMMStatsArchiveLayout m_layout;
+    char* m_data;
+    size_t m_length;
+    std::vector<std::string> m_keys;
+    std::map<std::string, size_t> m_index;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_GMMSTATSARCHIVE_H
@@ -0,0 +1,219 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief A contiguous container for the GMM statistics of many samples
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_GMMSTATSSET_H
+#define BOB_LEARN_EM_GMMSTATSSET_H
+
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <bob.io.base/HDF5File.h>
+#include <bob.learn.em/GMMStats.h>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief A container for the GMM statistics of N samples (e.g. utterances)
+ * stored in contiguous N x C, N x C x D (and optionally N x C x D second
+ * order) arrays.
+ * @details Consumers such as the IVectorTrainer or the linear scoring can
+ * process all the samples at once using matrix products, instead of looping
+ * over separately allocated GMMStats objects.
+ * @see GMMStats
+ */
+class GMMStatsSet {
+  public:
+
+    /**
+     * Default constructor (empty set).
+     */
+    GMMStatsSet();
+
+    /**
+     * Constructor.
+     * @param n_samples    Number of samples (GMMStats) in the set.
+     * @param n_gaussians  Number of Gaussians in the mixture model.
+     * @param n_inputs     Feature dimensionality.
+     * @param second_order Whether the second order statistics are allocated
+     */
+    GMMStatsSet(const size_t n_samples, const size_t n_gaussians,
+      const size_t n_inputs, const bool second_order=true);
+
+    /**
+     * Constructor, which packs a list of GMMStats.
+     * All the GMMStats must have the same shape. The second order statistics
+     * are only kept if all the GMMStats have them.
+     */
+    GMMStatsSet(const std::vector<bob::learn::em::GMMStats>& stats);
+
+    /**
+     * Constructor, which packs a list of GMMStats.
+     * All the GMMStats must have the same shape. The second order statistics
+     * are only kept if all the GMMStats have them.
+     */
+    GMMStatsSet(const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats);
+
+    /**
+     * Copy constructor
+     */
+    GMMStatsSet(const GMMStatsSet& other);
+
+    /**
+     * Constructor (from a Configuration)
+     */
+    GMMStatsSet(bob::io::base::HDF5File& config);
+
+    /**
+     * Destructor
+     */
+    ~GMMStatsSet();
+
+    /**
+     * Assigment
+     */
+    GMMStatsSet& operator=(const GMMStatsSet& other);
+
+    /**
+     * Equal to
+     */
+    bool operator==(const GMMStatsSet& b) const;
+
+    /**
+     * Not Equal to
+     */
+    bool operator!=(const GMMStatsSet& b) const;
+
+    /**
+     * @brief Similar to
+     */
+    bool is_similar_to(const GMMStatsSet& b, const double r_epsilon=1e-5,
+      const double a_epsilon=1e-8) const;
+
+    /**
+     * Allocates space for the statistics and resets to zero.
+     * @param n_samples    Number of samples (GMMStats) in the set.
+     * @param n_gaussians  Number of Gaussians in the mixture model.
+     * @param n_inputs     Feature dimensionality.
+     * @param second_order Whether the second order statistics are allocated
+     */
+    void resize(const size_t n_samples, const size_t n_gaussians,
+      const size_t n_inputs, const bool second_order=true);
+
+    /**
+     * Resets statistics to zero.
+     */
+    void init();
+
+    /**
+     * Returns the number of samples N
+     */
+    size_t getNSamples() const
+    { return n.extent(0); }
+
+    /**
+     * Returns the number of Gaussians C
+     */
+    size_t getNGaussians() const
+    { return n.extent(1); }
+
+    /**
+     * Returns the feature dimensionality D
+     */
+    size_t getNInputs() const
+    { return sumPx.extent(2); }
+
+    /**
+     * Tells if the second order statistics (sumPxx) are allocated
+     */
+    bool hasSecondOrder() const
+    { return m_second_order; }
+
+    /**
+     * Returns a GMMStats whose arrays are views on the statistics of the
+     * i'th sample (no data is copied). Modifying the arrays of the returned
+     * GMMStats modifies this set. T and log_likelihood are copied.
+     */
+    boost::shared_ptr<bob::learn::em::GMMStats> getStats(const size_t i) const;
+
+    /**
+     * Copies the given GMMStats into the i'th sample of this set
+     */
+    void setStats(const size_t i, const bob::learn::em::GMMStats& stats);
+
+    /**
+     * Computes the centered first order statistics of the samples
+     * with respect to the given mean supervector (of length CD), i.e.
+     * output(j, c*D+d) = sumPx(start+j,c,d) - n(start+j,c) * mean_supervector(c*D+d)
+     * @param mean_supervector The mean supervector (e.g. of the UBM)
+     * @param output           An M x CD array, for the samples start to
+     *                         start+M-1 (all the samples by default)
+     * @param start            The first sample
+     */
+    void computeCenteredSumPx(const blitz::Array<double,1>& mean_supervector,
+      blitz::Array<double,2>& output, const size_t start=0) const;
+
+    /**
+     * Save to a Configuration
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * Load from a Configuration
+     */
+    void load(bob::io::base::HDF5File& config);
+
+    /**
+     * The accumulated log likelihood of all frames, for each sample
+     */
+    blitz::Array<double,1> log_likelihood;
+
+    /**
+     * The accumulated number of frames, for each sample
+     */
+    blitz::Array<uint64_t,1> T;
+
+    /**
+     * For each sample and each Gaussian, the accumulated sum of
+     * responsibilities (N x C)
+     */
+    blitz::Array<double,2> n;
+
+    /**
+     * For each sample and each Gaussian, the accumulated sum of
+     * responsibility times the frame (N x C x D)
+     */
+    blitz::Array<double,3> sumPx;
+
+    /**
+     * For each sample and each Gaussian, the accumulated sum of
+     * responsibility times the frame squared (N x C x D, or empty if the
+     * statistics are first order only)
+     */
+    blitz::Array<double,3> sumPxx;
+
+  private:
+    /**
+     * Copy another GMMStatsSet
+     */
+    void copy(const GMMStatsSet&);
+
+    /**
+     * Packs a list of GMMStats
+     */
+    void pack(const std::vector<const bob::learn::em::GMMStats*>& stats);
+
+    /**
+     * Whether sumPxx is allocated
+     */
+    bool m_second_order;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_GMMSTATSSET_H
@@ -202,6 +202,13 @@ class ISVBase
     void estimateX(const bob::learn::em::GMMStats& gmm_stats, blitz::Array<double,1>& x) const
     { m_base.estimateX(gmm_stats, x); }
 
+    /**
+     * @brief Estimates x from GMM statistics already centered with respect
+     * to the UBM, considering the LPT assumption
+     */
+    void estimateX(const bob::learn::em::CenteredGMMStats& gmm_stats, blitz::Array<double,1>& x) const
+    { m_base.estimateX(gmm_stats, x); }
+
     /**
      * @brief Precompute (put U^{T}.Sigma^{-1} matrix in cache)
      * @warning Should only be used by the trainer for efficiency reason,
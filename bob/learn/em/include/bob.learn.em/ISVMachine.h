@@ -166,6 +166,13 @@ class ISVMachine
      */
     void estimateX(const bob::learn::em::GMMStats& gmm_stats, blitz::Array<double,1>& x) const
     { m_isv_base->estimateX(gmm_stats, x); }
+
+    /**
+     * @brief Estimates x from GMM statistics already centered with respect
+     * to the UBM, considering the LPT assumption
+     */
+    void estimateX(const bob::learn::em::CenteredGMMStats& gmm_stats, blitz::Array<double,1>& x) const
+    { m_isv_base->estimateX(gmm_stats, x); }
     /**
      * @brief Estimates Ux from the GMM statistics considering the LPT
      * assumption, that is the latent session variable x is approximated
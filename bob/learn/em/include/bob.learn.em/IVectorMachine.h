@@ -11,6 +11,7 @@
 #include <blitz/array.h>
 #include <bob.learn.em/GMMMachine.h>
 #include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/CenteredGMMStats.h>
 #include <bob.io.base/HDF5File.h>
 
 namespace bob { namespace learn { namespace em {
@@ -205,12 +206,26 @@ class IVectorMachine
      */
     void computeIdTtSigmaInvT(const bob::learn::em::GMMStats& input, blitz::Array<double,2>& output) const;
 
+    /**
+     * @brief Computes \f$(Id + \sum_{c=1}^{C} N_{i,j,c} T^{T} \Sigma_{c}^{-1} T)\f$
+     * from the zeroth order statistics \f$N_{i,j}\f$ only
+     * @warning No check is perform
+     */
+    void computeIdTtSigmaInvT(const blitz::Array<double,1>& n, blitz::Array<double,2>& output) const;
+
     /**
      * @brief Computes \f$T^{T} \Sigma^{-1} \sum_{c=1}^{C} (F_c - N_c ubmmean_{c})\f$
      * @warning No check is perform
      */
     void computeTtSigmaInvFnorm(const bob::learn::em::GMMStats& input, blitz::Array<double,1>& output) const;
 
+    /**
+     * @brief Computes \f$T^{T} \Sigma^{-1} \sum_{c=1}^{C} (F_c - N_c ubmmean_{c})\f$
+     * from statistics already centered with respect to the UBM
+     * @warning No check is perform
+     */
+    void computeTtSigmaInvFnorm(const bob::learn::em::CenteredGMMStats& input, blitz::Array<double,1>& output) const;
+
     /**
      * @brief Extracts an ivector from the input GMM statistics
      *
@@ -228,6 +243,15 @@ class IVectorMachine
      */
     void forward_(const bob::learn::em::GMMStats& input, blitz::Array<double,1>& output) const;
 
+    /**
+     * @brief Extracts an ivector from GMM statistics already centered with
+     * respect to the UBM of this machine
+     *
+     * @param input centered GMM statistics to be used by the machine
+     * @param output I-vector computed by the machine
+     */
+    void forward(const bob::learn::em::CenteredGMMStats& input, blitz::Array<double,1>& output) const;
+
   private:
     /**
      * @brief Apply the variance flooring thresholds.
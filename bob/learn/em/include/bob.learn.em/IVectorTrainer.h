@@ -11,6 +11,7 @@
 #include <blitz/array.h>
 #include <bob.learn.em/IVectorMachine.h>
 #include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/GMMStatsSet.h>
 #include <boost/shared_ptr.hpp>
 #include <vector>
 #include <bob.core/array_copy.h>
@@ -70,6 +71,15 @@ class IVectorTrainer
     virtual void eStep(bob::learn::em::IVectorMachine& ivector,
       const std::vector<bob::learn::em::GMMStats>& data);
 
+    /**
+     * @brief Calculates the same statistics as eStep() above, from a
+     * contiguous set of GMM statistics. The projections of the first
+     * order statistics and the accumulations over the samples are
+     * computed with matrix products.
+     */
+    virtual void eStep(bob::learn::em::IVectorMachine& ivector,
+      const bob::learn::em::GMMStatsSet& data);
+
     /**
      * @brief Maximisation step: Update the Total Variability matrix \f$T\f$
      * and \f$\Sigma\f$ if update_sigma is enabled.
@@ -131,6 +141,18 @@ class IVectorTrainer
       m_rng = rng;
     };
 
+    /**
+     * @brief Saves the state of the trainer (random number generator
+     * and accumulators) to checkpoint a training. The configuration is
+     * not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
   protected:
     // Attributes
     bool m_update_sigma;
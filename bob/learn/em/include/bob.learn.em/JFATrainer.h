@@ -161,6 +161,18 @@ class JFATrainer
     const boost::shared_ptr<boost::mt19937> getRng() const
     { return m_rng; }
 
+    /**
+     * @brief Saves the state of the trainer (random number generator,
+     * latent variables and accumulators) to checkpoint a training. The
+     * configuration is not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
     /**
      * @brief Get the x speaker factors
      */
@@ -0,0 +1,98 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief A k-d tree over a fixed set of points, for exact nearest neighbour
+ * searches in low dimensions
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_KDTREE_H
+#define BOB_LEARN_EM_KDTREE_H
+
+#include <blitz/array.h>
+#include <vector>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief A k-d tree over the rows of a matrix (e.g., the means of a
+ * KMeansMachine).
+ * @details Each node splits its points at the median of the dimension
+ * with the largest spread, down to leaves of at most leaf_size points, and
+ * keeps the bounding box of its points. A search visits the closest child
+ * first and skips the nodes whose bounding box is farther than the closest
+ * point found so far, which gives the exact nearest point.
+ *
+ * The points with a coordinate which is not finite (e.g., the mean of an
+ * empty cluster) are left out: as with an exhaustive search, they are never
+ * the nearest point.
+ *
+ * The tree is a copy of the points: it must be rebuilt when they change.
+ * It is never modified after its construction, such that it can be
+ * searched by several threads at once.
+ */
+class KDTree
+{
+  public:
+    /**
+     * @brief Builds the tree over the rows of points
+     */
+    KDTree(const blitz::Array<double,2>& points, const size_t leaf_size=8);
+
+    /**
+     * @brief Finds the point closest (in terms of Square Euclidean distance)
+     * to x. When several points are at the same distance, the one with the
+     * smallest index is returned, as by an exhaustive search. If no point
+     * is at a finite distance (e.g., if the query is not finite), the index
+     * 0 and the largest double are returned, as by
+     * KMeansMachine::getClosestMeans().
+     * @param x        The query (of length getNInputs())
+     * @param index    (output) The index (row) of the closest point
+     * @param distance (output) The Square Euclidean distance to it
+     * @return The number of distances to points computed by the search
+     */
+    size_t getNearest(const blitz::Array<double,1>& x, size_t& index,
+      double& distance) const;
+
+    /**
+     * @brief Same as above, with a contiguous query, which avoids a copy
+     * when searching many queries
+     */
+    size_t getNearest(const double* x, size_t& index, double& distance) const;
+
+    /// The number of points in the tree, i.e., of the finite ones
+    size_t getNPoints() const { return m_ids.size(); }
+    size_t getNInputs() const { return m_n_inputs; }
+    size_t getNNodes() const { return m_nodes.size(); }
+
+  private:
+    struct Node {
+      int start; ///< first point of the node (in m_points)
+      int end; ///< one past the last point of the node
+      int left; ///< child nodes, -1 for a leaf
+      int right;
+    };
+
+    int build(std::vector<int>& order, const blitz::Array<double,2>& points,
+      const int start, const int end, const size_t leaf_size);
+
+    double boxDistance(const int node, const double* x) const;
+
+    void search(const int node, const double* x, int& best,
+      double& best_distance, size_t& n_distances) const;
+
+    size_t m_n_inputs;
+    std::vector<Node> m_nodes;
+    /// the points in the order of the leaves (row-major) and their indices
+    std::vector<double> m_points;
+    std::vector<int> m_ids;
+    /// the bounding box of each node (row-major, one row per node)
+    std::vector<double> m_lower;
+    std::vector<double> m_upper;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_KDTREE_H
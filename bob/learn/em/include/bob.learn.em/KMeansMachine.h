@@ -12,6 +12,8 @@
 #include <cfloat>
 
 #include <bob.io.base/HDF5File.h>
+#include <bob.learn.em/KDTree.h>
+#include <boost/shared_ptr.hpp>
 
 namespace bob { namespace learn { namespace em {
 
@@ -129,10 +131,40 @@ class KMeansMachine {
      /**
      * Get the means in order to be updated (i.e. a 2D array, with as many
      * rows as means, and as many columns as feature dimensions.)
-     * @warning Only trainers should use this function for efficiency reasons
+     * @warning Only trainers should use this function for efficiency reasons.
+     * This clears the index of the means, which the trainer should rebuild
+     * with updateIndex() once the means are updated.
      */
     blitz::Array<double,2>& updateMeans()
-    { return m_means; }
+    { m_index.reset(); return m_means; }
+
+    /**
+     * Builds a k-d tree index of the means when it pays off, i.e., when the
+     * means are many and of a low dimensionality, and clears it otherwise.
+     * This is done by setMeans(), resize() and load(), and by the trainers
+     * after each update of the means.
+     */
+    void updateIndex();
+
+    /**
+     * Builds a k-d tree index of the means, with which getClosestMean() and
+     * getClosestMeans() find the closest mean by an exact tree search
+     * instead of an exhaustive one. setMean() and updateMeans() clear it.
+     */
+    void buildIndex();
+
+    /**
+     * Clears the index of the means, such that the closest means are found
+     * by an exhaustive search
+     */
+    void clearIndex()
+    { m_index.reset(); }
+
+    /**
+     * Tells if the means are indexed
+     */
+    bool hasIndex() const
+    { return m_index.get() != 0; }
 
     /**
      * Return the power of two of the (Square Euclidean) distance of the
@@ -159,6 +191,38 @@ class KMeansMachine {
      */
     double getMinDistance(const blitz::Array<double,1>& input) const;
 
+    /**
+     * Calculate the index of the closest mean and the distance to it for
+     * each sample (row) of the data, by tiles of samples.
+     * @details The means are ranked with the expansion
+     * \f$\|x-m\|^2 = \|x\|^2 - 2 x^T m + \|m\|^2\f$, where the dot
+     * products of a tile with all the means are a single matrix product,
+     * computed by BLAS (dgemm), and \f$\|x\|^2\f$ does not change the ranking. As the expansion is
+     * rounded differently (and loses precision by cancellation when the
+     * samples are far from the origin), the means whose score is within a
+     * small margin of the best one are then ranked by their distance,
+     * computed directly: the closest mean is the one of getClosestMean().
+     * If the means are indexed (see buildIndex()), each sample is instead
+     * searched in the index.
+     * @param data The data samples (one per row)
+     * @param closest_means (output) The index of the closest mean of each
+     *   sample
+     * @param min_distances (output) The distance of each sample from its
+     *   closest mean
+     * @return The number of distances to the means computed (i.e., the
+     *   number of samples times the number of means, unless the means are
+     *   indexed)
+     */
+    size_t getClosestMeans(const blitz::Array<double,2>& data,
+      blitz::Array<int,1>& closest_means, blitz::Array<double,1>& min_distances) const;
+
+    /**
+     * Output the minimum (Square Euclidean) distance between each sample
+     * (row) of the data and one of the means, using getClosestMeans()
+     */
+    void getMinDistance(const blitz::Array<double,2>& data,
+      blitz::Array<double,1>& min_distances) const;
+
     /**
      * For each mean, find the subset of the samples
      * that is closest to that mean, and calculate
@@ -168,6 +232,8 @@ class KMeansMachine {
      * @param[out] variances The cluster variances (one row per cluster),
      *                       with as many columns as feature dimensions.
      * @param[out] weights   A vector of weights, one per cluster
+     * This is a full pass over the data, which the KMeansTrainer can save
+     * (see KMeansTrainer::setComputeVariances()).
      */
     void getVariancesAndWeightsForEachCluster(const blitz::Array<double,2> &data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
     /**
@@ -181,6 +247,14 @@ class KMeansMachine {
     void getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2> &data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
     void getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
 
+    /**
+     * Turns the per-cluster sums of the samples, of their squares and the
+     * per-cluster counts into the means (in place of the sums), variances
+     * and weights of the clusters
+     */
+    static void finalizeVariancesAndWeights(blitz::Array<double,2>& sums,
+      blitz::Array<double,2>& variances, blitz::Array<double,1>& weights);
+
     /**
      * Get the m_cache_means array.
      * @warning This variable should only be used in the case you want to parallelize the
@@ -218,6 +292,14 @@ class KMeansMachine {
 
 
   private:
+    /**
+     * Adds the sums of the samples, of their squares and the counts of the
+     * samples of each cluster
+     */
+    void accumulateVariancesAndWeights(const blitz::Array<double,2>& data,
+      blitz::Array<double,2>& sums, blitz::Array<double,2>& variances,
+      blitz::Array<double,1>& weights) const;
+
      /**
      * The number of means
      */
@@ -237,6 +319,12 @@ class KMeansMachine {
      * cache to avoid re-allocation
      */
     mutable blitz::Array<double,2> m_cache_means;
+
+    /**
+     * The index of the means, if any. It is never modified once built, and
+     * thus shared by the copies of the machine.
+     */
+    boost::shared_ptr<const KDTree> m_index;
 };
 
 } } } // namespaces
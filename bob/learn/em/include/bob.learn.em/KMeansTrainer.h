@@ -9,6 +9,8 @@
 #define BOB_LEARN_EM_KMEANSTRAINER_H
 
 #include <bob.learn.em/KMeansMachine.h>
+#include <bob.learn.em/DataSource.h>
+#include <bob.io.base/HDF5File.h>
 #include <boost/version.hpp>
 #include <boost/random/mersenne_twister.hpp>
 
@@ -32,7 +34,8 @@ class KMeansTrainer
       RANDOM_NO_DUPLICATE
 #if BOOST_VERSION >= 104700
       ,
-      KMEANS_PLUS_PLUS
+      KMEANS_PLUS_PLUS,
+      KMEANS_PARALLEL
 #endif
     }
     InitializationMethod;
@@ -76,6 +79,11 @@ class KMeansTrainer
      * @brief Initialise the means randomly.
      * Data is split into as many chunks as there are means,
      * then each mean is set to a random example within each chunk.
+     * With KMEANS_PLUS_PLUS, the means are drawn one after the other, with
+     * a probability depending on the distance to the closest mean already
+     * drawn. With KMEANS_PARALLEL (Bahmani et al., "Scalable K-Means++",
+     * 2012), a few rounds each draw many candidates in a single pass over
+     * the data, and the means are then drawn among the candidates only.
      */
     void initialize(bob::learn::em::KMeansMachine& kMeansMachine,
       const blitz::Array<double,2>& sampler);
@@ -89,6 +97,12 @@ class KMeansTrainer
     void eStep(bob::learn::em::KMeansMachine& kmeans,
       const blitz::Array<double,2>& data);
 
+    /**
+     * @brief Same as above, on a full pass over a source of data
+     */
+    void eStep(bob::learn::em::KMeansMachine& kmeans,
+      bob::learn::em::DataSource& data);
+
     /**
      * @brief Updates the mean based on the statistics from the E-step.
      */
@@ -142,9 +156,130 @@ class KMeansTrainer
     void setFirstOrderStats(const blitz::Array<double,2>& firstOrderStats);
     void setAverageMinDistance(const double value) { m_average_min_distance = value; }
 
+    /**
+     * @brief Sets the number of candidates expected at each round of the
+     * KMEANS_PARALLEL initialization (0, the default, for twice the
+     * number of means)
+     */
+    void setOversamplingFactor(const double v) { m_oversampling_factor = v; }
+    double getOversamplingFactor() const { return m_oversampling_factor; }
+
+    /**
+     * @brief Sets the number of rounds (passes over the data) of the
+     * KMEANS_PARALLEL initialization
+     */
+    void setNParallelRounds(const size_t v) { m_n_parallel_rounds = v; }
+    size_t getNParallelRounds() const { return m_n_parallel_rounds; }
+
+    /**
+     * @brief Makes the E-step also accumulate the sums of the squares of
+     * the samples of each cluster, such that the variances and weights of
+     * the clusters can be computed without another pass over the data
+     * (see getVariancesAndWeightsForEachCluster())
+     */
+    void setComputeVariances(const bool v) { m_compute_variances = v; }
+    bool getComputeVariances() const { return m_compute_variances; }
+
+    /**
+     * @brief Computes the variances and weights of the clusters from the
+     * statistics of the last E-step, which must have been run with
+     * setComputeVariances(true). This is the same as
+     * KMeansMachine::getVariancesAndWeightsForEachCluster() on the data of
+     * the last E-step, given that the machine was not updated since.
+     */
+    void getVariancesAndWeightsForEachCluster(const bob::learn::em::KMeansMachine& kmeans,
+      blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
+    const blitz::Array<double,2>& getSecondOrderStats() const { return m_secondOrderStats; }
+
+    /**
+     * @brief Sets the number of threads of the E-step. Each thread
+     * accumulates the statistics of contiguous samples, which are then
+     * summed in the order of the samples: the statistics only depend on the
+     * number of threads (and with a single thread, they are accumulated in
+     * place, sample by sample).
+     */
+    void setNThreads(const size_t n_threads);
+    size_t getNThreads() const { return m_n_threads; }
+
+    /**
+     * @brief Enables the E-step accelerated with the triangle inequality
+     * (Hamerly, "Making k-means even faster", 2010).
+     * @details A lower bound on the distance of each sample to its second
+     * closest mean is kept between the E-steps, and decreased by the drift
+     * of the means. When the distance to the assigned mean is below this
+     * bound (or below half the distance to the closest other mean), the
+     * assignment cannot change and the other means are skipped. The
+     * assignments and statistics are the same as the ones of the
+     * exhaustive search. The bounds are reused by the next E-step on an
+     * array, which must hold the same data unless clearBounds() is called
+     * in between (initialize() and load() clear them); the E-step on a
+     * DataSource is exhaustive.
+     */
+    void setAccelerated(const bool accelerated);
+    bool getAccelerated() const { return m_accelerated; }
+
+    /**
+     * @brief Forgets the bounds of the accelerated E-step, which must be
+     * done before an E-step on other data
+     */
+    void clearBounds();
+
+    /**
+     * @brief Returns the number of distances computed by the last E-step
+     */
+    size_t getNDistances() const { return m_n_distances; }
+
+    /**
+     * @brief Saves the state of the trainer (random number generator
+     * and statistics) to checkpoint a training. The configuration
+     * (e.g., the initialization method) is not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
 
   private:
 
+    /**
+     * @brief The samples processed by one thread of the E-step, and their
+     * statistics
+     */
+    struct Chunk;
+
+    /**
+     * @brief The KMEANS_PARALLEL initialization
+     */
+    void initializeParallel(bob::learn::em::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Adds the statistics and the distances to the closest mean of
+     * the given samples to the accumulators
+     */
+    void accumulate(bob::learn::em::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Same as accumulate(), using and updating the bounds of the
+     * accelerated E-step
+     */
+    void accumulateBounded(bob::learn::em::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Splits the samples into one chunk per thread, runs
+     * accumulateChunk() or accumulateBoundedChunk() on them, and adds their
+     * statistics to the accumulators
+     */
+    void accumulateChunks(bob::learn::em::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data, const Chunk& bounds, const bool bounded);
+    void accumulateChunk(Chunk& chunk) const;
+    void accumulateBoundedChunk(Chunk& chunk) const;
+
     /**
      * @brief The initialization method
      * Check that there is no duplicated means during the random initialization
@@ -174,6 +309,37 @@ class KMeansTrainer
      * equation 9.4, Bishop, "Pattern recognition and machine learning", 2006
      */
     blitz::Array<double,2> m_firstOrderStats;
+
+    /**
+     * @brief Second order statistics accumulator (the sums of the squares
+     * of the samples of each cluster), only if m_compute_variances is set
+     */
+    bool m_compute_variances;
+    blitz::Array<double,2> m_secondOrderStats;
+
+    /**
+     * @brief Configuration of the KMEANS_PARALLEL initialization
+     */
+    double m_oversampling_factor;
+    size_t m_n_parallel_rounds;
+
+    /**
+     * @brief The number of threads of the E-step
+     */
+    size_t m_n_threads;
+
+    /**
+     * @brief Accelerated E-step: the means of the previous E-step, and for
+     * each sample, its assigned mean and a lower bound of the (Euclidean)
+     * distance to the other means. They are not copied with the trainer.
+     */
+    bool m_accelerated;
+    blitz::Array<double,2> m_bound_means;
+    blitz::Array<int,1> m_assignment;
+    blitz::Array<double,1> m_lower_bound;
+    mutable blitz::Array<double,1> m_cache_drift;
+    mutable blitz::Array<double,1> m_cache_half_separation;
+    size_t m_n_distances;
 };
 
 } } } // namespaces
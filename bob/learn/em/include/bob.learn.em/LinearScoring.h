@@ -11,6 +11,8 @@
 #include <boost/shared_ptr.hpp>
 #include <vector>
 #include <bob.learn.em/GMMMachine.h>
+#include <bob.learn.em/GMMStatsSet.h>
+#include <bob.learn.em/CenteredGMMStats.h>
 
 namespace bob { namespace learn { namespace em {
 
@@ -77,6 +79,93 @@ void linearScoring(const std::vector<boost::shared_ptr<const bob::learn::em::GMM
                    const bool frame_length_normalisation,
                    blitz::Array<double,2>& scores);
 
+/**
+ * Compute a matrix of scores using linear scoring, with the statistics of
+ * all the test trials stored contiguously in a GMMStatsSet.
+ *
+ * @param models        list of mean supervector for the client models
+ * @param ubm_mean      mean supervector of the world model
+ * @param ubm_variance  variance supervector of the world model
+ * @param test_stats    accumulated statistics of all the test trials
+ * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
+ * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
+ */
+void linearScoring(const std::vector<blitz::Array<double,1> >& models,
+                   const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                   const bob::learn::em::GMMStatsSet& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double,2>& scores);
+
+/**
+ * Compute a matrix of scores using linear scoring, with the statistics of
+ * all the test trials stored contiguously in a GMMStatsSet.
+ *
+ * @param models      list of client models as GMMMachines
+ * @param ubm         world model as a GMMMachine
+ * @param test_stats  accumulated statistics of all the test trials
+ * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
+ * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
+ */
+void linearScoring(const std::vector<boost::shared_ptr<const bob::learn::em::GMMMachine> >& models,
+                   const bob::learn::em::GMMMachine& ubm,
+                   const bob::learn::em::GMMStatsSet& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double,2>& scores);
+
+/**
+ * Compute a matrix of scores using linear scoring, with the statistics of
+ * the test trials already centered with respect to the world model.
+ * The variance-normalized statistics are used when available, which avoids
+ * any per-call division by the world model variance.
+ *
+ * @param models        list of mean supervector for the client models
+ * @param ubm_mean      mean supervector of the world model
+ * @param ubm_variance  variance supervector of the world model
+ * @param test_stats    list of centered statistics for each test trial
+ * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
+ * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
+ */
+void linearScoring(const std::vector<blitz::Array<double,1> >& models,
+                   const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                   const std::vector<boost::shared_ptr<const bob::learn::em::CenteredGMMStats> >& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double,2>& scores);
+
+/**
+ * Compute a matrix of scores using linear scoring, with the statistics of
+ * the test trials already centered with respect to the world model.
+ *
+ * @param models      list of client models as GMMMachines
+ * @param ubm         world model as a GMMMachine
+ * @param test_stats  list of centered statistics for each test trial
+ * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
+ * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
+ */
+void linearScoring(const std::vector<boost::shared_ptr<const bob::learn::em::GMMMachine> >& models,
+                   const bob::learn::em::GMMMachine& ubm,
+                   const std::vector<boost::shared_ptr<const bob::learn::em::CenteredGMMStats> >& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double,2>& scores);
+
+/**
+ * Compute a score using linear scoring, with the statistics of the test
+ * trial already centered with respect to the world model.
+ *
+ * @param model         mean supervector for the client model
+ * @param ubm_mean      mean supervector of the world model
+ * @param ubm_variance  variance supervector of the world model
+ * @param test_stats    centered statistics of the test trial
+ * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
+ */
+double linearScoring(const blitz::Array<double,1>& model,
+                   const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                   const bob::learn::em::CenteredGMMStats& test_stats,
+                   const bool frame_length_normalisation);
+
 /**
  * Compute a score using linear scoring.
  *
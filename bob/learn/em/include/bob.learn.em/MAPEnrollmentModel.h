@@ -0,0 +1,127 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief A MAP-adapted model which keeps its enrollment statistics
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_MAPENROLLMENTMODEL_H
+#define BOB_LEARN_EM_MAPENROLLMENTMODEL_H
+
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <bob.io.base/HDF5File.h>
+#include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/GMMMachine.h>
+#include <bob.learn.em/MAP_GMMTrainer.h>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief An enrollment model obtained by MAP adaptation, which keeps the
+ * accumulated statistics of its enrollment sessions next to the adapted
+ * parameters.
+ * @details The statistics are computed with the prior GMM of the trainer,
+ * and the model is the result of a single MAP update (see
+ * MAP_GMMTrainer::enroll()) on the sum of the statistics of all the
+ * sessions. Adding a session therefore only requires its own statistics:
+ * they are added to the retained ones, and the model is re-derived in
+ * O(C.D), without going back to the features of the previous sessions.
+ * The result is the same as adapting the prior on all the sessions at once.
+ */
+class MAPEnrollmentModel {
+  public:
+    /**
+     * Creates an empty model (no session), equal to the prior GMM
+     * @param trainer The MAP trainer, which gives the prior GMM and the
+     *                adaptation parameters
+     */
+    MAPEnrollmentModel(boost::shared_ptr<const bob::learn::em::MAP_GMMTrainer> trainer);
+
+    /**
+     * Loads the statistics of a model from an HDF5 file, and re-derives it
+     * @param trainer The MAP trainer
+     * @param config  The HDF5 file
+     */
+    MAPEnrollmentModel(boost::shared_ptr<const bob::learn::em::MAP_GMMTrainer> trainer,
+      bob::io::base::HDF5File& config);
+
+    /**
+     * Destructor
+     */
+    ~MAPEnrollmentModel();
+
+    /**
+     * Adds the statistics of a new session, computed with the prior GMM,
+     * and re-derives the model. If the statistics of the first session have
+     * second order statistics, the following ones must have them too.
+     */
+    void addSession(const bob::learn::em::GMMStats& stats);
+
+    /**
+     * Computes the statistics of a new session with the prior GMM, adds
+     * them and re-derives the model
+     */
+    void addSession(const blitz::Array<double,2>& features);
+
+    /**
+     * Re-derives the model from the retained statistics, e.g. after the
+     * adaptation parameters of the trainer were changed
+     */
+    void update();
+
+    /**
+     * Returns the number of sessions added to the model
+     */
+    size_t getNSessions() const
+    { return m_n_sessions; }
+
+    /**
+     * Returns the sum of the statistics of the sessions
+     */
+    const bob::learn::em::GMMStats& getStats() const
+    { return m_stats; }
+
+    /**
+     * Returns the adapted model. It is overwritten each time the model is
+     * re-derived, and must not be modified.
+     */
+    boost::shared_ptr<bob::learn::em::GMMMachine> getMachine() const
+    { return m_machine; }
+
+    /**
+     * Returns the trainer
+     */
+    boost::shared_ptr<const bob::learn::em::MAP_GMMTrainer> getTrainer() const
+    { return m_trainer; }
+
+    /**
+     * Saves the number of sessions and the statistics to an HDF5 file (the
+     * model is re-derived when loading)
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * Loads the number of sessions and the statistics from an HDF5 file,
+     * and re-derives the model
+     */
+    void load(bob::io::base::HDF5File& config);
+
+  private:
+    // Disable copy
+    MAPEnrollmentModel(const MAPEnrollmentModel&);
+    MAPEnrollmentModel& operator=(const MAPEnrollmentModel&);
+
+    void reset();
+
+    boost::shared_ptr<const bob::learn::em::MAP_GMMTrainer> m_trainer;
+    boost::shared_ptr<bob::learn::em::GMMMachine> m_machine;
+    bob::learn::em::GMMStats m_stats;
+    size_t m_n_sessions;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_MAPENROLLMENTMODEL_H
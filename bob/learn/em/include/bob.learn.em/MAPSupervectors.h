@@ -0,0 +1,73 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief Closed-form mean-only MAP adaptation to supervectors
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_MAPSUPERVECTORS_H
+#define BOB_LEARN_EM_MAPSUPERVECTORS_H
+
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <limits>
+#include <vector>
+#include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/GMMMachine.h>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * The representation of the adapted models
+ */
+typedef enum {
+  /// The adapted means \f$m_c = (F_c + r \mu_c) / (N_c + r)\f$
+  MAP_MEANS = 0,
+  /// The offsets to the UBM means \f$m_c - \mu_c\f$
+  MAP_OFFSETS,
+  /// The offsets normalized with the UBM, \f$\sqrt{w_c} \Sigma_c^{-1/2} (m_c - \mu_c)\f$
+  /// (for which the dot product approximates the KL-divergence kernel)
+  MAP_NORMALIZED_OFFSETS
+}
+MAPSupervectorType;
+
+/**
+ * Adapts the means of the UBM to each of the given statistics, with a
+ * single mean-only MAP update with Reynolds' data-dependent adaptation
+ * coefficients \f$\alpha_c = N_c / (N_c + r)\f$, and writes the results as
+ * supervectors.
+ *
+ * This is the closed form of a MAP_GMMTrainer::mStep() with only the means
+ * updated and Reynolds' adaptation, without building any GMMMachine. As in
+ * the trainer, the Gaussians for which \f$N_c\f$ is below the
+ * responsibilities threshold keep the mean of the UBM.
+ *
+ * @param ubm              the prior GMM
+ * @param n                the zeroth order statistics of the N models (N x C)
+ * @param sumPx            the first order statistics of the N models (N x C x D)
+ * @param relevance_factor the relevance factor r
+ * @param[out] output      the supervectors (N x CD), resized if required
+ * @param type             the representation of the adapted models
+ * @param threshold        the mean_var_update_responsibilities_threshold
+ *   of the MAP_GMMTrainer
+ */
+void mapMeanSupervectors(const bob::learn::em::GMMMachine& ubm,
+  const blitz::Array<double,2>& n, const blitz::Array<double,3>& sumPx,
+  const double relevance_factor, blitz::Array<double,2>& output,
+  const MAPSupervectorType type=MAP_MEANS,
+  const double threshold=std::numeric_limits<double>::epsilon());
+
+/**
+ * Same as above, for a collection of GMMStats
+ */
+void mapMeanSupervectors(const bob::learn::em::GMMMachine& ubm,
+  const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+  const double relevance_factor, blitz::Array<double,2>& output,
+  const MAPSupervectorType type=MAP_MEANS,
+  const double threshold=std::numeric_limits<double>::epsilon());
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_MAPSUPERVECTORS_H
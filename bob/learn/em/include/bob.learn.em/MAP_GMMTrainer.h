@@ -13,6 +13,7 @@
 
 #include <bob.learn.em/GMMBaseTrainer.h>
 #include <limits>
+#include <vector>
 
 namespace bob { namespace learn { namespace em {
 
@@ -72,6 +73,17 @@ class MAP_GMMTrainer
     bool is_similar_to(const MAP_GMMTrainer& b, const double r_epsilon=1e-5,
       const double a_epsilon=1e-8) const;
 
+    /**
+     * @brief Saves the state of the trainer (statistics of the last
+     * E-step) to checkpoint a training. The configuration is not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
     /**
      * @brief Set the GMM to use as a prior for MAP adaptation.
      * Generally, this is a "universal background model" (UBM),
@@ -79,6 +91,12 @@ class MAP_GMMTrainer
      */
     bool setPriorGMM(boost::shared_ptr<bob::learn::em::GMMMachine> prior_gmm);
 
+    /**
+     * @brief Returns the GMM used as a prior for MAP adaptation
+     */
+    boost::shared_ptr<bob::learn::em::GMMMachine> getPriorGMM() const
+    { return m_prior_gmm; }
+
     /**
      * @brief Calculates and saves statistics across the dataset,
      * and saves these as m_ss. Calculates the average
@@ -93,6 +111,14 @@ class MAP_GMMTrainer
       m_gmm_base_trainer.eStep(gmm,data);
      }
 
+    /**
+     * @brief Same as above, on a full pass over a source of data
+     */
+     void eStep(bob::learn::em::GMMMachine& gmm,
+      bob::learn::em::DataSource& data){
+      m_gmm_base_trainer.eStep(gmm,data);
+     }
+
 
     /**
      * @brief Performs a maximum a posteriori (MAP) update of the GMM
@@ -102,6 +128,32 @@ class MAP_GMMTrainer
      */
     void mStep(bob::learn::em::GMMMachine& gmm);
 
+    /**
+     * @brief Adapts a batch of models from their statistics, which must
+     * have been accumulated with the prior GMM.
+     * @details The models are adapted in parallel, and written into
+     * contiguous model banks: the means of the n'th model go to
+     * means(n,:,:) and, when they are updated, its weights and variances to
+     * weights(n,:) and variances(n,:,:). The banks are resized if required
+     * (to empty arrays for the parameters which are not updated). The
+     * variance thresholds of the prior GMM are used.
+     */
+    void enroll(const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+      blitz::Array<double,3>& means, blitz::Array<double,2>& weights,
+      blitz::Array<double,3>& variances, const size_t n_threads=1) const;
+
+    /**
+     * @brief Adapts a batch of models from their features.
+     * @details Each model starts from the prior GMM, and n_iterations MAP
+     * updates are run. The statistics of the first iteration are computed
+     * with the prior GMM, the ones of the following iterations with the
+     * current model. See the other overload for the model banks.
+     */
+    void enroll(const std::vector<blitz::Array<double,2> >& features,
+      blitz::Array<double,3>& means, blitz::Array<double,2>& weights,
+      blitz::Array<double,3>& variances, const size_t n_iterations=1,
+      const size_t n_threads=1) const;
+
     /**
      * @brief Computes the likelihood using current estimates of the latent
      * variables
@@ -162,6 +214,36 @@ class MAP_GMMTrainer
     bool m_reynolds_adaptation;
 
   private:
+    /**
+     * @brief Performs the MAP update of the given parameters (C), (C x D)
+     * and (C x D), which hold the current model on input
+     */
+    void adapt(const bob::learn::em::GMMStats& stats,
+      blitz::Array<double,1>& weights, blitz::Array<double,2>& means,
+      blitz::Array<double,2>& variances,
+      const blitz::Array<double,2>& variance_thresholds) const;
+
+    /**
+     * @brief Prepares the model banks of a batch of n_models models
+     */
+    void resizeBanks(const size_t n_models, blitz::Array<double,3>& means,
+      blitz::Array<double,2>& weights, blitz::Array<double,3>& variances) const;
+
+    /**
+     * @brief Adapts the models [start, end[ of a batch from their statistics
+     */
+    void enrollStatsChunk(const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+      const size_t start, const size_t end, blitz::Array<double,3>& means,
+      blitz::Array<double,2>& weights, blitz::Array<double,3>& variances) const;
+
+    /**
+     * @brief Adapts the models [start, end[ of a batch from their features
+     */
+    void enrollFeaturesChunk(const std::vector<blitz::Array<double,2> >& features,
+      const size_t n_iterations, const size_t start, const size_t end,
+      blitz::Array<double,3>& means, blitz::Array<double,2>& weights,
+      blitz::Array<double,3>& variances) const;
+
     /// cache to avoid re-allocation
     mutable blitz::Array<double,1> m_cache_alpha;
     mutable blitz::Array<double,1> m_cache_ml_weights;
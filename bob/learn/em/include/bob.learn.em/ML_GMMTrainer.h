@@ -13,6 +13,7 @@
 
 #include <bob.learn.em/GMMBaseTrainer.h>
 #include <limits>
+#include <vector>
 
 namespace bob { namespace learn { namespace em {
 
@@ -61,6 +62,14 @@ class ML_GMMTrainer{
       m_gmm_base_trainer.eStep(gmm,data);
      }
 
+    /**
+     * @brief Same as above, on a full pass over a source of data
+     */
+     void eStep(bob::learn::em::GMMMachine& gmm,
+      bob::learn::em::DataSource& data){
+      m_gmm_base_trainer.eStep(gmm,data);
+     }
+
     /**
      * @brief Performs a maximum likelihood (ML) update of the GMM parameters
      * using the accumulated statistics in m_ss
@@ -68,6 +77,97 @@ class ML_GMMTrainer{
      */
     void mStep(bob::learn::em::GMMMachine& gmm);
 
+    /**
+     * @brief Performs one step of the stepwise (online) EM algorithm on a
+     * mini-batch of frames.
+     * @details The statistics of the mini-batch, normalized by its number of
+     * frames, are interpolated into running statistics s with a decaying
+     * step size: \f$s \leftarrow (1 - \eta_k) s + \eta_k \bar{s}_k\f$,
+     * where \f$\eta_k = (k + t_0)^{-\alpha}\f$ for the k'th mini-batch
+     * (the first mini-batch initializes s). The GMM parameters are then
+     * updated from s as in mStep(). See Cappe and Moulines, "Online EM
+     * algorithm for latent data models", 2009.
+     */
+    void stepwiseStep(bob::learn::em::GMMMachine& gmm,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Restarts the stepwise EM (discards the running statistics)
+     */
+    void resetStepwise();
+
+    /**
+     * @brief Returns the step size that will be used for the next mini-batch
+     */
+    double getStepSize() const;
+
+    /**
+     * @brief The decay exponent \f$\alpha\f$ of the step size, in ]0.5,1]
+     */
+    double getStepwiseDecay() const
+    { return m_stepwise_decay; }
+    void setStepwiseDecay(const double decay);
+
+    /**
+     * @brief The offset \f$t_0 \geq 0\f$ of the step size, which slows
+     * down the decay of the first steps
+     */
+    double getStepwiseOffset() const
+    { return m_stepwise_offset; }
+    void setStepwiseOffset(const double offset);
+
+    /**
+     * @brief The number of mini-batches processed since the last reset
+     */
+    size_t getStepwiseIteration() const
+    { return m_stepwise_iteration; }
+
+    /**
+     * @brief The running statistics of the stepwise EM, per frame (T=1)
+     */
+    const bob::learn::em::GMMStats& getStepwiseStats() const
+    { return m_stepwise_ss; }
+
+    /**
+     * @brief The occupancy threshold of the pruning of dead components.
+     * @details After the update of the parameters, mStep() removes the
+     * components whose occupancy (zeroth order statistics) was below this
+     * threshold during getPruneIterations() consecutive M-steps, so that
+     * the following E-steps do not evaluate them anymore. If
+     * getPruneResplit() is set, the heaviest components are split to
+     * replace them instead (see GMMMachine::split()). The statistics of the
+     * trainer are resized accordingly. A threshold of 0 (the default)
+     * disables the pruning.
+     */
+    double getPruneThreshold() const
+    { return m_prune_threshold; }
+    void setPruneThreshold(const double threshold);
+
+    /**
+     * @brief The number of consecutive M-steps with a low occupancy after
+     * which a component is pruned
+     */
+    size_t getPruneIterations() const
+    { return m_prune_iterations; }
+    void setPruneIterations(const size_t iterations);
+
+    /**
+     * @brief Whether the pruned components are replaced by splits of the
+     * heaviest components
+     */
+    bool getPruneResplit() const
+    { return m_prune_resplit; }
+    void setPruneResplit(const bool resplit)
+    { m_prune_resplit = resplit; }
+
+    /**
+     * @brief The components pruned since the last initialize(), in order of
+     * removal. Components are identified by their index at initialization;
+     * the components created by re-splits get the following indices.
+     */
+    const std::vector<size_t>& getPrunedComponents() const
+    { return m_pruned_components; }
+
     /**
      * @brief Computes the likelihood using current estimates of the latent
      * variables
@@ -98,6 +198,19 @@ class ML_GMMTrainer{
     bool is_similar_to(const ML_GMMTrainer& b, const double r_epsilon=1e-5,
       const double a_epsilon=1e-8) const;
 
+    /**
+     * @brief Saves the state of the trainer (statistics of the last
+     * E-step, stepwise statistics and tracking of the components for
+     * the pruning) to checkpoint a training. The configuration is not
+     * saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
 
     bob::learn::em::GMMBaseTrainer& base_trainer(){return m_gmm_base_trainer;}
 
@@ -110,10 +223,50 @@ class ML_GMMTrainer{
 
 
   private:
+    /**
+     * @brief Updates the GMM parameters from the given statistics
+     * @param frame_weight The weight of a frame in the statistics, by which
+     *   the responsibilities threshold (a number of frames) is scaled
+     */
+    void updateParameters(bob::learn::em::GMMMachine& gmm,
+      const bob::learn::em::GMMStats& stats, const double frame_weight=1.);
+
+    /**
+     * @brief Prunes the components which have been dead for too long
+     */
+    void prune(bob::learn::em::GMMMachine& gmm,
+      const bob::learn::em::GMMStats& stats);
+
+    /**
+     * @brief Restarts the tracking of the components for the pruning
+     */
+    void resetPruning(const size_t n_gaussians);
+
     /**
      * @brief Add cache to avoid re-allocation at each iteration
      */
     mutable blitz::Array<double,1> m_cache_ss_n_thresholded;
+
+    /**
+     * @brief Stepwise EM: step size parameters, number of mini-batches
+     * processed and running statistics
+     */
+    double m_stepwise_decay;
+    double m_stepwise_offset;
+    size_t m_stepwise_iteration;
+    bob::learn::em::GMMStats m_stepwise_ss;
+
+    /**
+     * @brief Pruning: parameters, number of consecutive M-steps with a low
+     * occupancy and identifier of each component, and pruned components
+     */
+    double m_prune_threshold;
+    size_t m_prune_iterations;
+    bool m_prune_resplit;
+    std::vector<size_t> m_prune_counts;
+    std::vector<size_t> m_component_ids;
+    size_t m_next_component_id;
+    std::vector<size_t> m_pruned_components;
 };
 
 } } } // namespaces
@@ -0,0 +1,171 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief Mini-batch K-Means, which updates the means from small random
+ * batches of the data
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_MINIBATCHKMEANSTRAINER_H
+#define BOB_LEARN_EM_MINIBATCHKMEANSTRAINER_H
+
+#include <bob.learn.em/KMeansMachine.h>
+#include <bob.learn.em/KMeansTrainer.h>
+#include <bob.io.base/HDF5File.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/random/mersenne_twister.hpp>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * @brief Trains a KMeans machine with mini-batches.
+ * @details See Sculley, "Web-scale k-means clustering", 2010. Each E-step
+ * draws batch_size samples of the data at random (with replacement) and
+ * assigns them to their closest mean; the M-step then moves each mean
+ * towards the samples assigned to it, with a learning rate of one over the
+ * number of samples this mean has been assigned since the initialization.
+ * Each iteration thus costs O(batch_size.K.D) instead of O(N.K.D).
+ *
+ * The means are initialized like with the KMeansTrainer, and the trained
+ * machine can be used in the same way (e.g., to initialize a GMMMachine).
+ */
+class MiniBatchKMeansTrainer
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param batch_size The number of samples drawn by each E-step
+     * @param i_m        The initialization method of the means
+     */
+    MiniBatchKMeansTrainer(const size_t batch_size=1024,
+      KMeansTrainer::InitializationMethod i_m=KMeansTrainer::RANDOM);
+
+    /**
+     * @brief Virtualize destructor
+     */
+    virtual ~MiniBatchKMeansTrainer() {}
+
+    /**
+     * @brief Copy constructor
+     */
+    MiniBatchKMeansTrainer(const MiniBatchKMeansTrainer& other);
+
+    /**
+     * @brief Assigns from a different trainer
+     */
+    MiniBatchKMeansTrainer& operator=(const MiniBatchKMeansTrainer& other);
+
+    /**
+     * @brief Equal to
+     */
+    bool operator==(const MiniBatchKMeansTrainer& b) const;
+
+    /**
+     * @brief Not equal to
+     */
+    bool operator!=(const MiniBatchKMeansTrainer& b) const;
+
+    /**
+     * @brief The name for this trainer
+     */
+    virtual std::string name() const { return "MiniBatchKMeansTrainer"; }
+
+    /**
+     * @brief Initialises the means as the KMeansTrainer does (with the
+     * same random number generator), and resets the counts of the means
+     */
+    void initialize(bob::learn::em::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Draws a batch of samples of the data, and assigns them to
+     * their closest mean
+     */
+    void eStep(bob::learn::em::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Moves the means towards the samples of the last batch
+     * assigned to them
+     */
+    void mStep(bob::learn::em::KMeansMachine& kmeans);
+
+    /**
+     * @brief Returns an exponentially weighted average of the average min
+     * (Square Euclidean) distance of the batches, over a window of about 10
+     * batches, which is less noisy than the one of the last batch
+     */
+    double computeLikelihood(bob::learn::em::KMeansMachine& kmeans);
+
+    /**
+     * @brief Sets the number of samples drawn by each E-step
+     */
+    void setBatchSize(const size_t batch_size);
+    size_t getBatchSize() const { return m_batch_size; }
+
+    /**
+     * @brief Sets the Random Number Generator, used by the initialization
+     * and to draw the batches
+     */
+    void setRng(const boost::shared_ptr<boost::mt19937> rng)
+    { m_rng = rng; }
+    const boost::shared_ptr<boost::mt19937> getRng() const
+    { return m_rng; }
+
+    /**
+     * @brief Sets the initialization method used to generate the initial means
+     */
+    void setInitializationMethod(KMeansTrainer::InitializationMethod v) { m_initialization_method = v; }
+    KMeansTrainer::InitializationMethod getInitializationMethod() const { return m_initialization_method; }
+
+    /**
+     * @brief Returns the number of samples assigned to each mean since the
+     * initialization (the inverse of its learning rate)
+     */
+    const blitz::Array<double,1>& getCounts() const { return m_counts; }
+
+    /**
+     * @brief Returns the average min (Square Euclidean) distance of the
+     * last batch
+     */
+    double getBatchAverageMinDistance() const { return m_batch_average_min_distance; }
+
+    /**
+     * @brief Saves the state of the trainer (random number generator,
+     * counts and last batch) to checkpoint a training. The configuration
+     * is not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
+  private:
+    size_t m_batch_size;
+    KMeansTrainer::InitializationMethod m_initialization_method;
+    boost::shared_ptr<boost::mt19937> m_rng;
+
+    /**
+     * @brief The number of samples assigned to each mean
+     */
+    blitz::Array<double,1> m_counts;
+
+    /**
+     * @brief The last batch, and the closest mean of its samples
+     */
+    blitz::Array<double,2> m_batch;
+    blitz::Array<int,1> m_assignment;
+    blitz::Array<double,1> m_cache_min_distances;
+
+    double m_batch_average_min_distance;
+    double m_average_min_distance;
+    size_t m_n_batches;
+};
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_MINIBATCHKMEANSTRAINER_H
@@ -231,6 +231,18 @@ class PLDATrainer
     boost::shared_ptr<boost::mt19937> getRng() const
     { return m_rng; }
 
+    /**
+     * @brief Saves the state of the trainer (random number generator
+     * and statistics of the latent variables) to checkpoint a training.
+     * The configuration is not saved.
+     */
+    void save(bob::io::base::HDF5File& config) const;
+
+    /**
+     * @brief Restores a state saved by save()
+     */
+    void load(bob::io::base::HDF5File& config);
+
   private:
 
 	    boost::shared_ptr<boost::mt19937> m_rng;
@@ -0,0 +1,63 @@
+/**
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ *
+ * @brief Parallel reduction of collections of GMMStats
+ *
+ * Copyright (C) Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_LEARN_EM_SUMGMMSTATS_H
+#define BOB_LEARN_EM_SUMGMMSTATS_H
+
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <string>
+#include <bob.learn.em/GMMStats.h>
+
+namespace bob { namespace learn { namespace em {
+
+/**
+ * Sums a collection of GMMStats.
+ *
+ * The collection is split into @c n_threads contiguous chunks which are
+ * accumulated in parallel; the partial sums are then merged with a pairwise
+ * tree reduction. The result does not depend on the scheduling of the
+ * threads, but it may differ in the last bits from a serial sum when
+ * @c n_threads changes (unless @c compensated is set).
+ *
+ * As with GMMStats::operator+=, the shape of the first element is used and
+ * the second order statistics are only summed if the first element has them.
+ *
+ * @param stats       the statistics to sum (at least one)
+ * @param[out] output the sum, resized if required
+ * @param n_threads   the number of threads to use (at least 1)
+ * @param compensated use a compensated (Kahan-Babuska) summation, which
+ *                    keeps the precision of accumulators with large counts
+ */
+void sumGMMStats(const std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> >& stats,
+                 bob::learn::em::GMMStats& output,
+                 const size_t n_threads=1, const bool compensated=false);
+
+/**
+ * Sums a collection of GMMStats stored in HDF5 files, as written by
+ * GMMStats::save().
+ *
+ * The files are streamed: each thread only keeps its partial sum and the
+ * statistics it is currently adding in memory, whatever the number of
+ * files. Reading the files is serialized, since the HDF5 library may not
+ * be thread-safe; the accumulation runs in parallel.
+ *
+ * @param filenames   the HDF5 files to sum (at least one)
+ * @param[out] output the sum, resized if required
+ * @param n_threads   the number of threads to use (at least 1)
+ * @param compensated use a compensated (Kahan-Babuska) summation, which
+ *                    keeps the precision of accumulators with large counts
+ */
+void sumGMMStats(const std::vector<std::string>& filenames,
+                 bob::learn::em::GMMStats& output,
+                 const size_t n_threads=1, const bool compensated=false);
+
+} } } // namespaces
+
+#endif // BOB_LEARN_EM_SUMGMMSTATS_H
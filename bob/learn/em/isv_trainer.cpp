@@ -546,6 +546,56 @@ static PyObject* PyBobLearnEMISVTrainer_enroll(PyBobLearnEMISVTrainerObject* sel
 
 
 
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the state of the ISVTrainer to a given HDF5 file",
+  "The state (e.g., the statistics of the last E-step and the random number generator) is what is needed, together with the machine, "
+  "to resume a training from this point, see :py:func:`bob.learn.em.train`. "
+  "The configuration of the trainer is not saved.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMISVTrainer_save(PyBobLearnEMISVTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Restores the state of the ISVTrainer from a given HDF5 file",
+  "The trainer should have the same configuration as the one which saved the state, and should be initialized on the same data first.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMISVTrainer_load(PyBobLearnEMISVTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
 static PyMethodDef PyBobLearnEMISVTrainer_methods[] = {
   {
     initialize.name(),
@@ -571,6 +621,18 @@ static PyMethodDef PyBobLearnEMISVTrainer_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     enroll.doc()
   },
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMISVTrainer_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMISVTrainer_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
   {0} /* Sentinel */
 };
 
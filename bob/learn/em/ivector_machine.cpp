@@ -476,19 +476,27 @@ static auto project = bob::extension::FunctionDoc(
   true
 )
 .add_prototype("stats")
-.add_parameter("stats", ":py:class:`bob.learn.em.GMMStats`", "Statistics as input");
+.add_parameter("stats", ":py:class:`bob.learn.em.GMMStats` or :py:class:`bob.learn.em.CenteredGMMStats`", "Statistics as input. :py:class:`bob.learn.em.CenteredGMMStats` must have been computed with the UBM of this machine");
 static PyObject* PyBobLearnEMIVectorMachine_project(PyBobLearnEMIVectorMachineObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
   char** kwlist = project.kwlist(0);
 
-  PyBobLearnEMGMMStatsObject* stats = 0;
+  PyObject* stats = 0;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobLearnEMGMMStats_Type, &stats))
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &stats))
     return 0;
 
    blitz::Array<double,1> ivector(self->cxx->getDimRt());
-   self->cxx->forward(*stats->cxx, ivector);
+   if (PyBobLearnEMCenteredGMMStats_Check(stats))
+     self->cxx->forward(*reinterpret_cast<PyBobLearnEMCenteredGMMStatsObject*>(stats)->cxx, ivector);
+   else if (PyBobLearnEMGMMStats_Check(stats))
+     self->cxx->forward(*reinterpret_cast<PyBobLearnEMGMMStatsObject*>(stats)->cxx, ivector);
+   else {
+     PyErr_Format(PyExc_TypeError, "`%s' projects GMMStats or CenteredGMMStats only", Py_TYPE(self)->tp_name);
+     project.print_usage();
+     return 0;
+   }
 
   return PyBlitzArrayCxx_AsConstNumpy(ivector);
 
@@ -352,7 +352,7 @@ static auto e_step = bob::extension::FunctionDoc(
 )
 .add_prototype("ivector_machine,stats")
 .add_parameter("ivector_machine", ":py:class:`bob.learn.em.ISVBase`", "IVectorMachine Object")
-.add_parameter("stats", ":py:class:`bob.learn.em.GMMStats`", "GMMStats Object");
+.add_parameter("stats", "[:py:class:`bob.learn.em.GMMStats`] or :py:class:`bob.learn.em.GMMStatsSet`", "The statistics of the training samples. A :py:class:`bob.learn.em.GMMStatsSet` is processed at once using matrix products");
 static PyObject* PyBobLearnEMIVectorTrainer_e_step(PyBobLearnEMIVectorTrainerObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
@@ -362,8 +362,19 @@ static PyObject* PyBobLearnEMIVectorTrainer_e_step(PyBobLearnEMIVectorTrainerObj
   PyBobLearnEMIVectorMachineObject* ivector_machine = 0;
   PyObject* stats = 0;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!", kwlist, &PyBobLearnEMIVectorMachine_Type, &ivector_machine,
-                                                                 &PyList_Type, &stats)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O", kwlist, &PyBobLearnEMIVectorMachine_Type, &ivector_machine,
+                                                                 &stats)) return 0;
+
+  if (PyBobLearnEMGMMStatsSet_Check(stats)){
+    self->cxx->eStep(*ivector_machine->cxx, *reinterpret_cast<PyBobLearnEMGMMStatsSetObject*>(stats)->cxx);
+    Py_RETURN_NONE;
+  }
+
+  if (!PyList_Check(stats)){
+    PyErr_Format(PyExc_TypeError, "%s e_step expects a list of GMMStats or a GMMStatsSet", Py_TYPE(self)->tp_name);
+    e_step.print_usage();
+    return 0;
+  }
 
   std::vector<bob::learn::em::GMMStats> training_data;
   if(extract_GMMStats_1d(stats ,training_data)==0)
@@ -430,6 +441,56 @@ static PyObject* PyBobLearnEMIVectorTrainer_reset_accumulators(PyBobLearnEMIVect
 }
 
 
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the state of the IVectorTrainer to a given HDF5 file",
+  "The state (e.g., the statistics of the last E-step and the random number generator) is what is needed, together with the machine, "
+  "to resume a training from this point, see :py:func:`bob.learn.em.train`. "
+  "The configuration of the trainer is not saved.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMIVectorTrainer_save(PyBobLearnEMIVectorTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Restores the state of the IVectorTrainer from a given HDF5 file",
+  "The trainer should have the same configuration as the one which saved the state, and should be initialized on the same data first.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMIVectorTrainer_load(PyBobLearnEMIVectorTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
 static PyMethodDef PyBobLearnEMIVectorTrainer_methods[] = {
   {
     initialize.name(),
@@ -455,6 +516,18 @@ static PyMethodDef PyBobLearnEMIVectorTrainer_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     reset_accumulators.doc()
   },
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMIVectorTrainer_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMIVectorTrainer_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
   {0} /* Sentinel */
 };
 
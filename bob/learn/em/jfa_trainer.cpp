@@ -999,6 +999,56 @@ static PyObject* PyBobLearnEMJFATrainer_enroll(PyBobLearnEMJFATrainerObject* sel
 
 
 
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the state of the JFATrainer to a given HDF5 file",
+  "The state (e.g., the statistics of the last E-step and the random number generator) is what is needed, together with the machine, "
+  "to resume a training from this point, see :py:func:`bob.learn.em.train`. "
+  "The configuration of the trainer is not saved.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMJFATrainer_save(PyBobLearnEMJFATrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Restores the state of the JFATrainer from a given HDF5 file",
+  "The trainer should have the same configuration as the one which saved the state, and should be initialized on the same data first.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMJFATrainer_load(PyBobLearnEMJFATrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
 static PyMethodDef PyBobLearnEMJFATrainer_methods[] = {
   {
     initialize.name(),
@@ -1066,6 +1116,18 @@ static PyMethodDef PyBobLearnEMJFATrainer_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     enroll.doc()
   },
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMJFATrainer_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMJFATrainer_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
   {0} /* Sentinel */
 };
 
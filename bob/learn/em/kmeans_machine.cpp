@@ -228,6 +228,37 @@ int PyBobLearnEMKMeansMachine_setMeans(PyBobLearnEMKMeansMachineObject* self, Py
   BOB_CATCH_MEMBER("means could not be set", -1)
 }
 
+/***** indexed *****/
+static auto indexed = bob::extension::VariableDoc(
+  "indexed",
+  "bool",
+  "Tells if the means are indexed by a k-d tree",
+  "With an index, :py:meth:`get_closest_mean` and :py:meth:`get_min_distance` find the closest mean by an exact tree search instead of an exhaustive one, which is faster for many means of a low dimensionality. "
+  "The index is built automatically in this case (see :py:meth:`update_index`), and can be forced or removed by setting this variable. "
+  "It is removed by :py:meth:`set_mean`."
+);
+PyObject* PyBobLearnEMKMeansMachine_getIndexed(PyBobLearnEMKMeansMachineObject* self, void*){
+  BOB_TRY
+  if (self->cxx->hasIndex()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("indexed could not be read", 0)
+}
+int PyBobLearnEMKMeansMachine_setIndexed(PyBobLearnEMKMeansMachineObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBool_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a bool", Py_TYPE(self)->tp_name, indexed.name());
+    return -1;
+  }
+
+  if (PyObject_IsTrue(value) > 0)
+    self->cxx->buildIndex();
+  else
+    self->cxx->clearIndex();
+  return 0;
+  BOB_CATCH_MEMBER("indexed could not be set", -1)
+}
+
 
 static PyGetSetDef PyBobLearnEMKMeansMachine_getseters[] = {
   {
@@ -244,6 +275,13 @@ static PyGetSetDef PyBobLearnEMKMeansMachine_getseters[] = {
    means.doc(),
    0
   },
+  {
+   indexed.name(),
+   (getter)PyBobLearnEMKMeansMachine_getIndexed,
+   (setter)PyBobLearnEMKMeansMachine_setIndexed,
+   indexed.doc(),
+   0
+  },
   {0}  // Sentinel
 };
 
@@ -376,6 +414,21 @@ static PyObject* PyBobLearnEMKMeansMachine_resize(PyBobLearnEMKMeansMachineObjec
   Py_RETURN_NONE;
 }
 
+/*** update_index ***/
+static auto update_index = bob::extension::FunctionDoc(
+  "update_index",
+  "Indexes the means by a k-d tree if they are many and of a low dimensionality, and removes the index otherwise.",
+  "This is done each time the means are set with :py:attr:`means`, and by the trainers after each update of the means.",
+  true
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMKMeansMachine_update_index(PyBobLearnEMKMeansMachineObject* self) {
+  BOB_TRY
+  self->cxx->updateIndex();
+  BOB_CATCH_MEMBER("cannot update the index", 0)
+  Py_RETURN_NONE;
+}
+
 /*** get_mean ***/
 static auto get_mean = bob::extension::FunctionDoc(
   "get_mean",
@@ -500,12 +553,12 @@ static PyObject* PyBobLearnEMKMeansMachine_get_distance_from_mean(PyBobLearnEMKM
 static auto get_closest_mean = bob::extension::FunctionDoc(
   "get_closest_mean",
   "Calculate the index of the mean that is closest (in terms of square Euclidean distance) to the data sample, x.",
-  "",
+  "For a 2D array of samples, the closest means of all the samples are computed by tiles, with matrix products.",
   true
 )
 .add_prototype("input","output")
-.add_parameter("input", "array_like <float, 1D>", "The data sample (feature vector)")
-.add_return("output", "(int, int)", "Tuple containing the closest mean and the minimum distance from the input");
+.add_parameter("input", "array_like <float, 1D> or array_like <float, 2D>", "The data sample (feature vector), or the data samples (one per row)")
+.add_return("output", "(int, float) or (array_like <int, 1D>, array_like <float, 1D>)", "Tuple containing the closest mean and the minimum distance from the input, or the closest means and minimum distances of all the samples");
 static PyObject* PyBobLearnEMKMeansMachine_get_closest_mean(PyBobLearnEMKMeansMachineObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
@@ -526,16 +579,23 @@ static PyObject* PyBobLearnEMKMeansMachine_get_closest_mean(PyBobLearnEMKMeansMa
     return 0;
   }
 
-  if (input->ndim != 1){
-    PyErr_Format(PyExc_TypeError, "`%s' only processes 1D arrays of float64 for `%s`", Py_TYPE(self)->tp_name, get_closest_mean.name());
+  if (input->ndim != 1 && input->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 1D or 2D arrays of float64 for `%s`", Py_TYPE(self)->tp_name, get_closest_mean.name());
     return 0;
   }
 
-  if (input->shape[0] != (Py_ssize_t)self->cxx->getNInputs()){
-    PyErr_Format(PyExc_TypeError, "`%s' 1D `input` array should have %" PY_FORMAT_SIZE_T "d elements, not %" PY_FORMAT_SIZE_T "d for `%s`", Py_TYPE(self)->tp_name, self->cxx->getNInputs(), input->shape[0], get_closest_mean.name());
+  if (input->shape[input->ndim-1] != (Py_ssize_t)self->cxx->getNInputs()){
+    PyErr_Format(PyExc_TypeError, "`%s' `input` array should have %" PY_FORMAT_SIZE_T "d elements per sample, not %" PY_FORMAT_SIZE_T "d for `%s`", Py_TYPE(self)->tp_name, self->cxx->getNInputs(), input->shape[input->ndim-1], get_closest_mean.name());
     return 0;
   }
 
+  if (input->ndim == 2){
+    blitz::Array<int,1> closest_means(input->shape[0]);
+    blitz::Array<double,1> min_distances(input->shape[0]);
+    self->cxx->getClosestMeans(*PyBlitzArrayCxx_AsBlitz<double,2>(input), closest_means, min_distances);
+    return Py_BuildValue("(NN)", PyBlitzArrayCxx_AsNumpy(closest_means), PyBlitzArrayCxx_AsNumpy(min_distances));
+  }
+
   self->cxx->getClosestMean(*PyBlitzArrayCxx_AsBlitz<double,1>(input), closest_mean, min_distance);
 
   return Py_BuildValue("(i,d)", closest_mean, min_distance);
@@ -548,12 +608,12 @@ static PyObject* PyBobLearnEMKMeansMachine_get_closest_mean(PyBobLearnEMKMeansMa
 static auto get_min_distance = bob::extension::FunctionDoc(
   "get_min_distance",
   "Output the minimum (Square Euclidean) distance between the input and the closest mean ",
-  "",
+  "For a 2D array of samples, the distances of all the samples are computed by tiles, with matrix products.",
   true
 )
 .add_prototype("input","output")
-.add_parameter("input", "array_like <float, 1D>", "The data sample (feature vector)")
-.add_return("output", "float", "The minimum distance");
+.add_parameter("input", "array_like <float, 1D> or array_like <float, 2D>", "The data sample (feature vector), or the data samples (one per row)")
+.add_return("output", "float or array_like <float, 1D>", "The minimum distance, or the minimum distance of each sample");
 static PyObject* PyBobLearnEMKMeansMachine_get_min_distance(PyBobLearnEMKMeansMachineObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
@@ -572,16 +632,22 @@ static PyObject* PyBobLearnEMKMeansMachine_get_min_distance(PyBobLearnEMKMeansMa
     return 0;
   }
 
-  if (input->ndim != 1){
-    PyErr_Format(PyExc_TypeError, "`%s' only processes 1D arrays of float64 for `%s`", Py_TYPE(self)->tp_name, get_min_distance.name());
+  if (input->ndim != 1 && input->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 1D or 2D arrays of float64 for `%s`", Py_TYPE(self)->tp_name, get_min_distance.name());
     return 0;
   }
 
-  if (input->shape[0] != (Py_ssize_t)self->cxx->getNInputs()){
-    PyErr_Format(PyExc_TypeError, "`%s' 1D `input` array should have %" PY_FORMAT_SIZE_T "d elements, not %" PY_FORMAT_SIZE_T "d for `%s`", Py_TYPE(self)->tp_name, self->cxx->getNInputs(), input->shape[0], get_min_distance.name());
+  if (input->shape[input->ndim-1] != (Py_ssize_t)self->cxx->getNInputs()){
+    PyErr_Format(PyExc_TypeError, "`%s' `input` array should have %" PY_FORMAT_SIZE_T "d elements per sample, not %" PY_FORMAT_SIZE_T "d for `%s`", Py_TYPE(self)->tp_name, self->cxx->getNInputs(), input->shape[input->ndim-1], get_min_distance.name());
     return 0;
   }
 
+  if (input->ndim == 2){
+    blitz::Array<double,1> min_distances(input->shape[0]);
+    self->cxx->getMinDistance(*PyBlitzArrayCxx_AsBlitz<double,2>(input), min_distances);
+    return PyBlitzArrayCxx_AsNumpy(min_distances);
+  }
+
   min_distance = self->cxx->getMinDistance(*PyBlitzArrayCxx_AsBlitz<double,1>(input));
 
   return Py_BuildValue("d", min_distance);
@@ -769,6 +835,12 @@ static PyMethodDef PyBobLearnEMKMeansMachine_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     resize.doc()
   },
+  {
+    update_index.name(),
+    (PyCFunction)PyBobLearnEMKMeansMachine_update_index,
+    METH_NOARGS,
+    update_index.doc()
+  },
   {
     get_mean.name(),
     (PyCFunction)PyBobLearnEMKMeansMachine_get_mean,
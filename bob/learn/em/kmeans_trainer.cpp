@@ -16,17 +16,17 @@
 // InitializationMethod type conversion
 
 #if BOOST_VERSION >= 104700
-  static const std::map<std::string, bob::learn::em::KMeansTrainer::InitializationMethod> IM = {{"RANDOM",  bob::learn::em::KMeansTrainer::InitializationMethod::RANDOM},  {"RANDOM_NO_DUPLICATE", bob::learn::em::KMeansTrainer::InitializationMethod::RANDOM_NO_DUPLICATE}, {"KMEANS_PLUS_PLUS", bob::learn::em::KMeansTrainer::InitializationMethod::KMEANS_PLUS_PLUS}};
+  static const std::map<std::string, bob::learn::em::KMeansTrainer::InitializationMethod> IM = {{"RANDOM",  bob::learn::em::KMeansTrainer::InitializationMethod::RANDOM},  {"RANDOM_NO_DUPLICATE", bob::learn::em::KMeansTrainer::InitializationMethod::RANDOM_NO_DUPLICATE}, {"KMEANS_PLUS_PLUS", bob::learn::em::KMeansTrainer::InitializationMethod::KMEANS_PLUS_PLUS}, {"KMEANS_PARALLEL", bob::learn::em::KMeansTrainer::InitializationMethod::KMEANS_PARALLEL}};
 #else
   static const std::map<std::string, bob::learn::em::KMeansTrainer::InitializationMethod> IM = {{"RANDOM",  bob::learn::em::KMeansTrainer::InitializationMethod::RANDOM}, {"RANDOM_NO_DUPLICATE", bob::learn::em::KMeansTrainer::InitializationMethod::RANDOM_NO_DUPLICATE}};
 #endif
 
-static inline bob::learn::em::KMeansTrainer::InitializationMethod string2IM(const std::string& o){            /* converts string to InitializationMethod type */
+bob::learn::em::KMeansTrainer::InitializationMethod string2IM(const std::string& o){            /* converts string to InitializationMethod type */
   auto it = IM.find(o);
-  if (it == IM.end()) throw std::runtime_error("The given InitializationMethod '" + o + "' is not known; choose one of ('RANDOM', 'RANDOM_NO_DUPLICATE', 'KMEANS_PLUS_PLUS')");
+  if (it == IM.end()) throw std::runtime_error("The given InitializationMethod '" + o + "' is not known; choose one of ('RANDOM', 'RANDOM_NO_DUPLICATE', 'KMEANS_PLUS_PLUS', 'KMEANS_PARALLEL')");
   else return it->second;
 }
-static inline const std::string& IM2string(bob::learn::em::KMeansTrainer::InitializationMethod o){            /* converts InitializationMethod type to string */
+const std::string& IM2string(bob::learn::em::KMeansTrainer::InitializationMethod o){            /* converts InitializationMethod type to string */
   for (auto it = IM.begin(); it != IM.end(); ++it) if (it->second == o) return it->first;
   throw std::runtime_error("The given InitializationMethod type is not known");
 }
@@ -49,7 +49,7 @@ static auto KMeansTrainer_doc = bob::extension::ClassDoc(
   .add_prototype("other","")
   .add_prototype("","")
 
-  .add_parameter("initialization_method", "str", "The initialization method of the means.\nPossible values are: 'RANDOM', 'RANDOM_NO_DUPLICATE', 'KMEANS_PLUS_PLUS' ")
+  .add_parameter("initialization_method", "str", "The initialization method of the means.\nPossible values are: 'RANDOM', 'RANDOM_NO_DUPLICATE', 'KMEANS_PLUS_PLUS', 'KMEANS_PARALLEL' ")
   .add_parameter("other", ":py:class:`bob.learn.em.KMeansTrainer`", "A KMeansTrainer object to be copied.")
 
 );
@@ -122,6 +122,7 @@ static int PyBobLearnEMKMeansTrainer_init(PyBobLearnEMKMeansTrainerObject* self,
 
 static void PyBobLearnEMKMeansTrainer_delete(PyBobLearnEMKMeansTrainerObject* self) {
   self->cxx.reset();
+  Py_XDECREF(self->bound_data);
   Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
@@ -165,6 +166,7 @@ static auto initialization_method = bob::extension::VariableDoc(
   " `RANDOM`: Random initialization \n\n"
   " `RANDOM_NO_DUPLICATE`: Random initialization without repetition \n\n"
   " `KMEANS_PLUS_PLUS`: Apply the kmeans++ initialization http://en.wikipedia.org/wiki/K-means%2B%2B  \n\n"
+  " `KMEANS_PARALLEL`: Apply the scalable kmeans|| initialization (Bahmani et al., 2012), which draws candidates in a few passes over the data (see :py:attr:`n_parallel_rounds` and :py:attr:`oversampling_factor`) and applies kmeans++ on the weighted candidates \n\n"
 );
 PyObject* PyBobLearnEMKMeansTrainer_getInitializationMethod(PyBobLearnEMKMeansTrainerObject* self, void*) {
   BOB_TRY
@@ -268,6 +270,190 @@ int PyBobLearnEMKMeansTrainer_setAverageMinDistance(PyBobLearnEMKMeansTrainerObj
 
 
 
+/***** compute_variances *****/
+static auto compute_variances = bob::extension::VariableDoc(
+  "compute_variances",
+  "bool",
+  "[Default: ``False``] Also accumulate the second order statistics of the clusters in the E-step",
+  "The variances and weights of the clusters are then given by :py:meth:`get_variances_and_weights_for_each_cluster`, "
+  "without the pass over the data of :py:meth:`bob.learn.em.KMeansMachine.get_variances_and_weights_for_each_cluster`."
+);
+PyObject* PyBobLearnEMKMeansTrainer_getComputeVariances(PyBobLearnEMKMeansTrainerObject* self, void*){
+  BOB_TRY
+  if (self->cxx->getComputeVariances()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("compute_variances could not be read", 0)
+}
+int PyBobLearnEMKMeansTrainer_setComputeVariances(PyBobLearnEMKMeansTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBool_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a bool", Py_TYPE(self)->tp_name, compute_variances.name());
+    return -1;
+  }
+
+  self->cxx->setComputeVariances(PyObject_IsTrue(value) > 0);
+  return 0;
+  BOB_CATCH_MEMBER("compute_variances could not be set", -1)
+}
+
+
+/***** second_order_statistics *****/
+static auto second_order_statistics = bob::extension::VariableDoc(
+  "second_order_statistics",
+  "array_like <float, 2D>",
+  "The sums of the squares of the samples of each cluster, accumulated by the last E-step if :py:attr:`compute_variances` is set",
+  ""
+);
+PyObject* PyBobLearnEMKMeansTrainer_getSecondOrderStatistics(PyBobLearnEMKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getSecondOrderStats());
+  BOB_CATCH_MEMBER("second_order_statistics could not be read", 0)
+}
+
+
+/***** n_threads *****/
+static auto n_threads = bob::extension::VariableDoc(
+  "n_threads",
+  "int",
+  "[Default: ``1``] The number of threads of the E-step",
+  "Each thread accumulates the statistics of contiguous samples, which are then summed in the order of the samples: "
+  "the statistics are reproducible for a given number of threads, but may differ in the last digits from one number of threads to another."
+);
+PyObject* PyBobLearnEMKMeansTrainer_getNThreads(PyBobLearnEMKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getNThreads());
+  BOB_CATCH_MEMBER("n_threads could not be read", 0)
+}
+int PyBobLearnEMKMeansTrainer_setNThreads(PyBobLearnEMKMeansTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyInt_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an int", Py_TYPE(self)->tp_name, n_threads.name());
+    return -1;
+  }
+
+  if (PyInt_AS_LONG(value) <= 0){
+    PyErr_Format(PyExc_TypeError, "n_threads must be greater than zero");
+    return -1;
+  }
+
+  self->cxx->setNThreads(PyInt_AS_LONG(value));
+  return 0;
+  BOB_CATCH_MEMBER("n_threads could not be set", -1)
+}
+
+
+/***** accelerated *****/
+static auto accelerated = bob::extension::VariableDoc(
+  "accelerated",
+  "bool",
+  "[Default: ``False``] Use the triangle inequality to skip distance computations in the E-step",
+  "A lower bound on the distance of each sample to the means it is not assigned to is kept between the E-steps "
+  "(Hamerly's algorithm). Once the training settles, the assignment of most of the samples is proven unchanged "
+  "with the distance to their mean only. The assignments and the statistics are the same as without acceleration. "
+  "The bounds are only reused if the ``e_step`` is called with the same array object as the previous one (a reference to which is kept), "
+  "which must not have been modified in between, or else :py:meth:`clear_bounds` must be called. "
+  ":py:func:`bob.learn.em.train_em` and :py:func:`bob.learn.em.train_restarts` always start without bounds."
+);
+PyObject* PyBobLearnEMKMeansTrainer_getAccelerated(PyBobLearnEMKMeansTrainerObject* self, void*){
+  BOB_TRY
+  if (self->cxx->getAccelerated()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("accelerated could not be read", 0)
+}
+int PyBobLearnEMKMeansTrainer_setAccelerated(PyBobLearnEMKMeansTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBool_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a bool", Py_TYPE(self)->tp_name, accelerated.name());
+    return -1;
+  }
+
+  self->cxx->setAccelerated(PyObject_IsTrue(value) > 0);
+  return 0;
+  BOB_CATCH_MEMBER("accelerated could not be set", -1)
+}
+
+
+/***** oversampling_factor *****/
+static auto oversampling_factor = bob::extension::VariableDoc(
+  "oversampling_factor",
+  "float",
+  "[Default: ``0``] The number of candidates expected at each round of the ``KMEANS_PARALLEL`` initialization",
+  "With ``0``, twice the number of means are expected."
+);
+PyObject* PyBobLearnEMKMeansTrainer_getOversamplingFactor(PyBobLearnEMKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("d", self->cxx->getOversamplingFactor());
+  BOB_CATCH_MEMBER("oversampling_factor could not be read", 0)
+}
+int PyBobLearnEMKMeansTrainer_setOversamplingFactor(PyBobLearnEMKMeansTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBob_NumberCheck(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a float", Py_TYPE(self)->tp_name, oversampling_factor.name());
+    return -1;
+  }
+
+  const double v = PyFloat_AsDouble(value);
+  if (v < 0){
+    PyErr_Format(PyExc_TypeError, "oversampling_factor must be greater than or equal to zero");
+    return -1;
+  }
+
+  self->cxx->setOversamplingFactor(v);
+  return 0;
+  BOB_CATCH_MEMBER("oversampling_factor could not be set", -1)
+}
+
+
+/***** n_parallel_rounds *****/
+static auto n_parallel_rounds = bob::extension::VariableDoc(
+  "n_parallel_rounds",
+  "int",
+  "[Default: ``5``] The number of rounds, i.e., of passes over the data, of the ``KMEANS_PARALLEL`` initialization",
+  ""
+);
+PyObject* PyBobLearnEMKMeansTrainer_getNParallelRounds(PyBobLearnEMKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getNParallelRounds());
+  BOB_CATCH_MEMBER("n_parallel_rounds could not be read", 0)
+}
+int PyBobLearnEMKMeansTrainer_setNParallelRounds(PyBobLearnEMKMeansTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyInt_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an int", Py_TYPE(self)->tp_name, n_parallel_rounds.name());
+    return -1;
+  }
+
+  if (PyInt_AS_LONG(value) < 0){
+    PyErr_Format(PyExc_TypeError, "n_parallel_rounds must be greater than or equal to zero");
+    return -1;
+  }
+
+  self->cxx->setNParallelRounds(PyInt_AS_LONG(value));
+  return 0;
+  BOB_CATCH_MEMBER("n_parallel_rounds could not be set", -1)
+}
+
+
+/***** n_distances *****/
+static auto n_distances = bob::extension::VariableDoc(
+  "n_distances",
+  "int",
+  "The number of distances computed by the last E-step",
+  "Without acceleration, and unless the means are indexed (see :py:attr:`bob.learn.em.KMeansMachine.indexed`), "
+  "this is the number of samples times the number of means."
+);
+PyObject* PyBobLearnEMKMeansTrainer_getNDistances(PyBobLearnEMKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getNDistances());
+  BOB_CATCH_MEMBER("n_distances could not be read", 0)
+}
+
+
 
 static PyGetSetDef PyBobLearnEMKMeansTrainer_getseters[] = {
   {
@@ -298,6 +484,55 @@ static PyGetSetDef PyBobLearnEMKMeansTrainer_getseters[] = {
    average_min_distance.doc(),
    0
   },
+  {
+   compute_variances.name(),
+   (getter)PyBobLearnEMKMeansTrainer_getComputeVariances,
+   (setter)PyBobLearnEMKMeansTrainer_setComputeVariances,
+   compute_variances.doc(),
+   0
+  },
+  {
+   second_order_statistics.name(),
+   (getter)PyBobLearnEMKMeansTrainer_getSecondOrderStatistics,
+   0,
+   second_order_statistics.doc(),
+   0
+  },
+  {
+   n_threads.name(),
+   (getter)PyBobLearnEMKMeansTrainer_getNThreads,
+   (setter)PyBobLearnEMKMeansTrainer_setNThreads,
+   n_threads.doc(),
+   0
+  },
+  {
+   accelerated.name(),
+   (getter)PyBobLearnEMKMeansTrainer_getAccelerated,
+   (setter)PyBobLearnEMKMeansTrainer_setAccelerated,
+   accelerated.doc(),
+   0
+  },
+  {
+   oversampling_factor.name(),
+   (getter)PyBobLearnEMKMeansTrainer_getOversamplingFactor,
+   (setter)PyBobLearnEMKMeansTrainer_setOversamplingFactor,
+   oversampling_factor.doc(),
+   0
+  },
+  {
+   n_parallel_rounds.name(),
+   (getter)PyBobLearnEMKMeansTrainer_getNParallelRounds,
+   (setter)PyBobLearnEMKMeansTrainer_setNParallelRounds,
+   n_parallel_rounds.doc(),
+   0
+  },
+  {
+   n_distances.name(),
+   (getter)PyBobLearnEMKMeansTrainer_getNDistances,
+   0,
+   n_distances.doc(),
+   0
+  },
   {0}  // Sentinel
 };
 
@@ -371,7 +606,7 @@ static auto e_step = bob::extension::FunctionDoc(
 )
 .add_prototype("kmeans_machine,data")
 .add_parameter("kmeans_machine", ":py:class:`bob.learn.em.KMeansMachine`", "KMeansMachine Object")
-.add_parameter("data", "array_like <float, 2D>", "Input data");
+.add_parameter("data", "array_like <float, 2D> or :py:class:`bob.learn.em.FileListDataSource`", "Input data");
 static PyObject* PyBobLearnEMKMeansTrainer_e_step(PyBobLearnEMKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
@@ -379,9 +614,26 @@ static PyObject* PyBobLearnEMKMeansTrainer_e_step(PyBobLearnEMKMeansTrainerObjec
   char** kwlist = e_step.kwlist(0);
 
   PyBobLearnEMKMeansMachineObject* kmeans_machine;
+  PyObject* input = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O", kwlist, &PyBobLearnEMKMeansMachine_Type, &kmeans_machine,
+                                                                 &input)) return 0;
+
+  // The bounds of the accelerated E-step are dropped when the data changes
+  PyObject* bound_data = self->cxx->getAccelerated() ? input : 0;
+  if (bound_data != self->bound_data) {
+    self->cxx->clearBounds();
+    Py_XINCREF(bound_data);
+    Py_XDECREF(self->bound_data);
+    self->bound_data = bound_data;
+  }
+
+  if (PyBobLearnEMFileListDataSource_Check(input)){
+    self->cxx->eStep(*kmeans_machine->cxx, *((PyBobLearnEMFileListDataSourceObject*)input)->cxx);
+    Py_RETURN_NONE;
+  }
+
   PyBlitzArrayObject* data = 0;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&", kwlist, &PyBobLearnEMKMeansMachine_Type, &kmeans_machine,
-                                                                 &PyBlitzArray_Converter, &data)) return 0;
+  if (!PyBlitzArray_Converter(input, &data)) return 0;
   auto data_ = make_safe(data);
 
   if (data->type_num != NPY_FLOAT64){
@@ -486,6 +738,105 @@ static PyObject* PyBobLearnEMKMeansTrainer_reset_accumulators(PyBobLearnEMKMeans
 }
 
 
+/*** clear_bounds ***/
+static auto clear_bounds = bob::extension::FunctionDoc(
+  "clear_bounds",
+  "Forgets the bounds of the accelerated E-step.",
+  "This is required before an ``e_step`` on the same array object as the previous one, if the array was modified in between.",
+  true
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMKMeansTrainer_clear_bounds(PyBobLearnEMKMeansTrainerObject* self) {
+  BOB_TRY
+  self->cxx->clearBounds();
+  Py_CLEAR(self->bound_data);
+  BOB_CATCH_MEMBER("cannot clear the bounds", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** get_variances_and_weights_for_each_cluster ***/
+static auto get_variances_and_weights_for_each_cluster = bob::extension::FunctionDoc(
+  "get_variances_and_weights_for_each_cluster",
+  "Returns the variances and weights of the clusters, from the statistics of the last E-step",
+  "The last E-step must have been run with :py:attr:`compute_variances` set, and the machine should not have been updated since "
+  "(as at the end of :py:func:`bob.learn.em.train`). "
+  "The result is then the one of :py:meth:`bob.learn.em.KMeansMachine.get_variances_and_weights_for_each_cluster` on the same data, "
+  "without another pass over the data.",
+  true
+)
+.add_prototype("kmeans_machine","(variances,weights)")
+.add_parameter("kmeans_machine", ":py:class:`bob.learn.em.KMeansMachine`", "KMeansMachine Object")
+.add_return("variances", "array_like <float, 2D>", "The variances of the clusters")
+.add_return("weights", "array_like <float, 1D>", "The weights of the clusters");
+static PyObject* PyBobLearnEMKMeansTrainer_get_variances_and_weights_for_each_cluster(PyBobLearnEMKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = get_variances_and_weights_for_each_cluster.kwlist(0);
+
+  PyBobLearnEMKMeansMachineObject* kmeans_machine;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobLearnEMKMeansMachine_Type, &kmeans_machine)) return 0;
+
+  blitz::Array<double,2> variances(kmeans_machine->cxx->getNMeans(), kmeans_machine->cxx->getNInputs());
+  blitz::Array<double,1> weights(kmeans_machine->cxx->getNMeans());
+  self->cxx->getVariancesAndWeightsForEachCluster(*kmeans_machine->cxx, variances, weights);
+
+  return Py_BuildValue("(NN)", PyBlitzArrayCxx_AsNumpy(variances), PyBlitzArrayCxx_AsNumpy(weights));
+
+  BOB_CATCH_MEMBER("cannot compute the variances and weights of the clusters", 0)
+}
+
+
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the state of the KMeansTrainer to a given HDF5 file",
+  "The state (e.g., the statistics of the last E-step and the random number generator) is what is needed, together with the machine, "
+  "to resume a training from this point, see :py:func:`bob.learn.em.train`. "
+  "The configuration of the trainer is not saved.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMKMeansTrainer_save(PyBobLearnEMKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Restores the state of the KMeansTrainer from a given HDF5 file",
+  "The trainer should have the same configuration as the one which saved the state, and should be initialized on the same data first.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMKMeansTrainer_load(PyBobLearnEMKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
 static PyMethodDef PyBobLearnEMKMeansTrainer_methods[] = {
   {
     initialize.name(),
@@ -517,6 +868,30 @@ static PyMethodDef PyBobLearnEMKMeansTrainer_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     reset_accumulators.doc()
   },
+  {
+    clear_bounds.name(),
+    (PyCFunction)PyBobLearnEMKMeansTrainer_clear_bounds,
+    METH_NOARGS,
+    clear_bounds.doc()
+  },
+  {
+    get_variances_and_weights_for_each_cluster.name(),
+    (PyCFunction)PyBobLearnEMKMeansTrainer_get_variances_and_weights_for_each_cluster,
+    METH_VARARGS|METH_KEYWORDS,
+    get_variances_and_weights_for_each_cluster.doc()
+  },
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMKMeansTrainer_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMKMeansTrainer_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
   {0} /* Sentinel */
 };
 
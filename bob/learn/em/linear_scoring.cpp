@@ -26,6 +26,21 @@ static int extract_gmmstats_list(PyObject *list,
   return 0;
 }
 
+static int extract_centered_gmmstats_list(PyObject *list,
+                             std::vector<boost::shared_ptr<const bob::learn::em::CenteredGMMStats> >& training_data)
+{
+  for (int i=0; i<PyList_GET_SIZE(list); i++){
+
+    PyBobLearnEMCenteredGMMStatsObject* stats;
+    if (!PyArg_Parse(PyList_GetItem(list, i), "O!", &PyBobLearnEMCenteredGMMStats_Type, &stats)){
+      PyErr_Format(PyExc_RuntimeError, "Expected CenteredGMMStats objects");
+      return -1;
+    }
+    training_data.push_back(stats->cxx);
+  }
+  return 0;
+}
+
 static int extract_gmmmachine_list(PyObject *list,
                              std::vector<boost::shared_ptr<const bob::learn::em::GMMMachine> >& training_data)
 {
@@ -78,7 +93,7 @@ bob::extension::FunctionDoc linear_scoring1 = bob::extension::FunctionDoc(
 .add_prototype("models, ubm, test_stats, test_channelOffset, frame_length_normalisation", "output")
 .add_parameter("models", "[:py:class:`bob.learn.em.GMMMachine`]", "")
 .add_parameter("ubm", ":py:class:`bob.learn.em.GMMMachine`", "")
-.add_parameter("test_stats", "[:py:class:`bob.learn.em.GMMStats`]", "")
+.add_parameter("test_stats", "[:py:class:`bob.learn.em.GMMStats`] or :py:class:`bob.learn.em.GMMStatsSet` or [:py:class:`bob.learn.em.CenteredGMMStats`]", "The statistics of the test trials. If a :py:class:`bob.learn.em.GMMStatsSet` is given, all the trials are scored at once. If :py:class:`bob.learn.em.CenteredGMMStats` are given, their cached centered statistics are used. In both cases, ``test_channelOffset`` must be empty")
 .add_parameter("test_channelOffset", "[array_like<float,1>]", "")
 .add_parameter("frame_length_normalisation", "bool", "")
 .add_return("output","array_like<float,1>","Score");
@@ -94,7 +109,7 @@ bob::extension::FunctionDoc linear_scoring2 = bob::extension::FunctionDoc(
 .add_parameter("models", "list(array_like<float,1>)", "")
 .add_parameter("ubm_mean", "list(array_like<float,1>)", "")
 .add_parameter("ubm_variance", "list(array_like<float,1>)", "")
-.add_parameter("test_stats", "list(:py:class:`bob.learn.em.GMMStats`)", "")
+.add_parameter("test_stats", "list(:py:class:`bob.learn.em.GMMStats`) or :py:class:`bob.learn.em.GMMStatsSet` or [:py:class:`bob.learn.em.CenteredGMMStats`]", "The statistics of the test trials. If a :py:class:`bob.learn.em.GMMStatsSet` is given, all the trials are scored at once. If :py:class:`bob.learn.em.CenteredGMMStats` are given, their cached centered statistics are used. In both cases, ``test_channelOffset`` must be empty")
 .add_parameter("test_channelOffset", "list(array_like<float,1>)", "")
 .add_parameter("frame_length_normalisation", "bool", "")
 .add_return("output","array_like<float,1>","Score");
@@ -111,7 +126,7 @@ bob::extension::FunctionDoc linear_scoring3 = bob::extension::FunctionDoc(
 .add_parameter("model", "array_like<float,1>", "")
 .add_parameter("ubm_mean", "array_like<float,1>", "")
 .add_parameter("ubm_variance", "array_like<float,1>", "")
-.add_parameter("test_stats", ":py:class:`bob.learn.em.GMMStats`", "")
+.add_parameter("test_stats", ":py:class:`bob.learn.em.GMMStats` or :py:class:`bob.learn.em.CenteredGMMStats`", "The statistics of the test trial. If a :py:class:`bob.learn.em.CenteredGMMStats` is given, its cached centered statistics are used, and ``test_channelOffset`` must be empty or omitted")
 .add_parameter("test_channelOffset", "array_like<float,1>", "")
 .add_parameter("frame_length_normalisation", "bool", "")
 .add_return("output","array_like<float,1>","Score");
@@ -142,19 +157,15 @@ PyObject* PyBobLearnEM_linear_scoring(PyObject*, PyObject* args, PyObject* kwarg
     PyObject* channel_offset_list_o      = 0;
     PyObject* frame_length_normalisation = Py_False;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!O!|O!O!", kwlist, &PyList_Type, &gmm_list_o,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!O|O!O!", kwlist, &PyList_Type, &gmm_list_o,
                                                                        &PyBobLearnEMGMMMachine_Type, &ubm,
-                                                                       &PyList_Type, &stats_list_o,
+                                                                       &stats_list_o,
                                                                        &PyList_Type, &channel_offset_list_o,
                                                                        &PyBool_Type, &frame_length_normalisation)){
       linear_scoring1.print_usage();
       return 0;
     }
 
-    std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats_list;
-    if(extract_gmmstats_list(stats_list_o ,stats_list)!=0)
-      Py_RETURN_NONE;
-
     std::vector<boost::shared_ptr<const bob::learn::em::GMMMachine> > gmm_list;
     if(extract_gmmmachine_list(gmm_list_o ,gmm_list)!=0)
       Py_RETURN_NONE;
@@ -163,6 +174,40 @@ PyObject* PyBobLearnEM_linear_scoring(PyObject*, PyObject* args, PyObject* kwarg
     if(extract_array_list(channel_offset_list_o ,channel_offset_list)!=0)
       Py_RETURN_NONE;
 
+    if (PyBobLearnEMGMMStatsSet_Check(stats_list_o)){
+      if(channel_offset_list.size()!=0){
+        PyErr_Format(PyExc_RuntimeError, "linear_scoring does not support channel offsets with a GMMStatsSet");
+        return 0;
+      }
+      const bob::learn::em::GMMStatsSet& stats_set = *reinterpret_cast<PyBobLearnEMGMMStatsSetObject*>(stats_list_o)->cxx;
+      blitz::Array<double, 2> scores = blitz::Array<double, 2>(gmm_list.size(), stats_set.getNSamples());
+      bob::learn::em::linearScoring(gmm_list, *ubm->cxx, stats_set, f(frame_length_normalisation),scores);
+      return PyBlitzArrayCxx_AsConstNumpy(scores);
+    }
+
+    if (!PyList_Check(stats_list_o)){
+      PyErr_Format(PyExc_TypeError, "test_stats must be a list of GMMStats, a list of CenteredGMMStats or a GMMStatsSet");
+      linear_scoring1.print_usage();
+      return 0;
+    }
+
+    if (PyList_GET_SIZE(stats_list_o) && PyBobLearnEMCenteredGMMStats_Check(PyList_GetItem(stats_list_o, 0))){
+      if(channel_offset_list.size()!=0){
+        PyErr_Format(PyExc_RuntimeError, "linear_scoring does not support channel offsets with CenteredGMMStats");
+        return 0;
+      }
+      std::vector<boost::shared_ptr<const bob::learn::em::CenteredGMMStats> > centered_list;
+      if(extract_centered_gmmstats_list(stats_list_o ,centered_list)!=0)
+        Py_RETURN_NONE;
+      blitz::Array<double, 2> scores = blitz::Array<double, 2>(gmm_list.size(), centered_list.size());
+      bob::learn::em::linearScoring(gmm_list, *ubm->cxx, centered_list, f(frame_length_normalisation),scores);
+      return PyBlitzArrayCxx_AsConstNumpy(scores);
+    }
+
+    std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats_list;
+    if(extract_gmmstats_list(stats_list_o ,stats_list)!=0)
+      Py_RETURN_NONE;
+
     blitz::Array<double, 2> scores = blitz::Array<double, 2>(gmm_list.size(), stats_list.size());
     if(channel_offset_list.size()==0)
       bob::learn::em::linearScoring(gmm_list, *ubm->cxx, stats_list, f(frame_length_normalisation),scores);
@@ -184,10 +229,10 @@ PyObject* PyBobLearnEM_linear_scoring(PyObject*, PyObject* args, PyObject* kwarg
     PyObject* channel_offset_list_o           = 0;
     PyObject* frame_length_normalisation      = Py_False;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&O&O!|O!O!", kwlist, &PyList_Type, &model_supervector_list_o,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&O&O|O!O!", kwlist, &PyList_Type, &model_supervector_list_o,
                                                                        &PyBlitzArray_Converter, &ubm_means,
                                                                        &PyBlitzArray_Converter, &ubm_variances,
-                                                                       &PyList_Type, &stats_list_o,
+                                                                       &stats_list_o,
                                                                        &PyList_Type, &channel_offset_list_o,
                                                                        &PyBool_Type, &frame_length_normalisation)){
       linear_scoring2.print_usage();
@@ -202,14 +247,44 @@ PyObject* PyBobLearnEM_linear_scoring(PyObject*, PyObject* args, PyObject* kwarg
     if(extract_array_list(model_supervector_list_o ,model_supervector_list)!=0)
       Py_RETURN_NONE;
 
-    std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats_list;
-    if(extract_gmmstats_list(stats_list_o ,stats_list)!=0)
-      Py_RETURN_NONE;
-
     std::vector<blitz::Array<double,1> > channel_offset_list;
     if(extract_array_list(channel_offset_list_o ,channel_offset_list)!=0)
       Py_RETURN_NONE;
 
+    if (PyBobLearnEMGMMStatsSet_Check(stats_list_o)){
+      if(channel_offset_list.size()!=0){
+        PyErr_Format(PyExc_RuntimeError, "linear_scoring does not support channel offsets with a GMMStatsSet");
+        return 0;
+      }
+      const bob::learn::em::GMMStatsSet& stats_set = *reinterpret_cast<PyBobLearnEMGMMStatsSetObject*>(stats_list_o)->cxx;
+      blitz::Array<double, 2> scores = blitz::Array<double, 2>(model_supervector_list.size(), stats_set.getNSamples());
+      bob::learn::em::linearScoring(model_supervector_list, *PyBlitzArrayCxx_AsBlitz<double,1>(ubm_means),*PyBlitzArrayCxx_AsBlitz<double,1>(ubm_variances), stats_set, f(frame_length_normalisation),scores);
+      return PyBlitzArrayCxx_AsConstNumpy(scores);
+    }
+
+    if (!PyList_Check(stats_list_o)){
+      PyErr_Format(PyExc_TypeError, "test_stats must be a list of GMMStats, a list of CenteredGMMStats or a GMMStatsSet");
+      linear_scoring2.print_usage();
+      return 0;
+    }
+
+    if (PyList_GET_SIZE(stats_list_o) && PyBobLearnEMCenteredGMMStats_Check(PyList_GetItem(stats_list_o, 0))){
+      if(channel_offset_list.size()!=0){
+        PyErr_Format(PyExc_RuntimeError, "linear_scoring does not support channel offsets with CenteredGMMStats");
+        return 0;
+      }
+      std::vector<boost::shared_ptr<const bob::learn::em::CenteredGMMStats> > centered_list;
+      if(extract_centered_gmmstats_list(stats_list_o ,centered_list)!=0)
+        Py_RETURN_NONE;
+      blitz::Array<double, 2> scores = blitz::Array<double, 2>(model_supervector_list.size(), centered_list.size());
+      bob::learn::em::linearScoring(model_supervector_list, *PyBlitzArrayCxx_AsBlitz<double,1>(ubm_means),*PyBlitzArrayCxx_AsBlitz<double,1>(ubm_variances), centered_list, f(frame_length_normalisation),scores);
+      return PyBlitzArrayCxx_AsConstNumpy(scores);
+    }
+
+    std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats_list;
+    if(extract_gmmstats_list(stats_list_o ,stats_list)!=0)
+      Py_RETURN_NONE;
+
     blitz::Array<double, 2> scores = blitz::Array<double, 2>(model_supervector_list.size(), stats_list.size());
     if(channel_offset_list.size()==0)
       bob::learn::em::linearScoring(model_supervector_list, *PyBlitzArrayCxx_AsBlitz<double,1>(ubm_means),*PyBlitzArrayCxx_AsBlitz<double,1>(ubm_variances), stats_list, f(frame_length_normalisation),scores);
@@ -221,21 +296,21 @@ PyObject* PyBobLearnEM_linear_scoring(PyObject*, PyObject* args, PyObject* kwarg
   }
 
   //Checking the signature of the method (list of arrays as input
-  else if (PyArray_Check(arg) && (nargs >= 5) && (nargs<=6) ){
+  else if (PyArray_Check(arg) && (nargs >= 4) && (nargs<=6) ){
 
     char** kwlist = linear_scoring3.kwlist(0);
 
     PyBlitzArrayObject* model                 = 0;
     PyBlitzArrayObject* ubm_means             = 0;
     PyBlitzArrayObject* ubm_variances         = 0;
-    PyBobLearnEMGMMStatsObject* stats       = 0;
+    PyObject* stats_o                         = 0;
     PyBlitzArrayObject* channel_offset        = 0;
     PyObject* frame_length_normalisation      = Py_False;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O!O&|O!", kwlist, &PyBlitzArray_Converter, &model,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O|O&O!", kwlist, &PyBlitzArray_Converter, &model,
                                                                        &PyBlitzArray_Converter, &ubm_means,
                                                                        &PyBlitzArray_Converter, &ubm_variances,
-                                                                       &PyBobLearnEMGMMStats_Type, &stats,
+                                                                       &stats_o,
                                                                        &PyBlitzArray_Converter, &channel_offset,
                                                                        &PyBool_Type, &frame_length_normalisation)){
       linear_scoring3.print_usage();
@@ -246,7 +321,24 @@ PyObject* PyBobLearnEM_linear_scoring(PyObject*, PyObject* args, PyObject* kwarg
     auto model_ = make_safe(model);
     auto ubm_means_ = make_safe(ubm_means);
     auto ubm_variances_ = make_safe(ubm_variances);
-    auto channel_offset_ = make_safe(channel_offset);
+    auto channel_offset_ = make_xsafe(channel_offset);
+
+    if (PyBobLearnEMCenteredGMMStats_Check(stats_o)){
+      if (channel_offset && channel_offset->shape[0] != 0){
+        PyErr_Format(PyExc_RuntimeError, "linear_scoring does not support channel offsets with CenteredGMMStats");
+        return 0;
+      }
+      const bob::learn::em::CenteredGMMStats& stats = *reinterpret_cast<PyBobLearnEMCenteredGMMStatsObject*>(stats_o)->cxx;
+      double score = bob::learn::em::linearScoring(*PyBlitzArrayCxx_AsBlitz<double,1>(model), *PyBlitzArrayCxx_AsBlitz<double,1>(ubm_means),*PyBlitzArrayCxx_AsBlitz<double,1>(ubm_variances), stats, f(frame_length_normalisation));
+      return Py_BuildValue("d",score);
+    }
+
+    if (!PyBobLearnEMGMMStats_Check(stats_o) || !channel_offset){
+      PyErr_Format(PyExc_TypeError, "linear_scoring of a single model requires a GMMStats and a channel offset, or a CenteredGMMStats");
+      linear_scoring3.print_usage();
+      return 0;
+    }
+    PyBobLearnEMGMMStatsObject* stats = reinterpret_cast<PyBobLearnEMGMMStatsObject*>(stats_o);
 
     double score = bob::learn::em::linearScoring(*PyBlitzArrayCxx_AsBlitz<double,1>(model), *PyBlitzArrayCxx_AsBlitz<double,1>(ubm_means),*PyBlitzArrayCxx_AsBlitz<double,1>(ubm_variances), *stats->cxx, *PyBlitzArrayCxx_AsBlitz<double,1>(channel_offset), f(frame_length_normalisation));
 
@@ -255,7 +347,7 @@ PyObject* PyBobLearnEM_linear_scoring(PyObject*, PyObject* args, PyObject* kwarg
 
 
   else{
-    PyErr_Format(PyExc_RuntimeError, "number of arguments mismatch - linear_scoring requires 5 or 6 arguments, but you provided %d (see help)", nargs);
+    PyErr_Format(PyExc_RuntimeError, "number of arguments mismatch - linear_scoring requires 4 to 6 arguments, but you provided %d (see help)", nargs);
     linear_scoring1.print_usage();
     linear_scoring2.print_usage();
     linear_scoring3.print_usage();
@@ -35,6 +35,30 @@ static PyMethodDef module_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     linear_scoring1.doc()
   },
+  {
+    sum_gmm_stats.name(),
+    (PyCFunction)PyBobLearnEM_sum_gmm_stats,
+    METH_VARARGS|METH_KEYWORDS,
+    sum_gmm_stats.doc()
+  },
+  {
+    map_mean_supervectors.name(),
+    (PyCFunction)PyBobLearnEM_map_mean_supervectors,
+    METH_VARARGS|METH_KEYWORDS,
+    map_mean_supervectors.doc()
+  },
+  {
+    train_em.name(),
+    (PyCFunction)PyBobLearnEM_train_em,
+    METH_VARARGS|METH_KEYWORDS,
+    train_em.doc()
+  },
+  {
+    train_restarts.name(),
+    (PyCFunction)PyBobLearnEM_train_restarts,
+    METH_VARARGS|METH_KEYWORDS,
+    train_restarts.doc()
+  },
 
   {0}//Sentinel
 };
@@ -70,11 +94,18 @@ static PyObject* create_module (void) {
 
   if (!init_BobLearnEMGaussian(module)) return 0;
   if (!init_BobLearnEMGMMStats(module)) return 0;
+  if (!init_BobLearnEMGMMStatsSet(module)) return 0;
+  if (!init_BobLearnEMGMMStatsArchive(module)) return 0;
+  if (!init_BobLearnEMCenteredGMMStats(module)) return 0;
   if (!init_BobLearnEMGMMMachine(module)) return 0;
+  if (!init_BobLearnEMGMMStatsAccumulator(module)) return 0;
+  if (!init_BobLearnEMFileListDataSource(module)) return 0;
   if (!init_BobLearnEMKMeansMachine(module)) return 0;
   if (!init_BobLearnEMKMeansTrainer(module)) return 0;
+  if (!init_BobLearnEMMiniBatchKMeansTrainer(module)) return 0;
   if (!init_BobLearnEMMLGMMTrainer(module)) return 0;
   if (!init_BobLearnEMMAPGMMTrainer(module)) return 0;
+  if (!init_BobLearnEMMAPEnrollmentModel(module)) return 0;
 
   if (!init_BobLearnEMJFABase(module)) return 0;
   if (!init_BobLearnEMJFAMachine(module)) return 0;
@@ -24,13 +24,20 @@
 
 #include <bob.learn.em/Gaussian.h>
 #include <bob.learn.em/GMMStats.h>
+#include <bob.learn.em/GMMStatsSet.h>
+#include <bob.learn.em/GMMStatsArchive.h>
+#include <bob.learn.em/GMMStatsAccumulator.h>
+#include <bob.learn.em/DataSource.h>
+#include <bob.learn.em/CenteredGMMStats.h>
 #include <bob.learn.em/GMMMachine.h>
 #include <bob.learn.em/KMeansMachine.h>
 
 #include <bob.learn.em/KMeansTrainer.h>
+#include <bob.learn.em/MiniBatchKMeansTrainer.h>
 //#include <bob.learn.em/GMMBaseTrainer.h>
 #include <bob.learn.em/ML_GMMTrainer.h>
 #include <bob.learn.em/MAP_GMMTrainer.h>
+#include <bob.learn.em/MAPEnrollmentModel.h>
 
 #include <bob.learn.em/JFABase.h>
 #include <bob.learn.em/JFAMachine.h>
@@ -80,6 +87,46 @@ bool init_BobLearnEMGMMStats(PyObject* module);
 int PyBobLearnEMGMMStats_Check(PyObject* o);
 
 
+// GMMStatsSet
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::GMMStatsSet> cxx;
+} PyBobLearnEMGMMStatsSetObject;
+
+extern PyTypeObject PyBobLearnEMGMMStatsSet_Type;
+bool init_BobLearnEMGMMStatsSet(PyObject* module);
+int PyBobLearnEMGMMStatsSet_Check(PyObject* o);
+
+
+// GMMStatsArchive
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::GMMStatsArchiveWriter> cxx;
+} PyBobLearnEMGMMStatsArchiveWriterObject;
+
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::GMMStatsArchive> cxx;
+} PyBobLearnEMGMMStatsArchiveObject;
+
+extern PyTypeObject PyBobLearnEMGMMStatsArchiveWriter_Type;
+extern PyTypeObject PyBobLearnEMGMMStatsArchive_Type;
+bool init_BobLearnEMGMMStatsArchive(PyObject* module);
+int PyBobLearnEMGMMStatsArchiveWriter_Check(PyObject* o);
+int PyBobLearnEMGMMStatsArchive_Check(PyObject* o);
+
+
+// CenteredGMMStats
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::CenteredGMMStats> cxx;
+} PyBobLearnEMCenteredGMMStatsObject;
+
+extern PyTypeObject PyBobLearnEMCenteredGMMStats_Type;
+bool init_BobLearnEMCenteredGMMStats(PyObject* module);
+int PyBobLearnEMCenteredGMMStats_Check(PyObject* o);
+
+
 // GMMMachine
 typedef struct {
   PyObject_HEAD
@@ -91,6 +138,28 @@ bool init_BobLearnEMGMMMachine(PyObject* module);
 int PyBobLearnEMGMMMachine_Check(PyObject* o);
 
 
+// GMMStatsAccumulator
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::GMMStatsAccumulator> cxx;
+} PyBobLearnEMGMMStatsAccumulatorObject;
+
+extern PyTypeObject PyBobLearnEMGMMStatsAccumulator_Type;
+bool init_BobLearnEMGMMStatsAccumulator(PyObject* module);
+int PyBobLearnEMGMMStatsAccumulator_Check(PyObject* o);
+
+
+// FileListDataSource
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::FileListDataSource> cxx;
+} PyBobLearnEMFileListDataSourceObject;
+
+extern PyTypeObject PyBobLearnEMFileListDataSource_Type;
+bool init_BobLearnEMFileListDataSource(PyObject* module);
+int PyBobLearnEMFileListDataSource_Check(PyObject* o);
+
+
 // KMeansMachine
 typedef struct {
   PyObject_HEAD
@@ -106,12 +175,29 @@ int PyBobLearnEMKMeansMachine_Check(PyObject* o);
 typedef struct {
   PyObject_HEAD
   boost::shared_ptr<bob::learn::em::KMeansTrainer> cxx;
+  // The data of the last accelerated E-step, to which its bounds belong
+  PyObject* bound_data;
 } PyBobLearnEMKMeansTrainerObject;
 
 extern PyTypeObject PyBobLearnEMKMeansTrainer_Type;
 bool init_BobLearnEMKMeansTrainer(PyObject* module);
 int PyBobLearnEMKMeansTrainer_Check(PyObject* o);
 
+// Conversions of the KMeansTrainer::InitializationMethod from and to str
+bob::learn::em::KMeansTrainer::InitializationMethod string2IM(const std::string& o);
+const std::string& IM2string(bob::learn::em::KMeansTrainer::InitializationMethod o);
+
+
+// MiniBatchKMeansTrainer
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::MiniBatchKMeansTrainer> cxx;
+} PyBobLearnEMMiniBatchKMeansTrainerObject;
+
+extern PyTypeObject PyBobLearnEMMiniBatchKMeansTrainer_Type;
+bool init_BobLearnEMMiniBatchKMeansTrainer(PyObject* module);
+int PyBobLearnEMMiniBatchKMeansTrainer_Check(PyObject* o);
+
 
 // ML_GMMTrainer
 typedef struct {
@@ -135,6 +221,17 @@ bool init_BobLearnEMMAPGMMTrainer(PyObject* module);
 int PyBobLearnEMMAPGMMTrainer_Check(PyObject* o);
 
 
+// MAPEnrollmentModel
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::learn::em::MAPEnrollmentModel> cxx;
+} PyBobLearnEMMAPEnrollmentModelObject;
+
+extern PyTypeObject PyBobLearnEMMAPEnrollmentModel_Type;
+bool init_BobLearnEMMAPEnrollmentModel(PyObject* module);
+int PyBobLearnEMMAPEnrollmentModel_Check(PyObject* o);
+
+
 // JFABase
 typedef struct {
   PyObject_HEAD
@@ -282,4 +379,21 @@ extern bob::extension::FunctionDoc linear_scoring1;
 extern bob::extension::FunctionDoc linear_scoring2;
 extern bob::extension::FunctionDoc linear_scoring3;
 
+
+//Sum of GMMStats
+PyObject* PyBobLearnEM_sum_gmm_stats(PyObject*, PyObject* args, PyObject* kwargs);
+extern bob::extension::FunctionDoc sum_gmm_stats;
+
+
+//Closed-form MAP supervectors
+PyObject* PyBobLearnEM_map_mean_supervectors(PyObject*, PyObject* args, PyObject* kwargs);
+extern bob::extension::FunctionDoc map_mean_supervectors;
+
+
+//EM training loop
+PyObject* PyBobLearnEM_train_em(PyObject*, PyObject* args, PyObject* kwargs);
+extern bob::extension::FunctionDoc train_em;
+PyObject* PyBobLearnEM_train_restarts(PyObject*, PyObject* args, PyObject* kwargs);
+extern bob::extension::FunctionDoc train_restarts;
+
 #endif // BOB_LEARN_EM_MAIN_H
@@ -0,0 +1,326 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto MAPEnrollmentModel_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".MAPEnrollmentModel",
+  "A MAP-adapted model which keeps the statistics of its enrollment sessions",
+  "The model is the result of a single MAP update (see :py:meth:`bob.learn.em.MAP_GMMTrainer.enroll`) "
+  "on the sum of the :py:class:`bob.learn.em.GMMStats` of all its sessions, computed with the prior GMM of the trainer. "
+  "When a new session is added, only its own statistics are required: they are added to the retained ones, "
+  "and the model is re-derived without going back to the features of the previous sessions. "
+  "The result is the same as adapting the prior on all the sessions at once.\n\n"
+  "Only the statistics are stored by :py:meth:`save`; the model is re-derived when it is loaded.\n\n"
+  ".. code-block:: python\n\n"
+  "   model = bob.learn.em.MAPEnrollmentModel(map_trainer, bob.io.base.HDF5File('model.hdf5'))\n"
+  "   model.add_session(new_features)\n"
+  "   model.save(bob.io.base.HDF5File('model.hdf5', 'w'))\n"
+  "   score = model.machine(probe)\n"
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a model without any session (equal to the prior GMM), or loads one from an HDF5 file",
+    "",
+    true
+  )
+  .add_prototype("trainer,[hdf5]","")
+  .add_parameter("trainer", ":py:class:`bob.learn.em.MAP_GMMTrainer`", "The MAP trainer, which gives the prior GMM and the adaptation parameters")
+  .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading")
+);
+
+
+static int PyBobLearnEMMAPEnrollmentModel_init(PyBobLearnEMMAPEnrollmentModelObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = MAPEnrollmentModel_doc.kwlist(0);
+
+  PyBobLearnEMMAPGMMTrainerObject* trainer = 0;
+  PyBobIoHDF5FileObject* config = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O&", kwlist, &PyBobLearnEMMAPGMMTrainer_Type, &trainer,
+                                                                 &PyBobIoHDF5File_Converter, &config)){
+    MAPEnrollmentModel_doc.print_usage();
+    return -1;
+  }
+  auto config_ = make_xsafe(config);
+
+  if (config)
+    self->cxx.reset(new bob::learn::em::MAPEnrollmentModel(trainer->cxx, *(config->f)));
+  else
+    self->cxx.reset(new bob::learn::em::MAPEnrollmentModel(trainer->cxx));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create MAPEnrollmentModel", -1)
+}
+
+
+static void PyBobLearnEMMAPEnrollmentModel_delete(PyBobLearnEMMAPEnrollmentModelObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobLearnEMMAPEnrollmentModel_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMMAPEnrollmentModel_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+/***** n_sessions *****/
+static auto n_sessions = bob::extension::VariableDoc(
+  "n_sessions",
+  "int",
+  "The number of sessions added to the model",
+  ""
+);
+PyObject* PyBobLearnEMMAPEnrollmentModel_getNSessions(PyBobLearnEMMAPEnrollmentModelObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getNSessions());
+  BOB_CATCH_MEMBER("n_sessions could not be read", 0)
+}
+
+
+/***** stats *****/
+static auto stats = bob::extension::VariableDoc(
+  "stats",
+  ":py:class:`bob.learn.em.GMMStats`",
+  "A copy of the sum of the statistics of the sessions",
+  ""
+);
+PyObject* PyBobLearnEMMAPEnrollmentModel_getStats(PyBobLearnEMMAPEnrollmentModelObject* self, void*){
+  BOB_TRY
+
+  //Allocating the correspondent python object
+  PyBobLearnEMGMMStatsObject* retval =
+    (PyBobLearnEMGMMStatsObject*)PyBobLearnEMGMMStats_Type.tp_alloc(&PyBobLearnEMGMMStats_Type, 0);
+  retval->cxx.reset(new bob::learn::em::GMMStats(self->cxx->getStats()));
+
+  return Py_BuildValue("N",retval);
+  BOB_CATCH_MEMBER("stats could not be read", 0)
+}
+
+
+/***** machine *****/
+static auto machine = bob::extension::VariableDoc(
+  "machine",
+  ":py:class:`bob.learn.em.GMMMachine`",
+  "The adapted model",
+  "It is updated in place each time a session is added, and must not be modified. "
+  "Make a copy of it to keep the model of a given set of sessions."
+);
+PyObject* PyBobLearnEMMAPEnrollmentModel_getMachine(PyBobLearnEMMAPEnrollmentModelObject* self, void*){
+  BOB_TRY
+
+  //Allocating the correspondent python object
+  PyBobLearnEMGMMMachineObject* retval =
+    (PyBobLearnEMGMMMachineObject*)PyBobLearnEMGMMMachine_Type.tp_alloc(&PyBobLearnEMGMMMachine_Type, 0);
+  retval->cxx = self->cxx->getMachine();
+
+  return Py_BuildValue("N",retval);
+  BOB_CATCH_MEMBER("machine could not be read", 0)
+}
+
+
+static PyGetSetDef PyBobLearnEMMAPEnrollmentModel_getseters[] = {
+  {
+    n_sessions.name(),
+    (getter)PyBobLearnEMMAPEnrollmentModel_getNSessions,
+    0,
+    n_sessions.doc(),
+    0
+  },
+  {
+    stats.name(),
+    (getter)PyBobLearnEMMAPEnrollmentModel_getStats,
+    0,
+    stats.doc(),
+    0
+  },
+  {
+    machine.name(),
+    (getter)PyBobLearnEMMAPEnrollmentModel_getMachine,
+    0,
+    machine.doc(),
+    0
+  },
+  {0}  // Sentinel
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+/*** add_session ***/
+static auto add_session = bob::extension::FunctionDoc(
+  "add_session",
+  "Adds a new session to the model, and re-derives it",
+  "The session is given either by its statistics, computed with the prior GMM, or by its features. "
+  "If the statistics of the first session have second order statistics, the ones of the following sessions must have them too.",
+  true
+)
+.add_prototype("input")
+.add_parameter("input", ":py:class:`bob.learn.em.GMMStats` or array_like <float, 2D>", "The statistics of the session, or its feature vectors (one per row)");
+static PyObject* PyBobLearnEMMAPEnrollmentModel_addSession(PyBobLearnEMMAPEnrollmentModelObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = add_session.kwlist(0);
+
+  PyObject* input = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &input)) return 0;
+
+  if (PyBobLearnEMGMMStats_Check(input)){
+    self->cxx->addSession(*((PyBobLearnEMGMMStatsObject*)input)->cxx);
+    Py_RETURN_NONE;
+  }
+
+  PyBlitzArrayObject* features = 0;
+  if (!PyBlitzArray_Converter(input, &features)) return 0;
+  auto features_ = make_safe(features);
+
+  if (features->type_num != NPY_FLOAT64 || features->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays of float64 or GMMStats", Py_TYPE(self)->tp_name);
+    add_session.print_usage();
+    return 0;
+  }
+
+  self->cxx->addSession(*PyBlitzArrayCxx_AsBlitz<double,2>(features));
+
+  BOB_CATCH_MEMBER("cannot add the session", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** update ***/
+static auto update = bob::extension::FunctionDoc(
+  "update",
+  "Re-derives the model from the retained statistics",
+  "This is only required when the adaptation parameters of the trainer were changed."
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMMAPEnrollmentModel_update(PyBobLearnEMMAPEnrollmentModelObject* self) {
+  BOB_TRY
+  self->cxx->update();
+  BOB_CATCH_MEMBER("cannot update the model", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the number of sessions and the statistics of the model to a given HDF5 file"
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMMAPEnrollmentModel_Save(PyBobLearnEMMAPEnrollmentModelObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  // get list of arguments
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the data", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Loads the number of sessions and the statistics of the model from a given HDF5 file, and re-derives it"
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMMAPEnrollmentModel_Load(PyBobLearnEMMAPEnrollmentModelObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the data", 0)
+  Py_RETURN_NONE;
+}
+
+
+static PyMethodDef PyBobLearnEMMAPEnrollmentModel_methods[] = {
+  {
+    add_session.name(),
+    (PyCFunction)PyBobLearnEMMAPEnrollmentModel_addSession,
+    METH_VARARGS|METH_KEYWORDS,
+    add_session.doc()
+  },
+  {
+    update.name(),
+    (PyCFunction)PyBobLearnEMMAPEnrollmentModel_update,
+    METH_NOARGS,
+    update.doc()
+  },
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMMAPEnrollmentModel_Save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMMAPEnrollmentModel_Load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the MAPEnrollmentModel type struct; will be initialized later
+PyTypeObject PyBobLearnEMMAPEnrollmentModel_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobLearnEMMAPEnrollmentModel(PyObject* module)
+{
+  // initialize the type struct
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_name = MAPEnrollmentModel_doc.name();
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_basicsize = sizeof(PyBobLearnEMMAPEnrollmentModelObject);
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_doc = MAPEnrollmentModel_doc.doc();
+
+  // set the functions
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMMAPEnrollmentModel_init);
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMMAPEnrollmentModel_delete);
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_methods = PyBobLearnEMMAPEnrollmentModel_methods;
+  PyBobLearnEMMAPEnrollmentModel_Type.tp_getset = PyBobLearnEMMAPEnrollmentModel_getseters;
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobLearnEMMAPEnrollmentModel_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobLearnEMMAPEnrollmentModel_Type);
+  return PyModule_AddObject(module, "MAPEnrollmentModel", (PyObject*)&PyBobLearnEMMAPEnrollmentModel_Type) >= 0;
+}
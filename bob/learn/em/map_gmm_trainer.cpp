@@ -342,7 +342,7 @@ static auto e_step = bob::extension::FunctionDoc(
 )
 .add_prototype("gmm_machine,data")
 .add_parameter("gmm_machine", ":py:class:`bob.learn.em.GMMMachine`", "GMMMachine Object")
-.add_parameter("data", "array_like <float, 2D>", "Input data");
+.add_parameter("data", "array_like <float, 2D> or :py:class:`bob.learn.em.FileListDataSource`", "Input data");
 static PyObject* PyBobLearnEMMAPGMMTrainer_e_step(PyBobLearnEMMAPGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
@@ -350,9 +350,17 @@ static PyObject* PyBobLearnEMMAPGMMTrainer_e_step(PyBobLearnEMMAPGMMTrainerObjec
   char** kwlist = e_step.kwlist(0);
 
   PyBobLearnEMGMMMachineObject* gmm_machine;
+  PyObject* input = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O", kwlist, &PyBobLearnEMGMMMachine_Type, &gmm_machine,
+                                                                 &input)) return 0;
+
+  if (PyBobLearnEMFileListDataSource_Check(input)){
+    self->cxx->eStep(*gmm_machine->cxx, *((PyBobLearnEMFileListDataSourceObject*)input)->cxx);
+    Py_RETURN_NONE;
+  }
+
   PyBlitzArrayObject* data = 0;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&", kwlist, &PyBobLearnEMGMMMachine_Type, &gmm_machine,
-                                                                 &PyBlitzArray_Converter, &data)) return 0;
+  if (!PyBlitzArray_Converter(input, &data)) return 0;
   auto data_ = make_safe(data);
 
 
@@ -437,6 +445,163 @@ static PyObject* PyBobLearnEMMAPGMMTrainer_compute_likelihood(PyBobLearnEMMAPGMM
 }
 
 
+/*** enroll ***/
+static auto enroll = bob::extension::FunctionDoc(
+  "enroll",
+  "Adapts a batch of models from the prior GMM, in parallel",
+  "The adapted parameters are written into contiguous model banks instead of separate :py:class:`bob.learn.em.GMMMachine` objects: "
+  "the means of the n'th model are ``means[n]``, and when the trainer updates them, its weights and variances are ``weights[n]`` and ``variances[n]``. "
+  "The variance thresholds of the prior GMM are used.\n\n"
+  "When :py:class:`bob.learn.em.GMMStats` are given, they must have been computed with the prior GMM, and a single MAP update is performed. "
+  "When features are given, ``iterations`` MAP updates are run for each model, the first one with the statistics computed with the prior GMM, "
+  "as :py:func:`bob.learn.em.train` with ``max_iterations=iterations`` would do.",
+  true
+)
+.add_prototype("data, [iterations], [n_threads]", "means, weights, variances")
+.add_parameter("data", "[:py:class:`bob.learn.em.GMMStats`] or [array_like <float, 2D>]", "The statistics or the features of each model")
+.add_parameter("iterations", "int", "[Default: ``1``] The number of MAP updates per model (only for features)")
+.add_parameter("n_threads", "int", "[Default: ``1``] The number of threads to use")
+.add_return("means", "array_like <float, 3D>", "The means of the models, of shape ``(N, C, D)``")
+.add_return("weights", "array_like <float, 2D> or None", "The weights of the models, of shape ``(N, C)``, or None if they are not updated")
+.add_return("variances", "array_like <float, 3D> or None", "The variances of the models, of shape ``(N, C, D)``, or None if they are not updated");
+static PyObject* PyBobLearnEMMAPGMMTrainer_enroll(PyBobLearnEMMAPGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = enroll.kwlist(0);
+
+  PyObject* data = 0;
+  int iterations = 1;
+  int n_threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|ii", kwlist, &PyList_Type, &data,
+                                                                  &iterations,
+                                                                  &n_threads)){
+    enroll.print_usage();
+    return 0;
+  }
+
+  if (iterations <= 0 || n_threads <= 0){
+    PyErr_Format(PyExc_ValueError, "`%s' requires positive `iterations` and `n_threads`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  blitz::Array<double,3> means, variances;
+  blitz::Array<double,2> weights;
+
+  if (PyList_GET_SIZE(data) > 0 && PyBobLearnEMGMMStats_Check(PyList_GetItem(data, 0))){
+    std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats;
+    for (int i=0; i<PyList_GET_SIZE(data); i++){
+      PyBobLearnEMGMMStatsObject* s;
+      if (!PyArg_Parse(PyList_GetItem(data, i), "O!", &PyBobLearnEMGMMStats_Type, &s)){
+        PyErr_Format(PyExc_RuntimeError, "Expected GMMStats objects");
+        return 0;
+      }
+      stats.push_back(s->cxx);
+    }
+
+    PyThreadState* state = PyEval_SaveThread();
+    try {
+      self->cxx->enroll(stats, means, weights, variances, n_threads);
+    }
+    catch (...) {
+      PyEval_RestoreThread(state);
+      throw;
+    }
+    PyEval_RestoreThread(state);
+  }
+  else{
+    // The converted arrays are kept alive until the end of the enrollment
+    std::vector<boost::shared_ptr<PyBlitzArrayObject> > arrays;
+    std::vector<blitz::Array<double,2> > features;
+    for (int i=0; i<PyList_GET_SIZE(data); i++){
+      PyBlitzArrayObject* array;
+      if (!PyArg_Parse(PyList_GetItem(data, i), "O&", &PyBlitzArray_Converter, &array)){
+        PyErr_Format(PyExc_RuntimeError, "Expected GMMStats objects or numpy arrays");
+        return 0;
+      }
+      arrays.push_back(make_safe(array));
+      if (array->type_num != NPY_FLOAT64 || array->ndim != 2){
+        PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays of float64 for `data`", Py_TYPE(self)->tp_name);
+        return 0;
+      }
+      features.push_back(*PyBlitzArrayCxx_AsBlitz<double,2>(array));
+    }
+
+    PyThreadState* state = PyEval_SaveThread();
+    try {
+      self->cxx->enroll(features, means, weights, variances, iterations, n_threads);
+    }
+    catch (...) {
+      PyEval_RestoreThread(state);
+      throw;
+    }
+    PyEval_RestoreThread(state);
+  }
+
+  PyObject* weights_ = Py_None;
+  PyObject* variances_ = Py_None;
+  if (weights.extent(0)) weights_ = PyBlitzArrayCxx_AsNumpy(weights);
+  else Py_INCREF(Py_None);
+  if (variances.extent(0)) variances_ = PyBlitzArrayCxx_AsNumpy(variances);
+  else Py_INCREF(Py_None);
+
+  return Py_BuildValue("NNN", PyBlitzArrayCxx_AsNumpy(means), weights_, variances_);
+
+  BOB_CATCH_MEMBER("cannot perform the enroll method", 0)
+}
+
+
+
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the state of the MAP_GMMTrainer to a given HDF5 file",
+  "The state (e.g., the statistics of the last E-step and the random number generator) is what is needed, together with the machine, "
+  "to resume a training from this point, see :py:func:`bob.learn.em.train`. "
+  "The configuration of the trainer is not saved.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMMAPGMMTrainer_save(PyBobLearnEMMAPGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Restores the state of the MAP_GMMTrainer from a given HDF5 file",
+  "The trainer should have the same configuration as the one which saved the state, and should be initialized on the same data first.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMMAPGMMTrainer_load(PyBobLearnEMMAPGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
 
 static PyMethodDef PyBobLearnEMMAPGMMTrainer_methods[] = {
   {
@@ -463,7 +628,25 @@ static PyMethodDef PyBobLearnEMMAPGMMTrainer_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     compute_likelihood.doc()
   },
+  {
+    enroll.name(),
+    (PyCFunction)PyBobLearnEMMAPGMMTrainer_enroll,
+    METH_VARARGS|METH_KEYWORDS,
+    enroll.doc()
+  },
 
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMMAPGMMTrainer_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMMAPGMMTrainer_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
   {0} /* Sentinel */
 };
 
@@ -0,0 +1,95 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+#include <bob.learn.em/MAPSupervectors.h>
+
+
+/*** map_mean_supervectors ***/
+bob::extension::FunctionDoc map_mean_supervectors = bob::extension::FunctionDoc(
+  "map_mean_supervectors",
+  "Adapts the means of a UBM to a batch of statistics, and returns the adapted models as supervectors",
+  "This is a single mean-only MAP update with Reynolds' adaptation, "
+  "as :py:class:`bob.learn.em.MAP_GMMTrainer` with ``update_means=True``, ``update_variances=False``, ``update_weights=False`` and ``relevance_factor=r`` would do in one iteration, "
+  "but computed in closed form, without building any :py:class:`bob.learn.em.GMMMachine`. "
+  "The adapted means of the c'th Gaussian are :math:`m_c = (F_c + r \\mu_c) / (N_c + r)`, "
+  "or the UBM means :math:`\\mu_c` if :math:`N_c` is below ``mean_var_update_responsibilities_threshold``, as with the trainer.\n\n"
+  "The ``output`` can be:\n\n"
+  "* ``'means'``: the adapted mean supervectors :math:`m_c`\n"
+  "* ``'offsets'``: the offsets to the UBM means :math:`m_c - \\mu_c`\n"
+  "* ``'normalized'``: the offsets normalized with the UBM :math:`\\sqrt{w_c} \\Sigma_c^{-1/2} (m_c - \\mu_c)`, for linear kernels approximating the KL-divergence kernel",
+  true
+)
+.add_prototype("ubm, stats, [relevance_factor], [output], [mean_var_update_responsibilities_threshold]", "supervectors")
+.add_parameter("ubm", ":py:class:`bob.learn.em.GMMMachine`", "The prior GMM (Universal Background Model UBM)")
+.add_parameter("stats", "[:py:class:`bob.learn.em.GMMStats`] or :py:class:`bob.learn.em.GMMStatsArchive`", "The statistics of the models, computed with the UBM")
+.add_parameter("relevance_factor", "float", "[Default: ``4``] The relevance factor r")
+.add_parameter("output", "str", "[Default: ``'means'``] One of ``'means'``, ``'offsets'`` or ``'normalized'``")
+.add_parameter("mean_var_update_responsibilities_threshold", "float", "[Default: min_float] The threshold over the responsibilities of the Gaussians of the :py:class:`bob.learn.em.MAP_GMMTrainer`")
+.add_return("supervectors", "array_like <float, 2D>", "The supervectors of the adapted models, of shape ``(N, C*D)``");
+PyObject* PyBobLearnEM_map_mean_supervectors(PyObject*, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = map_mean_supervectors.kwlist(0);
+
+  PyBobLearnEMGMMMachineObject* ubm = 0;
+  PyObject* stats = 0;
+  double relevance_factor = 4.;
+  const char* output = "means";
+  double mean_var_update_responsibilities_threshold = std::numeric_limits<double>::epsilon();
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|dsd", kwlist, &PyBobLearnEMGMMMachine_Type, &ubm,
+                                                                  &stats,
+                                                                  &relevance_factor,
+                                                                  &output,
+                                                                  &mean_var_update_responsibilities_threshold)){
+    map_mean_supervectors.print_usage();
+    return 0;
+  }
+
+  const std::string output_(output);
+  bob::learn::em::MAPSupervectorType type;
+  if (output_ == "means") type = bob::learn::em::MAP_MEANS;
+  else if (output_ == "offsets") type = bob::learn::em::MAP_OFFSETS;
+  else if (output_ == "normalized") type = bob::learn::em::MAP_NORMALIZED_OFFSETS;
+  else {
+    PyErr_Format(PyExc_ValueError, "`map_mean_supervectors' output must be 'means', 'offsets' or 'normalized', not '%s'", output);
+    return 0;
+  }
+
+  blitz::Array<double,2> supervectors;
+
+  if (PyBobLearnEMGMMStatsArchive_Check(stats)){
+    // Directly on the memory-mapped records
+    const bob::learn::em::GMMStatsArchive& archive = *((PyBobLearnEMGMMStatsArchiveObject*)stats)->cxx;
+    bob::learn::em::mapMeanSupervectors(*ubm->cxx, archive.getN(), archive.getSumPx(), relevance_factor, supervectors, type,
+      mean_var_update_responsibilities_threshold);
+  }
+  else if (PyList_Check(stats)){
+    std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats_;
+    for (int i=0; i<PyList_GET_SIZE(stats); i++){
+      PyBobLearnEMGMMStatsObject* s;
+      if (!PyArg_Parse(PyList_GetItem(stats, i), "O!", &PyBobLearnEMGMMStats_Type, &s)){
+        PyErr_Format(PyExc_RuntimeError, "Expected GMMStats objects");
+        return 0;
+      }
+      stats_.push_back(s->cxx);
+    }
+    bob::learn::em::mapMeanSupervectors(*ubm->cxx, stats_, relevance_factor, supervectors, type,
+      mean_var_update_responsibilities_threshold);
+  }
+  else {
+    PyErr_Format(PyExc_TypeError, "`map_mean_supervectors' expects a list of GMMStats or a GMMStatsArchive, not `%s'", Py_TYPE(stats)->tp_name);
+    return 0;
+  }
+
+  return PyBlitzArrayCxx_AsNumpy(supervectors);
+
+  BOB_CATCH_FUNCTION("cannot compute the supervectors", 0)
+}
@@ -0,0 +1,541 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto MiniBatchKMeansTrainer_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".MiniBatchKMeansTrainer",
+  "Trains a KMeans machine with mini-batches",
+  "See Sculley, \"Web-scale k-means clustering\", 2010. "
+  "Each ``e_step`` draws ``batch_size`` samples of the data at random (with replacement) and assigns them to their closest mean; "
+  "the ``m_step`` then moves each mean towards the samples assigned to it, with a learning rate of one over the number of samples this mean has been assigned since the initialization. "
+  "An iteration thus only costs the processing of a batch, whatever the size of the data.\n\n"
+  "The means are initialized as with the :py:class:`bob.learn.em.KMeansTrainer`, and the trained :py:class:`bob.learn.em.KMeansMachine` is used in the same way, "
+  "e.g., to initialize a :py:class:`bob.learn.em.GMMMachine` with :py:meth:`bob.learn.em.KMeansMachine.get_variances_and_weights_for_each_cluster`. "
+  "With :py:func:`bob.learn.em.train`, each iteration processes one batch: ``max_iterations`` is the number of batches, "
+  "and the convergence criterion applies to a smoothed average distance (see :py:meth:`compute_likelihood`).\n\n"
+  ".. code-block:: python\n\n"
+  "   trainer = bob.learn.em.MiniBatchKMeansTrainer(batch_size=1024)\n"
+  "   bob.learn.em.train(trainer, kmeans, data, max_iterations=500)\n"
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a MiniBatchKMeansTrainer",
+    "",
+    true
+  )
+  .add_prototype("[batch_size],[initialization_method]","")
+  .add_prototype("other","")
+
+  .add_parameter("batch_size", "int", "[Default: ``1024``] The number of samples drawn by each E-step")
+  .add_parameter("initialization_method", "str", "[Default: ``'RANDOM'``] The initialization method of the means, see :py:attr:`bob.learn.em.KMeansTrainer.initialization_method`")
+  .add_parameter("other", ":py:class:`bob.learn.em.MiniBatchKMeansTrainer`", "A MiniBatchKMeansTrainer object to be copied.")
+);
+
+
+static int PyBobLearnEMMiniBatchKMeansTrainer_init_copy(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+
+  char** kwlist = MiniBatchKMeansTrainer_doc.kwlist(1);
+  PyBobLearnEMMiniBatchKMeansTrainerObject* tt;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobLearnEMMiniBatchKMeansTrainer_Type, &tt)){
+    MiniBatchKMeansTrainer_doc.print_usage();
+    return -1;
+  }
+
+  self->cxx.reset(new bob::learn::em::MiniBatchKMeansTrainer(*tt->cxx));
+  return 0;
+}
+
+static int PyBobLearnEMMiniBatchKMeansTrainer_init(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  int nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  if (nargs == 1){
+    //Reading the input argument
+    PyObject* arg = 0;
+    if (PyTuple_Size(args))
+      arg = PyTuple_GET_ITEM(args, 0);
+    else {
+      PyObject* tmp = PyDict_Values(kwargs);
+      auto tmp_ = make_safe(tmp);
+      arg = PyList_GET_ITEM(tmp, 0);
+    }
+
+    // If the constructor input is MiniBatchKMeansTrainer object
+    if (PyBobLearnEMMiniBatchKMeansTrainer_Check(arg))
+      return PyBobLearnEMMiniBatchKMeansTrainer_init_copy(self, args, kwargs);
+  }
+
+  char** kwlist = MiniBatchKMeansTrainer_doc.kwlist(0);
+  Py_ssize_t batch_size = 1024;
+  char* initialization_method = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|ns", kwlist, &batch_size, &initialization_method)){
+    MiniBatchKMeansTrainer_doc.print_usage();
+    return -1;
+  }
+
+  if (batch_size <= 0){
+    PyErr_Format(PyExc_TypeError, "batch_size must be greater than zero");
+    MiniBatchKMeansTrainer_doc.print_usage();
+    return -1;
+  }
+
+  bob::learn::em::KMeansTrainer::InitializationMethod i_m = bob::learn::em::KMeansTrainer::RANDOM;
+  if (initialization_method)
+    i_m = string2IM(std::string(initialization_method));
+
+  self->cxx.reset(new bob::learn::em::MiniBatchKMeansTrainer(batch_size, i_m));
+  return 0;
+
+  BOB_CATCH_MEMBER("cannot create MiniBatchKMeansTrainer", -1)
+}
+
+
+static void PyBobLearnEMMiniBatchKMeansTrainer_delete(PyBobLearnEMMiniBatchKMeansTrainerObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+
+int PyBobLearnEMMiniBatchKMeansTrainer_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobLearnEMMiniBatchKMeansTrainer_Type));
+}
+
+
+static PyObject* PyBobLearnEMMiniBatchKMeansTrainer_RichCompare(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* other, int op) {
+  BOB_TRY
+
+  if (!PyBobLearnEMMiniBatchKMeansTrainer_Check(other)) {
+    PyErr_Format(PyExc_TypeError, "cannot compare `%s' with `%s'", Py_TYPE(self)->tp_name, Py_TYPE(other)->tp_name);
+    return 0;
+  }
+  auto other_ = reinterpret_cast<PyBobLearnEMMiniBatchKMeansTrainerObject*>(other);
+  switch (op) {
+    case Py_EQ:
+      if (*self->cxx==*other_->cxx) Py_RETURN_TRUE; else Py_RETURN_FALSE;
+    case Py_NE:
+      if (*self->cxx==*other_->cxx) Py_RETURN_FALSE; else Py_RETURN_TRUE;
+    default:
+      Py_INCREF(Py_NotImplemented);
+      return Py_NotImplemented;
+  }
+  BOB_CATCH_MEMBER("cannot compare MiniBatchKMeansTrainer objects", 0)
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+/***** batch_size *****/
+static auto batch_size = bob::extension::VariableDoc(
+  "batch_size",
+  "int",
+  "The number of samples drawn by each E-step",
+  ""
+);
+PyObject* PyBobLearnEMMiniBatchKMeansTrainer_getBatchSize(PyBobLearnEMMiniBatchKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getBatchSize());
+  BOB_CATCH_MEMBER("batch_size could not be read", 0)
+}
+int PyBobLearnEMMiniBatchKMeansTrainer_setBatchSize(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyInt_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an int", Py_TYPE(self)->tp_name, batch_size.name());
+    return -1;
+  }
+
+  if (PyInt_AS_LONG(value) <= 0){
+    PyErr_Format(PyExc_TypeError, "batch_size must be greater than zero");
+    return -1;
+  }
+
+  self->cxx->setBatchSize(PyInt_AS_LONG(value));
+  return 0;
+  BOB_CATCH_MEMBER("batch_size could not be set", -1)
+}
+
+
+/***** initialization_method *****/
+static auto initialization_method = bob::extension::VariableDoc(
+  "initialization_method",
+  "str",
+  "Initialization method",
+  "See :py:attr:`bob.learn.em.KMeansTrainer.initialization_method`"
+);
+PyObject* PyBobLearnEMMiniBatchKMeansTrainer_getInitializationMethod(PyBobLearnEMMiniBatchKMeansTrainerObject* self, void*) {
+  BOB_TRY
+  return Py_BuildValue("s", IM2string(self->cxx->getInitializationMethod()).c_str());
+  BOB_CATCH_MEMBER("initialization method could not be read", 0)
+}
+int PyBobLearnEMMiniBatchKMeansTrainer_setInitializationMethod(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* value, void*) {
+  BOB_TRY
+
+  if (!PyString_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects an str", Py_TYPE(self)->tp_name, initialization_method.name());
+    return -1;
+  }
+  self->cxx->setInitializationMethod(string2IM(PyString_AS_STRING(value)));
+
+  return 0;
+  BOB_CATCH_MEMBER("initialization method could not be set", -1)
+}
+
+
+/***** counts *****/
+static auto counts = bob::extension::VariableDoc(
+  "counts",
+  "array_like <float, 1D>",
+  "The number of samples assigned to each mean since the initialization",
+  "The learning rate of a mean is the inverse of its count."
+);
+PyObject* PyBobLearnEMMiniBatchKMeansTrainer_getCounts(PyBobLearnEMMiniBatchKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->getCounts());
+  BOB_CATCH_MEMBER("counts could not be read", 0)
+}
+
+
+/***** batch_average_min_distance *****/
+static auto batch_average_min_distance = bob::extension::VariableDoc(
+  "batch_average_min_distance",
+  "float",
+  "The average min (square Euclidean) distance of the last batch",
+  ""
+);
+PyObject* PyBobLearnEMMiniBatchKMeansTrainer_getBatchAverageMinDistance(PyBobLearnEMMiniBatchKMeansTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("d", self->cxx->getBatchAverageMinDistance());
+  BOB_CATCH_MEMBER("batch_average_min_distance could not be read", 0)
+}
+
+
+static PyGetSetDef PyBobLearnEMMiniBatchKMeansTrainer_getseters[] = {
+  {
+   batch_size.name(),
+   (getter)PyBobLearnEMMiniBatchKMeansTrainer_getBatchSize,
+   (setter)PyBobLearnEMMiniBatchKMeansTrainer_setBatchSize,
+   batch_size.doc(),
+   0
+  },
+  {
+   initialization_method.name(),
+   (getter)PyBobLearnEMMiniBatchKMeansTrainer_getInitializationMethod,
+   (setter)PyBobLearnEMMiniBatchKMeansTrainer_setInitializationMethod,
+   initialization_method.doc(),
+   0
+  },
+  {
+   counts.name(),
+   (getter)PyBobLearnEMMiniBatchKMeansTrainer_getCounts,
+   0,
+   counts.doc(),
+   0
+  },
+  {
+   batch_average_min_distance.name(),
+   (getter)PyBobLearnEMMiniBatchKMeansTrainer_getBatchAverageMinDistance,
+   0,
+   batch_average_min_distance.doc(),
+   0
+  },
+  {0}  // Sentinel
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+/*** initialize ***/
+static auto initialize = bob::extension::FunctionDoc(
+  "initialize",
+  "Initialises the means as the :py:class:`bob.learn.em.KMeansTrainer` does, and resets the counts of the means",
+  "",
+  true
+)
+.add_prototype("kmeans_machine, data, [rng]")
+.add_parameter("kmeans_machine", ":py:class:`bob.learn.em.KMeansMachine`", "KMeansMachine Object")
+.add_parameter("data", "array_like <float, 2D>", "Input data")
+.add_parameter("rng", ":py:class:`bob.core.random.mt19937`", "The Mersenne Twister mt19937 random generator used for the initialization and to draw the batches.");
+static PyObject* PyBobLearnEMMiniBatchKMeansTrainer_initialize(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = initialize.kwlist(0);
+
+  PyBobLearnEMKMeansMachineObject* kmeans_machine = 0;
+  PyBlitzArrayObject* data                        = 0;
+  PyBoostMt19937Object* rng = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&|O!", kwlist, &PyBobLearnEMKMeansMachine_Type, &kmeans_machine,
+                                                                 &PyBlitzArray_Converter, &data,
+                                                                  &PyBoostMt19937_Type, &rng)) return 0;
+  auto data_ = make_safe(data);
+
+  // perform check on the input
+  if (data->type_num != NPY_FLOAT64){
+    PyErr_Format(PyExc_TypeError, "`%s' only supports 64-bit float arrays for input array `%s`", Py_TYPE(self)->tp_name, initialize.name());
+    return 0;
+  }
+
+  if (data->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays of float64 for `%s`", Py_TYPE(self)->tp_name, initialize.name());
+    return 0;
+  }
+
+  if (data->shape[1] != (Py_ssize_t)kmeans_machine->cxx->getNInputs() ) {
+    PyErr_Format(PyExc_TypeError, "`%s' 2D `input` array should have the shape [N, %" PY_FORMAT_SIZE_T "d] not [N, %" PY_FORMAT_SIZE_T "d] for `%s`", Py_TYPE(self)->tp_name, kmeans_machine->cxx->getNInputs(), data->shape[1], initialize.name());
+    return 0;
+  }
+
+  if(rng){
+    self->cxx->setRng(rng->rng);
+  }
+
+  self->cxx->initialize(*kmeans_machine->cxx, *PyBlitzArrayCxx_AsBlitz<double,2>(data));
+
+  BOB_CATCH_MEMBER("cannot perform the initialize method", 0)
+
+  Py_RETURN_NONE;
+}
+
+
+/*** e_step ***/
+static auto e_step = bob::extension::FunctionDoc(
+  "e_step",
+  "Draws a batch of samples of the data, and assigns them to their closest mean",
+  "",
+  true
+)
+.add_prototype("kmeans_machine,data")
+.add_parameter("kmeans_machine", ":py:class:`bob.learn.em.KMeansMachine`", "KMeansMachine Object")
+.add_parameter("data", "array_like <float, 2D>", "Input data");
+static PyObject* PyBobLearnEMMiniBatchKMeansTrainer_e_step(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = e_step.kwlist(0);
+
+  PyBobLearnEMKMeansMachineObject* kmeans_machine;
+  PyBlitzArrayObject* data = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&", kwlist, &PyBobLearnEMKMeansMachine_Type, &kmeans_machine,
+                                                                 &PyBlitzArray_Converter, &data)) return 0;
+  auto data_ = make_safe(data);
+
+  if (data->type_num != NPY_FLOAT64){
+    PyErr_Format(PyExc_TypeError, "`%s' only supports 64-bit float arrays for input array `%s`", Py_TYPE(self)->tp_name, e_step.name());
+    return 0;
+  }
+
+  if (data->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays of float64 for `%s`", Py_TYPE(self)->tp_name, e_step.name());
+    return 0;
+  }
+
+  if (data->shape[1] != (Py_ssize_t)kmeans_machine->cxx->getNInputs() ) {
+    PyErr_Format(PyExc_TypeError, "`%s' 2D `input` array should have the shape [N, %" PY_FORMAT_SIZE_T "d] not [N, %" PY_FORMAT_SIZE_T "d] for `%s`", Py_TYPE(self)->tp_name, kmeans_machine->cxx->getNInputs(), data->shape[1], e_step.name());
+    return 0;
+  }
+
+  self->cxx->eStep(*kmeans_machine->cxx, *PyBlitzArrayCxx_AsBlitz<double,2>(data));
+
+  BOB_CATCH_MEMBER("cannot perform the e_step method", 0)
+
+  Py_RETURN_NONE;
+}
+
+
+/*** m_step ***/
+static auto m_step = bob::extension::FunctionDoc(
+  "m_step",
+  "Moves the means towards the samples of the last batch assigned to them",
+  0,
+  true
+)
+.add_prototype("kmeans_machine, [data]")
+.add_parameter("kmeans_machine", ":py:class:`bob.learn.em.KMeansMachine`", "KMeansMachine Object")
+.add_parameter("data", "object", "Ignored.");
+static PyObject* PyBobLearnEMMiniBatchKMeansTrainer_m_step(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = m_step.kwlist(0);
+
+  PyBobLearnEMKMeansMachineObject* kmeans_machine;
+  PyObject* data = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O", kwlist, &PyBobLearnEMKMeansMachine_Type, &kmeans_machine,
+                                                                 &data)) return 0;
+  self->cxx->mStep(*kmeans_machine->cxx);
+
+  BOB_CATCH_MEMBER("cannot perform the m_step method", 0)
+
+  Py_RETURN_NONE;
+}
+
+
+/*** computeLikelihood ***/
+static auto compute_likelihood = bob::extension::FunctionDoc(
+  "compute_likelihood",
+  "Returns an exponentially weighted average of the average min (square Euclidean) distance of the batches",
+  "The average is over a window of about 10 batches (whatever the size of the data), the first batches being averaged uniformly. "
+  "This is less noisy than the distance of the last batch only (see :py:attr:`batch_average_min_distance`).",
+  true
+)
+.add_prototype("kmeans_machine")
+.add_parameter("kmeans_machine", ":py:class:`bob.learn.em.KMeansMachine`", "KMeansMachine Object");
+static PyObject* PyBobLearnEMMiniBatchKMeansTrainer_compute_likelihood(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = compute_likelihood.kwlist(0);
+
+  PyBobLearnEMKMeansMachineObject* kmeans_machine;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobLearnEMKMeansMachine_Type, &kmeans_machine)) return 0;
+
+  double value = self->cxx->computeLikelihood(*kmeans_machine->cxx);
+  return Py_BuildValue("d", value);
+
+  BOB_CATCH_MEMBER("cannot perform the computeLikelihood method", 0)
+}
+
+
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the state of the MiniBatchKMeansTrainer to a given HDF5 file",
+  "The state (the counts of the means, the last batch and the random number generator) is what is needed, together with the machine, "
+  "to resume a training from this point, see :py:func:`bob.learn.em.train`. "
+  "The configuration of the trainer is not saved.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMMiniBatchKMeansTrainer_save(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Restores the state of the MiniBatchKMeansTrainer from a given HDF5 file",
+  "The trainer should have the same configuration as the one which saved the state.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMMiniBatchKMeansTrainer_load(PyBobLearnEMMiniBatchKMeansTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+static PyMethodDef PyBobLearnEMMiniBatchKMeansTrainer_methods[] = {
+  {
+    initialize.name(),
+    (PyCFunction)PyBobLearnEMMiniBatchKMeansTrainer_initialize,
+    METH_VARARGS|METH_KEYWORDS,
+    initialize.doc()
+  },
+  {
+    e_step.name(),
+    (PyCFunction)PyBobLearnEMMiniBatchKMeansTrainer_e_step,
+    METH_VARARGS|METH_KEYWORDS,
+    e_step.doc()
+  },
+  {
+    m_step.name(),
+    (PyCFunction)PyBobLearnEMMiniBatchKMeansTrainer_m_step,
+    METH_VARARGS|METH_KEYWORDS,
+    m_step.doc()
+  },
+  {
+    compute_likelihood.name(),
+    (PyCFunction)PyBobLearnEMMiniBatchKMeansTrainer_compute_likelihood,
+    METH_VARARGS|METH_KEYWORDS,
+    compute_likelihood.doc()
+  },
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMMiniBatchKMeansTrainer_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMMiniBatchKMeansTrainer_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the MiniBatchKMeansTrainer type struct; will be initialized later
+PyTypeObject PyBobLearnEMMiniBatchKMeansTrainer_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobLearnEMMiniBatchKMeansTrainer(PyObject* module)
+{
+  // initialize the type struct
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_name = MiniBatchKMeansTrainer_doc.name();
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_basicsize = sizeof(PyBobLearnEMMiniBatchKMeansTrainerObject);
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;//Enable the class inheritance
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_doc = MiniBatchKMeansTrainer_doc.doc();
+
+  // set the functions
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_new = PyType_GenericNew;
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_init = reinterpret_cast<initproc>(PyBobLearnEMMiniBatchKMeansTrainer_init);
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobLearnEMMiniBatchKMeansTrainer_delete);
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_richcompare = reinterpret_cast<richcmpfunc>(PyBobLearnEMMiniBatchKMeansTrainer_RichCompare);
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_methods = PyBobLearnEMMiniBatchKMeansTrainer_methods;
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_getset = PyBobLearnEMMiniBatchKMeansTrainer_getseters;
+  PyBobLearnEMMiniBatchKMeansTrainer_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobLearnEMMiniBatchKMeansTrainer_compute_likelihood);
+
+
+  // check that everything is fine
+  if (PyType_Ready(&PyBobLearnEMMiniBatchKMeansTrainer_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobLearnEMMiniBatchKMeansTrainer_Type);
+  return PyModule_AddObject(module, "MiniBatchKMeansTrainer", (PyObject*)&PyBobLearnEMMiniBatchKMeansTrainer_Type) >= 0;
+}
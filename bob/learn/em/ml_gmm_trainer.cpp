@@ -169,6 +169,187 @@ int PyBobLearnEMMLGMMTrainer_set_gmm_statistics(PyBobLearnEMMLGMMTrainerObject*
 }
 
 
+/***** stepwise_decay *****/
+static auto stepwise_decay = bob::extension::VariableDoc(
+  "stepwise_decay",
+  "float",
+  "The decay exponent :math:`\\alpha \\in ]0.5,1]` of the step size of the stepwise EM :math:`\\eta_k = (k + t_0)^{-\\alpha}`",
+  "Smaller values forget the first mini-batches faster. [Default: ``0.6``]"
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getStepwiseDecay(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("d", self->cxx->getStepwiseDecay());
+  BOB_CATCH_MEMBER("stepwise_decay could not be read", 0)
+}
+int PyBobLearnEMMLGMMTrainer_setStepwiseDecay(PyBobLearnEMMLGMMTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBob_NumberCheck(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a float", Py_TYPE(self)->tp_name, stepwise_decay.name());
+    return -1;
+  }
+
+  self->cxx->setStepwiseDecay(PyFloat_AsDouble(value));
+  return 0;
+  BOB_CATCH_MEMBER("stepwise_decay could not be set", -1)
+}
+
+
+/***** stepwise_offset *****/
+static auto stepwise_offset = bob::extension::VariableDoc(
+  "stepwise_offset",
+  "float",
+  "The offset :math:`t_0 \\geq 0` of the step size of the stepwise EM :math:`\\eta_k = (k + t_0)^{-\\alpha}`",
+  "Larger values slow down the decay of the first steps. [Default: ``2``]"
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getStepwiseOffset(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("d", self->cxx->getStepwiseOffset());
+  BOB_CATCH_MEMBER("stepwise_offset could not be read", 0)
+}
+int PyBobLearnEMMLGMMTrainer_setStepwiseOffset(PyBobLearnEMMLGMMTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBob_NumberCheck(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a float", Py_TYPE(self)->tp_name, stepwise_offset.name());
+    return -1;
+  }
+
+  self->cxx->setStepwiseOffset(PyFloat_AsDouble(value));
+  return 0;
+  BOB_CATCH_MEMBER("stepwise_offset could not be set", -1)
+}
+
+
+/***** stepwise_iteration *****/
+static auto stepwise_iteration = bob::extension::VariableDoc(
+  "stepwise_iteration",
+  "int",
+  "The number of mini-batches processed by :py:meth:`stepwise_step` since the last :py:meth:`reset_stepwise` or :py:meth:`initialize`",
+  ""
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getStepwiseIteration(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getStepwiseIteration());
+  BOB_CATCH_MEMBER("stepwise_iteration could not be read", 0)
+}
+
+
+/***** step_size *****/
+static auto step_size = bob::extension::VariableDoc(
+  "step_size",
+  "float",
+  "The step size that :py:meth:`stepwise_step` will use for the next mini-batch",
+  ""
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getStepSize(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("d", self->cxx->getStepSize());
+  BOB_CATCH_MEMBER("step_size could not be read", 0)
+}
+
+
+/***** prune_threshold *****/
+static auto prune_threshold = bob::extension::VariableDoc(
+  "prune_threshold",
+  "float",
+  "The occupancy threshold of the pruning of dead components",
+  "After the update of the parameters, :py:meth:`m_step` removes the components whose occupancy (zeroth order statistics) "
+  "was below this threshold during :py:attr:`prune_iterations` consecutive M-steps, so that the following E-steps do not evaluate them anymore. "
+  "The :py:class:`bob.learn.em.GMMMachine` and the :py:attr:`gmm_statistics` shrink accordingly. "
+  "``0`` disables the pruning. [Default: ``0``]"
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getPruneThreshold(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("d", self->cxx->getPruneThreshold());
+  BOB_CATCH_MEMBER("prune_threshold could not be read", 0)
+}
+int PyBobLearnEMMLGMMTrainer_setPruneThreshold(PyBobLearnEMMLGMMTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBob_NumberCheck(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a float", Py_TYPE(self)->tp_name, prune_threshold.name());
+    return -1;
+  }
+
+  self->cxx->setPruneThreshold(PyFloat_AsDouble(value));
+  return 0;
+  BOB_CATCH_MEMBER("prune_threshold could not be set", -1)
+}
+
+
+/***** prune_iterations *****/
+static auto prune_iterations = bob::extension::VariableDoc(
+  "prune_iterations",
+  "int",
+  "The number of consecutive M-steps with an occupancy below :py:attr:`prune_threshold` after which a component is pruned",
+  "[Default: ``3``]"
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getPruneIterations(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->getPruneIterations());
+  BOB_CATCH_MEMBER("prune_iterations could not be read", 0)
+}
+int PyBobLearnEMMLGMMTrainer_setPruneIterations(PyBobLearnEMMLGMMTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyInt_Check(value) || PyInt_AS_LONG(value) <= 0){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a positive int", Py_TYPE(self)->tp_name, prune_iterations.name());
+    return -1;
+  }
+
+  self->cxx->setPruneIterations(PyInt_AS_LONG(value));
+  return 0;
+  BOB_CATCH_MEMBER("prune_iterations could not be set", -1)
+}
+
+
+/***** prune_resplit *****/
+static auto prune_resplit = bob::extension::VariableDoc(
+  "prune_resplit",
+  "bool",
+  "Whether the pruned components are replaced by splits of the heaviest components (see :py:meth:`bob.learn.em.GMMMachine.split`), keeping the number of components",
+  "[Default: ``False``]"
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getPruneResplit(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  if (self->cxx->getPruneResplit()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+  BOB_CATCH_MEMBER("prune_resplit could not be read", 0)
+}
+int PyBobLearnEMMLGMMTrainer_setPruneResplit(PyBobLearnEMMLGMMTrainerObject* self, PyObject* value, void*){
+  BOB_TRY
+
+  if (!PyBool_Check(value)){
+    PyErr_Format(PyExc_RuntimeError, "%s %s expects a bool", Py_TYPE(self)->tp_name, prune_resplit.name());
+    return -1;
+  }
+
+  self->cxx->setPruneResplit(PyObject_IsTrue(value) > 0);
+  return 0;
+  BOB_CATCH_MEMBER("prune_resplit could not be set", -1)
+}
+
+
+/***** pruned_components *****/
+static auto pruned_components = bob::extension::VariableDoc(
+  "pruned_components",
+  "[int]",
+  "The components pruned since the last :py:meth:`initialize`, in order of removal",
+  "Components are identified by their index at initialization; the components created by re-splits get the following indices."
+);
+PyObject* PyBobLearnEMMLGMMTrainer_getPrunedComponents(PyBobLearnEMMLGMMTrainerObject* self, void*){
+  BOB_TRY
+  const std::vector<size_t>& pruned = self->cxx->getPrunedComponents();
+  PyObject* list = PyList_New(pruned.size());
+  if (!list) return 0;
+  for (size_t i=0; i<pruned.size(); ++i)
+    PyList_SET_ITEM(list, i, Py_BuildValue("n", (Py_ssize_t)pruned[i]));
+  return list;
+  BOB_CATCH_MEMBER("pruned_components could not be read", 0)
+}
+
+
 static PyGetSetDef PyBobLearnEMMLGMMTrainer_getseters[] = {
   {
    gmm_statistics.name(),
@@ -177,6 +358,62 @@ static PyGetSetDef PyBobLearnEMMLGMMTrainer_getseters[] = {
    gmm_statistics.doc(),
    0
   },
+  {
+   stepwise_decay.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getStepwiseDecay,
+   (setter)PyBobLearnEMMLGMMTrainer_setStepwiseDecay,
+   stepwise_decay.doc(),
+   0
+  },
+  {
+   stepwise_offset.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getStepwiseOffset,
+   (setter)PyBobLearnEMMLGMMTrainer_setStepwiseOffset,
+   stepwise_offset.doc(),
+   0
+  },
+  {
+   stepwise_iteration.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getStepwiseIteration,
+   0,
+   stepwise_iteration.doc(),
+   0
+  },
+  {
+   step_size.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getStepSize,
+   0,
+   step_size.doc(),
+   0
+  },
+  {
+   prune_threshold.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getPruneThreshold,
+   (setter)PyBobLearnEMMLGMMTrainer_setPruneThreshold,
+   prune_threshold.doc(),
+   0
+  },
+  {
+   prune_iterations.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getPruneIterations,
+   (setter)PyBobLearnEMMLGMMTrainer_setPruneIterations,
+   prune_iterations.doc(),
+   0
+  },
+  {
+   prune_resplit.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getPruneResplit,
+   (setter)PyBobLearnEMMLGMMTrainer_setPruneResplit,
+   prune_resplit.doc(),
+   0
+  },
+  {
+   pruned_components.name(),
+   (getter)PyBobLearnEMMLGMMTrainer_getPrunedComponents,
+   0,
+   pruned_components.doc(),
+   0
+  },
   {0}  // Sentinel
 };
 
@@ -227,7 +464,7 @@ static auto e_step = bob::extension::FunctionDoc(
 )
 .add_prototype("gmm_machine,data")
 .add_parameter("gmm_machine", ":py:class:`bob.learn.em.GMMMachine`", "GMMMachine Object")
-.add_parameter("data", "array_like <float, 2D>", "Input data");
+.add_parameter("data", "array_like <float, 2D> or :py:class:`bob.learn.em.FileListDataSource`", "Input data");
 static PyObject* PyBobLearnEMMLGMMTrainer_e_step(PyBobLearnEMMLGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
   BOB_TRY
 
@@ -235,9 +472,17 @@ static PyObject* PyBobLearnEMMLGMMTrainer_e_step(PyBobLearnEMMLGMMTrainerObject*
   char** kwlist = e_step.kwlist(0);
 
   PyBobLearnEMGMMMachineObject* gmm_machine;
+  PyObject* input = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O", kwlist, &PyBobLearnEMGMMMachine_Type, &gmm_machine,
+                                                                 &input)) return 0;
+
+  if (PyBobLearnEMFileListDataSource_Check(input)){
+    self->cxx->eStep(*gmm_machine->cxx, *((PyBobLearnEMFileListDataSourceObject*)input)->cxx);
+    Py_RETURN_NONE;
+  }
+
   PyBlitzArrayObject* data = 0;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&", kwlist, &PyBobLearnEMGMMMachine_Type, &gmm_machine,
-                                                                 &PyBlitzArray_Converter, &data)) return 0;
+  if (!PyBlitzArray_Converter(input, &data)) return 0;
   auto data_ = make_safe(data);
 
   // perform check on the input
@@ -322,6 +567,118 @@ static PyObject* PyBobLearnEMMLGMMTrainer_compute_likelihood(PyBobLearnEMMLGMMTr
 }
 
 
+/*** stepwise_step ***/
+static auto stepwise_step = bob::extension::FunctionDoc(
+  "stepwise_step",
+  "Performs one step of the stepwise (online) EM algorithm on a mini-batch of frames",
+
+  "The statistics of the mini-batch, normalized by its number of frames, are interpolated into running statistics "
+  ":math:`s \\leftarrow (1 - \\eta_k) s + \\eta_k \\bar{s}_k` with the decaying step size "
+  ":math:`\\eta_k = (k + t_0)^{-\\alpha}` (see :py:attr:`stepwise_decay` and :py:attr:`stepwise_offset`), "
+  "and the GMM parameters are updated from the running statistics as in :py:meth:`m_step`. "
+  "The first mini-batch after :py:meth:`initialize` or :py:meth:`reset_stepwise` initializes the running statistics. "
+  "See Cappe and Moulines, \"Online EM algorithm for latent data models\", 2009.",
+
+  true
+)
+.add_prototype("gmm_machine,data")
+.add_parameter("gmm_machine", ":py:class:`bob.learn.em.GMMMachine`", "GMMMachine Object")
+.add_parameter("data", "array_like <float, 2D>", "The mini-batch of frames");
+static PyObject* PyBobLearnEMMLGMMTrainer_stepwise_step(PyBobLearnEMMLGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  /* Parses input arguments in a single shot */
+  char** kwlist = stepwise_step.kwlist(0);
+
+  PyBobLearnEMGMMMachineObject* gmm_machine;
+  PyBlitzArrayObject* data = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&", kwlist, &PyBobLearnEMGMMMachine_Type, &gmm_machine,
+                                                                 &PyBlitzArray_Converter, &data)) return 0;
+  auto data_ = make_safe(data);
+
+  // perform check on the input
+  if (data->type_num != NPY_FLOAT64 || data->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' only processes 2D arrays of float64 for `%s`", Py_TYPE(self)->tp_name, stepwise_step.name());
+    return 0;
+  }
+
+  if (data->shape[1] != (Py_ssize_t)gmm_machine->cxx->getNInputs() ) {
+    PyErr_Format(PyExc_TypeError, "`%s' 2D `input` array should have the shape [N, %" PY_FORMAT_SIZE_T "d] not [N, %" PY_FORMAT_SIZE_T "d] for `%s`", Py_TYPE(self)->tp_name, gmm_machine->cxx->getNInputs(), data->shape[1], stepwise_step.name());
+    return 0;
+  }
+
+  self->cxx->stepwiseStep(*gmm_machine->cxx, *PyBlitzArrayCxx_AsBlitz<double,2>(data));
+
+  BOB_CATCH_MEMBER("cannot perform the stepwise_step method", 0)
+
+  Py_RETURN_NONE;
+}
+
+
+/*** reset_stepwise ***/
+static auto reset_stepwise = bob::extension::FunctionDoc(
+  "reset_stepwise",
+  "Restarts the stepwise EM, discarding the running statistics"
+)
+.add_prototype("");
+static PyObject* PyBobLearnEMMLGMMTrainer_reset_stepwise(PyBobLearnEMMLGMMTrainerObject* self) {
+  BOB_TRY
+  self->cxx->resetStepwise();
+  BOB_CATCH_MEMBER("cannot perform the reset_stepwise method", 0)
+  Py_RETURN_NONE;
+}
+
+
+
+/*** save ***/
+static auto save = bob::extension::FunctionDoc(
+  "save",
+  "Saves the state of the ML_GMMTrainer to a given HDF5 file",
+  "The state (e.g., the statistics of the last E-step and the random number generator) is what is needed, together with the machine, "
+  "to resume a training from this point, see :py:func:`bob.learn.em.train`. "
+  "The configuration of the trainer is not saved.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing");
+static PyObject* PyBobLearnEMMLGMMTrainer_save(PyBobLearnEMMLGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = save.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->save(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot save the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
+
+/*** load ***/
+static auto load = bob::extension::FunctionDoc(
+  "load",
+  "Restores the state of the ML_GMMTrainer from a given HDF5 file",
+  "The trainer should have the same configuration as the one which saved the state, and should be initialized on the same data first.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading");
+static PyObject* PyBobLearnEMMLGMMTrainer_load(PyBobLearnEMMLGMMTrainerObject* self, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = load.kwlist(0);
+  PyBobIoHDF5FileObject* hdf5;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &hdf5)) return 0;
+
+  auto hdf5_ = make_safe(hdf5);
+  self->cxx->load(*hdf5->f);
+
+  BOB_CATCH_MEMBER("cannot load the state of the trainer", 0)
+  Py_RETURN_NONE;
+}
+
 
 static PyMethodDef PyBobLearnEMMLGMMTrainer_methods[] = {
   {
@@ -348,6 +705,30 @@ static PyMethodDef PyBobLearnEMMLGMMTrainer_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     compute_likelihood.doc()
   },
+  {
+    stepwise_step.name(),
+    (PyCFunction)PyBobLearnEMMLGMMTrainer_stepwise_step,
+    METH_VARARGS|METH_KEYWORDS,
+    stepwise_step.doc()
+  },
+  {
+    reset_stepwise.name(),
+    (PyCFunction)PyBobLearnEMMLGMMTrainer_reset_stepwise,
+    METH_NOARGS,
+    reset_stepwise.doc()
+  },
+  {
+    save.name(),
+    (PyCFunction)PyBobLearnEMMLGMMTrainer_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save.doc()
+  },
+  {
+    load.name(),
+    (PyCFunction)PyBobLearnEMMLGMMTrainer_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load.doc()
+  },
   {0} /* Sentinel */
 };
 
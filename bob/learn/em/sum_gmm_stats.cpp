@@ -0,0 +1,115 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+#include <bob.learn.em/SumGMMStats.h>
+
+/* converts PyObject to bool and returns false if object is NULL */
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}
+
+
+/*** sum_gmm_stats ***/
+bob::extension::FunctionDoc sum_gmm_stats = bob::extension::FunctionDoc(
+  "sum_gmm_stats",
+  "Sums a collection of :py:class:`bob.learn.em.GMMStats`",
+  "The collection is split into ``n_threads`` chunks that are accumulated in parallel, "
+  "and the partial sums are merged with a pairwise tree reduction. "
+  "When file names are given, the statistics are streamed from the HDF5 files, "
+  "so that only one partial sum per thread is kept in memory.\n\n"
+  "The compensated summation keeps the precision of the accumulators when summing a large number of statistics.",
+  true
+)
+.add_prototype("stats, [n_threads], [compensated]", "output")
+.add_parameter("stats", "[:py:class:`bob.learn.em.GMMStats`] or [str]", "The statistics to sum, or the names of the HDF5 files they were saved to")
+.add_parameter("n_threads", "int", "[Default: ``1``] The number of threads to use")
+.add_parameter("compensated", "bool", "[Default: ``False``] Use a compensated (Kahan-Babuska) summation")
+.add_return("output", ":py:class:`bob.learn.em.GMMStats`", "The sum of the statistics");
+PyObject* PyBobLearnEM_sum_gmm_stats(PyObject*, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = sum_gmm_stats.kwlist(0);
+
+  PyObject* stats_list_o = 0;
+  int n_threads = 1;
+  PyObject* compensated = Py_False;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|iO!", kwlist, &PyList_Type, &stats_list_o,
+                                                                  &n_threads,
+                                                                  &PyBool_Type, &compensated)){
+    sum_gmm_stats.print_usage();
+    return 0;
+  }
+
+  if (n_threads <= 0){
+    PyErr_Format(PyExc_TypeError, "n_threads must be greater than zero");
+    sum_gmm_stats.print_usage();
+    return 0;
+  }
+
+  if (PyList_GET_SIZE(stats_list_o) == 0){
+    PyErr_Format(PyExc_RuntimeError, "sum_gmm_stats requires at least one element");
+    return 0;
+  }
+
+  boost::shared_ptr<bob::learn::em::GMMStats> output(new bob::learn::em::GMMStats());
+  const bool compensated_ = f(compensated);
+
+  if (PyString_Check(PyList_GetItem(stats_list_o, 0))){
+    std::vector<std::string> filenames;
+    for (int i=0; i<PyList_GET_SIZE(stats_list_o); i++){
+      PyObject* item = PyList_GetItem(stats_list_o, i);
+      if (!PyString_Check(item)){
+        PyErr_Format(PyExc_RuntimeError, "Expected file names");
+        return 0;
+      }
+      filenames.push_back(PyString_AS_STRING(item));
+    }
+
+    PyThreadState* state = PyEval_SaveThread();
+    try {
+      bob::learn::em::sumGMMStats(filenames, *output, n_threads, compensated_);
+    }
+    catch (...) {
+      PyEval_RestoreThread(state);
+      throw;
+    }
+    PyEval_RestoreThread(state);
+  }
+  else{
+    std::vector<boost::shared_ptr<const bob::learn::em::GMMStats> > stats;
+    for (int i=0; i<PyList_GET_SIZE(stats_list_o); i++){
+      PyBobLearnEMGMMStatsObject* s;
+      if (!PyArg_Parse(PyList_GetItem(stats_list_o, i), "O!", &PyBobLearnEMGMMStats_Type, &s)){
+        PyErr_Format(PyExc_RuntimeError, "Expected GMMStats objects");
+        return 0;
+      }
+      stats.push_back(s->cxx);
+    }
+
+    // The statistics are only read, and are kept alive by the list
+    PyThreadState* state = PyEval_SaveThread();
+    try {
+      bob::learn::em::sumGMMStats(stats, *output, n_threads, compensated_);
+    }
+    catch (...) {
+      PyEval_RestoreThread(state);
+      throw;
+    }
+    PyEval_RestoreThread(state);
+  }
+
+  //Allocating the correspondent python object
+  PyBobLearnEMGMMStatsObject* retval =
+    (PyBobLearnEMGMMStatsObject*)PyBobLearnEMGMMStats_Type.tp_alloc(&PyBobLearnEMGMMStats_Type, 0);
+  retval->cxx = output;
+
+  return Py_BuildValue("N",retval);
+
+  BOB_CATCH_FUNCTION("cannot sum the statistics", 0)
+}
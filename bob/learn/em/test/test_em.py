@@ -9,6 +9,10 @@
 """
 import unittest
 import numpy
+import os
+import shutil
+import tempfile
+import nose.tools
 
 import bob.io.base
 from bob.io.base.test_utils import datafile
@@ -69,6 +73,301 @@ def test_gmm_ML_1():
   assert (gmm == gmm_ref) or (gmm == gmm_ref_32bit_release) or (gmm == gmm_ref_32bit_release)
 
 
+def test_gmm_ML_prune():
+
+  # Trains a GMMMachine with a dead component, which gets pruned
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+
+  def deadGMM():
+    gmm = GMMMachine(3, 2)
+    reference = loadGMM()
+    gmm.weights = numpy.array([0.45, 0.45, 0.1])
+    gmm.means = numpy.vstack((reference.means, [[1e3, 1e3]]))
+    gmm.variances = numpy.vstack((reference.variances, [[1., 1.]]))
+    gmm.set_variance_thresholds(1e-3)
+    return gmm
+
+  gmm = deadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  ml_gmmtrainer.prune_threshold = 1.
+  ml_gmmtrainer.prune_iterations = 2
+  bob.learn.em.train(ml_gmmtrainer, gmm, ar, max_iterations=5)
+  assert gmm.shape == (2, 2)
+  assert ml_gmmtrainer.pruned_components == [2]
+  assert ml_gmmtrainer.gmm_statistics.n.shape == (2,)
+  assert abs(numpy.sum(gmm.weights) - 1.) < 1e-10
+
+  # The dead component is replaced by a split of the heaviest one
+  gmm = deadGMM()
+  ml_gmmtrainer.prune_resplit = True
+  bob.learn.em.train(ml_gmmtrainer, gmm, ar, max_iterations=5)
+  assert gmm.shape == (3, 2)
+  assert ml_gmmtrainer.pruned_components == [2]
+  assert (gmm.means < 1e2).all()
+
+  # Without pruning, the dead component stays
+  gmm = deadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm, ar, max_iterations=5)
+  assert gmm.shape == (3, 2)
+  assert ml_gmmtrainer.pruned_components == []
+
+
+def test_gmm_ML_train_em():
+
+  # Trains a GMMMachine with the EM loop run in C++
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+
+  gmm = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm, ar, convergence_threshold=0.001)
+
+  gmm_native = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  (converged, likelihoods, times) = bob.learn.em.train_em(ml_gmmtrainer, gmm_native, ar, convergence_threshold=0.001)
+  assert converged
+  assert gmm_native == gmm
+  assert likelihoods.shape == times.shape
+  assert abs(likelihoods[-1] - ml_gmmtrainer.compute_likelihood(gmm_native)) < 1e-10
+  assert (times >= 0).all()
+
+  # Without convergence threshold, all the iterations are run
+  gmm_native = loadGMM()
+  (converged, likelihoods, times) = bob.learn.em.train_em(ml_gmmtrainer, gmm_native, ar, max_iterations=3)
+  assert not converged
+  assert likelihoods.shape == (4,)
+
+  nose.tools.assert_raises(TypeError, bob.learn.em.train_em, ml_gmmtrainer, KMeansMachine(2, 2), ar)
+
+
+def test_gmm_ML_train_restarts():
+
+  # Restarts from random means, run concurrently; the result does not depend on the threads
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+
+  gmm = GMMMachine(3, 2)
+  (best, reports) = bob.learn.em.train_restarts(ML_GMMTrainer(True, True, True), gmm, ar, n_restarts=4, max_iterations=10, warmup_iterations=2, check_interval=2, n_threads=3, seed=1)
+  assert len(reports) == 4
+  assert not reports[best]['stopped_early']
+  assert reports[best]['iterations'] == 10
+  likelihoods = [r['likelihood'] for r in reports if not r['stopped_early']]
+  assert reports[best]['likelihood'] == max(likelihoods)
+  assert abs(gmm.weights.sum() - 1.) < 1e-10
+
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  ml_gmmtrainer.initialize(gmm)
+  ml_gmmtrainer.e_step(gmm, ar)
+  assert abs(ml_gmmtrainer.compute_likelihood(gmm) - reports[best]['likelihood']) < 1e-10
+
+  gmm_serial = GMMMachine(3, 2)
+  (best_serial, reports_serial) = bob.learn.em.train_restarts(ML_GMMTrainer(True, True, True), gmm_serial, ar, n_restarts=4, max_iterations=10, warmup_iterations=2, check_interval=2, n_threads=1, seed=1)
+  assert best_serial == best
+  assert reports_serial[best]['likelihood'] == reports[best]['likelihood']
+  assert gmm_serial == gmm
+
+
+def test_gmm_ML_checkpoint():
+
+  # A training resumed from a checkpoint continues exactly as the uninterrupted one
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+
+  gmm = loadGMM()
+  bob.learn.em.train(ML_GMMTrainer(True, True, True), gmm, ar, max_iterations=10)
+
+  temp_dir = tempfile.mkdtemp()
+  try:
+    checkpoint = os.path.join(temp_dir, "checkpoint.hdf5")
+    gmm_resumed = loadGMM()
+    bob.learn.em.train(ML_GMMTrainer(True, True, True), gmm_resumed, ar, max_iterations=3, checkpoint=checkpoint)
+
+    # The machine and the statistics of the last E-step are restored
+    gmm_resumed = loadGMM()
+    bob.learn.em.train(ML_GMMTrainer(True, True, True), gmm_resumed, ar, max_iterations=10, checkpoint=checkpoint)
+    assert gmm_resumed == gmm
+
+    # The state of the trainer can be saved and restored on its own
+    trainer = ML_GMMTrainer(True, True, True)
+    trainer.initialize(gmm, ar)
+    trainer.e_step(gmm, ar)
+    filename = os.path.join(temp_dir, "trainer.hdf5")
+    trainer.save(bob.io.base.HDF5File(filename, 'w'))
+    trainer_loaded = ML_GMMTrainer(True, True, True)
+    trainer_loaded.initialize(gmm, ar)
+    trainer_loaded.load(bob.io.base.HDF5File(filename))
+    assert trainer_loaded.gmm_statistics == trainer.gmm_statistics
+  finally:
+    shutil.rmtree(temp_dir)
+
+
+def test_gmm_ML_file_list():
+
+  # Trains a GMMMachine with the data read from a list of files, in the background
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+  temp_dir = tempfile.mkdtemp()
+  try:
+    filenames = []
+    for i in range(3):
+      filenames.append(os.path.join(temp_dir, "features_%d.hdf5" % i))
+      bob.io.base.save(ar[i::3].copy(), filenames[-1])
+    ordered = numpy.vstack([ar[i::3] for i in range(3)])
+
+    gmm = loadGMM()
+    ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+    bob.learn.em.train(ml_gmmtrainer, gmm, ordered, max_iterations=5)
+
+    data = bob.learn.em.FileListDataSource(filenames, n_buffers=2)
+    assert data.filenames == filenames
+    gmm_files = loadGMM()
+    ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+    bob.learn.em.train(ml_gmmtrainer, gmm_files, data, max_iterations=5)
+    assert gmm_files.is_similar_to(gmm, 1e-10, 1e-10)
+
+    # The files are not read between two E-steps, while checkpoints are saved
+    gmm_files = loadGMM()
+    checkpoint = os.path.join(temp_dir, "checkpoint.hdf5")
+    bob.learn.em.train(ML_GMMTrainer(True, True, True), gmm_files, data, max_iterations=5, checkpoint=checkpoint)
+    assert gmm_files.is_similar_to(gmm, 1e-10, 1e-10)
+
+    # An aborted pass is restarted
+    data.reset()
+    ml_gmmtrainer.e_step(gmm_files, data)
+    assert ml_gmmtrainer.gmm_statistics.t == ar.shape[0]
+
+    missing = bob.learn.em.FileListDataSource(filenames + [os.path.join(temp_dir, "missing.hdf5")])
+    nose.tools.assert_raises(RuntimeError, ml_gmmtrainer.e_step, gmm_files, missing)
+  finally:
+    shutil.rmtree(temp_dir)
+
+
+def test_gmm_ML_distributed():
+
+  # Trains a GMMMachine with the E-step distributed over 3 processes
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+
+  gmm = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm, ar, max_iterations=10)
+
+  gmm_distributed = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  shards = [ar[0::3].copy(), ar[1::3].copy(), ar[2::3].copy()]
+  bob.learn.em.train_local_distributed(ml_gmmtrainer, gmm_distributed, shards, max_iterations=10, timeout=60)
+
+  assert gmm_distributed.is_similar_to(gmm, 1e-8, 1e-8)
+
+  # A working directory can be reused, and is left empty but for the
+  # termination file
+  work_dir = tempfile.mkdtemp(prefix="bob.learn.em.")
+  try:
+    for run in range(2):
+      gmm_distributed = loadGMM()
+      ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+      bob.learn.em.train_local_distributed(ml_gmmtrainer, gmm_distributed, shards, work_dir, max_iterations=10, timeout=60)
+      assert gmm_distributed.is_similar_to(gmm, 1e-8, 1e-8)
+      assert os.listdir(work_dir) == ["done"]
+  finally:
+    shutil.rmtree(work_dir)
+
+
+def test_gmm_ML_subsample():
+
+  # Trains a GMMMachine with subsampled E-steps in the first iterations
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+
+  gmm = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm, ar, max_iterations=30)
+
+  schedule = [0.1, 0.1, 0.25, 0.5]
+  gmm_subsampled = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm_subsampled, ar, max_iterations=30, subsample=schedule, subsample_seed=3)
+  # The statistics of the last E-step use all the frames
+  assert ml_gmmtrainer.gmm_statistics.t == ar.shape[0]
+  assert gmm_subsampled.is_similar_to(gmm, 1e-3, 1e-3)
+
+  # The frames only depend on the seed
+  gmm_subsampled2 = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm_subsampled2, ar, max_iterations=3, subsample=schedule, subsample_seed=3)
+  gmm_subsampled3 = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm_subsampled3, ar, max_iterations=3, subsample=schedule, subsample_seed=3)
+  assert gmm_subsampled2 == gmm_subsampled3
+
+
+def test_gmm_ML_stepwise():
+
+  # Trains a GMMMachine with the stepwise EM of ML_GMMTrainer
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+  numpy.random.seed(5)
+  ar = ar[numpy.random.permutation(ar.shape[0])]
+
+  gmm = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train(ml_gmmtrainer, gmm, ar, convergence_threshold=0.001)
+  llh_ref = gmm(ar)
+
+  gmm_stepwise = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  ml_gmmtrainer.stepwise_decay = 0.7
+  assert ml_gmmtrainer.stepwise_decay == 0.7
+  assert ml_gmmtrainer.step_size == 1.
+  bob.learn.em.train_stepwise(ml_gmmtrainer, gmm_stepwise, ar, 20)
+  assert ml_gmmtrainer.stepwise_iteration == 14
+  assert abs(ml_gmmtrainer.step_size - (14 + 2.)**-0.7) < 1e-12
+  assert abs(numpy.sum(gmm_stepwise.weights) - 1.) < 1e-10
+
+  # One pass of stepwise EM is already close to the full-batch solution
+  llh_stepwise = gmm_stepwise(ar)
+  assert abs(llh_stepwise - llh_ref) < 0.05 * abs(llh_ref)
+
+  # The full-batch polish can only increase the likelihood
+  bob.learn.em.train_stepwise(ml_gmmtrainer, gmm_stepwise, ar, 20, max_mini_batches=0, full_batch_iterations=5, initialize=False)
+  assert gmm_stepwise(ar) >= llh_stepwise - 1e-6
+
+  ml_gmmtrainer.reset_stepwise()
+  assert ml_gmmtrainer.stepwise_iteration == 0
+
+  # The responsibilities threshold is a number of frames, which none of the
+  # Gaussians is below in a mini-batch: it does not change the training
+  gmm_stepwise = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train_stepwise(ml_gmmtrainer, gmm_stepwise, ar, 20)
+  gmm_threshold = loadGMM()
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True, 1.)
+  bob.learn.em.train_stepwise(ml_gmmtrainer, gmm_threshold, ar, 20)
+  assert gmm_threshold.is_similar_to(gmm_stepwise, 1e-8, 1e-8)
+
+
+def test_gmm_ML_split():
+
+  # Grows a GMMMachine by binary splitting with ML_GMMTrainer
+
+  ar = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+
+  gmm = GMMMachine(1, 2)
+  gmm.set_variance_thresholds(1e-3)
+  ml_gmmtrainer = ML_GMMTrainer(True, True, True)
+  bob.learn.em.train_split(ml_gmmtrainer, gmm, ar, 3, iterations_per_stage=3, final_iterations=10, max_frames_per_gaussian=50)
+  assert gmm.shape == (3, 2)
+  assert abs(numpy.sum(gmm.weights) - 1.) < 1e-10
+  assert (gmm.variance_thresholds == 1e-3).all()
+
+  # Three Gaussians fit the data better than one
+  single = GMMMachine(1, 2)
+  single.means = ar.mean(axis=0).reshape(1, 2)
+  single.variances = ar.var(axis=0).reshape(1, 2)
+  assert gmm(ar) > single(ar)
+
+
 def test_gmm_ML_2():
 
   # Trains a GMMMachine with ML_GMMTrainer; compares to an old reference
@@ -127,6 +426,130 @@ def test_gmm_MAP_1():
   assert (equals(gmm.means,gmm_ref.means,1e-3) and equals(gmm.variances,gmm_ref.variances,1e-3) and equals(gmm.weights,gmm_ref.weights,1e-3))
 
 
+def test_gmm_MAP_enroll():
+
+  # Adapts a batch of models at once, and compares to separate MAP trainings
+
+  ar = bob.io.base.load(datafile('faithful.torch3_f64.hdf5', __name__, path="../data/"))
+  gmmprior = GMMMachine(bob.io.base.HDF5File(datafile("gmm_ML.hdf5", __name__, path="../data/")))
+  features = [ar[i::5].copy() for i in range(5)]
+
+  map_gmmtrainer = MAP_GMMTrainer(update_means=True, update_variances=True, update_weights=True, prior_gmm=gmmprior, relevance_factor=4.)
+
+  references = []
+  for f in features:
+    gmm = GMMMachine(gmmprior)
+    bob.learn.em.train(map_gmmtrainer, gmm, f, max_iterations=2)
+    references.append(gmm)
+
+  (means, weights, variances) = map_gmmtrainer.enroll(features, iterations=2, n_threads=3)
+  assert means.shape == (5, 2, 2)
+  assert weights.shape == (5, 2)
+  assert variances.shape == (5, 2, 2)
+  for n, gmm in enumerate(references):
+    assert equals(means[n], gmm.means, 1e-10)
+    assert equals(weights[n], gmm.weights, 1e-10)
+    assert equals(variances[n], gmm.variances, 1e-10)
+
+  # From the statistics computed with the prior
+  stats = []
+  for f in features:
+    s = bob.learn.em.GMMStats(2, 2)
+    gmmprior.acc_statistics(f, s)
+    stats.append(s)
+  map_gmmtrainer = MAP_GMMTrainer(update_means=True, prior_gmm=gmmprior, relevance_factor=4.)
+  (means, weights, variances) = map_gmmtrainer.enroll(stats, n_threads=2)
+  assert weights is None and variances is None
+  (means_features, _, _) = map_gmmtrainer.enroll(features)
+  assert equals(means, means_features, 1e-10)
+  for n, f in enumerate(features):
+    gmm = GMMMachine(gmmprior)
+    bob.learn.em.train(map_gmmtrainer, gmm, f, max_iterations=1)
+    assert equals(means[n], gmm.means, 1e-10)
+
+
+def test_gmm_MAP_incremental():
+
+  # Adding the sessions one by one gives the same model as adapting the prior on all of them
+
+  ar = bob.io.base.load(datafile('faithful.torch3_f64.hdf5', __name__, path="../data/"))
+  gmmprior = GMMMachine(bob.io.base.HDF5File(datafile("gmm_ML.hdf5", __name__, path="../data/")))
+  sessions = [ar[i::4].copy() for i in range(4)]
+
+  map_gmmtrainer = MAP_GMMTrainer(update_means=True, update_variances=True, update_weights=True, prior_gmm=gmmprior, relevance_factor=4.)
+  model = bob.learn.em.MAPEnrollmentModel(map_gmmtrainer)
+  assert model.n_sessions == 0
+  assert model.machine.is_similar_to(gmmprior)
+
+  for n, session in enumerate(sessions):
+    if n % 2:
+      model.add_session(session)
+    else:
+      stats = bob.learn.em.GMMStats(2, 2)
+      gmmprior.acc_statistics(session, stats)
+      model.add_session(stats)
+    assert model.n_sessions == n+1
+
+    gmm = GMMMachine(gmmprior)
+    bob.learn.em.train(map_gmmtrainer, gmm, numpy.vstack(sessions[:n+1]), max_iterations=1)
+    assert equals(model.machine.means, gmm.means, 1e-10)
+    assert equals(model.machine.weights, gmm.weights, 1e-10)
+    assert equals(model.machine.variances, gmm.variances, 1e-10)
+
+  # Only the statistics are stored
+  filename = str(tempfile.mkstemp(".hdf5")[1])
+  try:
+    model.save(bob.io.base.HDF5File(filename, 'w'))
+    loaded = bob.learn.em.MAPEnrollmentModel(map_gmmtrainer, bob.io.base.HDF5File(filename))
+  finally:
+    os.unlink(filename)
+  assert loaded.n_sessions == 4
+  assert loaded.stats == model.stats
+  assert loaded.machine.is_similar_to(model.machine)
+
+
+def test_map_mean_supervectors():
+
+  # Closed-form mean-only MAP adaptation, compared to MAP_GMMTrainer
+
+  ar = bob.io.base.load(datafile('faithful.torch3_f64.hdf5', __name__, path="../data/"))
+  ubm = GMMMachine(bob.io.base.HDF5File(datafile("gmm_ML.hdf5", __name__, path="../data/")))
+  stats = []
+  for i in range(4):
+    s = bob.learn.em.GMMStats(2, 2)
+    ubm.acc_statistics(ar[i::4], s)
+    stats.append(s)
+
+  supervectors = bob.learn.em.map_mean_supervectors(ubm, stats, relevance_factor=4.)
+  assert supervectors.shape == (4, 4)
+
+  map_gmmtrainer = MAP_GMMTrainer(update_means=True, reynolds_adaptation=True, prior_gmm=ubm, relevance_factor=4.)
+  for n in range(4):
+    gmm = GMMMachine(ubm)
+    bob.learn.em.train(map_gmmtrainer, gmm, ar[n::4], max_iterations=1)
+    assert equals(supervectors[n], gmm.means.flatten(), 1e-10)
+
+  offsets = bob.learn.em.map_mean_supervectors(ubm, stats, relevance_factor=4., output='offsets')
+  assert equals(offsets, supervectors - ubm.means.flatten(), 1e-10)
+
+  normalized = bob.learn.em.map_mean_supervectors(ubm, stats, relevance_factor=4., output='normalized')
+  scale = numpy.sqrt(numpy.repeat(ubm.weights, 2) / ubm.variances.flatten())
+  assert equals(normalized, offsets * scale, 1e-10)
+
+  # The Gaussians with too small responsibilities keep the UBM means, as with the trainer
+  threshold = stats[0].n.mean()
+  thresholded = bob.learn.em.map_mean_supervectors(ubm, stats[:1], 4., 'means', threshold)
+  map_gmmtrainer = MAP_GMMTrainer(update_means=True, reynolds_adaptation=True, prior_gmm=ubm, relevance_factor=4., mean_var_update_responsibilities_threshold=threshold)
+  gmm = GMMMachine(ubm)
+  bob.learn.em.train(map_gmmtrainer, gmm, ar[0::4], max_iterations=1)
+  assert equals(thresholded[0], gmm.means.flatten(), 1e-10)
+  c = stats[0].n.argmin()
+  assert (thresholded[0].reshape(2,2)[c] == ubm.means[c]).all()
+  assert not (thresholded[0].reshape(2,2)[1-c] == ubm.means[1-c]).all()
+
+  nose.tools.assert_raises(ValueError, bob.learn.em.map_mean_supervectors, ubm, stats, 4., 'weights')
+
+
 def test_gmm_MAP_2():
 
   # Train a GMMMachine with MAP_GMMTrainer and compare with matlab reference
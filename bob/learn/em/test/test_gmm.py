@@ -11,11 +11,12 @@
 import os
 import numpy
 import tempfile
+import nose.tools
 
 import bob.io.base
 from bob.io.base.test_utils import datafile
 
-from bob.learn.em import GMMStats, GMMMachine
+from bob.learn.em import GMMStats, GMMStatsSet, GMMStatsArchive, GMMStatsArchiveWriter, GMMStatsAccumulator, GMMMachine, sum_gmm_stats
 
 def test_GMMStats():
   # Test a GMMStats
@@ -110,6 +111,189 @@ def test_GMMStats():
   # Clean-up
   os.unlink(filename)
 
+def test_GMMStatsSet():
+  # Packs a list of GMMStats into a GMMStatsSet
+  gs1 = GMMStats(2,3)
+  gs1.log_likelihood = -3.
+  gs1.t = 57
+  gs1.n = numpy.array([4.37, 5.31], 'float64')
+  gs1.sum_px = numpy.array([[1., 2., 3.], [4., 5., 6.]], 'float64')
+  gs1.sum_pxx = numpy.array([[10., 20., 30.], [40., 50., 60.]], 'float64')
+  gs2 = GMMStats(2,3)
+  gs2.log_likelihood = -4.
+  gs2.t = 12
+  gs2.n = numpy.array([1.2, 3.4], 'float64')
+  gs2.sum_px = numpy.array([[3., 2., 1.], [6., 5., 4.]], 'float64')
+  gs2.sum_pxx = numpy.array([[30., 20., 10.], [60., 50., 40.]], 'float64')
+
+  gss = GMMStatsSet([gs1, gs2])
+  assert gss.shape == (2,2,3)
+  assert gss.has_second_order
+  assert (gss.t == [57, 12]).all()
+  assert (gss.log_likelihood == [-3., -4.]).all()
+  assert (gss.n[1] == gs2.n).all()
+  assert (gss.sum_px[0] == gs1.sum_px).all()
+  assert (gss.sum_pxx[1] == gs2.sum_pxx).all()
+  assert gss.get_stats(0) == gs1
+  assert gss.get_stats(1) == gs2
+
+  # Sets and gets back a sample
+  gss.set_stats(0, gs2)
+  assert gss.get_stats(0) == gs2
+  gss.set_stats(0, gs1)
+
+  # Saves and reads from file
+  filename = str(tempfile.mkstemp(".hdf5")[1])
+  gss.save(bob.io.base.HDF5File(filename, 'w'))
+  gss_loaded = GMMStatsSet(bob.io.base.HDF5File(filename))
+  assert gss == gss_loaded
+  assert (gss != gss_loaded) is False
+  assert gss.is_similar_to(gss_loaded)
+  assert GMMStatsSet(gss) == gss
+
+  # First order only statistics
+  gs3 = GMMStats(2,3,False)
+  gs3.n = gs1.n
+  gs3.sum_px = gs1.sum_px
+  gss_first = GMMStatsSet([gs1, gs3])
+  assert not gss_first.has_second_order
+  assert gss_first.sum_pxx.size == 0
+  assert (gss_first.sum_px[1] == gs1.sum_px).all()
+  assert not gss_first.get_stats(1).has_second_order
+  gss_first.save(bob.io.base.HDF5File(filename, 'w'))
+  assert GMMStatsSet(bob.io.base.HDF5File(filename)) == gss_first
+
+  # Resize and reinit
+  gss.resize(4,5,6)
+  assert gss.shape == (4,5,6)
+  assert (gss.n == 0).all()
+
+  # Clean-up
+  os.unlink(filename)
+
+
+def test_sum_gmm_stats():
+  # Sums a list of random GMMStats
+  numpy.random.seed(42)
+  stats = []
+  for i in range(13):
+    gs = GMMStats(3,2)
+    gs.log_likelihood = -numpy.random.rand()
+    gs.t = i+1
+    gs.n = numpy.random.rand(3)
+    gs.sum_px = numpy.random.rand(3,2)
+    gs.sum_pxx = numpy.random.rand(3,2)
+    stats.append(gs)
+
+  ref = GMMStats(3,2)
+  for gs in stats:
+    ref += gs
+
+  for n_threads in (1, 2, 4, 20):
+    for compensated in (False, True):
+      gs_sum = sum_gmm_stats(stats, n_threads, compensated)
+      assert gs_sum.t == ref.t
+      assert gs_sum.is_similar_to(ref)
+
+  # Streams the statistics from files
+  filenames = []
+  for gs in stats:
+    filename = str(tempfile.mkstemp(".hdf5")[1])
+    gs.save(bob.io.base.HDF5File(filename, 'w'))
+    filenames.append(filename)
+  gs_sum = sum_gmm_stats(filenames, n_threads=3, compensated=True)
+  assert gs_sum.is_similar_to(ref)
+
+  # The compensated summation keeps the small increments
+  big = GMMStats(1,1)
+  big.n = numpy.array([1e16])
+  small = GMMStats(1,1)
+  small.n = numpy.array([1.])
+  gs_sum = sum_gmm_stats([big] + [small]*100, compensated=True)
+  assert gs_sum.n[0] == 1e16 + 100
+
+  # Clean-up
+  for filename in filenames:
+    os.unlink(filename)
+
+
+def test_GMMStatsArchive():
+  # Writes random GMMStats into an archive
+  numpy.random.seed(42)
+  stats = []
+  for i in range(5):
+    gs = GMMStats(3,2)
+    gs.log_likelihood = -numpy.random.rand()
+    gs.t = i+1
+    gs.n = numpy.random.rand(3)
+    gs.sum_px = numpy.random.rand(3,2)
+    gs.sum_pxx = numpy.random.rand(3,2)
+    stats.append(gs)
+
+  filename = str(tempfile.mkstemp(".gmmstats")[1])
+  writer = GMMStatsArchiveWriter(filename, 3, 2)
+  for i in range(3):
+    writer.append("utt%d" % i, stats[i])
+  writer.flush()
+  assert len(writer) == 3
+
+  # Reads the records while the archive is being built
+  archive = GMMStatsArchive(filename)
+  assert len(archive) == 3
+  assert archive.shape == (3,3,2)
+  assert archive.has_second_order
+  assert archive.keys == ["utt0", "utt1", "utt2"]
+
+  for i in range(3):
+    assert archive.get_stats(i) == stats[i]
+    assert archive.get_stats("utt%d" % i) == stats[i]
+    assert archive.index("utt%d" % i) == i
+  assert archive.contains("utt1")
+  assert not archive.contains("utt3")
+
+  # Appends the remaining records to the existing archive
+  writer.append("utt3", stats[3])
+  writer.close()
+  writer = GMMStatsArchiveWriter(filename)
+  assert len(writer) == 4
+  writer.append("utt4", stats[4])
+  writer.close()
+
+  n = archive.n
+  archive.refresh()
+  assert len(archive) == 5
+  assert n.shape == (3,3)
+
+  # The views on the mapped file
+  assert archive.n.shape == (5,3)
+  assert archive.sum_px.shape == (5,3,2)
+  assert not archive.n.flags.writeable
+  for i in range(5):
+    assert numpy.allclose(archive.n[i], stats[i].n)
+    assert numpy.allclose(archive.sum_px[i], stats[i].sum_px)
+    assert numpy.allclose(archive.sum_pxx[i], stats[i].sum_pxx)
+    assert archive.t[i] == stats[i].t
+    assert numpy.allclose(archive.log_likelihood[i], stats[i].log_likelihood)
+
+  # Copies the archive into a GMMStatsSet
+  assert archive.stats_set() == GMMStatsSet(stats)
+
+  # First order only archive, which replaces the file: the archive mapped
+  # before still reads the previous records
+  writer = GMMStatsArchiveWriter(filename, 3, 2, False)
+  writer.append("utt0", stats[0])
+  writer.close()
+  assert numpy.allclose(archive.sum_pxx[4], stats[4].sum_pxx)
+  archive = GMMStatsArchive(filename)
+  assert not archive.has_second_order
+  assert not archive.get_stats(0).has_second_order
+  assert numpy.allclose(archive.get_stats(0).sum_px, stats[0].sum_px)
+
+  # Clean-up
+  del archive
+  os.unlink(filename)
+
+
 def test_GMMMachine_1():
   # Test a GMMMachine basic features
 
@@ -203,6 +387,26 @@ def test_GMMMachine_1():
   assert (gmm == gmm6) is False
   assert gmm.is_similar_to(gmm6) is False
 
+def test_GMMMachine_split():
+  # Test a GMMMachine split along the direction of largest variance
+  gmm = GMMMachine(2, 2)
+  gmm.weights = numpy.array([0.25, 0.75], 'float64')
+  gmm.means = numpy.array([[0., 0.], [10., 10.]], 'float64')
+  gmm.variances = numpy.array([[1., 4.], [9., 1.]], 'float64')
+
+  gmm.split(1, 0.5)
+  assert gmm.shape == (3, 2)
+  # Only the heaviest Gaussian is split, along its first dimension
+  assert numpy.allclose(gmm.weights, [0.25, 0.375, 0.375])
+  assert numpy.allclose(gmm.means, [[0., 0.], [11.5, 10.], [8.5, 10.]])
+  assert numpy.allclose(gmm.variances, [[1., 4.], [9., 1.], [9., 1.]])
+
+  gmm.split(3)
+  assert gmm.shape == (6, 2)
+  assert abs(numpy.sum(gmm.weights) - 1.) < 1e-10
+  nose.tools.assert_raises(RuntimeError, gmm.split, 7)
+
+
 def test_GMMMachine_2():
   # Test a GMMMachine (statistics)
 
@@ -225,6 +429,47 @@ def test_GMMMachine_2():
   assert numpy.allclose(stats.sum_px, stats_ref.sum_px, atol=1e-10)
   assert numpy.allclose(stats.sum_pxx, stats_ref.sum_pxx, atol=1e-10)
 
+def test_GMMMachine_2_first_order():
+  # Test a GMMMachine (first order only statistics)
+
+  arrayset = bob.io.base.load(datafile("faithful.torch3_f64.hdf5", __name__, path="../data/"))
+  gmm = GMMMachine(2, 2)
+  gmm.weights   = numpy.array([0.5, 0.5], 'float64')
+  gmm.means     = numpy.array([[3, 70], [4, 72]], 'float64')
+  gmm.variances = numpy.array([[1, 10], [2, 5]], 'float64')
+  gmm.variance_thresholds = numpy.array([[0, 0], [0, 0]], 'float64')
+
+  stats = GMMStats(2, 2, False)
+  assert stats.has_second_order is False
+  assert stats.sum_pxx.size == 0
+  gmm.acc_statistics(arrayset, stats)
+
+  stats_ref = GMMStats(bob.io.base.HDF5File(datafile("stats.hdf5",__name__, path="../data/")))
+  assert stats_ref.has_second_order
+
+  assert stats.t == stats_ref.t
+  assert numpy.allclose(stats.n, stats_ref.n, atol=1e-10)
+  assert numpy.allclose(stats.sum_px, stats_ref.sum_px, atol=1e-10)
+  assert stats.sum_pxx.size == 0
+
+  # Saves and reads from file
+  filename = str(tempfile.mkstemp(".hdf5")[1])
+  stats.save(bob.io.base.HDF5File(filename, 'w'))
+  stats_loaded = GMMStats(bob.io.base.HDF5File(filename))
+  assert stats_loaded.has_second_order is False
+  assert stats == stats_loaded
+  os.unlink(filename)
+
+  # Full statistics can be accumulated into first order ones, not the opposite
+  stats += stats_ref
+  assert numpy.allclose(stats.sum_px, 2*stats_ref.sum_px, atol=1e-10)
+  try:
+    stats_ref += stats_loaded
+    raised = False
+  except RuntimeError:
+    raised = True
+  assert raised
+
 def test_GMMMachine_3():
   # Test a GMMMachine (log-likelihood computation)
 
@@ -259,5 +504,56 @@ def test_GMMMachine_4():
   ll /= data.shape[0]
   
   assert ll==gmm(data)
-  
-  
+
+
+def test_GMMStatsAccumulator():
+  # Accumulates the statistics of random samples, with a checkpoint every 3 samples
+  numpy.random.seed(7)
+  samples = [numpy.random.rand(10+i,50) for i in range(8)]
+
+  gmm = GMMMachine(2, 50)
+  gmm.weights   = bob.io.base.load(datafile('weights.hdf5', __name__, path="../data/"))
+  gmm.means     = bob.io.base.load(datafile('means.hdf5', __name__, path="../data/"))
+  gmm.variances = bob.io.base.load(datafile('variances.hdf5', __name__, path="../data/"))
+
+  ref = GMMStats(2, 50)
+  for sample in samples:
+    gmm.acc_statistics(sample, ref)
+
+  checkpoint = str(tempfile.mkstemp(".hdf5")[1])
+  os.unlink(checkpoint)
+
+  # The job is "killed" after 7 samples: the last checkpoint is after 6
+  acc = GMMStatsAccumulator(gmm, checkpoint, 3)
+  assert acc.resume() == 0
+  for sample in samples[:7]:
+    acc.accumulate(sample)
+  assert acc.cursor == 7
+  del acc
+
+  # A new job resumes from the checkpoint
+  acc = GMMStatsAccumulator(gmm, checkpoint, 3)
+  assert acc.resume() == 6
+  for sample in samples[acc.cursor:]:
+    acc.accumulate(sample)
+  assert acc.cursor == 8
+  assert acc.stats == ref
+
+  # An explicit checkpoint saves the final statistics
+  acc.checkpoint()
+  acc = GMMStatsAccumulator(gmm, checkpoint)
+  assert acc.resume() == 8
+  assert acc.stats == ref
+
+  acc.reset()
+  assert acc.cursor == 0
+  assert acc.stats.t == 0
+
+  # A checkpoint computed with a different GMM is refused
+  other = GMMMachine(gmm)
+  other.means = gmm.means + 1.
+  acc = GMMStatsAccumulator(other, checkpoint)
+  nose.tools.assert_raises(RuntimeError, acc.resume)
+
+  # Clean-up
+  os.unlink(checkpoint)
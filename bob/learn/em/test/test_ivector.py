@@ -13,7 +13,7 @@ import numpy
 import numpy.linalg
 import numpy.random
 
-from bob.learn.em import GMMMachine, GMMStats, IVectorMachine
+from bob.learn.em import GMMMachine, GMMStats, CenteredGMMStats, IVectorMachine
 
 
 ### Test class inspired by an implementation of Chris McCool
@@ -157,3 +157,12 @@ def test_machine():
   wij_ref = numpy.array([-0.04213415, 0.21463343]) # Reference from original Chris implementation
   wij = mc.project(gs)
   assert numpy.allclose(wij_ref, wij, 1e-5)
+
+  # IVector (C++) from the centered statistics
+  cgs = CenteredGMMStats(gs, ubm)
+  assert numpy.allclose(cgs.centered_sum_px, (sumpx - n[:,numpy.newaxis] * ubm.means).flatten(), 1e-10)
+  assert numpy.allclose(cgs.whitened_sum_px, cgs.centered_sum_px / ubm.variance_supervector, 1e-10)
+  wij = mc.project(cgs)
+  assert numpy.allclose(wij_ref, wij, 1e-5)
+  wij = mc.project(CenteredGMMStats(gs, ubm, False))
+  assert numpy.allclose(wij_ref, wij, 1e-5)
@@ -12,7 +12,7 @@ import numpy.linalg
 import numpy.random
 import nose.tools
 
-from bob.learn.em import GMMMachine, GMMStats, IVectorMachine, IVectorTrainer
+from bob.learn.em import GMMMachine, GMMStats, GMMStatsSet, IVectorMachine, IVectorTrainer
 
 ### Test class inspired by an implementation of Chris McCool
 ### Chris McCool (chris.mccool@nicta.com.au)
@@ -366,3 +366,69 @@ def test_trainer_update_sigma():
     trainer.m_step(m)
     assert numpy.allclose(t_ref[it], m.t, 1e-5)
     assert numpy.allclose(sigma_ref[it], m.sigma, 1e-5)
+
+
+  # C++ implementation, with the statistics packed into a GMMStatsSet
+  m = IVectorMachine(ubm, 2)
+  m.variance_threshold = 1e-5
+
+  trainer = IVectorTrainer(update_sigma=True)
+  trainer.initialize(m)
+  m.t = t
+  m.sigma = sigma
+  data_set = GMMStatsSet(data)
+  for it in range(2):
+    # E-Step
+    trainer.e_step(m, data_set)
+    for k in acc_Nij_Sigma_wij2_ref[it]:
+      assert numpy.allclose(acc_Nij_Sigma_wij2_ref[it][k], trainer.acc_nij_wij2[k], 1e-5)
+    for k in acc_Fnorm_Sigma_wij_ref[it]:
+      assert numpy.allclose(acc_Fnorm_Sigma_wij_ref[it][k], trainer.acc_fnormij_wij[k], 1e-5)
+    assert numpy.allclose(acc_Snorm_ref[it].reshape(dim_c,dim_d), trainer.acc_snormij, 1e-5)
+    assert numpy.allclose(N_ref[it], trainer.acc_nij, 1e-5)
+
+    # M-Step
+    trainer.m_step(m)
+    assert numpy.allclose(t_ref[it], m.t, 1e-5)
+    assert numpy.allclose(sigma_ref[it], m.sigma, 1e-5)
+
+  # Updating sigma requires second order statistics
+  data_set = GMMStatsSet(3, dim_c, dim_d, False)
+  nose.tools.assert_raises(RuntimeError, trainer.e_step, m, data_set)
+
+
+def test_trainer_stats_set_tiles():
+  # A GMMStatsSet spanning several tiles of samples gives the same
+  # accumulators as the list of GMMStats
+  numpy.random.seed(3)
+  dim_c = 2
+  dim_d = 3
+  ubm = GMMMachine(dim_c,dim_d)
+  ubm.weights = numpy.array([0.4,0.6])
+  ubm.means = numpy.array([[1.,7,4],[4,5,3]])
+  ubm.variances = numpy.array([[0.5,1.,1.5],[1.,1.5,2.]])
+
+  data = []
+  for i in range(100):
+    gs = GMMStats(dim_c,dim_d)
+    gs.t = 10
+    gs.n = numpy.random.uniform(1., 5., (dim_c,))
+    gs.sum_px = numpy.random.normal(size=(dim_c,dim_d)) * gs.n[:,numpy.newaxis]
+    gs.sum_pxx = numpy.random.uniform(1., 50., (dim_c,dim_d))
+    data.append(gs)
+
+  m = IVectorMachine(ubm, 2)
+  m.variance_threshold = 1e-5
+  trainer = IVectorTrainer(update_sigma=True)
+  trainer.initialize(m)
+  trainer.e_step(m, data)
+  acc_nij_wij2 = trainer.acc_nij_wij2.copy()
+  acc_fnormij_wij = trainer.acc_fnormij_wij.copy()
+  acc_snormij = trainer.acc_snormij.copy()
+  acc_nij = trainer.acc_nij.copy()
+
+  trainer.e_step(m, GMMStatsSet(data))
+  assert numpy.allclose(acc_nij_wij2, trainer.acc_nij_wij2, 1e-8)
+  assert numpy.allclose(acc_fnormij_wij, trainer.acc_fnormij_wij, 1e-8)
+  assert numpy.allclose(acc_snormij, trainer.acc_snormij, 1e-8)
+  assert numpy.allclose(acc_nij, trainer.acc_nij, 1e-8)
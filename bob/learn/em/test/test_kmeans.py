@@ -94,3 +94,89 @@ def test_KMeansMachine2():
   assert equals(weights_result,weights, 1e-3).all()
   assert equals(variances_result,variances,1e-3).all()
  
+
+
+def test_KMeansMachine_batched():
+  # The batched nearest-mean assignment matches the one of each sample
+  numpy.random.seed(5)
+  kmeans       = bob.learn.em.KMeansMachine(7,4)
+  kmeans.means = numpy.random.normal(size=(7,4))
+  # More samples than a tile
+  data         = numpy.random.normal(size=(600,4))
+
+  (indices, distances) = kmeans.get_closest_mean(data)
+  min_distances = kmeans.get_min_distance(data)
+  assert indices.shape == (600,)
+  assert distances.shape == (600,)
+  for i in range(data.shape[0]):
+    (index, distance) = kmeans.get_closest_mean(data[i])
+    assert indices[i] == index
+    assert equals(distances[i], distance, 1e-10)
+    assert equals(min_distances[i], kmeans.get_min_distance(data[i]), 1e-10)
+
+  # Far from the origin, with ties and near ties, the same means are chosen
+  means = 1e4 + numpy.random.randint(0, 3, size=(7,4)).astype(numpy.float64)
+  means[3] = means[1]
+  kmeans.means = means
+  data = 1e4 + numpy.random.randint(0, 6, size=(300,4)) / 2. + numpy.random.normal(scale=1e-9, size=(300,4)) * (numpy.arange(300) % 2)[:,numpy.newaxis]
+  (indices, distances) = kmeans.get_closest_mean(data)
+  for i in range(data.shape[0]):
+    (index, distance) = kmeans.get_closest_mean(data[i])
+    assert indices[i] == index
+    assert distances[i] == distance
+
+def test_KMeansMachine_indexed():
+  # Many means of a low dimensionality are indexed, which gives the same
+  # closest means as an exhaustive search
+  numpy.random.seed(7)
+  means        = numpy.random.normal(size=(500,2))
+  # Duplicated means, for which the first one is the closest
+  means[300:320] = means[10:30]
+  kmeans       = bob.learn.em.KMeansMachine(500,2)
+  kmeans.means = means
+  assert kmeans.indexed
+  data         = numpy.vstack((numpy.random.normal(size=(1000,2)), means[300:320]))
+
+  distances = ((data[:,numpy.newaxis,:] - means[numpy.newaxis,:,:])**2).sum(axis=2)
+  (indices, min_distances) = kmeans.get_closest_mean(data)
+  assert (indices == distances.argmin(axis=1)).all()
+  assert numpy.allclose(min_distances, distances.min(axis=1), atol=1e-10)
+  for i in range(0, data.shape[0], 50):
+    (index, distance) = kmeans.get_closest_mean(data[i])
+    assert index == indices[i]
+    assert equals(distance, min_distances[i], 1e-10)
+
+  # Same result without the index
+  exhaustive = bob.learn.em.KMeansMachine(kmeans)
+  exhaustive.indexed = False
+  assert not exhaustive.indexed
+  (indices2, min_distances2) = exhaustive.get_closest_mean(data)
+  assert (indices == indices2).all()
+  assert numpy.allclose(min_distances, min_distances2, atol=1e-10)
+
+  # The mean of an empty cluster (not a number) is never the closest one
+  nan_means = means.copy()
+  nan_means[42] = numpy.nan
+  nan_means[43,1] = numpy.inf
+  nan_kmeans = bob.learn.em.KMeansMachine(500,2)
+  nan_kmeans.means = nan_means
+  assert nan_kmeans.indexed
+  (indices, min_distances) = nan_kmeans.get_closest_mean(data)
+  nan_distances = distances.copy()
+  nan_distances[:,42:44] = numpy.inf
+  assert (indices == nan_distances.argmin(axis=1)).all()
+  assert numpy.allclose(min_distances, nan_distances.min(axis=1), atol=1e-10)
+
+  # Changing a mean clears the index
+  kmeans.set_mean(0, numpy.zeros((2,)))
+  assert not kmeans.indexed
+  kmeans.update_index()
+  assert kmeans.indexed
+
+  # Few means are not indexed, but can be
+  small = bob.learn.em.KMeansMachine(10,2)
+  small.means = means[:10]
+  assert not small.indexed
+  small.indexed = True
+  (indices, min_distances) = small.get_closest_mean(data)
+  assert (indices == distances[:,:10].argmin(axis=1)).all()
@@ -8,6 +8,9 @@
 """Test K-Means algorithm
 """
 import numpy
+import os
+import shutil
+import tempfile
 
 import bob.core
 import bob.io
@@ -81,6 +84,29 @@ if hasattr(KMeansTrainer, 'KMEANS_PLUS_PLUS'):
     kmeans_plus_plus(py_machine, data, seed)
     assert equals(machine.means, py_machine.means, 1e-8)
 
+  def test_kmeans_parallel():
+
+    # Tests the K-Means|| initialization on well separated clusters
+    numpy.random.seed(3)
+    centers = numpy.array([[0,0],[10,0],[0,10],[10,10]], 'float64')
+    data = numpy.vstack([c + 0.1*numpy.random.randn(100,2) for c in centers])
+
+    machine = KMeansMachine(4, 2)
+    trainer = KMeansTrainer('KMEANS_PARALLEL')
+    trainer.n_parallel_rounds = 3
+    trainer.initialize(machine, data, bob.core.random.mt19937(0))
+
+    # The means are samples, one per cluster
+    for m in machine.means:
+      assert (data == m).all(axis=1).any()
+    indices = sorted(machine.get_closest_mean(centers)[0])
+    assert indices == [0,1,2,3]
+
+    # Same random generator, same means
+    machine2 = KMeansMachine(4, 2)
+    trainer.initialize(machine2, data, bob.core.random.mt19937(0))
+    assert (machine.means == machine2.means).all()
+
 def test_kmeans_noduplicate():
   # Data/dimensions
   dim_c = 2
@@ -171,3 +197,315 @@ def test_kmeans_b():
   data = numpy.array([[1.], [1.], [1.], [1.], [1.], [1.], [2.], [3.]])
   bob.learn.em.train(trainer, machine, data)
   assert (numpy.isnan(machine.means).any()) == False
+
+
+def test_kmeans_fused_variances():
+
+  # The variances and weights from the last E-step are the ones of an extra pass over the data
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  for n_threads in (1, 3):
+    machine = KMeansMachine(3, 2)
+    trainer = KMeansTrainer()
+    trainer.compute_variances = True
+    trainer.n_threads = n_threads
+    bob.learn.em.train(trainer, machine, arStd, max_iterations=10, rng=bob.core.random.mt19937(3))
+
+    (variances, weights) = trainer.get_variances_and_weights_for_each_cluster(machine)
+    (variances_ref, weights_ref) = machine.get_variances_and_weights_for_each_cluster(arStd)
+    assert equals(variances, variances_ref, 1e-10)
+    assert equals(weights, weights_ref, 1e-10)
+
+  # Not available without the second order statistics
+  trainer.compute_variances = False
+  trainer.e_step(machine, arStd)
+  try:
+    trainer.get_variances_and_weights_for_each_cluster(machine)
+    assert False
+  except RuntimeError:
+    pass
+
+
+def test_kmeans_subsample():
+
+  # Trains a KMeansMachine with subsampled E-steps in the first iterations
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  machine = KMeansMachine(2, 2)
+  trainer = KMeansTrainer()
+  bob.learn.em.train(trainer, machine, arStd, convergence_threshold=0.001, rng=bob.core.random.mt19937(5))
+
+  machine_subsampled = KMeansMachine(2, 2)
+  trainer = KMeansTrainer()
+  bob.learn.em.train(trainer, machine_subsampled, arStd, convergence_threshold=0.001, rng=bob.core.random.mt19937(5), subsample=[0.2, 0.5], subsample_seed=7)
+
+  assert equals(machine_subsampled.means, machine.means, 1e-3)
+
+
+def test_kmeans_checkpoint():
+
+  # A training resumed from a checkpoint continues exactly as the uninterrupted one
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  machine = KMeansMachine(3, 2)
+  bob.learn.em.train(KMeansTrainer(), machine, arStd, max_iterations=10, rng=bob.core.random.mt19937(5))
+
+  temp_dir = tempfile.mkdtemp()
+  try:
+    checkpoint = os.path.join(temp_dir, "checkpoint.hdf5")
+    # Interrupted after 4 iterations
+    machine_resumed = KMeansMachine(3, 2)
+    bob.learn.em.train(KMeansTrainer(), machine_resumed, arStd, max_iterations=4, rng=bob.core.random.mt19937(5), checkpoint=checkpoint, checkpoint_interval=2)
+    assert os.path.exists(checkpoint)
+
+    machine_resumed = KMeansMachine(3, 2)
+    bob.learn.em.train(KMeansTrainer(), machine_resumed, arStd, max_iterations=10, rng=bob.core.random.mt19937(5), checkpoint=checkpoint, checkpoint_interval=2)
+    assert (machine_resumed.means == machine.means).all()
+  finally:
+    shutil.rmtree(temp_dir)
+
+
+def test_kmeans_accelerated():
+
+  # The E-step accelerated with the triangle inequality gives the same statistics, with fewer distances
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  machine = KMeansMachine(8, 2)
+  trainer = KMeansTrainer()
+  trainer.initialize(machine, arStd, bob.core.random.mt19937(5))
+  machine_accelerated = KMeansMachine(machine)
+  trainer_accelerated = KMeansTrainer()
+  trainer_accelerated.accelerated = True
+
+  for i in range(20):
+    trainer.e_step(machine, arStd)
+    trainer_accelerated.e_step(machine_accelerated, arStd)
+    assert (trainer_accelerated.zeroeth_order_statistics == trainer.zeroeth_order_statistics).all()
+    assert (trainer_accelerated.first_order_statistics == trainer.first_order_statistics).all()
+    assert trainer_accelerated.compute_likelihood(machine_accelerated) == trainer.compute_likelihood(machine)
+    assert trainer.n_distances == 8 * arStd.shape[0]
+    trainer.m_step(machine, arStd)
+    trainer_accelerated.m_step(machine_accelerated, arStd)
+
+  assert (machine_accelerated.means == machine.means).all()
+  # Most of the distances are skipped once the training settles
+  assert trainer_accelerated.n_distances < 0.5 * trainer.n_distances
+
+  # The bounds are dropped for other data of the same shape, or when cleared
+  # after the data was modified in place
+  other = arStd[::-1].copy()
+  other[:,0] += 0.5
+  for data in (other, arStd):
+    trainer.e_step(machine, data)
+    trainer_accelerated.e_step(machine_accelerated, data)
+    assert (trainer_accelerated.first_order_statistics == trainer.first_order_statistics).all()
+    assert trainer_accelerated.n_distances == trainer.n_distances
+
+  arStd[:,1] -= 0.5
+  trainer_accelerated.clear_bounds()
+  trainer.e_step(machine, arStd)
+  trainer_accelerated.e_step(machine_accelerated, arStd)
+  assert (trainer_accelerated.first_order_statistics == trainer.first_order_statistics).all()
+
+
+def test_kmeans_indexed_empty_cluster():
+
+  # An empty cluster gets a mean which is not a number, which the index of
+  # the means leaves out
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  machine = KMeansMachine(100, 2)
+  trainer = KMeansTrainer()
+  trainer.initialize(machine, arStd, bob.core.random.mt19937(5))
+  means = machine.means
+  means[7] = 1e3
+  machine.means = means
+  trainer.e_step(machine, arStd)
+  assert trainer.zeroeth_order_statistics[7] == 0
+  trainer.m_step(machine, arStd)
+  assert numpy.isnan(machine.means[7]).all()
+  assert machine.indexed
+
+  exhaustive = KMeansMachine(machine)
+  exhaustive.indexed = False
+  trainer_exhaustive = KMeansTrainer()
+  trainer.e_step(machine, arStd)
+  trainer_exhaustive.e_step(exhaustive, arStd)
+  assert trainer.zeroeth_order_statistics[7] == 0
+  assert (trainer.zeroeth_order_statistics == trainer_exhaustive.zeroeth_order_statistics).all()
+  assert (trainer.first_order_statistics == trainer_exhaustive.first_order_statistics).all()
+  assert trainer.compute_likelihood(machine) == trainer_exhaustive.compute_likelihood(exhaustive)
+
+
+def test_kmeans_indexed_n_distances():
+
+  # The distances are counted by the search of the index of the means
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  machine = KMeansMachine(100, 2)
+  trainer = KMeansTrainer()
+  trainer.initialize(machine, arStd, bob.core.random.mt19937(5))
+  assert machine.indexed
+  trainer.e_step(machine, arStd)
+  assert 0 < trainer.n_distances < 100 * arStd.shape[0]
+
+  machine.indexed = False
+  trainer.e_step(machine, arStd)
+  assert trainer.n_distances == 100 * arStd.shape[0]
+
+
+def test_kmeans_threads():
+
+  # The multithreaded E-step gives the statistics of the serial one, reproducibly
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  for accelerated in (False, True):
+    machine = KMeansMachine(4, 2)
+    trainer = KMeansTrainer()
+    trainer.accelerated = accelerated
+    trainer.initialize(machine, arStd, bob.core.random.mt19937(5))
+    machine_threads = KMeansMachine(machine)
+    trainer_threads = KMeansTrainer()
+    trainer_threads.accelerated = accelerated
+    trainer_threads.n_threads = 3
+
+    for i in range(5):
+      trainer.e_step(machine, arStd)
+      trainer_threads.e_step(machine_threads, arStd)
+      assert (trainer_threads.zeroeth_order_statistics == trainer.zeroeth_order_statistics).all()
+      assert equals(trainer_threads.first_order_statistics, trainer.first_order_statistics, 1e-10)
+      assert abs(trainer_threads.compute_likelihood(machine_threads) - trainer.compute_likelihood(machine)) < 1e-10
+      if not accelerated:
+        assert trainer_threads.n_distances == trainer.n_distances
+
+      first = trainer_threads.first_order_statistics.copy()
+      trainer_threads.e_step(machine_threads, arStd)
+      assert (trainer_threads.first_order_statistics == first).all()
+
+      trainer.m_step(machine, arStd)
+      trainer_threads.m_step(machine_threads, arStd)
+
+
+def test_kmeans_train_em():
+
+  # Trains a KMeansMachine with the EM loop run in C++
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  machine = KMeansMachine(2, 2)
+  trainer = KMeansTrainer()
+  bob.learn.em.train(trainer, machine, arStd, convergence_threshold=0.001, rng=bob.core.random.mt19937(5))
+
+  machine_native = KMeansMachine(2, 2)
+  trainer = KMeansTrainer()
+  (converged, distances, times) = bob.learn.em.train_em(trainer, machine_native, arStd, convergence_threshold=0.001, rng=bob.core.random.mt19937(5))
+
+  assert converged
+  assert equals(machine_native.means, machine.means, 1e-10)
+  # The average distance to the closest mean never increases
+  assert (numpy.diff(distances) <= 1e-10).all()
+
+  # The bounds of an accelerated e_step on other data are not reused
+  other = arStd[::-1].copy()
+  other[:,0] += 0.5
+  machine_accelerated = KMeansMachine(machine_native)
+  trainer_accelerated = KMeansTrainer()
+  trainer_accelerated.accelerated = True
+  trainer_accelerated.e_step(machine_accelerated, arStd)
+  bob.learn.em.train_em(trainer_accelerated, machine_accelerated, other, max_iterations=3, initialize=False)
+  machine_exhaustive = KMeansMachine(machine_native)
+  bob.learn.em.train_em(KMeansTrainer(), machine_exhaustive, other, max_iterations=3, initialize=False)
+  assert (machine_accelerated.means == machine_exhaustive.means).all()
+
+
+def test_kmeans_train_restarts():
+
+  # Restarts with independent seeds, compared to separate trainings
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  distances = []
+  for seed in range(3, 7):
+    (_, d, _) = bob.learn.em.train_em(KMeansTrainer(), KMeansMachine(3, 2), arStd, max_iterations=10, rng=bob.core.random.mt19937(seed))
+    distances.append(d[-1])
+
+  machine = KMeansMachine(3, 2)
+  (best, reports) = bob.learn.em.train_restarts(KMeansTrainer(), machine, arStd, n_restarts=4, max_iterations=10, margin=None, n_threads=2, seed=3)
+  assert len(reports) == 4
+  for r, report in enumerate(reports):
+    assert report['seed'] == 3 + r
+    assert report['iterations'] == 10
+    assert not report['stopped_early']
+    assert abs(report['likelihood'] - distances[r]) < 1e-10
+  assert best == numpy.argmin(distances)
+
+  # The restarts which trail the leader are stopped, but never the best one
+  machine_early = KMeansMachine(3, 2)
+  (best_early, reports) = bob.learn.em.train_restarts(KMeansTrainer(), machine_early, arStd, n_restarts=4, max_iterations=10, warmup_iterations=2, check_interval=2, margin=0., n_threads=2, seed=3)
+  assert not reports[best_early]['stopped_early']
+  assert reports[best_early]['iterations'] == 10
+  for report in reports:
+    assert report['stopped_early'] or report['iterations'] == 10
+
+
+def test_kmeans_e_step_file_list():
+
+  # The E-step on a list of files gives the same statistics as on the concatenated data
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  temp_dir = tempfile.mkdtemp()
+  try:
+    filenames = []
+    for i in range(4):
+      filenames.append(os.path.join(temp_dir, "features_%d.hdf5" % i))
+      bob.io.base.save(arStd[i::4].copy(), filenames[-1])
+    ordered = numpy.vstack([arStd[i::4] for i in range(4)])
+
+    machine = KMeansMachine(3, 2)
+    trainer = KMeansTrainer()
+    trainer.initialize(machine, ordered, bob.core.random.mt19937(2))
+    trainer.e_step(machine, ordered)
+    zeroeth, first, distance = trainer.zeroeth_order_statistics, trainer.first_order_statistics, trainer.compute_likelihood(machine)
+
+    data = bob.learn.em.FileListDataSource(filenames, n_buffers=3)
+    for n_pass in range(2):
+      trainer.e_step(machine, data)
+      assert (trainer.zeroeth_order_statistics == zeroeth).all()
+      assert equals(trainer.first_order_statistics, first, 1e-10)
+      assert abs(trainer.compute_likelihood(machine) - distance) < 1e-10
+  finally:
+    shutil.rmtree(temp_dir)
+
+
+
+def test_kmeans_mini_batch():
+
+  # Mini-batches reach about the distance of the full-batch training
+  (arStd,std) = NormalizeStdArray(datafile("faithful.torch3.hdf5", __name__, path="../data/"))
+
+  machine = KMeansMachine(3, 2)
+  trainer = KMeansTrainer()
+  bob.learn.em.train(trainer, machine, arStd, max_iterations=50, convergence_threshold=1e-6, rng=bob.core.random.mt19937(4))
+  trainer.e_step(machine, arStd)
+  full_distance = trainer.compute_likelihood(machine)
+
+  mini_machine = KMeansMachine(3, 2)
+  mini_trainer = bob.learn.em.MiniBatchKMeansTrainer(batch_size=32)
+  bob.learn.em.train(mini_trainer, mini_machine, arStd, max_iterations=100, rng=bob.core.random.mt19937(4))
+  assert mini_trainer.counts.sum() == 100 * 32
+  trainer.e_step(mini_machine, arStd)
+  assert trainer.compute_likelihood(mini_machine) < 1.1 * full_distance
+
+  # The same seed draws the same batches
+  mini_machine2 = KMeansMachine(3, 2)
+  mini_trainer2 = bob.learn.em.MiniBatchKMeansTrainer(32)
+  bob.learn.em.train(mini_trainer2, mini_machine2, arStd, max_iterations=100, rng=bob.core.random.mt19937(4))
+  assert (mini_machine2.means == mini_machine.means).all()
+
+  # On data much larger than a batch, the convergence threshold does not
+  # stop the training after the first batches
+  large = numpy.tile(arStd, (1000, 1))
+  mini_machine3 = KMeansMachine(3, 2)
+  mini_trainer3 = bob.learn.em.MiniBatchKMeansTrainer(32)
+  bob.learn.em.train(mini_trainer3, mini_machine3, large, max_iterations=200, convergence_threshold=1e-5, rng=bob.core.random.mt19937(4))
+  assert mini_trainer3.counts.sum() > 10 * 32
+  trainer.e_step(mini_machine3, arStd)
+  assert trainer.compute_likelihood(mini_machine3) < 1.1 * full_distance
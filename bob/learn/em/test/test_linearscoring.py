@@ -10,7 +10,7 @@
 
 import numpy
 
-from bob.learn.em import GMMMachine, GMMStats, linear_scoring
+from bob.learn.em import GMMMachine, GMMStats, GMMStatsSet, CenteredGMMStats, linear_scoring
 
 def test_LinearScoring():
 
@@ -96,6 +96,33 @@ def test_LinearScoring():
   assert (abs(scores - ref_scores_11) < 1e-7).all()
 
 
+  # 4/ Use a GMMStatsSet
+  stats_set = GMMStatsSet([stats1, stats2, stats3])
+  scores = linear_scoring([model1, model2], ubm, stats_set)
+  assert (abs(scores - ref_scores_00) < 1e-7).all()
+  scores = linear_scoring([model1, model2], ubm, stats_set, [], True)
+  assert (abs(scores - ref_scores_01) < 1e-7).all()
+  scores = linear_scoring([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector, stats_set)
+  assert (abs(scores - ref_scores_00) < 1e-7).all()
+  scores = linear_scoring([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector, stats_set, [], True)
+  assert (abs(scores - ref_scores_01) < 1e-7).all()
+
+
+  # 5/ Use CenteredGMMStats, with and without the variance-normalized statistics
+  for whitened in (True, False):
+    centered = [CenteredGMMStats(s, ubm, whitened) for s in (stats1, stats2, stats3)]
+    scores = linear_scoring([model1, model2], ubm, centered)
+    assert (abs(scores - ref_scores_00) < 1e-7).all()
+    scores = linear_scoring([model1, model2], ubm, centered, [], True)
+    assert (abs(scores - ref_scores_01) < 1e-7).all()
+    scores = linear_scoring([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector, centered)
+    assert (abs(scores - ref_scores_00) < 1e-7).all()
+    score = linear_scoring(model1.mean_supervector, ubm.mean_supervector, ubm.variance_supervector, centered[1])
+    assert abs(score - ref_scores_00[0,1]) < 1e-7
+    score = linear_scoring(model2.mean_supervector, ubm.mean_supervector, ubm.variance_supervector, centered[2], numpy.array([], 'float64'), True)
+    assert abs(score - ref_scores_01[1,2]) < 1e-7
+
+
   # 3/ Using single model/sample
   # 3/a/ without frame-length normalisation
   score = linear_scoring(model1.mean_supervector, ubm.mean_supervector, ubm.variance_supervector, stats1, test_channeloffset[0])
@@ -4,18 +4,20 @@
 # Fri Feb 13 13:18:10 2015 +0200
 #
 # Copyright (C) 2011-2015 Idiap Research Institute, Martigny, Switzerland
+import os
 import numpy
+import bob.io.base
 import bob.learn.em
 import logging
 logger = logging.getLogger('bob.learn.em')
 
-def train(trainer, machine, data, max_iterations = 50, convergence_threshold=None, initialize=True, rng=None):
+def train(trainer, machine, data, max_iterations = 50, convergence_threshold=None, initialize=True, rng=None, subsample=None, subsample_seed=0, checkpoint=None, checkpoint_interval=1):
 
   """
   Trains a machine given a trainer and the proper data
 
   **Parameters**:
-    trainer : one of :py:class:`KMeansTrainer`, :py:class:`MAP_GMMTrainer`, :py:class:`ML_GMMTrainer`, :py:class:`ISVTrainer`, :py:class:`IVectorTrainer`, :py:class:`PLDATrainer`, :py:class:`EMPCATrainer`
+    trainer : one of :py:class:`KMeansTrainer`, :py:class:`MiniBatchKMeansTrainer`, :py:class:`MAP_GMMTrainer`, :py:class:`ML_GMMTrainer`, :py:class:`ISVTrainer`, :py:class:`IVectorTrainer`, :py:class:`PLDATrainer`, :py:class:`EMPCATrainer`
       A trainer mechanism
     machine : one of :py:class:`KMeansMachine`, :py:class:`GMMMachine`, :py:class:`ISVBase`, :py:class:`IVectorMachine`, :py:class:`PLDAMachine`, :py:class:`bob.learn.linear.Machine`
       A container machine
@@ -29,26 +31,53 @@ def train(trainer, machine, data, max_iterations = 50, convergence_threshold=Non
       If True, runs the initialization procedure
     rng :  :py:class:`bob.core.random.mt19937`
       The Mersenne Twister mt19937 random generator used for the initialization of subspaces/arrays before the EM loop
+    subsample : [float]
+      The fraction of the frames used by each E-step, only for :py:class:`KMeansTrainer`, :py:class:`ML_GMMTrainer` and :py:class:`MAP_GMMTrainer`. ``subsample[0]`` is used by the E-step before the first M-step, ``subsample[i]`` by the E-step after the i'th M-step, and all the frames are used once the schedule is exhausted. The convergence criterion is only evaluated between two E-steps on all the frames, and the last E-step always uses all the frames. If None, all the frames are used at each iteration. The frames are drawn by this function only: the ``e_step`` of the trainers and :py:func:`train_em` always use all the given data
+    subsample_seed : int
+      The seed of the random generator which draws the frames of the subsampled E-steps
+    checkpoint : str
+      The name of an HDF5 file to which the machine and the state of the trainer (see :py:meth:`KMeansTrainer.save`, for instance) are saved during the training. If the file exists, the training resumes from it instead of starting over, and continues exactly as the interrupted training would have: the trainer, its configuration and the data should be the same. Not supported with ``subsample``
+    checkpoint_interval : int
+      The number of iterations between two checkpoints. A checkpoint is also saved when the training converges
   """
-  #Initialization
-  if initialize:
+  if subsample is not None:
+    if checkpoint is not None:
+      raise ValueError("checkpoints are not supported with subsampling")
+    e_step_data = _FrameSampler(data, subsample, subsample_seed)
+  else:
+    e_step_data = lambda iteration: data
+  resume = checkpoint is not None and os.path.exists(checkpoint)
+
+  #Initialization (when resuming, this allocates the caches computed from the data, before restoring the state)
+  if initialize or resume:
     if rng is not None:
       trainer.initialize(machine, data, rng)
     else:
       trainer.initialize(machine, data)
 
-  trainer.e_step(machine, data)
   average_output          = 0
   average_output_previous = 0
+  if resume:
+    start, average_output, converged = _load_checkpoint(checkpoint, trainer, machine, "iteration", "likelihood", "converged")
+    logger.info("Resuming from `%s' at iteration %d", checkpoint, start)
+    stage_data = data
+    if converged:
+      start = max_iterations
+  else:
+    start = 0
+    stage_data = e_step_data(0)
+    trainer.e_step(machine, stage_data)
 
-  if hasattr(trainer,"compute_likelihood"):
-    average_output          = trainer.compute_likelihood(machine)
+    if hasattr(trainer,"compute_likelihood"):
+      average_output          = trainer.compute_likelihood(machine)
 
-  for i in range(max_iterations):
+  for i in range(start, max_iterations):
     logger.info("Iteration = %d/%d", i, max_iterations)
     average_output_previous = average_output
-    trainer.m_step(machine, data)
-    trainer.e_step(machine, data)
+    previous_data = stage_data
+    trainer.m_step(machine, stage_data)
+    stage_data = e_step_data(i+1)
+    trainer.e_step(machine, stage_data)
     
     if hasattr(trainer,"compute_likelihood"):
       average_output = trainer.compute_likelihood(machine)
@@ -61,14 +90,171 @@ def train(trainer, machine, data, max_iterations = 50, convergence_threshold=Non
       convergence_value = abs((average_output_previous - average_output)/average_output_previous)
       logger.info("convergence value = %f",convergence_value)
     
-      #Terminates if converged (and likelihood computation is set)
-      if convergence_threshold!=None and convergence_value <= convergence_threshold:
-        break
+      #Terminates if converged (and likelihood computation is set), only
+      #comparing likelihoods computed on the same frames
+      converged = convergence_threshold!=None and convergence_value <= convergence_threshold and stage_data is data and previous_data is data
+    else:
+      converged = False
+
+    if checkpoint is not None and ((i+1) % checkpoint_interval == 0 or converged):
+      _save_checkpoint(checkpoint, trainer, machine, iteration=i+1, likelihood=average_output, converged=int(converged))
+    if converged:
+      break
+
+  #The statistics of the last E-step are always computed on all the frames
+  if stage_data is not data:
+    trainer.e_step(machine, data)
   if hasattr(trainer,"finalize"):
     trainer.finalize(machine, data)
 
 
-def train_jfa(trainer, jfa_base, data, max_iterations=10, initialize=True, rng=None):
+def _save_checkpoint(filename, trainer, machine, **values):
+  # The file is only visible under its final name once it is complete, so
+  # that an interruption while saving keeps the previous checkpoint
+  tmp = filename + ".tmp%d" % os.getpid()
+  hdf5 = bob.io.base.HDF5File(tmp, 'w')
+  for key in sorted(values):
+    hdf5.set(key, values[key])
+  for group, obj in (("machine", machine), ("trainer", trainer)):
+    hdf5.create_group(group)
+    hdf5.cd(group)
+    obj.save(hdf5)
+    hdf5.cd("..")
+  del hdf5
+  os.rename(tmp, filename)
+
+
+def _load_checkpoint(filename, trainer, machine, *keys):
+  # Restores the machine and the trainer saved by _save_checkpoint(), and
+  # returns the requested values
+  hdf5 = bob.io.base.HDF5File(filename)
+  for group, obj in (("machine", machine), ("trainer", trainer)):
+    hdf5.cd(group)
+    obj.load(hdf5)
+    hdf5.cd("..")
+  return tuple(hdf5.read(key) for key in keys)
+
+
+class _FrameSampler(object):
+  # Draws the frames used at each iteration of a subsampled training, in a
+  # deterministic way (the same seed gives the same frames)
+  def __init__(self, data, schedule, seed):
+    self.data = data
+    self.schedule = list(schedule)
+    self.generator = numpy.random.RandomState(seed)
+    for fraction in self.schedule:
+      if not 0. < fraction <= 1.:
+        raise ValueError("the fractions of a subsampling schedule must be in ]0,1], not %f" % fraction)
+
+  def __call__(self, iteration):
+    if iteration >= len(self.schedule) or self.schedule[iteration] == 1.:
+      return self.data
+    n_frames = max(1, int(round(self.schedule[iteration] * self.data.shape[0])))
+    # Keeps the frames in order, for a better memory access pattern
+    indices = numpy.sort(self.generator.choice(self.data.shape[0], n_frames, replace=False))
+    logger.info("E-step on %d/%d frames", n_frames, self.data.shape[0])
+    return numpy.ascontiguousarray(self.data[indices])
+
+
+def train_stepwise(trainer, machine, data, mini_batch_size, max_mini_batches=None, full_batch_iterations=0, initialize=True):
+
+  """
+  Trains a :py:class:`GMMMachine` with the stepwise (online) EM of :py:class:`ML_GMMTrainer`
+
+  The parameters are updated after each mini-batch of ``mini_batch_size``
+  consecutive frames of ``data`` (see :py:meth:`ML_GMMTrainer.stepwise_step`),
+  so the frames should be given in random order. Optionally, the machine is
+  then polished with a few iterations of full-batch EM.
+
+  **Parameters**:
+    trainer : :py:class:`ML_GMMTrainer`
+      A trainer mechanism
+    machine : :py:class:`GMMMachine`
+      A container machine
+    data : array_like <float, 2D>
+      The data to be trained
+    mini_batch_size : int
+      The number of frames in each mini-batch
+    max_mini_batches : int
+      The maximum number of mini-batches to process. If None, one pass over the data is done
+    full_batch_iterations : int
+      The number of full-batch EM iterations run at the end
+    initialize : bool
+      If True, runs the initialization procedure
+  """
+  if initialize:
+    trainer.initialize(machine, data)
+
+  n_mini_batches = (data.shape[0] + mini_batch_size - 1) // mini_batch_size
+  if max_mini_batches is not None:
+    n_mini_batches = min(n_mini_batches, max_mini_batches)
+
+  for i in range(n_mini_batches):
+    trainer.stepwise_step(machine, data[i*mini_batch_size:(i+1)*mini_batch_size])
+    logger.debug("Mini-batch = %d/%d, step size = %f", i, n_mini_batches, trainer.step_size)
+
+  if full_batch_iterations > 0:
+    train(trainer, machine, data, max_iterations=full_batch_iterations, initialize=False)
+
+
+def train_split(trainer, machine, data, n_gaussians, iterations_per_stage=5, final_iterations=None, epsilon=0.2, max_frames_per_gaussian=None):
+
+  """
+  Grows a :py:class:`GMMMachine` (e.g. a UBM) by binary splitting, from a single Gaussian to ``n_gaussians`` components
+
+  The machine starts with one Gaussian estimated on ``data``. At each stage,
+  every component is split along its dimension of largest variance (see
+  :py:meth:`GMMMachine.split`) and a few EM iterations are run. At the last
+  stage, only the heaviest components are split if ``n_gaussians`` is not a
+  power of two. The variance thresholds of the first component of ``machine``
+  are kept.
+
+  **Parameters**:
+    trainer : :py:class:`ML_GMMTrainer`
+      A trainer mechanism, which should update the means, the variances and the weights
+    machine : :py:class:`GMMMachine`
+      The machine to train, whose number of inputs gives the dimensionality of the data
+    data : array_like <float, 2D>
+      The data to be trained
+    n_gaussians : int
+      The number of components of the trained machine
+    iterations_per_stage : int
+      The number of EM iterations after each split
+    final_iterations : int
+      The number of EM iterations of the last stage. If None, ``iterations_per_stage`` is used
+    epsilon : float
+      The displacement of the means of the split components, in standard deviations
+    max_frames_per_gaussian : int
+      If given, the intermediate stages with ``C`` components only use (at most) ``C * max_frames_per_gaussian`` frames, regularly subsampled from ``data``. The last stage uses all the data
+  """
+  if final_iterations is None:
+    final_iterations = iterations_per_stage
+
+  n_inputs = machine.shape[1]
+  variance_thresholds = machine.variance_thresholds[0].copy() if machine.shape[0] > 0 else numpy.zeros((n_inputs,))
+
+  # A single Gaussian is the ML estimate on the data
+  machine.resize(1, n_inputs)
+  machine.variance_thresholds = variance_thresholds.reshape(1, n_inputs)
+  machine.means = data.mean(axis=0).reshape(1, n_inputs)
+  machine.variances = data.var(axis=0).reshape(1, n_inputs)
+
+  while machine.shape[0] < n_gaussians:
+    n_splits = min(machine.shape[0], n_gaussians - machine.shape[0])
+    machine.split(n_splits, epsilon)
+    last = machine.shape[0] == n_gaussians
+
+    stage_data = data
+    if not last and max_frames_per_gaussian is not None:
+      step = data.shape[0] // (machine.shape[0] * max_frames_per_gaussian)
+      if step > 1:
+        stage_data = data[::step]
+
+    logger.info("Stage with %d Gaussians, %d frames", machine.shape[0], stage_data.shape[0])
+    train(trainer, machine, stage_data, max_iterations=final_iterations if last else iterations_per_stage)
+
+
+def train_jfa(trainer, jfa_base, data, max_iterations=10, initialize=True, rng=None, checkpoint=None, checkpoint_interval=1):
   """
   Trains a :py:class:`bob.learn.em.JFABase` given a :py:class:`bob.learn.em.JFATrainer` and the proper data
 
@@ -85,34 +271,39 @@ def train_jfa(trainer, jfa_base, data, max_iterations=10, initialize=True, rng=N
       If True, runs the initialization procedure
     rng :  :py:class:`bob.core.random.mt19937`
       The Mersenne Twister mt19937 random generator used for the initialization of subspaces/arrays before the EM loops
+    checkpoint : str
+      The name of an HDF5 file to which the machine and the state of the trainer are saved during the training. If the file exists, the training resumes from it, as in :py:func:`bob.learn.em.train`
+    checkpoint_interval : int
+      The number of iterations between two checkpoints. A checkpoint is also saved at the end of the estimation of each subspace
   """
+  resume = checkpoint is not None and os.path.exists(checkpoint)
 
-  if initialize:
+  if initialize or resume:
     if rng is not None:
       trainer.initialize(jfa_base, data, rng)
     else:
       trainer.initialize(jfa_base, data)
 
-  #V Subspace
-  logger.info("V subspace estimation...")
-  for i in range(max_iterations):
-    logger.info("Iteration = %d/%d", i, max_iterations)
-    trainer.e_step_v(jfa_base, data)
-    trainer.m_step_v(jfa_base, data)
-  trainer.finalize_v(jfa_base, data)
-
-  #U subspace
-  logger.info("U subspace estimation...")  
-  for i in range(max_iterations):
-    logger.info("Iteration = %d/%d", i, max_iterations)
-    trainer.e_step_u(jfa_base, data)
-    trainer.m_step_u(jfa_base, data)
-  trainer.finalize_u(jfa_base, data)
+  start_stage, start_iteration = 0, 0
+  if resume:
+    start_stage, start_iteration = _load_checkpoint(checkpoint, trainer, jfa_base, "stage", "iteration")
+    logger.info("Resuming from `%s' at stage %d, iteration %d", checkpoint, start_stage, start_iteration)
 
-  # D subspace
-  logger.info("D subspace estimation...")  
-  for i in range(max_iterations):
-    logger.info("Iteration = %d/%d", i, max_iterations)
-    trainer.e_step_d(jfa_base, data)
-    trainer.m_step_d(jfa_base, data)
-  trainer.finalize_d(jfa_base, data)
+  stages = (
+    ("V", trainer.e_step_v, trainer.m_step_v, trainer.finalize_v),
+    ("U", trainer.e_step_u, trainer.m_step_u, trainer.finalize_u),
+    ("D", trainer.e_step_d, trainer.m_step_d, trainer.finalize_d),
+  )
+  for stage, (name, e_step, m_step, finalize) in enumerate(stages):
+    if stage < start_stage:
+      continue
+    logger.info("%s subspace estimation...", name)
+    for i in range(start_iteration if stage == start_stage else 0, max_iterations):
+      logger.info("Iteration = %d/%d", i, max_iterations)
+      e_step(jfa_base, data)
+      m_step(jfa_base, data)
+      if checkpoint is not None and (i+1) % checkpoint_interval == 0:
+        _save_checkpoint(checkpoint, trainer, jfa_base, stage=stage, iteration=i+1)
+    finalize(jfa_base, data)
+    if checkpoint is not None:
+      _save_checkpoint(checkpoint, trainer, jfa_base, stage=stage+1, iteration=0)
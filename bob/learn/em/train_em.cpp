@@ -0,0 +1,293 @@
+/**
+ * @author Tiago de Freitas Pereira <tiago.pereira@idiap.ch>
+ * @date Mon Oct 19 09:12:41 2026 +0200
+ *
+ * @brief Python API for bob::learn::em
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "main.h"
+#include <bob.learn.em/EMTrainingDriver.h>
+#include <bob.learn.em/EMMultiRestartDriver.h>
+
+/* converts PyObject to bool and returns false if object is NULL */
+static inline bool f(PyObject* o){return o != 0 && PyObject_IsTrue(o) > 0;}
+
+
+/*** train_em ***/
+bob::extension::FunctionDoc train_em = bob::extension::FunctionDoc(
+  "train_em",
+  "Trains a machine given a trainer and the proper data, with the EM loop run in C++",
+  "This is equivalent to :py:func:`bob.learn.em.train`, but the whole loop "
+  "(initialization, E-steps, M-steps and computation of the likelihood) is run "
+  "without going back to Python and with the global interpreter lock released, "
+  "so that other Python threads can run during the training. "
+  "The trainer and the machine must not be used by another thread meanwhile.\n\n"
+  "Only the C++ trainers are supported: methods overridden in Python subclasses are ignored. "
+  "The subsampling and the checkpoints of :py:func:`bob.learn.em.train` are not available: each E-step uses all the data.",
+  true
+)
+.add_prototype("trainer, machine, data, [max_iterations], [convergence_threshold], [initialize], [rng]", "converged, likelihoods, times")
+.add_parameter("trainer", ":py:class:`bob.learn.em.KMeansTrainer`, :py:class:`bob.learn.em.ML_GMMTrainer`, :py:class:`bob.learn.em.MAP_GMMTrainer` or :py:class:`bob.learn.em.EMPCATrainer`", "A trainer mechanism")
+.add_parameter("machine", ":py:class:`bob.learn.em.KMeansMachine`, :py:class:`bob.learn.em.GMMMachine` or :py:class:`bob.learn.linear.Machine`", "The machine to train, matching the trainer")
+.add_parameter("data", "array_like <float, 2D>", "The data to be trained")
+.add_parameter("max_iterations", "int", "[Default: ``50``] The maximum number of iterations")
+.add_parameter("convergence_threshold", "float", "[Default: ``None``] The convergence threshold. If None, the training procedure will stop with the iterations criteria")
+.add_parameter("initialize", "bool", "[Default: ``True``] If True, runs the initialization procedure")
+.add_parameter("rng", ":py:class:`bob.core.random.mt19937`", "The Mersenne Twister mt19937 random generator used for the initialization of the :py:class:`bob.learn.em.KMeansTrainer` and :py:class:`bob.learn.em.EMPCATrainer`")
+.add_return("converged", "bool", "True if the training stopped because of the convergence criterion")
+.add_return("likelihoods", "array_like <float, 1D>", "The likelihood after each iteration, the first one being the E-step that follows the initialization")
+.add_return("times", "array_like <float, 1D>", "The wall time of each iteration, in seconds");
+
+template <typename T_trainer, typename T_machine>
+static PyObject* run_em(T_trainer& trainer, T_machine& machine,
+  const blitz::Array<double,2>& data, const int max_iterations,
+  const double convergence_threshold, const bool initialize)
+{
+  bob::learn::em::EMTrainingDriver<T_trainer, T_machine> driver(max_iterations, convergence_threshold);
+
+  PyThreadState* state = PyEval_SaveThread();
+  try {
+    driver.train(trainer, machine, data, initialize);
+  }
+  catch (...) {
+    PyEval_RestoreThread(state);
+    throw;
+  }
+  PyEval_RestoreThread(state);
+
+  const std::vector<bob::learn::em::EMIteration>& iterations = driver.getIterations();
+  blitz::Array<double,1> likelihoods(iterations.size()), times(iterations.size());
+  for (size_t i=0; i<iterations.size(); ++i) {
+    likelihoods(i) = iterations[i].likelihood;
+    times(i) = iterations[i].time;
+  }
+
+  return Py_BuildValue("ONN", driver.hasConverged() ? Py_True : Py_False,
+    PyBlitzArrayCxx_AsNumpy(likelihoods), PyBlitzArrayCxx_AsNumpy(times));
+}
+
+static bool check_machine(PyObject* machine, PyTypeObject* type, PyObject* trainer) {
+  if (!PyObject_TypeCheck(machine, type)) {
+    PyErr_Format(PyExc_TypeError, "`%s' trains `%s' objects, not `%s'", Py_TYPE(trainer)->tp_name, type->tp_name, Py_TYPE(machine)->tp_name);
+    return false;
+  }
+  return true;
+}
+
+PyObject* PyBobLearnEM_train_em(PyObject*, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = train_em.kwlist(0);
+
+  PyObject* trainer = 0;
+  PyObject* machine = 0;
+  PyBlitzArrayObject* data = 0;
+  int max_iterations = 50;
+  PyObject* convergence_threshold = Py_None;
+  PyObject* initialize = Py_True;
+  PyBoostMt19937Object* rng = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO&|iOO!O!", kwlist, &trainer, &machine,
+                                                                    &PyBlitzArray_Converter, &data,
+                                                                    &max_iterations,
+                                                                    &convergence_threshold,
+                                                                    &PyBool_Type, &initialize,
+                                                                    &PyBoostMt19937_Type, &rng)){
+    train_em.print_usage();
+    return 0;
+  }
+  auto data_ = make_safe(data);
+
+  if (data->type_num != NPY_FLOAT64 || data->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`train_em' only processes 2D arrays of float64 for `data`");
+    return 0;
+  }
+
+  if (max_iterations < 0){
+    PyErr_Format(PyExc_ValueError, "`train_em' requires a positive number of iterations, not %d", max_iterations);
+    return 0;
+  }
+
+  double threshold = -1.;
+  if (convergence_threshold != Py_None){
+    threshold = PyFloat_AsDouble(convergence_threshold);
+    if (PyErr_Occurred()) return 0;
+  }
+
+  const blitz::Array<double,2>& data__ = *PyBlitzArrayCxx_AsBlitz<double,2>(data);
+
+  if (PyBobLearnEMKMeansTrainer_Check(trainer)){
+    if (!check_machine(machine, &PyBobLearnEMKMeansMachine_Type, trainer)) return 0;
+    bob::learn::em::KMeansTrainer& trainer_ = *((PyBobLearnEMKMeansTrainerObject*)trainer)->cxx;
+    if (rng) trainer_.setRng(rng->rng);
+    // The bounds of the accelerated E-step may be the ones of other data
+    // (e.g., of a previous e_step)
+    trainer_.clearBounds();
+    Py_CLEAR(((PyBobLearnEMKMeansTrainerObject*)trainer)->bound_data);
+    return run_em(trainer_, *((PyBobLearnEMKMeansMachineObject*)machine)->cxx, data__, max_iterations, threshold, f(initialize));
+  }
+  if (PyBobLearnEMMLGMMTrainer_Check(trainer)){
+    if (!check_machine(machine, &PyBobLearnEMGMMMachine_Type, trainer)) return 0;
+    return run_em(*((PyBobLearnEMMLGMMTrainerObject*)trainer)->cxx, *((PyBobLearnEMGMMMachineObject*)machine)->cxx, data__, max_iterations, threshold, f(initialize));
+  }
+  if (PyBobLearnEMMAPGMMTrainer_Check(trainer)){
+    if (!check_machine(machine, &PyBobLearnEMGMMMachine_Type, trainer)) return 0;
+    return run_em(*((PyBobLearnEMMAPGMMTrainerObject*)trainer)->cxx, *((PyBobLearnEMGMMMachineObject*)machine)->cxx, data__, max_iterations, threshold, f(initialize));
+  }
+  if (PyBobLearnEMEMPCATrainer_Check(trainer)){
+    if (!check_machine(machine, &PyBobLearnLinearMachine_Type, trainer)) return 0;
+    bob::learn::em::EMPCATrainer& trainer_ = *((PyBobLearnEMEMPCATrainerObject*)trainer)->cxx;
+    if (rng) trainer_.setRng(rng->rng);
+    return run_em(trainer_, *((PyBobLearnLinearMachineObject*)machine)->cxx, data__, max_iterations, threshold, f(initialize));
+  }
+
+  PyErr_Format(PyExc_TypeError, "`train_em' does not support trainers of type `%s'", Py_TYPE(trainer)->tp_name);
+  return 0;
+
+  BOB_CATCH_FUNCTION("cannot train the machine", 0)
+}
+
+
+/*** train_restarts ***/
+bob::extension::FunctionDoc train_restarts = bob::extension::FunctionDoc(
+  "train_restarts",
+  "Trains several copies of a machine from independent random initializations, concurrently, and keeps the best one",
+  "Each restart has its own copy of the trainer and of the machine, and a random generator seeded with ``seed+r``; "
+  "the data is shared by all the restarts, which are run on ``n_threads`` threads with the global interpreter lock released. "
+  "The :py:class:`bob.learn.em.KMeansTrainer` is initialized with its own initialization method; "
+  "the means of a :py:class:`bob.learn.em.GMMMachine` are drawn among the data, its variances are the ones of the data and its weights are uniform.\n\n"
+  "The restarts are run in lockstep: after ``warmup_iterations`` iterations, and then every ``check_interval`` iterations, "
+  "the restarts whose likelihood trails the one of the best restart by more than ``margin`` (relative to the best likelihood) are stopped. "
+  "For the k-means, the average distance to the closest mean is used, and lower is better.\n\n"
+  "The given machine is overwritten by the best machine.",
+  true
+)
+.add_prototype("trainer, machine, data, [n_restarts], [max_iterations], [convergence_threshold], [warmup_iterations], [check_interval], [margin], [n_threads], [seed]", "best, reports")
+.add_parameter("trainer", ":py:class:`bob.learn.em.KMeansTrainer` or :py:class:`bob.learn.em.ML_GMMTrainer`", "A trainer mechanism, copied for each restart")
+.add_parameter("machine", ":py:class:`bob.learn.em.KMeansMachine` or :py:class:`bob.learn.em.GMMMachine`", "The machine to train, matching the trainer")
+.add_parameter("data", "array_like <float, 2D>", "The data to be trained")
+.add_parameter("n_restarts", "int", "[Default: ``4``] The number of restarts")
+.add_parameter("max_iterations", "int", "[Default: ``50``] The maximum number of iterations of a restart")
+.add_parameter("convergence_threshold", "float", "[Default: ``None``] The convergence threshold of a restart. If None, a restart stops with the iterations criteria")
+.add_parameter("warmup_iterations", "int", "[Default: ``5``] The number of iterations before the restarts are first compared")
+.add_parameter("check_interval", "int", "[Default: ``5``] The number of iterations between two comparisons of the restarts")
+.add_parameter("margin", "float", "[Default: ``0.01``] The relative margin below the best likelihood under which a restart is stopped. If None, no restart is stopped early")
+.add_parameter("n_threads", "int", "[Default: ``1``] The number of threads")
+.add_parameter("seed", "int", "[Default: ``0``] The seed of the first restart")
+.add_return("best", "int", "The index of the best restart")
+.add_return("reports", "[dict]", "For each restart, its ``seed``, the number of ``iterations`` run, its last ``likelihood``, whether it ``converged`` or was ``stopped_early``, and its wall ``time`` in seconds");
+
+template <typename T_trainer, typename T_machine>
+static PyObject* run_restarts(const T_trainer& trainer, T_machine& machine,
+  const blitz::Array<double,2>& data, bob::learn::em::EMMultiRestartDriver<T_trainer, T_machine>& driver,
+  const uint64_t seed)
+{
+  size_t best;
+  PyThreadState* state = PyEval_SaveThread();
+  try {
+    best = driver.train(trainer, machine, data, seed);
+  }
+  catch (...) {
+    PyEval_RestoreThread(state);
+    throw;
+  }
+  PyEval_RestoreThread(state);
+
+  const std::vector<bob::learn::em::EMRestartReport>& reports = driver.getReports();
+  PyObject* list = PyList_New(reports.size());
+  if (!list) return 0;
+  auto list_ = make_safe(list);
+  for (size_t r=0; r<reports.size(); ++r) {
+    PyObject* report = Py_BuildValue("{s:K,s:n,s:d,s:N,s:N,s:d}",
+      "seed", (unsigned long long)reports[r].seed,
+      "iterations", (Py_ssize_t)reports[r].n_iterations,
+      "likelihood", reports[r].likelihood,
+      "converged", PyBool_FromLong(reports[r].converged),
+      "stopped_early", PyBool_FromLong(reports[r].stopped_early),
+      "time", reports[r].time);
+    if (!report) return 0;
+    PyList_SET_ITEM(list, r, report);
+  }
+
+  return Py_BuildValue("nO", (Py_ssize_t)best, list);
+}
+
+PyObject* PyBobLearnEM_train_restarts(PyObject*, PyObject* args, PyObject* kwargs) {
+  BOB_TRY
+
+  char** kwlist = train_restarts.kwlist(0);
+
+  PyObject* trainer = 0;
+  PyObject* machine = 0;
+  PyBlitzArrayObject* data = 0;
+  int n_restarts = 4;
+  int max_iterations = 50;
+  PyObject* convergence_threshold = Py_None;
+  int warmup_iterations = 5;
+  int check_interval = 5;
+  PyObject* margin = 0;
+  int n_threads = 1;
+  unsigned long long seed = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO&|iiOiiOiK", kwlist, &trainer, &machine,
+                                                                     &PyBlitzArray_Converter, &data,
+                                                                     &n_restarts, &max_iterations,
+                                                                     &convergence_threshold,
+                                                                     &warmup_iterations, &check_interval,
+                                                                     &margin, &n_threads, &seed)){
+    train_restarts.print_usage();
+    return 0;
+  }
+  auto data_ = make_safe(data);
+
+  if (data->type_num != NPY_FLOAT64 || data->ndim != 2){
+    PyErr_Format(PyExc_TypeError, "`train_restarts' only processes 2D arrays of float64 for `data`");
+    return 0;
+  }
+
+  if (n_restarts <= 0 || n_threads <= 0 || check_interval <= 0){
+    PyErr_Format(PyExc_ValueError, "`train_restarts' requires a positive number of restarts, threads and iterations between two checks");
+    return 0;
+  }
+
+  if (max_iterations < 0 || warmup_iterations < 0){
+    PyErr_Format(PyExc_ValueError, "`train_restarts' requires a positive number of iterations");
+    return 0;
+  }
+
+  double threshold = -1.;
+  if (convergence_threshold != Py_None){
+    threshold = PyFloat_AsDouble(convergence_threshold);
+    if (PyErr_Occurred()) return 0;
+  }
+
+  double margin_ = 0.01;
+  if (margin == Py_None)
+    margin_ = -1.;
+  else if (margin){
+    margin_ = PyFloat_AsDouble(margin);
+    if (PyErr_Occurred()) return 0;
+  }
+
+  const blitz::Array<double,2>& data__ = *PyBlitzArrayCxx_AsBlitz<double,2>(data);
+
+  if (PyBobLearnEMKMeansTrainer_Check(trainer)){
+    if (!check_machine(machine, &PyBobLearnEMKMeansMachine_Type, trainer)) return 0;
+    bob::learn::em::EMMultiRestartDriver<bob::learn::em::KMeansTrainer, bob::learn::em::KMeansMachine>
+      driver(n_restarts, max_iterations, threshold, warmup_iterations, check_interval, margin_, n_threads);
+    return run_restarts(*((PyBobLearnEMKMeansTrainerObject*)trainer)->cxx, *((PyBobLearnEMKMeansMachineObject*)machine)->cxx, data__, driver, seed);
+  }
+  if (PyBobLearnEMMLGMMTrainer_Check(trainer)){
+    if (!check_machine(machine, &PyBobLearnEMGMMMachine_Type, trainer)) return 0;
+    bob::learn::em::EMMultiRestartDriver<bob::learn::em::ML_GMMTrainer, bob::learn::em::GMMMachine>
+      driver(n_restarts, max_iterations, threshold, warmup_iterations, check_interval, margin_, n_threads);
+    return run_restarts(*((PyBobLearnEMMLGMMTrainerObject*)trainer)->cxx, *((PyBobLearnEMGMMMachineObject*)machine)->cxx, data__, driver, seed);
+  }
+
+  PyErr_Format(PyExc_TypeError, "`train_restarts' does not support trainers of type `%s'", Py_TYPE(trainer)->tp_name);
+  return 0;
+
+  BOB_CATCH_FUNCTION("cannot train the machine", 0)
+}
@@ -16,7 +16,7 @@ build_requires = load_requirements()
 version = open("version.txt").read().rstrip()
 
 packages = ['boost']
-boost_modules = ['system']
+boost_modules = ['system', 'thread']
 
 setup(
 
@@ -55,9 +55,18 @@ setup(
           "bob/learn/em/cpp/Gaussian.cpp",
           "bob/learn/em/cpp/GMMMachine.cpp",
           "bob/learn/em/cpp/GMMStats.cpp",
+          "bob/learn/em/cpp/GMMStatsSet.cpp",
+          "bob/learn/em/cpp/GMMStatsArchive.cpp",
+          "bob/learn/em/cpp/GMMStatsAccumulator.cpp",
+          "bob/learn/em/cpp/DataSource.cpp",
+          "bob/learn/em/cpp/Checkpoint.cpp",
+          "bob/learn/em/cpp/CenteredGMMStats.cpp",
           "bob/learn/em/cpp/IVectorMachine.cpp",
           "bob/learn/em/cpp/KMeansMachine.cpp",
+          "bob/learn/em/cpp/KDTree.cpp",
           "bob/learn/em/cpp/LinearScoring.cpp",
+          "bob/learn/em/cpp/SumGMMStats.cpp",
+          "bob/learn/em/cpp/MAPSupervectors.cpp",
           "bob/learn/em/cpp/PLDAMachine.cpp",
           "bob/learn/em/cpp/ZTNorm.cpp",
 
@@ -75,13 +84,16 @@ setup(
           "bob/learn/em/cpp/GMMBaseTrainer.cpp",
           "bob/learn/em/cpp/IVectorTrainer.cpp",
           "bob/learn/em/cpp/KMeansTrainer.cpp",
+          "bob/learn/em/cpp/MiniBatchKMeansTrainer.cpp",
           "bob/learn/em/cpp/MAP_GMMTrainer.cpp",
+          "bob/learn/em/cpp/MAPEnrollmentModel.cpp",
           "bob/learn/em/cpp/ML_GMMTrainer.cpp",
           "bob/learn/em/cpp/PLDATrainer.cpp",
         ],
         bob_packages = bob_packages,
         packages = packages,
         boost_modules = boost_modules,
+        libraries = ['blas'],
         version = version,
       ),
 
@@ -89,12 +101,19 @@ setup(
         [
           "bob/learn/em/gaussian.cpp",
           "bob/learn/em/gmm_stats.cpp",
+          "bob/learn/em/gmm_stats_set.cpp",
+          "bob/learn/em/gmm_stats_archive.cpp",
+          "bob/learn/em/gmm_stats_accumulator.cpp",
+          "bob/learn/em/data_source.cpp",
+          "bob/learn/em/centered_gmm_stats.cpp",
           "bob/learn/em/gmm_machine.cpp",
           "bob/learn/em/kmeans_machine.cpp",
           "bob/learn/em/kmeans_trainer.cpp",
+          "bob/learn/em/mini_batch_kmeans_trainer.cpp",
 
           "bob/learn/em/ml_gmm_trainer.cpp",
           "bob/learn/em/map_gmm_trainer.cpp",
+          "bob/learn/em/map_enrollment_model.cpp",
 
           "bob/learn/em/jfa_base.cpp",
           "bob/learn/em/jfa_machine.cpp",
@@ -118,6 +137,12 @@ setup(
 
           "bob/learn/em/linear_scoring.cpp",
 
+          "bob/learn/em/sum_gmm_stats.cpp",
+
+          "bob/learn/em/map_supervectors.cpp",
+
+          "bob/learn/em/train_em.cpp",
+
           "bob/learn/em/main.cpp",
         ],
         bob_packages = bob_packages,